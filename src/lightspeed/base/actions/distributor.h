@@ -57,6 +57,8 @@ namespace LightSpeed {
 	 * @tparam Config configuration for distributor. See DistributorDefCfg to
 	 * see documentation for configuration
 	 *
+	 * @note Distributor holds the lock while it walks the listeners. If many threads
+	 * publishes messages and stages are not needed, use RcuDistributor
 	 */
 	template<typename Ifc,
 			 typename StageSel = DistributorNoStages,
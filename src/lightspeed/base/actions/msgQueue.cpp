@@ -116,6 +116,7 @@ void MsgQueue::postMessage(AbstractMsg *msg) {
 	if (msg == 0 || msg->next != nil) return;
 	//notify message, that is queued
 	msg->queued(*this);
+	msg->traceContext = TraceContext::current();
 	//set next by current top
 	msg->next = newMessages;
 	//atomically set new top
@@ -138,6 +139,7 @@ void MsgQueue::postPriorityMessage(AbstractMsg *msg) {
 	if (msg == 0 || msg->next != nil) return;
 	//notify message, that is queued
 	msg->queued(*this);
+	msg->traceContext = TraceContext::current();
 	msg->next = curQueue;
 	while (lockCompareExchangePtr(&curQueue,msg->next.get(),msg) != msg->next.get()) {
 		msg->next.detach();
@@ -186,6 +188,7 @@ bool MsgQueue::pumpMessage() {
 	PMsg m = getNextMsg();
 	if (m == nil) return false;
 	curMessage = m;
+	TraceContextScope _(m->traceContext);
 	m->run();
 	curMessage = 0;
 	return true;
@@ -11,6 +11,7 @@
 #include "executor.h"
 #include "../memory/allocPointer.h"
 #include "../../mt/notifier.h"
+#include "../debug/traceContext.h"
 
 namespace LightSpeed {
 
@@ -146,6 +147,8 @@ public:
 
 
 		PMsg next;
+		///trace context of the thread which posted the message, it is active while message runs
+		TraceContext traceContext;
 
 	};
 
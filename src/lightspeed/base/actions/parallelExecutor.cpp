@@ -14,9 +14,35 @@
 #include "../exceptions/throws.tcc"
 #include "../actions/parallelExecutor.h"
 #include "../framework/iapp.h"
+#include "../framework/metrics.h"
 
 namespace LightSpeed {
 
+class ParallelExecutor::Instruments {
+public:
+	StringA label;
+	MetricGauge threads;
+	MetricGauge idle;
+	MetricCounter jobs;
+
+	Instruments(const ParallelExecutor &owner)
+		:label(Metric::label("executor","default"))
+		,threads("lightspeed_executor_threads","Count of threads of the executor",label,owner.curThreadCount)
+		,idle("lightspeed_executor_idle_threads","Count of idle threads of the executor",label,owner.idleCount)
+		,jobs("lightspeed_executor_jobs_total","Count of actions passed to the executor",label) {}
+
+	void setName(ConstStrA name) {
+		label = Metric::label("executor",name);
+		threads.setLabels(label);
+		idle.setLabels(label);
+		jobs.setLabels(label);
+	}
+};
+
+void ParallelExecutor::setMetricsName(ConstStrA name) {
+	instruments->setName(name);
+}
+
 ParallelExecutor::ParallelExecutor(natural maxThreads,natural maxWaitTimeout,
 	 	  natural newThreadTimeout,natural threadIdleTimeout)
 	:maxThreads(maxThreads)
@@ -28,6 +54,7 @@ ParallelExecutor::ParallelExecutor(natural maxThreads,natural maxWaitTimeout,
 	,curAction(0)
 	,waitPt(SyncPt::stack)
 	,orderStop(false)
+	,instruments(new Instruments(*this))
 {
 	if (this->maxThreads == 0) this->maxThreads = ParallelExecutor::getCPUCount();
 	if (this->maxThreads == 0) this->maxThreads = 1;
@@ -43,6 +70,7 @@ ParallelExecutor::ParallelExecutor(const ParallelExecutor& other)
 ,curAction(0)
 ,waitPt(SyncPt::stack)
 ,orderStop(false)
+,instruments(new Instruments(*this))
 {
 }
 
@@ -110,12 +138,15 @@ void ParallelExecutor::execute(const IExecAction &action) {
 
 	Synchronized<FastLock> _(executeLock);
 
+	instruments->jobs.add();
 	orderStop = false;
 
 	//create notifier
 	Notifier ntf;
 	//register notifier
 	writeReleasePtr<ISleepingObject>(&callerNtf,&ntf);
+	//caller's trace context continues in the worker
+	curTraceContext = TraceContext::current();
 	//write new action
 	writeReleasePtr<const IExecAction>(&curAction,&action);
 
@@ -200,6 +231,8 @@ void ParallelExecutor::Worker::runAction(const IExecAction *action) {
 	AllocInBuffer abuff(buff,sz);
 	//clone action into the buffer in the stack
 	AllocPointer<IExecAction> a(action->clone(abuff));
+	//caller is still blocked, take its trace context
+	TraceContextScope trace(owner.curTraceContext);
 	//store last exception
 	//notify caller, action taken, worker starting to work
 	owner.callerNtf->wakeUp(0);
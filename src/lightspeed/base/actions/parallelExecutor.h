@@ -13,6 +13,8 @@
 #include "../../mt/syncPt.h"
 #include "../../mt/atomic_type.h"
 #include "../../mt/thread.h"
+#include "../memory/allocPointer.h"
+#include "../debug/traceContext.h"
 
 namespace LightSpeed {
 
@@ -120,6 +122,10 @@ public:
 
 	natural getIdleTimeout() const;
 
+	///Sets name of the executor exported as the label of its metrics
+	/** Executors without the name share the label executor="default" */
+	void setMetricsName(ConstStrA name);
+
 	///retrieves count of CPUs available on this computer
 	static natural getCPUCount();
 
@@ -177,9 +183,16 @@ protected:
 	Pointer<Worker> topWorker;
 	ISleepingObject * volatile callerNtf;
 	const Message<void>::Ifc * volatile curAction;
+	///trace context of the caller, valid with curAction
+	TraceContext curTraceContext;
 	SyncPt waitPt;
 	FastLock executeLock;
 	bool orderStop;
+
+	///Metrics of the executor (see MetricsRegistry)
+	class Instruments;
+	AllocPointer<Instruments> instruments;
+
 	virtual void startNewThread();
 	///Called when executor wants to wake one thread from the pool of the waiting threads
 	/** Function tries to wake one thread
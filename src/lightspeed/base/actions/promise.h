@@ -9,6 +9,7 @@
 #include "../../mt/fastlock.h"
 #include "../containers/deque.h"
 #include "../meta/emptyClass.h"
+#include "../debug/traceContext.h"
 
 #ifdef LIGHTSPEED_ENABLE_CPP11
 #include <cstddef>
@@ -821,7 +822,17 @@ protected:
 		Optional<T> value;
 		PException exception;
 
-		typedef Deque<IObserver *, SmallAlloc<4> > Observers;
+		///Registered observer
+		struct RegObserver {
+			IObserver *observer;
+			///trace context of the thread which registered the observer, active while observer is resolved
+			TraceContext traceContext;
+
+			RegObserver(IObserver *observer, const TraceContext &traceContext)
+				:observer(observer),traceContext(traceContext) {}
+		};
+
+		typedef Deque<RegObserver, SmallAlloc<4> > Observers;
 		Observers observers;
 		atomic resultRefCnt;
 
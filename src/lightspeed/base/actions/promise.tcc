@@ -66,10 +66,11 @@ void Future<T>::Value::resolveInternal(X &var, const Y & result)
 	var = result;
 	//cycle until the list of observers is empty
 	while (!observers.empty()) {
-		IObserver *x = observers.getFront();
+		RegObserver x = observers.getFront();
 		observers.popFront();
 		SyncReleased<FastLock> _(lock);
-		x->resolve(var);
+		TraceContextScope trace(x.traceContext);
+		x.observer->resolve(var);
 	}
 	//reset state
 	resolving = false;
@@ -99,7 +100,7 @@ void Future<T>::Value::registerObserver( IObserver *ifc ) throw()
 		}
 	}
 	//otherwise add the observer to the list
-	observers.pushBack(ifc);
+	observers.pushBack(RegObserver(ifc, TraceContext::current()));
 	//unlock internals
 	lock.unlock();
 }
@@ -112,9 +113,9 @@ bool Future<T>::Value::unregisterObserver( IObserver *ifc ) throw()
 	natural cnt = observers.length();
 	natural i = 0;
 	while (i < cnt) {
-		IObserver *x = observers.getBack();
+		RegObserver x = observers.getBack();
 		observers.popBack();
-		if (x == ifc) {
+		if (x.observer == ifc) {
 			if (i < cnt / 2) {
 				while (i > 0) {
 					x = observers.getFront();
@@ -452,7 +453,7 @@ template<typename T>
 IPromiseControl::State Future<T>::Value::cancel( const PException &e ) throw() {	
 
 
-	AutoArray<IObserver *, SmallAlloc<16> > cpy;
+	AutoArray<RegObserver, SmallAlloc<16> > cpy;
 	{
 		Synchronized<FastLock> _(lock);
 		cpy.reserve(observers.length());
@@ -462,8 +463,10 @@ IPromiseControl::State Future<T>::Value::cancel( const PException &e ) throw() {
 		}
 	}
 
-	for (natural i = 0; i < cpy.length(); i++)
-		cpy[i]->resolve(e);
+	for (natural i = 0; i < cpy.length(); i++) {
+		TraceContextScope trace(cpy[i].traceContext);
+		cpy[i].observer->resolve(e);
+	}
 		
 	return getState();
 	
@@ -604,7 +607,7 @@ inline Future<T>::Value::~Value() {
 		CanceledException e(THISLOCATION);
 		PException ce = e.clone();
 		for (natural i = 0; i < observers.length();i++)
-			observers[i]->resolve(ce);
+			observers[i].observer->resolve(ce);
 	}
 }
 
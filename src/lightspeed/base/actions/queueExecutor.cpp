@@ -11,6 +11,9 @@
 #include "../../mt/thread.h"
 #include "../sync/synchronize.h"
 #include "../containers/queue.tcc"
+#include "../memory/stdAlloc.h"
+#include "../containers/autoArray.tcc"
+#include "../exceptions/throws.tcc"
 
 namespace LightSpeed {
 
@@ -22,22 +25,150 @@ void QueueExecutor::wakeThread() {
 	semaphore.unlock();
 }
 
-void QueueExecutor::execute(const IExecAction& action) {
-	//lock internals
+bool QueueExecutor::pushRing(const IExecAction &action) {
+	atomicValue pos = readAcquire(&enqueuePos);
+	Cell *cell;
+	while (true) {
+		cell = &cells(pos & mask);
+		atomicValue dif = readAcquire(&cell->seq) - pos;
+		if (dif == 0) {
+			//cell is free, try to claim it
+			if (lockCompareExchange(enqueuePos,pos,pos+1) == pos) break;
+			pos = readAcquire(&enqueuePos);
+		} else if (dif < 0) {
+			//cell is still occupied by previous round - ring is full
+			return false;
+		} else {
+			//someone claimed the cell before us
+			pos = readAcquire(&enqueuePos);
+		}
+	}
+	cell->traceContext = TraceContext::current();
+	try {
+		//small action is constructed in the cell, larger on the heap
+		if (action.getObjectSize() <= inlineActionSize)
+			cell->action = action.clone(cell->alloc);
+		else
+			cell->action = action.clone(StdAlloc::getInstance());
+	} catch (...) {
+		//the cell must be published anyway, consumers will skip it
+		cell->action = 0;
+		lockExchange(cell->seq,pos+1);
+		throw;
+	}
+	//publish the action - full barrier is needed before sleepers are checked
+	lockExchange(cell->seq,pos+1);
+	return true;
+}
+
+natural QueueExecutor::popRing(natural &outPos) {
+	atomicValue pos = readAcquire(&dequeuePos);
+	while (true) {
+		natural count = 0;
+		//count ready cells
+		while (count < batchSize) {
+			const Cell &cell = cells((pos + count) & mask);
+			if (readAcquire(&cell.seq) != (atomicValue)(pos + count + 1)) break;
+			count++;
+		}
+		if (count == 0) {
+			atomicValue npos = readAcquire(&dequeuePos);
+			//position didn't moved, ring is empty
+			if (npos == pos) return 0;
+			pos = npos;
+		} else if (lockCompareExchange(dequeuePos,pos,pos+count) == pos) {
+			outPos = pos;
+			return count;
+		} else {
+			pos = readAcquire(&dequeuePos);
+		}
+	}
+}
+
+void QueueExecutor::releaseCell(natural pos) {
+	Cell &cell = cells(pos & mask);
+	IExecAction *a = cell.action;
+	cell.action = 0;
+	//destroy action - action stored in the cell returns the storage to the cell's allocator
+	delete a;
+	//make cell available for the next round
+	writeRelease(&cell.seq,pos + mask + 1);
+}
+
+SharedPtr<QueueExecutor::IExecAction> QueueExecutor::popOverflow(TraceContext &traceContext) {
+	if (readAcquire(&overflowCount) == 0 && readAcquire(&returnedCount) == 0) return nil;
+	Synchronized<FastLock> _(lock);
+	if (!returned.empty()) {
+		SharedPtr<IExecAction> a = returned.top().action;
+		traceContext = returned.top().traceContext;
+		returned.pop();
+		lockDec(returnedCount);
+		return a;
+	}
+	if (overflow.empty()) return nil;
+	SharedPtr<IExecAction> a = overflow.top().action;
+	traceContext = overflow.top().traceContext;
+	overflow.pop();
+	lockDec(overflowCount);
+	return a;
+}
+
+bool QueueExecutor::hasActions() const {
+	atomicValue pos = readAcquire(&dequeuePos);
+	const Cell &cell = cells[pos & mask];
+	return readAcquire(&cell.seq) == pos + 1 || readAcquire(&overflowCount) != 0
+			|| readAcquire(&returnedCount) != 0;
+}
+
+void QueueExecutor::clearQueue() {
+	natural pos;
+	natural cnt;
+	while ((cnt = popRing(pos)) != 0) {
+		for (natural i = 0; i < cnt; i++) releaseCell(pos + i);
+	}
 	Synchronized<FastLock> _(lock);
+	overflow.clear();
+	writeRelease(&overflowCount,0);
+	returned.clear();
+	writeRelease(&returnedCount,0);
+}
+
+void QueueExecutor::execute(const IExecAction& action) {
 	//if finish flag active, reject request
-	if (finishFlag) return;
+	if (readAcquire(&finishFlag)) return;
 
-	//clone the action
-	SharedPtr<IExecAction> a = action.clone();
-	//push to the queue
-	queue.push(a);
+	//once overflow is in use, all actions must go there to keep order
+	if (readAcquire(&overflowCount) != 0 || !pushRing(action)) {
+		Synchronized<FastLock> _(lock);
+		SharedPtr<IExecAction> a = action.clone();
+		overflow.push(OverflowItem(a, TraceContext::current()));
+		lockInc(overflowCount);
+	}
+	//finish() could clear the queue before the action was pushed. Both sides store and then
+	//check the other one with full barrier, so at least one of them destroys the action
+	if (readAcquire(&finishFlag)) {
+		clearQueue();
+		return;
+	}
 	//wake possible sleeping thread
-	wakeThread();
+	if (readAcquire(&sleepers) != 0) wakeThread();
 }
 
-QueueExecutor::QueueExecutor():semaphore(1),runningMessages(0),threadsIn(0) {
+static natural roundCapacity(natural capacity) {
+	natural r = 2;
+	while (r < capacity) r <<= 1;
+	return r;
+}
 
+QueueExecutor::QueueExecutor(natural capacity)
+	:mask(roundCapacity(capacity) - 1)
+	,enqueuePos(0),dequeuePos(0),sleepers(0),overflowCount(0),returnedCount(0),runningMessages(0)
+	,semaphore(1),threadsIn(0),finishFlag(0) {
+	cells.resize(mask + 1);
+	for (natural i = 0; i <= mask; i++) {
+		cells(i).seq = i;
+		cells(i).action = 0;
+	}
 }
 
 ///handles entering and exitting from the serving thread
@@ -54,6 +185,13 @@ public:
 
 protected:
 	QueueExecutor *owner;
+
+	///executes batch of actions taken from the ring
+	void runBatch(natural pos, natural count);
+	///returns cells of the batch which were not executed
+	void returnBatch(natural pos, natural count);
+	///waits for an action
+	void waitForAction();
 };
 
 QueueExecutor::Server::Server(QueueExecutor *owner) throw()
@@ -81,56 +219,119 @@ QueueExecutor::Server::~Server() throw() {
 		owner->wakeThread();
 }
 
+void QueueExecutor::Server::runBatch(natural pos, natural count) {
+	natural i = 0;
+	//increase running actions
+	lockInc(owner->runningMessages);
+	try {
+		while (i < count) {
+			//if finish reported or thread will finish, stop executing
+			if (readAcquire(&owner->finishFlag) || Thread::canFinish()) break;
+			const Cell &cell = owner->cells(pos & owner->mask);
+			//empty cell is result of failed clone
+			if (cell.action) {
+				TraceContextScope trace(cell.traceContext);
+				(*cell.action)();
+			}
+			owner->releaseCell(pos);
+			pos++;
+			i++;
+		}
+	} catch (...) {
+		//release cell of failed action
+		owner->releaseCell(pos++);
+		i++;
+		//rest of the batch will be processed by other threads
+		returnBatch(pos, count - i);
+		//in case of exception, decrease running actions
+		lockDec(owner->runningMessages);
+		//throw above
+		throw;
+	}
+	//thread is leaving, but the executor continues - give the rest of the batch to other threads
+	returnBatch(pos, count - i);
+	//decrease running actions
+	lockDec(owner->runningMessages);
+}
+
+void QueueExecutor::Server::returnBatch(natural pos, natural count) {
+	if (count == 0) return;
+	{
+		Synchronized<FastLock> _(owner->lock);
+		for (natural i = 0; i < count; i++, pos++) {
+			const Cell &cell = owner->cells(pos & owner->mask);
+			//actions are destroyed without execution when executor is finishing
+			if (cell.action && !readAcquire(&owner->finishFlag)) {
+				SharedPtr<IExecAction> b = cell.action->clone();
+				owner->returned.push(OverflowItem(b, cell.traceContext));
+				lockInc(owner->returnedCount);
+			}
+			owner->releaseCell(pos);
+		}
+	}
+	if (readAcquire(&owner->sleepers) != 0) owner->wakeThread();
+}
+
+void QueueExecutor::Server::waitForAction() {
+	//spin for a while, new action can arrive soon
+	for (natural i = 0; i < spinCount; i++) {
+		if (owner->hasActions() || readAcquire(&owner->finishFlag)) return;
+	}
+	//announce that thread will sleep. The full barrier of the lockInc
+	//guarantees, that producer either sees the sleeper or we see its action
+	lockInc(owner->sleepers);
+	//counts idle cycles
+	natural counter=0;
+	//we can wait for infinite time, but it is better to give
+	//implementator chance to control his thread. Call onIdle repeatedly
+	bool contWait = !owner->hasActions() && !readAcquire(&owner->finishFlag);
+	while (contWait) {
+		//call onIdle and determine timeout (default infinite)
+		Timeout tm = owner->onIdle(counter++);
+		//wait for unlock semaphore and determine whether it succeed
+		contWait = !owner->semaphore.lock(tm);
+	}
+	lockDec(owner->sleepers);
+}
+
 void QueueExecutor::Server::serve() {
 
 	while(true) {
-
-		{
-			//lock internals
-			Synchronized<FastLock> _(owner->lock);
-			//if finish flag or thread is marked finish, break
-			if (owner->finishFlag || Thread::canFinish()) break;
-			//while queue is not empty
-			while (!owner->queue.empty()) {
-				//pick next action
-				SharedPtr<IExecAction> action = owner->queue.top();
-				//remove it from queue
-				owner->queue.pop();
+		//if finish flag or thread is marked finish, break
+		if (readAcquire(&owner->finishFlag) || Thread::canFinish()) break;
+		natural pos;
+		//returned actions are older than actions in the ring
+		natural count = readAcquire(&owner->returnedCount) != 0?0:owner->popRing(pos);
+		if (count) {
+			//if there are more actions, let another thread to help us
+			if (readAcquire(&owner->sleepers) != 0 && owner->hasActions())
+				owner->wakeThread();
+			runBatch(pos, count);
+		} else {
+			TraceContext traceContext;
+			SharedPtr<IExecAction> action = owner->popOverflow(traceContext);
+			if (action != nil) {
+				//action can be taken while finish() is clearing the queue
+				if (readAcquire(&owner->finishFlag)) break;
 				//increase running actions
-				owner->runningMessages++;
-				try
-				{
-					//unlock the lock temporary
-					SyncReleased<FastLock> _(owner->lock);
+				lockInc(owner->runningMessages);
+				try {
+					TraceContextScope trace(traceContext);
 					//perform action (in case of exception, continue after catch
 					(*action)();
 					//decrease running actions
-					owner->runningMessages--;
+					lockDec(owner->runningMessages);
 				} catch (...) {
 					//in case of exception, decrease running actions
-					owner->runningMessages--;
+					lockDec(owner->runningMessages);
 					//throw above
 					throw;
 				}
-				//if finish reported or thread will finish, break
-				if (owner->finishFlag || Thread::canFinish()) break;
+			} else {
+				//if queue is empty, we need to wait for next message
+				waitForAction();
 			}
 		}
-		//counts idle cycles
-		natural counter=0;
-
-		//if queue is empty, we need to wait for next message
-		//when message is added, semaphore is unlocked
-		//we can wait for infinite time, but it is better to give
-		//implementator chance to control his thread. Call onIdle repeatedly
-		bool contWait;
-		do {
-			//call onIdle and determine timeout (default infinite)
-			Timeout tm = owner->onIdle(counter++);
-			//wait for unlock semaphore and determine whether it succeed
-			contWait = !owner->semaphore.lock(tm);
-			//repeat if not
-		} while (contWait);
 	}
 }
 
@@ -156,12 +357,12 @@ Timeout  QueueExecutor::onIdle(natural ) {
 }
 
 void QueueExecutor::finish() {
-	Synchronized<FastLock> _(lock);
+	//mark finished - full barrier, queue is examined after the flag is visible
+	lockExchange(finishFlag,1);
 	//clear queue
-	queue.clear();
-	//mark finished
-	finishFlag=true;
+	clearQueue();
 	//wake up possible sleeping thread to receive finish flag status
+	Synchronized<FastLock> _(lock);
 	wakeThread();
 
 }
@@ -173,18 +374,20 @@ void QueueExecutor::join() {
 QueueExecutor::~QueueExecutor() {
 	//join all threads
 	join();
+	//destroy actions queued during finishing
+	clearQueue();
 	//ensure that nothing is running there and protect the destructor until lock is destroyed
 	lock.lock();
 }
 
 bool QueueExecutor::isRunning() const {
 	//function must return true, if there are running messages
-	return runningMessages > 0;
+	return readAcquire(&runningMessages) > 0;
 }
 
 void QueueExecutor::reset() {
 	//reset finish flag
-	finishFlag = false;
+	writeRelease(&finishFlag,0);
 }
 
 }
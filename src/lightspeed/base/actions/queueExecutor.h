@@ -12,6 +12,10 @@
 #include "../../mt/gate.h"
 #include "../../mt/semaphore.h"
 #include "../memory/sharedPtr.h"
+#include "../containers/autoArray.h"
+#include "../memory/runtimeAlloc.h"
+#include "../../mt/atomic.h"
+#include "../debug/traceContext.h"
 
 namespace LightSpeed {
 
@@ -21,11 +25,27 @@ namespace LightSpeed {
  *  include Promise and try-catch handler into the executed routine, otherwise
  *  execeptions can be thrown out of the executor in unexpected thread.
  *
+ *  Actions are queued into lock-free bounded ring (MPMC). Small actions are cloned directly
+ *  into the cells of the ring, so execute() doesn't allocate. Larger actions are cloned
+ *  using default allocator and only the pointer is stored in the cell. Serving threads
+ *  take actions in batches, so one atomic operation is enough to remove multiple actions
+ *  from the ring.
+ *
+ *  When the ring is full, actions are stored into the overflow queue protected by the lock.
+ *  While the overflow queue is not empty, all new actions are going to the overflow queue to
+ *  keep order of the actions.
+ *
+ *  Idle threads spin for a while before they are parked on the semaphore. Producers wakes
+ *  the semaphore only if there is a parked thread.
  */
 class QueueExecutor: public IExecutor {
 public:
 
-	QueueExecutor();
+	///Creates executor
+	/**
+	 * @param capacity count of cells in the ring. Value is rounded up to power of two
+	 */
+	QueueExecutor(natural capacity = 256);
 	~QueueExecutor();
 
 
@@ -53,6 +73,10 @@ public:
 	 * @note if executor is stopped or destroyed, all actions are also destroyed without execution. Detecting
 	 * of this situation is on you. If you use Future-Promise, then Promise is reject if last
 	 * instance of the Promise is destroyed without resolution.
+	 *
+	 * @note if an action throws exception or the serving thread is finishing, the rest of the batch
+	 * taken by the thread is returned to the executor and executed by other threads before any
+	 * newer action.
 	 */
 	virtual void execute(const IExecAction &action);
 
@@ -78,25 +102,108 @@ public:
 
 	///Resets finish flag enabling to enqueue actions again
 	void reset();
+
+	///Maximal size of action which is stored directly in the cell
+	static const natural inlineActionSize = 64;
+	///Maximal count of actions taken at once
+	static const natural batchSize = 16;
+	///Count of checks of the queue before thread is parked
+	static const natural spinCount = 200;
+
 protected:
 
+	///One cell of the ring
+	struct Cell {
+		///sequence number. Equal to position, when cell is free, position+1, when cell contains action
+		atomic seq;
+		///pointer to the action. It can point to the storage
+		IExecAction *action;
+		///trace context of the thread which queued the action
+		TraceContext traceContext;
+		///storage for small actions
+		union {
+			natural align;
+			byte storage[inlineActionSize];
+		};
+		///allocates small actions in the storage. Action releases the storage when it is destroyed
+		AllocInBuffer alloc;
+
+		Cell():seq(0),action(0),alloc(storage,inlineActionSize) {}
+		///cells are copied empty only, allocator always refers to own storage
+		Cell(const Cell &):seq(0),action(0),alloc(storage,inlineActionSize) {}
+	private:
+		Cell &operator=(const Cell &);
+	};
+
+	///Action in the overflow queue
+	struct OverflowItem {
+		SharedPtr<IExecAction> action;
+		TraceContext traceContext;
+
+		OverflowItem(const SharedPtr<IExecAction> &action, const TraceContext &traceContext)
+			:action(action),traceContext(traceContext) {}
+	};
+
+	///cells of the ring
+	AutoArray<Cell> cells;
+	///mask to calculate index from the position
+	natural mask;
+	///position where next action will be written
+	atomic enqueuePos;
+	byte enqueuePad[64 - sizeof(atomic)];
+	///position where next action will be read
+	atomic dequeuePos;
+	byte dequeuePad[64 - sizeof(atomic)];
+	///count of parked threads
+	atomic sleepers;
+	///count of actions in overflow queue
+	atomic overflowCount;
+	///count of actions in returned queue
+	atomic returnedCount;
+	///count of running messages
+	atomic runningMessages;
+
 	///lock of internals
 	FastLock lock;
 	///gate is opened, if no threads are serving inside
 	Gate noThreads;
-	///queue of messages
-	Queue<SharedPtr<IExecAction> > queue;
+	///queue of messages when ring is full (protected by lock)
+	Queue<OverflowItem> overflow;
+	///actions taken from the ring but not executed (protected by lock). They are older than
+	///any action in the ring or in the overflow queue, so they are executed first
+	Queue<OverflowItem> returned;
 	///point where all threads waiting for a new action
 	Semaphore semaphore;
-	///count of running messages
-	natural runningMessages;
 	///count of serving threads
 	natural threadsIn;
-	///true if finish is signaled (someone may wait on the gate)
-	bool finishFlag;
+	///nonzero if finish is signaled (someone may wait on the gate)
+	atomic finishFlag;
 
 	virtual void wakeThread();
 
+	///Pushes action to the ring
+	/** @retval true pushed
+	 *  @retval false ring is full */
+	bool pushRing(const IExecAction &action);
+	///Takes batch of cells from the ring
+	/**
+	 * @param pos receives position of the first cell
+	 * @return count of taken cells, zero if ring is empty
+	 */
+	natural popRing(natural &pos);
+	///Releases the cell, destroys action and make cell available for writing
+	void releaseCell(natural pos);
+	///Takes one action from the returned queue or from the overflow queue
+	/**
+	 * @param traceContext receives trace context of the action
+	 * @return action or nil, if queue is empty
+	 */
+	SharedPtr<IExecAction> popOverflow(TraceContext &traceContext);
+	///returns true, if there is something in the queue
+	bool hasActions() const;
+	///Destroys all queued actions
+	void clearQueue();
+
 	class Server;
 
 
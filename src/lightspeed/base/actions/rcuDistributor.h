@@ -0,0 +1,222 @@
+/*
+ * rcuDistributor.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_ACTIONS_RCUDISTRIBUTOR_H_
+#define LIGHTSPEED_BASE_ACTIONS_RCUDISTRIBUTOR_H_
+
+#include "message.h"
+#include "executor.h"
+#include "../containers/autoArray.h"
+#include "../containers/queue.h"
+#include "../memory/refCntPtr.h"
+#include "../../mt/fastlock.h"
+#include "../../mt/atomic.h"
+
+namespace LightSpeed {
+
+	///Distributes events to group of listeners, optimized for many publishers and rare changes of listeners
+	/**
+	 * Unlike Distributor, RcuDistributor doesn't hold any lock during distribution. Listeners
+	 * are stored in immutable snapshot. Publisher only registers itself as reader, picks
+	 * current snapshot and walks it. Adding or removing listener creates new snapshot, which
+	 * replaces the current one. The old snapshot is destroyed once all readers which
+	 * could see it have left (read-copy-update).
+	 *
+	 * Readers are counted in shards selected by the thread identifier, so publishers running
+	 * in different threads don't fight for the same cache line. There are two counters in
+	 * each shard, one for each parity of the epoch. Writer retires the old snapshot,
+	 * flips the epoch and releases the snapshot, when counters of the old parity
+	 * reach zero. Writer never waits for readers, so listener can add or remove listeners
+	 * (including itself) during distribution. Retired snapshots are released during
+	 * next change of the listeners or by the destructor
+	 *
+	 * Distributor doesn't support stages, nested requests and stopping distribution. If you
+	 * need these features, use Distributor.
+	 *
+	 * Messages can be also posted through an executor (see post()). Each listener has
+	 * its own mailbox, so messages are delivered to the listener in order in which they
+	 * were posted, but different listeners can receive messages in parallel.
+	 *
+	 * @tparam Ifc pointer or smart pointer to the listener
+	 */
+	template<typename Ifc>
+	class RcuDistributor {
+	public:
+
+		///Type of message
+		typedef Message<void, Ifc> Msg;
+
+		RcuDistributor();
+		///Destroys distributor
+		/** Waits until all readers leave. You should not destroy distributor while
+		 * there is an active distribution
+		 */
+		~RcuDistributor();
+
+		///adds new listener
+		/**
+		 * @param ptr pointer or smart pointer to new listener
+		 */
+		void add(Ifc ptr);
+
+		///adds new listener to the front of the list
+		/**
+		 * @param ptr pointer or smart pointer to new listener
+		 */
+		void priorityAdd(Ifc ptr);
+
+		///Removes listener
+		/**
+		 * Removes first occurrence of the listener. Function can be called from
+		 * the listener during distribution. However, listener can still receive
+		 * messages which are already being distributed or posted.
+		 *
+		 * @param ptr pointer or smart pointer to the listener
+		 * @retval true removed
+		 * @retval false not found
+		 */
+		bool remove(Ifc ptr);
+
+		///Removes all listeners
+		void removeAll();
+
+		///Counts occurrences of the listener
+		natural isAdded(Ifc ptr) const;
+
+		///Sends message to all listeners
+		/**
+		 * Function returns after message is processed by all listeners. Function
+		 * is MT safe and doesn't acquire any lock. It can be called from multiple
+		 * threads at once. Exception thrown by the listener stops the distribution
+		 *
+		 * @param msg message to send
+		 */
+		void send(const Msg &msg) const;
+
+		///Sends message to all listeners except the sender
+		/**
+		 * @param sender listener which is skipped
+		 * @param msg message to send
+		 */
+		void send(Ifc sender, const Msg &msg) const;
+
+		///Posts message to all listeners through the executor
+		/**
+		 * Function puts message to mailbox of each listener. If the listener
+		 * doesn't have scheduled delivery, the function schedules it on the executor.
+		 * Messages are delivered to each listener in order of posting. Messages
+		 * to the different listeners can be delivered in parallel, depend on
+		 * the executor.
+		 *
+		 * @param msg message to post. Message is shared, it is not copied for each listener.
+		 * @param executor executor which carries out the delivery. It must be MT safe,
+		 * if post() is called from multiple threads. Executor must exist until all messages
+		 * are delivered.
+		 *
+		 * @note if the listener throws exception, rest of the mailbox is scheduled again
+		 * and exception is thrown out of the executor's action.
+		 */
+		void post(const Msg &msg, IExecutor &executor) const;
+
+		///True if distributor is empty
+		bool empty() const;
+
+		///Count of listeners
+		natural size() const;
+
+		void clear() {removeAll();}
+
+		///Waits until all retired snapshots are released
+		/**
+		 * Function must not be called from the listener.
+		 */
+		void synchronize();
+
+		///Count of reader shards
+		static const natural shardCount = 16;
+
+	protected:
+
+		///Listener and its mailbox
+		class Slot: public RefCntObj {
+		public:
+			Slot(Ifc ifc):ifc(ifc),scheduled(false) {}
+
+			const Ifc ifc;
+
+			///puts message into the mailbox
+			void post(const Msg &msg, IExecutor &executor);
+			///delivers messages from mailbox
+			void drain(IExecutor &executor);
+
+		protected:
+			FastLock lock;
+			Queue<Msg> pending;
+			bool scheduled;
+		};
+
+		typedef RefCntPtr<Slot> PSlot;
+
+		///Action which drains mailbox of the slot
+		class DrainAction {
+		public:
+			DrainAction(const PSlot &slot, IExecutor &executor):slot(slot),executor(executor) {}
+			void operator()() const {slot->drain(executor);}
+		protected:
+			PSlot slot;
+			IExecutor &executor;
+		};
+
+		///Immutable list of listeners
+		struct Snapshot {
+			AutoArray<PSlot> slots;
+		};
+
+		///Counters of the readers, one cache line per shard
+		struct Shard {
+			atomic readers[2];
+			byte padding[64 - 2 * sizeof(atomic)];
+		};
+
+		///Registration of the reader (RAII)
+		class ReadSection {
+		public:
+			ReadSection(const RcuDistributor &owner);
+			~ReadSection();
+			const Snapshot *get() const {return snapshot;}
+		protected:
+			atomic *counter;
+			const Snapshot *snapshot;
+		};
+
+		Shard shards[shardCount];
+		atomic epoch;
+		Snapshot * volatile current;
+
+		///lock of writers
+		FastLock writeLock;
+		///snapshots retired after the grace period started (protected by writeLock)
+		AutoArray<Snapshot *> retired;
+		///snapshots waiting for the grace period (protected by writeLock)
+		AutoArray<Snapshot *> waiting;
+		///parity of the counters which must reach zero to release waiting snapshots
+		natural waitingParity;
+
+		Shard &selectShard() const;
+		///replaces current snapshot (writeLock must be held)
+		void replace(Snapshot *snap);
+		///releases snapshots without readers (writeLock must be held)
+		bool tryReclaim();
+
+	private:
+		RcuDistributor(const RcuDistributor &);
+		RcuDistributor &operator=(const RcuDistributor &);
+	};
+
+}
+
+#endif /* LIGHTSPEED_BASE_ACTIONS_RCUDISTRIBUTOR_H_ */
@@ -0,0 +1,223 @@
+/*
+ * rcuDistributor.tcc
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_ACTIONS_RCUDISTRIBUTOR_TCC_
+#define LIGHTSPEED_BASE_ACTIONS_RCUDISTRIBUTOR_TCC_
+
+#include "rcuDistributor.h"
+#include "../containers/autoArray.tcc"
+#include "../containers/queue.tcc"
+#include "../sync/synchronize.h"
+#include "../../mt/thread.h"
+#include "../../mt/threadId.h"
+
+namespace LightSpeed {
+
+template<typename Ifc>
+RcuDistributor<Ifc>::RcuDistributor():epoch(0),current(new Snapshot),waitingParity(0) {
+	for (natural i = 0; i < shardCount; i++) {
+		shards[i].readers[0] = 0;
+		shards[i].readers[1] = 0;
+	}
+}
+
+template<typename Ifc>
+RcuDistributor<Ifc>::~RcuDistributor() {
+	synchronize();
+	delete current;
+}
+
+template<typename Ifc>
+typename RcuDistributor<Ifc>::Shard &RcuDistributor<Ifc>::selectShard() const {
+	natural id = (natural)ThreadId::current().asAtomic();
+	//thread identifiers are often aligned addresses, mix higher bits
+	id = id ^ (id >> 7) ^ (id >> 13);
+	return const_cast<Shard &>(shards[id % shardCount]);
+}
+
+template<typename Ifc>
+RcuDistributor<Ifc>::ReadSection::ReadSection(const RcuDistributor &owner) {
+	Shard &shard = owner.selectShard();
+	while (true) {
+		atomicValue e = readAcquire(&owner.epoch);
+		counter = &shard.readers[e & 1];
+		lockInc(*counter);
+		//if epoch has been flipped meanwhile, writer could miss us, try again
+		if (readAcquire(&owner.epoch) == e) break;
+		lockDec(*counter);
+	}
+	snapshot = readAcquirePtr(&owner.current);
+}
+
+template<typename Ifc>
+RcuDistributor<Ifc>::ReadSection::~ReadSection() {
+	lockDec(*counter);
+}
+
+template<typename Ifc>
+void RcuDistributor<Ifc>::replace(Snapshot *snap) {
+	Snapshot *old = lockExchangePtr(&current, snap);
+	retired.add(old);
+	tryReclaim();
+}
+
+template<typename Ifc>
+bool RcuDistributor<Ifc>::tryReclaim() {
+	while (true) {
+		if (!waiting.empty()) {
+			for (natural i = 0; i < shardCount; i++)
+				if (readAcquire(&shards[i].readers[waitingParity]) != 0) return false;
+			//all readers which could see waiting snapshots have left
+			for (natural i = 0; i < waiting.length(); i++) delete waiting[i];
+			waiting.clear();
+		}
+		if (retired.empty()) return true;
+		//start new grace period. New readers will use other parity
+		//and will see the current snapshot
+		waiting.swap(retired);
+		waitingParity = (natural)(lockInc(epoch) - 1) & 1;
+	}
+}
+
+template<typename Ifc>
+void RcuDistributor<Ifc>::synchronize() {
+	Synchronized<FastLock> _(writeLock);
+	while (!tryReclaim()) {
+		Thread::sleep(1);
+	}
+}
+
+template<typename Ifc>
+void RcuDistributor<Ifc>::add(Ifc ptr) {
+	Synchronized<FastLock> _(writeLock);
+	Snapshot *snap = new Snapshot(*current);
+	snap->slots.add(new Slot(ptr));
+	replace(snap);
+}
+
+template<typename Ifc>
+void RcuDistributor<Ifc>::priorityAdd(Ifc ptr) {
+	Synchronized<FastLock> _(writeLock);
+	Snapshot *snap = new Snapshot;
+	snap->slots.reserve(current->slots.length() + 1);
+	snap->slots.add(new Slot(ptr));
+	snap->slots.append(current->slots);
+	replace(snap);
+}
+
+template<typename Ifc>
+bool RcuDistributor<Ifc>::remove(Ifc ptr) {
+	Synchronized<FastLock> _(writeLock);
+	const AutoArray<PSlot> &slots = current->slots;
+	for (natural i = 0; i < slots.length(); i++) {
+		if (slots[i]->ifc == ptr) {
+			Snapshot *snap = new Snapshot(*current);
+			snap->slots.erase(i);
+			replace(snap);
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename Ifc>
+void RcuDistributor<Ifc>::removeAll() {
+	Synchronized<FastLock> _(writeLock);
+	if (!current->slots.empty()) replace(new Snapshot);
+}
+
+template<typename Ifc>
+natural RcuDistributor<Ifc>::isAdded(Ifc ptr) const {
+	ReadSection rd(*this);
+	const AutoArray<PSlot> &slots = rd.get()->slots;
+	natural count = 0;
+	for (natural i = 0; i < slots.length(); i++)
+		if (slots[i]->ifc == ptr) count++;
+	return count;
+}
+
+template<typename Ifc>
+bool RcuDistributor<Ifc>::empty() const {
+	ReadSection rd(*this);
+	return rd.get()->slots.empty();
+}
+
+template<typename Ifc>
+natural RcuDistributor<Ifc>::size() const {
+	ReadSection rd(*this);
+	return rd.get()->slots.length();
+}
+
+template<typename Ifc>
+void RcuDistributor<Ifc>::send(const Msg &msg) const {
+	ReadSection rd(*this);
+	const AutoArray<PSlot> &slots = rd.get()->slots;
+	for (natural i = 0; i < slots.length(); i++)
+		msg(slots[i]->ifc);
+}
+
+template<typename Ifc>
+void RcuDistributor<Ifc>::send(Ifc sender, const Msg &msg) const {
+	ReadSection rd(*this);
+	const AutoArray<PSlot> &slots = rd.get()->slots;
+	for (natural i = 0; i < slots.length(); i++)
+		if (slots[i]->ifc != sender) msg(slots[i]->ifc);
+}
+
+template<typename Ifc>
+void RcuDistributor<Ifc>::post(const Msg &msg, IExecutor &executor) const {
+	ReadSection rd(*this);
+	const AutoArray<PSlot> &slots = rd.get()->slots;
+	for (natural i = 0; i < slots.length(); i++)
+		slots[i]->post(msg, executor);
+}
+
+template<typename Ifc>
+void RcuDistributor<Ifc>::Slot::post(const Msg &msg, IExecutor &executor) {
+	{
+		Synchronized<FastLock> _(lock);
+		pending.push(msg);
+		//delivery is already scheduled, it will pick the message
+		if (scheduled) return;
+		scheduled = true;
+	}
+	executor.execute(IExecutor::ExecAction::create(DrainAction(this, executor)));
+}
+
+template<typename Ifc>
+void RcuDistributor<Ifc>::Slot::drain(IExecutor &executor) {
+	while (true) {
+		Msg msg;
+		{
+			Synchronized<FastLock> _(lock);
+			if (pending.empty()) {
+				scheduled = false;
+				return;
+			}
+			msg = pending.top();
+			pending.pop();
+		}
+		try {
+			msg(ifc);
+		} catch (...) {
+			//continue with rest of the mailbox in another action
+			bool resched;
+			{
+				Synchronized<FastLock> _(lock);
+				resched = !pending.empty();
+				scheduled = resched;
+			}
+			if (resched)
+				executor.execute(IExecutor::ExecAction::create(DrainAction(this, executor)));
+			throw;
+		}
+	}
+}
+
+}
+
+#endif /* LIGHTSPEED_BASE_ACTIONS_RCUDISTRIBUTOR_TCC_ */
@@ -9,7 +9,7 @@
 #include "autoArray.tcc"
 #include "../iter/iteratorFilter.tcc"
 #include "../iter/merge.h"
-#include "sort.tcc"
+#include "fastSort.tcc"
 #include <memory>
 
 namespace LightSpeed {
@@ -93,8 +93,7 @@ void ArraySet<T,Cmp,Allocator>::makeOrdered()
 			}
 			orderedCount = this->length();
 		} else  {
-			HeapSort<ArraySet,Cmp> heap(*this,cmp);
-			heap.sort();
+			introSort(*this,cmp);
 			if (!duplicates) removeDuplicatesAfterOrder();
 		}
 		orderedCount = this->length();
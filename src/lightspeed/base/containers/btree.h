@@ -170,12 +170,8 @@ public:
   comparing two cells. The {\tt order} parameter must be at least 2;
   anything less than 2 is taken to be 2.
 
-  The NodeSpace {\tt space} may by created by the derived
-  class and
-  passed to this constructor; if it is NULL, a default in-memory node
-  space is created. If the derived class passes a non-null NodeSpace,
-  it is the responsibility of the derived class to destroy the
-  NodeSpace object.
+  Nodes are always allocated on the heap. If you need to store the tree
+  in pages of the file (NodeSpace), use PagedBTree.
   */
   BTree (short order = 40)
     : _order(order > 2?order:2),
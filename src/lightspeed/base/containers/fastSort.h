@@ -0,0 +1,130 @@
+/*
+ * fastSort.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_CONTAINERS_FASTSORT_H_
+#define LIGHTSPEED_BASE_CONTAINERS_FASTSORT_H_
+
+#include <functional>
+#include "arrayref.h"
+#include "constStr.h"
+
+namespace LightSpeed {
+
+
+	///Sorts items in range using introsort
+	/**
+	 * Introsort is quicksort with median of three pivot, which switches to the heap sort
+	 * when recursion is too deep (so worst case is still O(n log n)) and which finishes
+	 * short ranges by insertion sort. Items are accessed sequentially, so it is much
+	 * more cache friendly than HeapSort
+	 *
+	 * @param begin first item
+	 * @param end item after last
+	 * @param isLess compare operator
+	 *
+	 * @note sort is not stable
+	 */
+	template<typename T, typename Cmp>
+	void introSort(T *begin, T *end, const Cmp &isLess);
+
+	///Sorts items in range using introsort and operator <
+	template<typename T>
+	void introSort(T *begin, T *end) {introSort(begin,end,std::less<T>());}
+
+	///Sorts array (AutoArray, StringCore, etc) using introsort
+	template<typename T, typename Impl, typename Cmp>
+	void introSort(FlatArray<T,Impl> &arr, const Cmp &isLess) {
+		introSort(arr.data(), arr.data() + arr.length(), isLess);
+	}
+
+	///Sorts array (AutoArray, StringCore, etc) using introsort and operator <
+	template<typename T, typename Impl>
+	void introSort(FlatArray<T,Impl> &arr) {introSort(arr,std::less<T>());}
+
+	///Sorts referenced array using introsort
+	template<typename T, typename Cmp>
+	void introSort(ArrayRef<T> arr, const Cmp &isLess) {
+		introSort(arr.data(), arr.data() + arr.length(), isLess);
+	}
+
+	///Sorts referenced array using introsort and operator <
+	template<typename T>
+	void introSort(ArrayRef<T> arr) {introSort(arr,std::less<T>());}
+
+
+	///Sorts items by integral key using LSD radix sort
+	/**
+	 * Items are ordered by a key, which is returned by the key extractor. Key can be
+	 * any signed or unsigned integral type (up to 64 bits). Sort needs one pass to
+	 * calculate histograms and one pass per byte of the key. Passes where all keys
+	 * have the same byte are skipped, so small keys stored in large type are sorted
+	 * faster. Complexity is O(n) regardless of the order of items.
+	 *
+	 * @param begin first item
+	 * @param end item after last
+	 * @param tmp temporary buffer, which must have same size as the range
+	 * @param key key extractor. It is called with const reference to the item and
+	 * must return the key. It is called for every item in every pass, so it should be cheap.
+	 *
+	 * @note sort is stable. Items must be copy-assignable
+	 */
+	template<typename T, typename KeyFn>
+	void radixSort(T *begin, T *end, T *tmp, const KeyFn &key);
+
+	///Sorts items by integral key using LSD radix sort
+	/**
+	 * Function allocates temporary buffer. Items must be default constructible
+	 *
+	 * @copydetails radixSort(T *,T *,T *,const KeyFn &)
+	 */
+	template<typename T, typename KeyFn>
+	void radixSort(T *begin, T *end, const KeyFn &key);
+
+	///Sorts array by integral key using LSD radix sort
+	template<typename T, typename Impl, typename KeyFn>
+	void radixSort(FlatArray<T,Impl> &arr, const KeyFn &key) {
+		radixSort(arr.data(), arr.data() + arr.length(), key);
+	}
+
+	///Sorts referenced array by integral key using LSD radix sort
+	template<typename T, typename KeyFn>
+	void radixSort(ArrayRef<T> arr, const KeyFn &key) {
+		radixSort(arr.data(), arr.data() + arr.length(), key);
+	}
+
+	///Sorts items by string key using MSD radix sort
+	/**
+	 * Items are ordered by bytes of the string returned by the key extractor (as unsigned
+	 * characters, shorter string before longer). Each pass distributes items to 256 buckets by
+	 * one character and continues with each bucket separately. Small buckets are finished
+	 * by introsort.
+	 *
+	 * @param begin first item
+	 * @param end item after last
+	 * @param key key extractor. It is called with const reference to the item and must
+	 * return ConstStrA. It is called many times, so it should not build the string.
+	 *
+	 * @note sort is not stable. Items must be default constructible and copy-assignable
+	 */
+	template<typename T, typename KeyFn>
+	void radixSortStrings(T *begin, T *end, const KeyFn &key);
+
+	///Sorts array by string key using MSD radix sort
+	template<typename T, typename Impl, typename KeyFn>
+	void radixSortStrings(FlatArray<T,Impl> &arr, const KeyFn &key) {
+		radixSortStrings(arr.data(), arr.data() + arr.length(), key);
+	}
+
+	///Sorts referenced array by string key using MSD radix sort
+	template<typename T, typename KeyFn>
+	void radixSortStrings(ArrayRef<T> arr, const KeyFn &key) {
+		radixSortStrings(arr.data(), arr.data() + arr.length(), key);
+	}
+
+}
+
+#endif /* LIGHTSPEED_BASE_CONTAINERS_FASTSORT_H_ */
@@ -0,0 +1,261 @@
+/*
+ * fastSort.tcc
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_CONTAINERS_FASTSORT_TCC_
+#define LIGHTSPEED_BASE_CONTAINERS_FASTSORT_TCC_
+
+#include "fastSort.h"
+#include "autoArray.tcc"
+#include <limits>
+#include <string.h>
+#include <utility>
+
+namespace LightSpeed {
+
+namespace _intr {
+
+	///ranges shorter than this are sorted by insertion sort
+	static const natural introSortThreshold = 16;
+
+	template<typename T, typename Cmp>
+	void insertionSort(T *begin, T *end, const Cmp &isLess) {
+		if (begin == end) return;
+		for (T *i = begin + 1; i < end; ++i) {
+			T v(std::move(*i));
+			T *j = i;
+			while (j != begin && isLess(v, *(j - 1))) {
+				*j = std::move(*(j - 1));
+				--j;
+			}
+			*j = std::move(v);
+		}
+	}
+
+	template<typename T, typename Cmp>
+	void siftDown(T *base, natural root, natural size, const Cmp &isLess) {
+		T v(std::move(base[root]));
+		for(;;) {
+			natural child = root * 2 + 1;
+			if (child >= size) break;
+			if (child + 1 < size && isLess(base[child], base[child + 1])) child++;
+			if (!isLess(v, base[child])) break;
+			base[root] = std::move(base[child]);
+			root = child;
+		}
+		base[root] = std::move(v);
+	}
+
+	template<typename T, typename Cmp>
+	void heapSortRange(T *begin, T *end, const Cmp &isLess) {
+		natural n = end - begin;
+		for (natural i = n / 2; i > 0; i--) siftDown(begin, i - 1, n, isLess);
+		for (natural i = n - 1; i > 0; i--) {
+			std::swap(begin[0], begin[i]);
+			siftDown(begin, 0, i, isLess);
+		}
+	}
+
+	///Moves median of a, b, c to the result
+	template<typename T, typename Cmp>
+	void moveMedianToFirst(T *result, T *a, T *b, T *c, const Cmp &isLess) {
+		if (isLess(*a, *b)) {
+			if (isLess(*b, *c)) std::swap(*result, *b);
+			else if (isLess(*a, *c)) std::swap(*result, *c);
+			else std::swap(*result, *a);
+		} else if (isLess(*a, *c)) std::swap(*result, *a);
+		else if (isLess(*b, *c)) std::swap(*result, *c);
+		else std::swap(*result, *b);
+	}
+
+	///Partitions range around pivot. Range must contain item not less and not greater than pivot
+	template<typename T, typename Cmp>
+	T *partitionRange(T *first, T *last, const T &pivot, const Cmp &isLess) {
+		for(;;) {
+			while (isLess(*first, pivot)) ++first;
+			--last;
+			while (isLess(pivot, *last)) --last;
+			if (!(first < last)) return first;
+			std::swap(*first, *last);
+			++first;
+		}
+	}
+
+	template<typename T, typename Cmp>
+	void introSortLoop(T *first, T *last, natural depth, const Cmp &isLess) {
+		while (natural(last - first) > introSortThreshold) {
+			if (depth == 0) {
+				heapSortRange(first, last, isLess);
+				return;
+			}
+			depth--;
+			moveMedianToFirst(first, first + 1, first + (last - first) / 2, last - 1, isLess);
+			T *cut = partitionRange(first + 1, last, *first, isLess);
+			//recursion for right part, loop for left part
+			introSortLoop(cut, last, depth, isLess);
+			last = cut;
+		}
+	}
+
+	template<typename K>
+	K *keyTypeOf(const K &) {return 0;}
+
+	///Maps integral key to unsigned number with the same order
+	template<typename K>
+	inline Bin::natural64 radixKey(K k) {
+		Bin::natural64 u = (Bin::natural64)k;
+		if (std::numeric_limits<K>::is_signed) u ^= Bin::natural64(1) << (sizeof(K) * 8 - 1);
+		return u & (~Bin::natural64(0) >> (64 - sizeof(K) * 8));
+	}
+
+	template<typename KeyFn>
+	class RadixKeyLess {
+	public:
+		RadixKeyLess(const KeyFn &key):key(key) {}
+		template<typename T>
+		bool operator()(const T &a, const T &b) const {
+			return radixKey(key(a)) < radixKey(key(b));
+		}
+	protected:
+		const KeyFn &key;
+	};
+
+	template<typename T, typename KeyFn, typename K>
+	void radixSortLsd(T *data, T *tmp, natural count, const KeyFn &key, K *) {
+		static const natural bytes = sizeof(K);
+		natural hist[bytes][256];
+		memset(hist, 0, sizeof(hist));
+		for (natural i = 0; i < count; i++) {
+			Bin::natural64 k = radixKey<K>(key(data[i]));
+			for (natural b = 0; b < bytes; b++) hist[b][(k >> (b * 8)) & 0xFF]++;
+		}
+		Bin::natural64 first = radixKey<K>(key(data[0]));
+		T *src = data;
+		T *dst = tmp;
+		for (natural b = 0; b < bytes; b++) {
+			natural *h = hist[b];
+			//all keys have the same byte
+			if (h[(first >> (b * 8)) & 0xFF] == count) continue;
+			natural sum = 0;
+			for (natural d = 0; d < 256; d++) {
+				natural c = h[d];
+				h[d] = sum;
+				sum += c;
+			}
+			for (natural i = 0; i < count; i++) {
+				natural d = (natural)(radixKey<K>(key(src[i])) >> (b * 8)) & 0xFF;
+				dst[h[d]++] = src[i];
+			}
+			std::swap(src, dst);
+		}
+		if (src != data) {
+			for (natural i = 0; i < count; i++) data[i] = src[i];
+		}
+	}
+
+	///Returns character at the position + 1, or zero at the end of the string
+	inline natural radixChar(ConstStrA s, natural pos) {
+		return pos < s.length()?(natural)(byte)s[pos] + 1:0;
+	}
+
+	template<typename KeyFn>
+	class StringKeyLess {
+	public:
+		StringKeyLess(const KeyFn &key, natural depth):key(key),depth(depth) {}
+		template<typename T>
+		bool operator()(const T &a, const T &b) const {
+			ConstStrA ka = key(a);
+			ConstStrA kb = key(b);
+			natural la = ka.length(), lb = kb.length();
+			natural l = la < lb?la:lb;
+			if (depth < l) {
+				int r = memcmp(ka.data() + depth, kb.data() + depth, l - depth);
+				if (r) return r < 0;
+			}
+			return la < lb;
+		}
+	protected:
+		const KeyFn &key;
+		natural depth;
+	};
+
+	template<typename T, typename KeyFn>
+	void radixSortMsd(T *data, T *tmp, natural count, natural depth, const KeyFn &key) {
+		natural counts[257];
+		for(;;) {
+			if (count < 64) {
+				introSort(data, data + count, StringKeyLess<KeyFn>(key, depth));
+				return;
+			}
+			memset(counts, 0, sizeof(counts));
+			for (natural i = 0; i < count; i++) counts[radixChar(key(data[i]), depth)]++;
+			natural c0 = radixChar(key(data[0]), depth);
+			//common prefix - continue with next character
+			if (counts[c0] != count) break;
+			if (c0 == 0) return;
+			depth++;
+		}
+		natural offs[257];
+		natural sum = 0;
+		for (natural c = 0; c < 257; c++) {
+			offs[c] = sum;
+			sum += counts[c];
+		}
+		for (natural i = 0; i < count; i++) tmp[offs[radixChar(key(data[i]), depth)]++] = data[i];
+		for (natural i = 0; i < count; i++) data[i] = tmp[i];
+		//bucket 0 contains strings which ended, they are equal
+		natural start = counts[0];
+		for (natural c = 1; c < 257; c++) {
+			natural n = counts[c];
+			if (n > 1) radixSortMsd(data + start, tmp + start, n, depth + 1, key);
+			start += n;
+		}
+	}
+
+}
+
+template<typename T, typename Cmp>
+void introSort(T *begin, T *end, const Cmp &isLess) {
+	natural n = end - begin;
+	if (n < 2) return;
+	natural depth = 0;
+	for (natural k = n; k > 1; k >>= 1) depth += 2;
+	_intr::introSortLoop(begin, end, depth, isLess);
+	_intr::insertionSort(begin, end, isLess);
+}
+
+template<typename T, typename KeyFn>
+void radixSort(T *begin, T *end, T *tmp, const KeyFn &key) {
+	natural count = end - begin;
+	if (count < 2) return;
+	_intr::radixSortLsd(begin, tmp, count, key, _intr::keyTypeOf(key(*begin)));
+}
+
+template<typename T, typename KeyFn>
+void radixSort(T *begin, T *end, const KeyFn &key) {
+	natural count = end - begin;
+	if (count < 64) {
+		//insertion sort is stable
+		_intr::insertionSort(begin, end, _intr::RadixKeyLess<KeyFn>(key));
+		return;
+	}
+	AutoArray<T> tmp;
+	tmp.resize(count);
+	radixSort(begin, end, tmp.data(), key);
+}
+
+template<typename T, typename KeyFn>
+void radixSortStrings(T *begin, T *end, const KeyFn &key) {
+	natural count = end - begin;
+	if (count < 2) return;
+	AutoArray<T> tmp;
+	if (count >= 64) tmp.resize(count);
+	_intr::radixSortMsd(begin, tmp.data(), count, 0, key);
+}
+
+}
+
+#endif /* LIGHTSPEED_BASE_CONTAINERS_FASTSORT_TCC_ */
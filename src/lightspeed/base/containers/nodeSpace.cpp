@@ -0,0 +1,405 @@
+/*
+ * nodeSpace.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "nodeSpace.h"
+#include <string.h>
+#include <stddef.h>
+#include "autoArray.tcc"
+#include "../exceptions/errorMessageException.h"
+
+namespace LightSpeed {
+
+NodeSpaceBase::NodeSpaceBase(natural pageSize)
+	:pageSize(pageSize),pageCount(1),root(nullPage),committedRoot(nullPage),userData(0),committedUserData(0)
+{
+	//page 0 is reserved
+	state.add(stCommitted);
+}
+
+INodeSpace::PageId NodeSpaceBase::allocPage() {
+	PageId id;
+	bool fresh;
+	if (!freeList.empty()) {
+		id = freeList[freeList.length() - 1];
+		freeList.resize(freeList.length() - 1);
+		fresh = false;
+	} else {
+		id = pageCount++;
+		state.add(stFree);
+		fresh = true;
+	}
+	state(id) = stNew;
+	newPages.add(id);
+	onAlloc(id,fresh);
+	return id;
+}
+
+void NodeSpaceBase::freePage(PageId id) {
+	if (id == nullPage || id >= pageCount)
+		throw ErrorMessageException(THISLOCATION,"NodeSpace: invalid page id");
+	switch (state[id]) {
+	case stNew:
+		//page is not committed, so it can be reused immediately
+		state(id) = stFree;
+		onDiscard(id);
+		freeList.add(id);
+		break;
+	case stCommitted:
+		//page is part of the committed state, it can be reused after commit
+		pendingFree.add(id);
+		break;
+	default:
+		throw ErrorMessageException(THISLOCATION,"NodeSpace: page is already free");
+	}
+}
+
+bool NodeSpaceBase::isWritable(PageId id) const {
+	return id < pageCount && state[id] == stNew;
+}
+
+void NodeSpaceBase::setRoot(PageId root, Bin::natural64 userData) {
+	this->root = root;
+	this->userData = userData;
+}
+
+void NodeSpaceBase::commit() {
+	onCommit();
+	finishCommit();
+}
+
+void NodeSpaceBase::finishCommit() {
+	//page can be in the list multiple times, or it could be released
+	for (natural i = 0; i < newPages.length(); i++) {
+		PageId id = newPages[i];
+		if (state[id] == stNew) state(id) = stCommitted;
+	}
+	for (natural i = 0; i < pendingFree.length(); i++) {
+		PageId id = pendingFree[i];
+		state(id) = stFree;
+		freeList.add(id);
+	}
+	newPages.clear();
+	pendingFree.clear();
+	committedRoot = root;
+	committedUserData = userData;
+}
+
+void NodeSpaceBase::rollback() {
+	for (natural i = 0; i < newPages.length(); i++) {
+		PageId id = newPages[i];
+		if (state[id] == stNew) {
+			state(id) = stFree;
+			onDiscard(id);
+			freeList.add(id);
+		}
+	}
+	newPages.clear();
+	pendingFree.clear();
+	root = committedRoot;
+	userData = committedUserData;
+}
+
+MemNodeSpace::MemNodeSpace(natural pageSize):NodeSpaceBase(pageSize) {
+	pages.add(0);
+}
+
+MemNodeSpace::~MemNodeSpace() {
+	for (natural i = 0; i < pages.length(); i++) delete [] pages[i];
+}
+
+const byte *MemNodeSpace::pin(PageId id) {
+	if (id == nullPage || id >= pageCount)
+		throw ErrorMessageException(THISLOCATION,"NodeSpace: invalid page id");
+	return pages[id];
+}
+
+byte *MemNodeSpace::pinWrite(PageId id) {
+	if (!isWritable(id))
+		throw ErrorMessageException(THISLOCATION,"NodeSpace: page is not writable");
+	return pages[id];
+}
+
+void MemNodeSpace::onAlloc(PageId id, bool fresh) {
+	if (fresh) pages.add(new byte[pageSize]);
+	memset(pages[id],0,pageSize);
+}
+
+
+///Header of the file node space
+/** There are two headers in the first page of the file */
+struct FileNodeSpaceHeader {
+	char magic[8];
+	Bin::natural32 pageSize;
+	Bin::natural32 root;
+	Bin::natural64 generation;
+	Bin::natural64 pageCount;
+	Bin::natural64 userData;
+	Bin::natural32 freeListHead;
+	Bin::natural32 reserved;
+	Bin::natural64 checksum;
+
+	Bin::natural64 calcChecksum() const {
+		//FNV-1a
+		const byte *b = reinterpret_cast<const byte *>(this);
+		Bin::natural64 h = 14695981039346656037ULL;
+		for (natural i = 0; i < offsetof(FileNodeSpaceHeader,checksum); i++) {
+			h ^= b[i];
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+	bool isValid() const {
+		return memcmp(magic,fileMagic,8) == 0 && checksum == calcChecksum();
+	}
+	static const char fileMagic[8];
+	///offset of the second header
+	static const natural slotSize = 512;
+};
+
+const char FileNodeSpaceHeader::fileMagic[8] = {'L','S','N','O','D','E','S','1'};
+
+///Page of list of free pages
+struct FileNodeSpaceFreePage {
+	Bin::natural32 next;
+	Bin::natural32 count;
+	Bin::natural32 ids[1];
+
+	static natural capacity(natural pageSize) {
+		return (pageSize - offsetof(FileNodeSpaceFreePage,ids)) / sizeof(Bin::natural32);
+	}
+};
+
+static const natural minPageSize = 1024;
+static const natural minCachePages = 32;
+
+FileNodeSpace::FileNodeSpace(PRndFileHandle file, natural pageSize, natural cachePages)
+	:NodeSpaceBase(pageSize),file(file),hand(0),generation(0),readCount(0),writeCount(0)
+{
+	PageId head = openFile(pageSize);
+	init(this->pageSize, cachePages);
+	loadFreeList(head);
+}
+
+FileNodeSpace::FileNodeSpace(ConstStrW fname, natural pageSize, natural cachePages)
+	:NodeSpaceBase(pageSize),hand(0),generation(0),readCount(0),writeCount(0)
+{
+	file = IFileIOServices::getIOServices().openRndFile(fname,IFileIOServices::fileOpenReadWrite,OpenFlags::create);
+	PageId head = openFile(pageSize);
+	init(this->pageSize, cachePages);
+	loadFreeList(head);
+}
+
+void FileNodeSpace::init(natural pageSize, natural cachePages) {
+	if (cachePages < minCachePages) cachePages = minCachePages;
+	Frame empty;
+	empty.id = nullPage;
+	empty.pins = 0;
+	empty.next = naturalNull;
+	empty.dirty = false;
+	empty.referenced = false;
+	frames.resize(cachePages, empty);
+	buffers.resize(cachePages * pageSize);
+	natural nb = 1;
+	while (nb < cachePages * 2) nb <<= 1;
+	buckets.resize(nb, naturalNull);
+}
+
+INodeSpace::PageId FileNodeSpace::openFile(natural pageSize) {
+	if (file->size() == 0) {
+		if (pageSize < minPageSize) pageSize = minPageSize;
+		this->pageSize = pageSize;
+		return nullPage;
+	}
+	byte hdrs[FileNodeSpaceHeader::slotSize * 2];
+	memset(hdrs,0,sizeof(hdrs));
+	file->read(hdrs,sizeof(hdrs),0);
+	const FileNodeSpaceHeader *best = 0;
+	for (natural i = 0; i < 2; i++) {
+		const FileNodeSpaceHeader *h = reinterpret_cast<const FileNodeSpaceHeader *>(hdrs + i * FileNodeSpaceHeader::slotSize);
+		if (h->isValid() && (best == 0 || h->generation > best->generation)) best = h;
+	}
+	if (best == 0)
+		throw ErrorMessageException(THISLOCATION,"NodeSpace: file doesn't contain valid header");
+	this->pageSize = best->pageSize;
+	generation = best->generation;
+	pageCount = (PageId)best->pageCount;
+	root = committedRoot = best->root;
+	userData = committedUserData = best->userData;
+	state.resize(pageCount, stCommitted);
+	return best->freeListHead;
+}
+
+void FileNodeSpace::loadFreeList(PageId head) {
+	while (head != nullPage) {
+		PageRef ref(*this, head);
+		const FileNodeSpaceFreePage *p = reinterpret_cast<const FileNodeSpaceFreePage *>(ref.get());
+		for (natural i = 0; i < p->count; i++) {
+			PageId id = p->ids[i];
+			state(id) = stFree;
+			freeList.add(id);
+		}
+		freeListPages.add(head);
+		head = p->next;
+	}
+}
+
+INodeSpace::PageId FileNodeSpace::storeFreeList() {
+	//pages of the previous list are released with the committed state
+	pendingFree.append(freeListPages);
+	freeListPages.clear();
+	natural cap = FileNodeSpaceFreePage::capacity(pageSize);
+	natural total = freeList.length() + pendingFree.length();
+	natural cnt = (total + cap - 1) / cap;
+	for (natural i = 0; i < cnt; i++) freeListPages.add(allocPage());
+	//allocation could take pages from the free list, so some pages can stay empty
+	total = freeList.length() + pendingFree.length();
+	natural pos = 0;
+	PageId next = nullPage;
+	for (natural i = cnt; i > 0; i--) {
+		PageWriteRef ref(*this, freeListPages[i-1]);
+		FileNodeSpaceFreePage *p = reinterpret_cast<FileNodeSpaceFreePage *>(ref.get());
+		p->next = next;
+		p->count = 0;
+		while (p->count < cap && pos < total) {
+			natural fl = freeList.length();
+			p->ids[p->count++] = pos < fl?freeList[pos]:pendingFree[pos - fl];
+			pos++;
+		}
+		next = ref.getId();
+	}
+	return next;
+}
+
+natural FileNodeSpace::findFrame(PageId id) const {
+	natural idx = buckets[bucketOf(id)];
+	while (idx != naturalNull && frames[idx].id != id) idx = frames[idx].next;
+	return idx;
+}
+
+void FileNodeSpace::unlinkFrame(natural idx) {
+	natural b = bucketOf(frames[idx].id);
+	natural *p = &buckets(b);
+	while (*p != idx) p = &frames(*p).next;
+	*p = frames[idx].next;
+	frames(idx).next = naturalNull;
+	frames(idx).id = nullPage;
+}
+
+void FileNodeSpace::writeFrame(natural idx) {
+	Frame &f = frames(idx);
+	file->write(frameData(idx), pageSize, (IRndFileHandle::FileOffset)f.id * pageSize);
+	f.dirty = false;
+	writeCount++;
+}
+
+natural FileNodeSpace::evictFrame() {
+	natural n = frames.length();
+	//two rounds are enough to clear all referenced flags
+	for (natural i = 0; i < 2 * n + 1; i++) {
+		natural idx = hand;
+		hand = (hand + 1) % n;
+		Frame &f = frames(idx);
+		if (f.pins) continue;
+		if (f.id == nullPage) return idx;
+		if (f.referenced) {
+			f.referenced = false;
+			continue;
+		}
+		//dirty pages are new pages, they can be written anytime
+		if (f.dirty) writeFrame(idx);
+		unlinkFrame(idx);
+		return idx;
+	}
+	throw ErrorMessageException(THISLOCATION,"NodeSpace: all pages in the cache are pinned");
+}
+
+natural FileNodeSpace::getFrame(PageId id, bool load) {
+	natural idx = findFrame(id);
+	if (idx != naturalNull) return idx;
+	idx = evictFrame();
+	Frame &f = frames(idx);
+	f.id = id;
+	f.dirty = false;
+	f.referenced = true;
+	natural b = bucketOf(id);
+	f.next = buckets[b];
+	buckets(b) = idx;
+	if (load) {
+		byte *data = frameData(idx);
+		natural rd = file->read(data, pageSize, (IRndFileHandle::FileOffset)id * pageSize);
+		if (rd < pageSize) memset(data + rd, 0, pageSize - rd);
+		readCount++;
+	}
+	return idx;
+}
+
+const byte *FileNodeSpace::pin(PageId id) {
+	if (id == nullPage || id >= pageCount)
+		throw ErrorMessageException(THISLOCATION,"NodeSpace: invalid page id");
+	natural idx = getFrame(id, true);
+	Frame &f = frames(idx);
+	f.pins++;
+	f.referenced = true;
+	return frameData(idx);
+}
+
+byte *FileNodeSpace::pinWrite(PageId id) {
+	if (!isWritable(id))
+		throw ErrorMessageException(THISLOCATION,"NodeSpace: page is not writable");
+	natural idx = getFrame(id, true);
+	Frame &f = frames(idx);
+	f.pins++;
+	f.referenced = true;
+	f.dirty = true;
+	return frameData(idx);
+}
+
+void FileNodeSpace::unpin(PageId id) {
+	natural idx = findFrame(id);
+	if (idx != naturalNull && frames[idx].pins) frames(idx).pins--;
+}
+
+void FileNodeSpace::onAlloc(PageId id, bool ) {
+	natural idx = getFrame(id, false);
+	memset(frameData(idx), 0, pageSize);
+	frames(idx).dirty = true;
+}
+
+void FileNodeSpace::onDiscard(PageId id) {
+	natural idx = findFrame(id);
+	if (idx != naturalNull && frames[idx].pins == 0) {
+		frames(idx).dirty = false;
+		unlinkFrame(idx);
+	}
+}
+
+void FileNodeSpace::onCommit() {
+	PageId freeHead = storeFreeList();
+	//write all dirty pages. These are new pages, they are not part of the committed state
+	for (natural i = 0; i < frames.length(); i++)
+		if (frames[i].dirty) writeFrame(i);
+	if (file->size() < (IRndFileHandle::FileOffset)pageCount * pageSize)
+		file->setSize((IRndFileHandle::FileOffset)pageCount * pageSize);
+	file->flush();
+
+	//now write header to the slot not used by the previous commit
+	FileNodeSpaceHeader hdr;
+	memset(&hdr,0,sizeof(hdr));
+	memcpy(hdr.magic,FileNodeSpaceHeader::fileMagic,8);
+	hdr.pageSize = (Bin::natural32)pageSize;
+	hdr.root = root;
+	hdr.generation = generation + 1;
+	hdr.pageCount = pageCount;
+	hdr.userData = userData;
+	hdr.freeListHead = freeHead;
+	hdr.checksum = hdr.calcChecksum();
+	file->write(&hdr, sizeof(hdr), (hdr.generation & 1) * FileNodeSpaceHeader::slotSize);
+	file->flush();
+	generation = hdr.generation;
+}
+
+}
@@ -0,0 +1,297 @@
+/*
+ * nodeSpace.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_CONTAINERS_NODESPACE_H_
+#define LIGHTSPEED_BASE_CONTAINERS_NODESPACE_H_
+
+#include "autoArray.h"
+#include "../streams/fileio_ifc.h"
+
+namespace LightSpeed {
+
+	///Space of fixed-size pages used to store nodes of the PagedBTree
+	/**
+	 * Pages are identified by a number. Page 0 is reserved and it is used as null page.
+	 *
+	 * NodeSpace works with transactions. Pages allocated in the current transaction are
+	 * writable. Pages committed by the previous transaction are read-only. To modify
+	 * such page, the caller must allocate a new page, copy the content and release the
+	 * old page (copy-on-write). Released committed pages are not reused until commit,
+	 * so the committed state is never overwritten. If the process crashes before the
+	 * commit is finished, the previous committed state is still valid.
+	 *
+	 * Pages must be pinned before they are accessed. Pinned page stays in the memory
+	 * until it is unpinned. Use PageRef and PageWriteRef to handle pinning.
+	 */
+	class INodeSpace {
+	public:
+
+		typedef Bin::natural32 PageId;
+		///Null page
+		static const PageId nullPage = 0;
+
+		///Retrieves size of the page in bytes
+		virtual natural getPageSize() const = 0;
+		///Pins page for reading
+		/**
+		 * @param id page id
+		 * @return pointer to content of the page. Pointer is valid until page is unpinned
+		 */
+		virtual const byte *pin(PageId id) = 0;
+		///Pins page for writing
+		/**
+		 * @param id page id. Page must be writable (see isWritable())
+		 * @return pointer to content of the page. Pointer is valid until page is unpinned
+		 */
+		virtual byte *pinWrite(PageId id) = 0;
+		///Unpins page
+		virtual void unpin(PageId id) = 0;
+
+		///Allocates new page
+		/** @return id of new page. Page is writable and it is filled by zeroes */
+		virtual PageId allocPage() = 0;
+		///Releases page
+		/**
+		 * Page allocated in the current transaction is released immediately. Committed
+		 * page is released after commit
+		 */
+		virtual void freePage(PageId id) = 0;
+		///Returns true, if page has been allocated in the current transaction
+		virtual bool isWritable(PageId id) const = 0;
+
+		///Retrieves root page of the current state
+		virtual PageId getRoot() const = 0;
+		///Retrieves user data stored with the current state
+		virtual Bin::natural64 getUserData() const = 0;
+		///Sets root page and user data of the current state
+		/** Values are persisted during commit */
+		virtual void setRoot(PageId root, Bin::natural64 userData) = 0;
+
+		///Commits the current state
+		/** All pages allocated in the transaction becomes committed (read-only).
+		 * Pages released in the transaction are available for allocation. */
+		virtual void commit() = 0;
+		///Discards all changes made after last commit
+		virtual void rollback() = 0;
+
+		virtual ~INodeSpace() {}
+	};
+
+	///Pins page for reading (RAII)
+	class PageRef {
+	public:
+		PageRef(INodeSpace &space, INodeSpace::PageId id)
+			:space(space),id(id),data(space.pin(id)) {}
+		~PageRef() {space.unpin(id);}
+		const byte *get() const {return data;}
+		INodeSpace::PageId getId() const {return id;}
+	protected:
+		INodeSpace &space;
+		INodeSpace::PageId id;
+		const byte *data;
+	private:
+		PageRef(const PageRef &);
+		PageRef &operator=(const PageRef &);
+	};
+
+	///Pins page for writing (RAII)
+	class PageWriteRef {
+	public:
+		PageWriteRef(INodeSpace &space, INodeSpace::PageId id)
+			:space(space),id(id),data(space.pinWrite(id)) {}
+		~PageWriteRef() {space.unpin(id);}
+		byte *get() const {return data;}
+		INodeSpace::PageId getId() const {return id;}
+	protected:
+		INodeSpace &space;
+		INodeSpace::PageId id;
+		byte *data;
+	private:
+		PageWriteRef(const PageWriteRef &);
+		PageWriteRef &operator=(const PageWriteRef &);
+	};
+
+
+	///Implements transaction logic common to all node spaces
+	/** Class tracks state of each page and handles releasing pages */
+	class NodeSpaceBase: public INodeSpace {
+	public:
+
+		NodeSpaceBase(natural pageSize);
+
+		virtual natural getPageSize() const {return pageSize;}
+		virtual PageId allocPage();
+		virtual void freePage(PageId id);
+		virtual bool isWritable(PageId id) const;
+		virtual PageId getRoot() const {return root;}
+		virtual Bin::natural64 getUserData() const {return userData;}
+		virtual void setRoot(PageId root, Bin::natural64 userData);
+		virtual void commit();
+		virtual void rollback();
+
+		///Retrieves count of pages (including reserved page 0)
+		PageId getPageCount() const {return pageCount;}
+		///Retrieves count of free pages
+		natural getFreeCount() const {return freeList.length();}
+
+	protected:
+
+		enum PageState {
+			///page is free
+			stFree = 0,
+			///page is committed - read only
+			stCommitted = 1,
+			///page has been allocated in the current transaction
+			stNew = 2
+		};
+
+		natural pageSize;
+		///state of each page
+		AutoArray<byte> state;
+		///pages available for allocation
+		AutoArray<PageId> freeList;
+		///pages allocated in the current transaction
+		AutoArray<PageId> newPages;
+		///committed pages released in the current transaction
+		AutoArray<PageId> pendingFree;
+		///count of pages
+		PageId pageCount;
+
+		PageId root, committedRoot;
+		Bin::natural64 userData, committedUserData;
+
+		///Called when new page is allocated
+		/**
+		 * @param id id of the page
+		 * @param fresh true if page is above the previous end of the space
+		 */
+		virtual void onAlloc(PageId id, bool fresh) = 0;
+		///Called when new page is released before it has been committed
+		virtual void onDiscard(PageId id) = 0;
+		///Called to persist the state. Function is called by commit()
+		virtual void onCommit() = 0;
+
+		///Marks pages of the transaction committed and makes released pages free
+		void finishCommit();
+	};
+
+
+	///Node space stored in the memory
+	/** Nodes are not persistent. This is useful for temporary indexes */
+	class MemNodeSpace: public NodeSpaceBase {
+	public:
+		MemNodeSpace(natural pageSize = 4096);
+		~MemNodeSpace();
+
+		virtual const byte *pin(PageId id);
+		virtual byte *pinWrite(PageId id);
+		virtual void unpin(PageId ) {}
+
+	protected:
+		AutoArray<byte *> pages;
+
+		virtual void onAlloc(PageId id, bool fresh);
+		virtual void onDiscard(PageId ) {}
+		virtual void onCommit() {}
+	};
+
+
+	///Node space stored in the file
+	/**
+	 * Pages are stored in the file accessed through IRndFileHandle. Only limited count
+	 * of pages are kept in the memory (page cache). The cache uses CLOCK algorithm to
+	 * choose page for eviction. Because dirty pages are always new pages (copy-on-write),
+	 * they can be written to the file anytime without damaging the committed state.
+	 *
+	 * First page of the file contains two headers. Commit writes all dirty pages,
+	 * list of free pages, flushes the file and then writes the header into the slot
+	 * which is not used by the previous commit. Then the file is flushed again.
+	 * When the file is opened, the valid header with the highest generation is used.
+	 */
+	class FileNodeSpace: public NodeSpaceBase {
+	public:
+
+		///Opens the node space
+		/**
+		 * @param file opened file (read and write). If file is empty, it is initialized
+		 * @param pageSize size of the page. It is ignored for the existing file, the
+		 *  size of the page is read from the header. Minimal size is 1024 bytes.
+		 * @param cachePages count of pages kept in memory. Minimum is 32 pages
+		 *
+		 * @exception ErrorMessageException file is not valid
+		 */
+		FileNodeSpace(PRndFileHandle file, natural pageSize = 4096, natural cachePages = 1024);
+
+		///Opens the node space in the file
+		/**
+		 * @param fname name of the file. File is created if it doesn't exist
+		 * @param pageSize size of the page for the new file.
+		 * @param cachePages count of pages kept in memory
+		 */
+		FileNodeSpace(ConstStrW fname, natural pageSize = 4096, natural cachePages = 1024);
+
+		virtual const byte *pin(PageId id);
+		virtual byte *pinWrite(PageId id);
+		virtual void unpin(PageId id);
+
+		///Count of pages read from the file
+		natural getReadCount() const {return readCount;}
+		///Count of pages written to the file
+		natural getWriteCount() const {return writeCount;}
+
+	protected:
+
+		///One frame of the page cache
+		struct Frame {
+			///page in the frame (nullPage means that frame is empty)
+			PageId id;
+			///count of pins
+			natural pins;
+			///next frame in the hash chain
+			natural next;
+			///frame is dirty
+			bool dirty;
+			///frame has been recently used (CLOCK)
+			bool referenced;
+		};
+
+		PRndFileHandle file;
+		///frames
+		AutoArray<Frame> frames;
+		///content of the frames
+		AutoArray<byte> buffers;
+		///heads of the hash chains
+		AutoArray<natural> buckets;
+		///position of the clock hand
+		natural hand;
+		///generation of the last commit
+		Bin::natural64 generation;
+		///pages which store the list of free pages of the committed state
+		AutoArray<PageId> freeListPages;
+		natural readCount, writeCount;
+
+		void init(natural pageSize, natural cachePages);
+		PageId openFile(natural pageSize);
+		void loadFreeList(PageId head);
+		PageId storeFreeList();
+
+		natural findFrame(PageId id) const;
+		natural getFrame(PageId id, bool load);
+		natural evictFrame();
+		void unlinkFrame(natural idx);
+		void writeFrame(natural idx);
+		byte *frameData(natural idx) {return buffers.data() + idx * pageSize;}
+		natural bucketOf(PageId id) const {return (id * 2654435761U) & (buckets.length() - 1);}
+
+		virtual void onAlloc(PageId id, bool fresh);
+		virtual void onDiscard(PageId id);
+		virtual void onCommit();
+	};
+
+}
+
+#endif /* LIGHTSPEED_BASE_CONTAINERS_NODESPACE_H_ */
@@ -0,0 +1,187 @@
+/*
+ * pagedBTree.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_CONTAINERS_PAGEDBTREE_H_
+#define LIGHTSPEED_BASE_CONTAINERS_PAGEDBTREE_H_
+
+#include <functional>
+#include "nodeSpace.h"
+
+namespace LightSpeed {
+
+	///B+tree which stores nodes in pages of the INodeSpace
+	/**
+	 * Unlike BTree, nodes are not allocated on the heap. They are stored in fixed-size
+	 * pages of the node space. If FileNodeSpace is used, the tree is persistent and
+	 * it can be larger than available memory, because only the pages in the page cache
+	 * are kept in the memory.
+	 *
+	 * The tree uses copy-on-write. Every modification copies the committed pages
+	 * on the path from the root to the leaf. Modifications become persistent after commit(),
+	 * rollback() returns the tree to the state of the last commit.
+	 *
+	 * Keys and values are stored in separated arrays inside of the page. The
+	 * search in the page uses binary search to narrow the range and then it
+	 * counts keys below the searched key in a short branch-free loop, which
+	 * compiler can vectorize for the arithmetic keys.
+	 *
+	 * Nodes are not merged when they become underfilled. Empty nodes are removed.
+	 *
+	 * @tparam K type of key. Must be trivially copyable type (it is copied by memcpy)
+	 * @tparam V type of value. Must be trivially copyable type
+	 * @tparam Cmp comparison (less)
+	 *
+	 * @note object is not MT safe.
+	 */
+	template<typename K, typename V, typename Cmp = std::less<K> >
+	class PagedBTree {
+	public:
+
+		typedef INodeSpace::PageId PageId;
+
+		struct KeyValue {
+			K key;
+			V value;
+		};
+
+		///Iterates items in the ascending order
+		/** Iterator is invalidated by any modification of the tree */
+		class Iterator {
+		public:
+			///Returns true, if there are more items
+			bool hasItems() const {return depth > 0;}
+			///Returns next item
+			const KeyValue &getNext();
+			///Returns next item without advancing
+			const KeyValue &peek() const;
+
+		protected:
+			friend class PagedBTree;
+
+			Iterator(const PagedBTree &tree):tree(tree),depth(0) {}
+
+			struct Level {
+				PageId id;
+				natural pos;
+			};
+			static const natural maxDepth = 32;
+
+			const PagedBTree &tree;
+			Level path[maxDepth];
+			natural depth;
+			mutable KeyValue cur;
+
+			void descendLeft(PageId id);
+			void normalize();
+			void load() const;
+		};
+
+		///Constructs tree
+		/**
+		 * @param space node space. If space contains committed tree, the tree is opened
+		 * @param cmp instance of comparator
+		 *
+		 * @note one node space can hold only one tree, because the root is stored with the space.
+		 */
+		PagedBTree(INodeSpace &space, const Cmp &cmp = Cmp());
+
+		///Inserts or replaces the item
+		/**
+		 * @param key key
+		 * @param value value
+		 * @retval true item inserted
+		 * @retval false item replaced
+		 */
+		bool insert(const K &key, const V &value);
+		///Removes item
+		/**
+		 * @retval true removed
+		 * @retval false not found
+		 */
+		bool erase(const K &key);
+		///Finds item
+		/**
+		 * @param key key to find
+		 * @param value receives the value
+		 * @retval true found
+		 * @retval false not found
+		 */
+		bool find(const K &key, V &value) const;
+		///Returns true, if key exists
+		bool contains(const K &key) const;
+
+		///Count of items
+		natural length() const {return (natural)space.getUserData();}
+		///Returns true, if tree is empty
+		bool empty() const {return space.getRoot() == INodeSpace::nullPage;}
+		///Removes all items
+		void clear();
+
+		///Iterates all items
+		Iterator getFwIter() const;
+		///Iterates from the first item which is not less than the key
+		Iterator seek(const K &key) const;
+
+		///Commits changes
+		void commit() {space.commit();}
+		///Discards uncommitted changes
+		void rollback() {space.rollback();}
+
+		///Retrieves the node space
+		INodeSpace &getSpace() const {return space;}
+
+	protected:
+
+		///Header of the node
+		struct NodeHdr {
+			Bin::natural16 leaf;
+			Bin::natural16 count;
+			Bin::natural32 reserved;
+		};
+
+		INodeSpace &space;
+		Cmp less;
+		///count of items in the leaf
+		natural leafCap;
+		///offset of values in the leaf
+		natural leafValOffs;
+		///count of keys in the inner node
+		natural innerCap;
+		///offset of children in the inner node
+		natural innerChildOffs;
+
+		static NodeHdr &hdr(byte *p) {return *reinterpret_cast<NodeHdr *>(p);}
+		static const NodeHdr &hdr(const byte *p) {return *reinterpret_cast<const NodeHdr *>(p);}
+		static K *keys(byte *p) {return reinterpret_cast<K *>(p + sizeof(NodeHdr));}
+		static const K *keys(const byte *p) {return reinterpret_cast<const K *>(p + sizeof(NodeHdr));}
+		V *values(byte *p) const {return reinterpret_cast<V *>(p + leafValOffs);}
+		const V *values(const byte *p) const {return reinterpret_cast<const V *>(p + leafValOffs);}
+		PageId *children(byte *p) const {return reinterpret_cast<PageId *>(p + innerChildOffs);}
+		const PageId *children(const byte *p) const {return reinterpret_cast<const PageId *>(p + innerChildOffs);}
+
+		///Returns index of the first key which is not less than the key
+		natural lowerBound(const K *k, natural count, const K &key) const;
+		///Returns index of the first key which is greater than the key
+		natural upperBound(const K *k, natural count, const K &key) const;
+
+		///Returns writable version of the page (copies page if needed)
+		PageId makeWritable(PageId id);
+		PageId allocNode(bool leaf);
+
+		bool insertRec(PageId id, const K &key, const V &value, bool &added, K &sep, PageId &right);
+		void eraseRec(PageId id, const K &key);
+		void clearRec(PageId id);
+
+		template<typename T>
+		static void insertAt(T *arr, natural count, natural pos, const T &val);
+		template<typename T>
+		static void removeAt(T *arr, natural count, natural pos);
+	};
+
+}
+
+#endif /* LIGHTSPEED_BASE_CONTAINERS_PAGEDBTREE_H_ */
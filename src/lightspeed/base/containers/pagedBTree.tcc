@@ -0,0 +1,414 @@
+/*
+ * pagedBTree.tcc
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_CONTAINERS_PAGEDBTREE_TCC_
+#define LIGHTSPEED_BASE_CONTAINERS_PAGEDBTREE_TCC_
+
+#include "pagedBTree.h"
+#include <string.h>
+#include "../exceptions/errorMessageException.h"
+
+namespace LightSpeed {
+
+static inline natural pagedBTreeAlign(natural x) {return (x + 7) & ~(natural)7;}
+
+template<typename K, typename V, typename Cmp>
+PagedBTree<K,V,Cmp>::PagedBTree(INodeSpace &space, const Cmp &cmp)
+	:space(space),less(cmp)
+{
+	natural pageSize = space.getPageSize();
+	natural hs = sizeof(NodeHdr);
+	leafCap = (pageSize - hs) / (sizeof(K) + sizeof(V));
+	while (leafCap && pagedBTreeAlign(hs + leafCap * sizeof(K)) + leafCap * sizeof(V) > pageSize) leafCap--;
+	leafValOffs = pagedBTreeAlign(hs + leafCap * sizeof(K));
+	innerCap = (pageSize - hs - sizeof(PageId)) / (sizeof(K) + sizeof(PageId));
+	while (innerCap && pagedBTreeAlign(hs + innerCap * sizeof(K)) + (innerCap + 1) * sizeof(PageId) > pageSize) innerCap--;
+	innerChildOffs = pagedBTreeAlign(hs + innerCap * sizeof(K));
+	if (leafCap < 3 || innerCap < 3)
+		throw ErrorMessageException(THISLOCATION,"PagedBTree: page is too small for the key and the value");
+}
+
+template<typename K, typename V, typename Cmp>
+natural PagedBTree<K,V,Cmp>::lowerBound(const K *k, natural count, const K &key) const {
+	natural lo = 0, hi = count;
+	while (hi - lo > 16) {
+		natural mid = (lo + hi) / 2;
+		if (less(k[mid],key)) lo = mid + 1; else hi = mid;
+	}
+	//keys are sorted, so count of lesser keys is position. Loop without branches can be vectorized
+	natural c = lo;
+	for (natural i = lo; i < hi; i++) c += less(k[i],key)?1:0;
+	return c;
+}
+
+template<typename K, typename V, typename Cmp>
+natural PagedBTree<K,V,Cmp>::upperBound(const K *k, natural count, const K &key) const {
+	natural lo = 0, hi = count;
+	while (hi - lo > 16) {
+		natural mid = (lo + hi) / 2;
+		if (less(key,k[mid])) hi = mid; else lo = mid + 1;
+	}
+	natural c = lo;
+	for (natural i = lo; i < hi; i++) c += less(key,k[i])?0:1;
+	return c;
+}
+
+template<typename K, typename V, typename Cmp>
+template<typename T>
+void PagedBTree<K,V,Cmp>::insertAt(T *arr, natural count, natural pos, const T &val) {
+	memmove(arr + pos + 1, arr + pos, (count - pos) * sizeof(T));
+	memcpy(arr + pos, &val, sizeof(T));
+}
+
+template<typename K, typename V, typename Cmp>
+template<typename T>
+void PagedBTree<K,V,Cmp>::removeAt(T *arr, natural count, natural pos) {
+	memmove(arr + pos, arr + pos + 1, (count - pos - 1) * sizeof(T));
+}
+
+template<typename K, typename V, typename Cmp>
+typename PagedBTree<K,V,Cmp>::PageId PagedBTree<K,V,Cmp>::makeWritable(PageId id) {
+	if (space.isWritable(id)) return id;
+	PageId nid = space.allocPage();
+	{
+		PageRef src(space, id);
+		PageWriteRef trg(space, nid);
+		memcpy(trg.get(), src.get(), space.getPageSize());
+	}
+	space.freePage(id);
+	return nid;
+}
+
+template<typename K, typename V, typename Cmp>
+typename PagedBTree<K,V,Cmp>::PageId PagedBTree<K,V,Cmp>::allocNode(bool leaf) {
+	PageId id = space.allocPage();
+	PageWriteRef p(space, id);
+	hdr(p.get()).leaf = leaf?1:0;
+	hdr(p.get()).count = 0;
+	return id;
+}
+
+template<typename K, typename V, typename Cmp>
+bool PagedBTree<K,V,Cmp>::find(const K &key, V &value) const {
+	PageId id = space.getRoot();
+	while (id != INodeSpace::nullPage) {
+		PageRef pg(space, id);
+		const byte *p = pg.get();
+		const NodeHdr &h = hdr(p);
+		if (h.leaf) {
+			natural pos = lowerBound(keys(p), h.count, key);
+			if (pos < h.count && !less(key, keys(p)[pos])) {
+				memcpy(&value, values(p) + pos, sizeof(V));
+				return true;
+			}
+			return false;
+		}
+		id = children(p)[upperBound(keys(p), h.count, key)];
+	}
+	return false;
+}
+
+template<typename K, typename V, typename Cmp>
+bool PagedBTree<K,V,Cmp>::contains(const K &key) const {
+	V dummy;
+	return find(key, dummy);
+}
+
+template<typename K, typename V, typename Cmp>
+bool PagedBTree<K,V,Cmp>::insert(const K &key, const V &value) {
+	PageId root = space.getRoot();
+	if (root == INodeSpace::nullPage) root = allocNode(true);
+	else root = makeWritable(root);
+	bool added = false;
+	K sep;
+	PageId right;
+	if (insertRec(root, key, value, added, sep, right)) {
+		//root has been split, tree grows
+		PageId nr = allocNode(false);
+		PageWriteRef pg(space, nr);
+		byte *p = pg.get();
+		memcpy(keys(p), &sep, sizeof(K));
+		children(p)[0] = root;
+		children(p)[1] = right;
+		hdr(p).count = 1;
+		root = nr;
+	}
+	space.setRoot(root, space.getUserData() + (added?1:0));
+	return added;
+}
+
+template<typename K, typename V, typename Cmp>
+bool PagedBTree<K,V,Cmp>::insertRec(PageId id, const K &key, const V &value, bool &added, K &sep, PageId &right) {
+	PageWriteRef pg(space, id);
+	byte *p = pg.get();
+	NodeHdr &h = hdr(p);
+	K *k = keys(p);
+	if (h.leaf) {
+		V *v = values(p);
+		natural pos = lowerBound(k, h.count, key);
+		if (pos < h.count && !less(key, k[pos])) {
+			memcpy(v + pos, &value, sizeof(V));
+			added = false;
+			return false;
+		}
+		added = true;
+		if (h.count < leafCap) {
+			insertAt(k, h.count, pos, key);
+			insertAt(v, h.count, pos, value);
+			h.count++;
+			return false;
+		}
+		//split the leaf
+		right = allocNode(true);
+		PageWriteRef rpg(space, right);
+		byte *q = rpg.get();
+		natural half = h.count / 2;
+		natural moved = h.count - half;
+		memcpy(keys(q), k + half, moved * sizeof(K));
+		memcpy(values(q), v + half, moved * sizeof(V));
+		hdr(q).count = (Bin::natural16)moved;
+		h.count = (Bin::natural16)half;
+		if (pos <= half) {
+			insertAt(k, h.count, pos, key);
+			insertAt(v, h.count, pos, value);
+			h.count++;
+		} else {
+			insertAt(keys(q), hdr(q).count, pos - half, key);
+			insertAt(values(q), hdr(q).count, pos - half, value);
+			hdr(q).count++;
+		}
+		memcpy(&sep, keys(q), sizeof(K));
+		return true;
+	} else {
+		PageId *c = children(p);
+		natural idx = upperBound(k, h.count, key);
+		PageId child = makeWritable(c[idx]);
+		c[idx] = child;
+		K csep;
+		PageId cright;
+		if (!insertRec(child, key, value, added, csep, cright)) return false;
+		if (h.count < innerCap) {
+			insertAt(k, h.count, idx, csep);
+			insertAt(c, h.count + 1, idx + 1, cright);
+			h.count++;
+			return false;
+		}
+		//split the inner node, middle key goes up
+		right = allocNode(false);
+		PageWriteRef rpg(space, right);
+		byte *q = rpg.get();
+		natural n = h.count;
+		natural mid = n / 2;
+		memcpy(keys(q), k + mid + 1, (n - mid - 1) * sizeof(K));
+		memcpy(children(q), c + mid + 1, (n - mid) * sizeof(PageId));
+		hdr(q).count = (Bin::natural16)(n - mid - 1);
+		memcpy(&sep, k + mid, sizeof(K));
+		h.count = (Bin::natural16)mid;
+		if (idx <= mid) {
+			insertAt(k, h.count, idx, csep);
+			insertAt(c, h.count + 1, idx + 1, cright);
+			h.count++;
+		} else {
+			NodeHdr &rh = hdr(q);
+			insertAt(keys(q), rh.count, idx - mid - 1, csep);
+			insertAt(children(q), rh.count + 1, idx - mid, cright);
+			rh.count++;
+		}
+		return true;
+	}
+}
+
+template<typename K, typename V, typename Cmp>
+bool PagedBTree<K,V,Cmp>::erase(const K &key) {
+	//don't copy pages, when there is nothing to erase
+	if (!contains(key)) return false;
+	PageId root = makeWritable(space.getRoot());
+	eraseRec(root, key);
+	bool leaf;
+	natural count;
+	PageId first;
+	{
+		PageRef pg(space, root);
+		leaf = hdr(pg.get()).leaf != 0;
+		count = hdr(pg.get()).count;
+		first = leaf?INodeSpace::nullPage:children(pg.get())[0];
+	}
+	if (count == 0) {
+		//tree shrinks
+		space.freePage(root);
+		root = first;
+	}
+	space.setRoot(root, space.getUserData() - 1);
+	return true;
+}
+
+template<typename K, typename V, typename Cmp>
+void PagedBTree<K,V,Cmp>::eraseRec(PageId id, const K &key) {
+	PageWriteRef pg(space, id);
+	byte *p = pg.get();
+	NodeHdr &h = hdr(p);
+	K *k = keys(p);
+	if (h.leaf) {
+		natural pos = lowerBound(k, h.count, key);
+		removeAt(k, h.count, pos);
+		removeAt(values(p), h.count, pos);
+		h.count--;
+		return;
+	}
+	PageId *c = children(p);
+	natural idx = upperBound(k, h.count, key);
+	PageId child = makeWritable(c[idx]);
+	c[idx] = child;
+	eraseRec(child, key);
+	bool leaf;
+	natural count;
+	PageId first;
+	{
+		PageRef cpg(space, child);
+		leaf = hdr(cpg.get()).leaf != 0;
+		count = hdr(cpg.get()).count;
+		first = leaf?INodeSpace::nullPage:children(cpg.get())[0];
+	}
+	if (count) return;
+	space.freePage(child);
+	if (leaf) {
+		//remove empty leaf and its separator
+		removeAt(k, h.count, idx?idx-1:0);
+		removeAt(c, h.count + 1, idx);
+		h.count--;
+	} else {
+		//inner node with single child is replaced by the child
+		c[idx] = first;
+	}
+}
+
+template<typename K, typename V, typename Cmp>
+void PagedBTree<K,V,Cmp>::clear() {
+	PageId root = space.getRoot();
+	if (root != INodeSpace::nullPage) clearRec(root);
+	space.setRoot(INodeSpace::nullPage, 0);
+}
+
+template<typename K, typename V, typename Cmp>
+void PagedBTree<K,V,Cmp>::clearRec(PageId id) {
+	natural count;
+	bool leaf;
+	{
+		PageRef pg(space, id);
+		leaf = hdr(pg.get()).leaf != 0;
+		count = hdr(pg.get()).count;
+	}
+	if (!leaf) {
+		for (natural i = 0; i <= count; i++) {
+			PageId child;
+			{
+				PageRef pg(space, id);
+				child = children(pg.get())[i];
+			}
+			clearRec(child);
+		}
+	}
+	space.freePage(id);
+}
+
+template<typename K, typename V, typename Cmp>
+typename PagedBTree<K,V,Cmp>::Iterator PagedBTree<K,V,Cmp>::getFwIter() const {
+	Iterator iter(*this);
+	PageId root = space.getRoot();
+	if (root != INodeSpace::nullPage) {
+		iter.descendLeft(root);
+		iter.normalize();
+	}
+	return iter;
+}
+
+template<typename K, typename V, typename Cmp>
+typename PagedBTree<K,V,Cmp>::Iterator PagedBTree<K,V,Cmp>::seek(const K &key) const {
+	Iterator iter(*this);
+	PageId id = space.getRoot();
+	while (id != INodeSpace::nullPage) {
+		PageRef pg(space, id);
+		const byte *p = pg.get();
+		const NodeHdr &h = hdr(p);
+		typename Iterator::Level &l = iter.path[iter.depth++];
+		l.id = id;
+		if (h.leaf) {
+			l.pos = lowerBound(keys(p), h.count, key);
+			break;
+		}
+		l.pos = upperBound(keys(p), h.count, key);
+		id = children(p)[l.pos];
+	}
+	iter.normalize();
+	return iter;
+}
+
+template<typename K, typename V, typename Cmp>
+void PagedBTree<K,V,Cmp>::Iterator::descendLeft(PageId id) {
+	while (true) {
+		Level &l = path[depth++];
+		l.id = id;
+		l.pos = 0;
+		PageRef pg(tree.space, id);
+		if (hdr(pg.get()).leaf) break;
+		id = tree.children(pg.get())[0];
+	}
+}
+
+template<typename K, typename V, typename Cmp>
+void PagedBTree<K,V,Cmp>::Iterator::normalize() {
+	while (depth > 0) {
+		natural count;
+		{
+			PageRef pg(tree.space, path[depth - 1].id);
+			count = hdr(pg.get()).count;
+		}
+		//leaf has more items
+		if (path[depth - 1].pos < count) return;
+		//leaf exhausted, go up and find next subtree
+		depth--;
+		while (depth > 0) {
+			Level &l = path[depth - 1];
+			PageId next = INodeSpace::nullPage;
+			{
+				PageRef pg(tree.space, l.id);
+				if (l.pos < hdr(pg.get()).count) next = tree.children(pg.get())[++l.pos];
+			}
+			if (next != INodeSpace::nullPage) {
+				descendLeft(next);
+				break;
+			}
+			depth--;
+		}
+	}
+}
+
+template<typename K, typename V, typename Cmp>
+void PagedBTree<K,V,Cmp>::Iterator::load() const {
+	const Level &l = path[depth - 1];
+	PageRef pg(tree.space, l.id);
+	memcpy(&cur.key, keys(pg.get()) + l.pos, sizeof(K));
+	memcpy(&cur.value, tree.values(pg.get()) + l.pos, sizeof(V));
+}
+
+template<typename K, typename V, typename Cmp>
+const typename PagedBTree<K,V,Cmp>::KeyValue &PagedBTree<K,V,Cmp>::Iterator::peek() const {
+	load();
+	return cur;
+}
+
+template<typename K, typename V, typename Cmp>
+const typename PagedBTree<K,V,Cmp>::KeyValue &PagedBTree<K,V,Cmp>::Iterator::getNext() {
+	load();
+	path[depth - 1].pos++;
+	normalize();
+	return cur;
+}
+
+}
+
+#endif /* LIGHTSPEED_BASE_CONTAINERS_PAGEDBTREE_TCC_ */
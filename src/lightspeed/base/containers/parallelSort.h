@@ -0,0 +1,61 @@
+/*
+ * parallelSort.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_CONTAINERS_PARALLELSORT_H_
+#define LIGHTSPEED_BASE_CONTAINERS_PARALLELSORT_H_
+
+#include "fastSort.h"
+#include "../actions/executor.h"
+
+namespace LightSpeed {
+
+	///Sorts items in range using parallel merge sort
+	/**
+	 * Range is divided into parts, which are sorted by introSort() in the executor.
+	 * Sorted parts are merged by pairs, every merge is also divided into
+	 * independent pieces (using binary search), so all threads are used even in
+	 * the last pass. Calling thread also performs part of the work.
+	 *
+	 * Function needs temporary buffer of the same size as the range. Items must
+	 * be default constructible and copy-assignable.
+	 *
+	 * @param begin first item
+	 * @param end item after last
+	 * @param isLess compare operator
+	 * @param executor executor which runs tasks (for example ParallelExecutor). Function
+	 * blocks until all tasks finish. Don't call it from a thread of the same executor when
+	 * it is not able to start other threads.
+	 * @param parts count of parts. Default value 0 means count of CPUs. Range is
+	 * never divided to parts smaller than minPartSize
+	 * @param minPartSize minimum count of items in one part
+	 *
+	 * @exception any exception thrown by the compare operator is rethrown in
+	 * calling thread after all tasks are finished
+	 *
+	 * @note sort is not stable
+	 */
+	template<typename T, typename Cmp>
+	void parallelSort(T *begin, T *end, const Cmp &isLess, IExecutor &executor,
+			natural parts = 0, natural minPartSize = 65536);
+
+	///Sorts array (AutoArray, StringCore, etc) using parallel merge sort
+	template<typename T, typename Impl, typename Cmp>
+	void parallelSort(FlatArray<T,Impl> &arr, const Cmp &isLess, IExecutor &executor,
+			natural parts = 0, natural minPartSize = 65536) {
+		parallelSort(arr.data(), arr.data() + arr.length(), isLess, executor, parts, minPartSize);
+	}
+
+	///Sorts referenced array using parallel merge sort
+	template<typename T, typename Cmp>
+	void parallelSort(ArrayRef<T> arr, const Cmp &isLess, IExecutor &executor,
+			natural parts = 0, natural minPartSize = 65536) {
+		parallelSort(arr.data(), arr.data() + arr.length(), isLess, executor, parts, minPartSize);
+	}
+
+}
+
+#endif /* LIGHTSPEED_BASE_CONTAINERS_PARALLELSORT_H_ */
@@ -0,0 +1,239 @@
+/*
+ * parallelSort.tcc
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_CONTAINERS_PARALLELSORT_TCC_
+#define LIGHTSPEED_BASE_CONTAINERS_PARALLELSORT_TCC_
+
+#include "parallelSort.h"
+#include "fastSort.tcc"
+#include "../actions/parallelExecutor.h"
+#include "../sync/synchronize.h"
+#include "../../mt/gate.h"
+#include "../../mt/atomic.h"
+#include <exception>
+
+namespace LightSpeed {
+
+namespace _intr {
+
+	///Waits for tasks of the parallel sort and collects the first exception
+	class SortTaskGroup {
+	public:
+		SortTaskGroup(natural count):pending(count),released(0),gate(Gate::stateClose) {}
+
+		///Marks one task finished
+		void done() {
+			if (lockDec(pending) == 0) {
+				gate.open();
+				//group can be destroyed after this point
+				writeRelease(&released, 1);
+			}
+		}
+		///Records exception of the current task
+		void fail() {
+			Synchronized<FastLock> _(lock);
+			if (!error) error = std::current_exception();
+		}
+		///Runs task in the current thread
+		template<typename Fn>
+		void run(const Fn &fn) {
+			try {
+				fn.exec();
+			} catch (...) {
+				fail();
+			}
+			done();
+		}
+		///Waits for all tasks, rethrows exception of a failed task
+		void wait() {
+			gate.wait(Timeout());
+			while (readAcquire(&released) == 0) {}
+			if (error) std::rethrow_exception(error);
+		}
+
+	protected:
+		atomic pending;
+		atomic released;
+		Gate gate;
+		FastLock lock;
+		std::exception_ptr error;
+	};
+
+	///Executes task of the group in the executor
+	template<typename Task>
+	class SortTaskAction {
+	public:
+		SortTaskAction(const Task &task, SortTaskGroup &group):task(task),group(group) {}
+		void operator()() const {group.run(task);}
+	protected:
+		Task task;
+		SortTaskGroup &group;
+	};
+
+	template<typename T, typename Cmp>
+	class SortPartTask {
+	public:
+		SortPartTask(T *begin, T *end, const Cmp &isLess):begin(begin),end(end),isLess(isLess) {}
+		void exec() const {introSort(begin, end, isLess);}
+	protected:
+		T *begin;
+		T *end;
+		const Cmp &isLess;
+	};
+
+	///Merges two sorted ranges into the output, items of the first range go first when equal
+	template<typename T, typename Cmp>
+	class MergeTask {
+	public:
+		MergeTask(const T *a, const T *aEnd, const T *b, const T *bEnd, T *out, const Cmp &isLess)
+			:a(a),aEnd(aEnd),b(b),bEnd(bEnd),out(out),isLess(isLess) {}
+		void exec() const {
+			const T *x = a, *y = b;
+			T *o = out;
+			while (x != aEnd && y != bEnd) {
+				if (isLess(*y, *x)) *o++ = *y++;
+				else *o++ = *x++;
+			}
+			while (x != aEnd) *o++ = *x++;
+			while (y != bEnd) *o++ = *y++;
+		}
+	protected:
+		const T *a, *aEnd, *b, *bEnd;
+		T *out;
+		const Cmp &isLess;
+	};
+
+	///Runs tasks, last task is executed by the calling thread
+	template<typename Task>
+	void runSortTasks(const AutoArray<Task> &tasks, IExecutor &executor) {
+		natural cnt = tasks.length();
+		SortTaskGroup group(cnt);
+		natural i = 0;
+		try {
+			for (; i + 1 < cnt; i++)
+				executor.execute(IExecutor::ExecAction::create(SortTaskAction<Task>(tasks[i], group)));
+		} catch (...) {
+			//tasks which were not started
+			for (; i + 1 < cnt; i++) group.done();
+			group.run(tasks[cnt - 1]);
+			group.wait();
+			throw;
+		}
+		group.run(tasks[cnt - 1]);
+		group.wait();
+	}
+
+	///count of items in sorted range which are less than the value
+	template<typename T, typename Cmp>
+	natural lowerBound(const T *arr, natural len, const T &val, const Cmp &isLess) {
+		natural l = 0, h = len;
+		while (l < h) {
+			natural m = (l + h) / 2;
+			if (isLess(arr[m], val)) l = m + 1; else h = m;
+		}
+		return l;
+	}
+
+	///count of items in sorted range which are less or equal to the value
+	template<typename T, typename Cmp>
+	natural upperBound(const T *arr, natural len, const T &val, const Cmp &isLess) {
+		natural l = 0, h = len;
+		while (l < h) {
+			natural m = (l + h) / 2;
+			if (isLess(val, arr[m])) h = m; else l = m + 1;
+		}
+		return l;
+	}
+
+	///Divides merge of two ranges to independent pieces
+	template<typename T, typename Cmp>
+	void splitMerge(const T *a, natural aLen, const T *b, natural bLen, T *out, natural pieces,
+			const Cmp &isLess, AutoArray<MergeTask<T,Cmp> > &tasks) {
+		natural ai = 0, bi = 0;
+		for (natural j = 1; j <= pieces; j++) {
+			natural an, bn;
+			if (j == pieces) {
+				an = aLen;
+				bn = bLen;
+			} else if (aLen >= bLen) {
+				an = aLen * j / pieces;
+				bn = an < aLen?lowerBound(b, bLen, a[an], isLess):bLen;
+			} else {
+				bn = bLen * j / pieces;
+				an = bn < bLen?upperBound(a, aLen, b[bn], isLess):aLen;
+			}
+			if (an < ai) an = ai;
+			if (bn < bi) bn = bi;
+			if (an > ai || bn > bi)
+				tasks.add(MergeTask<T,Cmp>(a + ai, a + an, b + bi, b + bn, out + ai + bi, isLess));
+			ai = an;
+			bi = bn;
+		}
+	}
+
+}
+
+template<typename T, typename Cmp>
+void parallelSort(T *begin, T *end, const Cmp &isLess, IExecutor &executor,
+		natural parts, natural minPartSize) {
+	natural count = end - begin;
+	if (parts == 0) parts = ParallelExecutor::getCPUCount();
+	if (minPartSize == 0) minPartSize = 1;
+	if (parts > count / minPartSize) parts = count / minPartSize;
+	if (parts < 2) {
+		introSort(begin, end, isLess);
+		return;
+	}
+
+	AutoArray<natural> bounds;
+	for (natural i = 0; i <= parts; i++) bounds.add(count * i / parts);
+
+	{
+		AutoArray<_intr::SortPartTask<T,Cmp> > tasks;
+		for (natural i = 0; i < parts; i++)
+			tasks.add(_intr::SortPartTask<T,Cmp>(begin + bounds[i], begin + bounds[i + 1], isLess));
+		_intr::runSortTasks(tasks, executor);
+	}
+
+	AutoArray<T> tmp;
+	tmp.resize(count);
+	T *src = begin;
+	T *dst = tmp.data();
+	AutoArray<_intr::MergeTask<T,Cmp> > tasks;
+	while (bounds.length() > 2) {
+		natural runs = bounds.length() - 1;
+		natural pairs = runs / 2;
+		//divide merges, so every thread has some work
+		natural pieces = (parts + pairs - 1) / pairs;
+		tasks.clear();
+		AutoArray<natural> newBounds;
+		for (natural p = 0; p < pairs; p++) {
+			natural a = bounds[2 * p], b = bounds[2 * p + 1], e = bounds[2 * p + 2];
+			_intr::splitMerge<T,Cmp>(src + a, b - a, src + b, e - b, dst + a, pieces, isLess, tasks);
+			newBounds.add(a);
+		}
+		if (runs & 1) {
+			natural a = bounds[runs - 1];
+			_intr::splitMerge<T,Cmp>(src + a, count - a, src + count, 0, dst + a, pieces, isLess, tasks);
+			newBounds.add(a);
+		}
+		newBounds.add(count);
+		_intr::runSortTasks(tasks, executor);
+		bounds = newBounds;
+		std::swap(src, dst);
+	}
+	if (src != begin) {
+		//copy result back in parallel
+		tasks.clear();
+		_intr::splitMerge<T,Cmp>(src, count, src + count, 0, begin, parts, isLess, tasks);
+		_intr::runSortTasks(tasks, executor);
+	}
+}
+
+}
+
+#endif /* LIGHTSPEED_BASE_CONTAINERS_PARALLELSORT_TCC_ */
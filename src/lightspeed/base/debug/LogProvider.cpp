@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include "../../mt/atomic.h"
+#include "../../mt/timeout.h"
 #ifdef LIGHTSPEED_PLATFORM_WINDOWS
 #include <time.h>
 inline int gmtime_r(const time_t *tmt, struct tm *tminfo) {
@@ -80,17 +81,31 @@ AbstractLogProvider::AbstractLogProvider() {
 
 
 
+//broken-down time of the current second and the cached clock (ms) when the second ends
+#ifdef LIGHTSPEED_PLATFORM_WINDOWS
+static _declspec(thread) struct tm logTmCache;
+static _declspec(thread) natural logTmValidUntil = 0;
+#else
+static __thread struct tm logTmCache;
+static __thread natural logTmValidUntil = 0;
+#endif
+
 AbstractLogProvider::LogTimestamp::LogTimestamp() {
-	time_t tmt;
-	time(&tmt);
-	struct tm tminfo;
-	gmtime_r(&tmt,&tminfo);
-	year = tminfo.tm_year+1900;
-	month = tminfo.tm_mon+1;
-	day = tminfo.tm_mday;
-	hour = tminfo.tm_hour;
-	min = tminfo.tm_min;
-	sec = tminfo.tm_sec;
+	//calendar time is computed once per second, SysTime::cached() tells when the second ends
+	natural curMs = SysTime::cached().msecs();
+	if (logTmValidUntil == 0 || curMs >= logTmValidUntil) {
+		natural frac = SysTime::wallClock().msec();
+		time_t tmt;
+		time(&tmt);
+		gmtime_r(&tmt,&logTmCache);
+		logTmValidUntil = curMs + (1000 - frac);
+	}
+	year = logTmCache.tm_year+1900;
+	month = logTmCache.tm_mon+1;
+	day = logTmCache.tm_mday;
+	hour = logTmCache.tm_hour;
+	min = logTmCache.tm_min;
+	sec = logTmCache.tm_sec;
 }
 
 void AbstractLogProvider::checkLogRotate() {
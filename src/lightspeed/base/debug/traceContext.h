@@ -0,0 +1,47 @@
+/*
+ * traceContext.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_DEBUG_TRACECONTEXT_H_
+#define LIGHTSPEED_DEBUG_TRACECONTEXT_H_
+
+#include "../types.h"
+
+namespace LightSpeed {
+
+	///Identifies the span which is currently active in the thread
+	/**
+	 * Context is kept in thread local variable. To continue the trace in an another thread,
+	 * capture the context by current() and activate it in the other thread by TraceContextScope.
+	 * MsgQueue, ParallelExecutor, QueueExecutor and Future::then() do this automatically.
+	 */
+	struct TraceContext {
+		///identifier of the trace (id of the root span), zero if there is no trace
+		natural traceId;
+		///identifier of the active span
+		natural spanId;
+
+		TraceContext():traceId(0),spanId(0) {}
+		TraceContext(natural traceId, natural spanId):traceId(traceId),spanId(spanId) {}
+
+		bool isValid() const {return traceId != 0;}
+
+		///Retrieves context of the current thread
+		static TraceContext current();
+	};
+
+	///Activates the context for the lifetime of the object, previous context is restored in destructor
+	class TraceContextScope {
+	public:
+		TraceContextScope(const TraceContext &ctx);
+		~TraceContextScope();
+	protected:
+		TraceContext prev;
+	};
+
+}
+
+#endif /* LIGHTSPEED_DEBUG_TRACECONTEXT_H_ */
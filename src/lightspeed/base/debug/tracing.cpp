@@ -0,0 +1,230 @@
+/*
+ * tracing.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "tracing.h"
+#include "../containers/autoArray.tcc"
+#include "../text/textstream.tcc"
+#include "../text/textFormat.tcc"
+#include "../sync/synchronize.h"
+#include "../framework/perfCounters.h"
+#include "../../mt/fastlock.h"
+#include "../../mt/threadHook.h"
+
+namespace LightSpeed {
+
+///Ring buffer of one thread
+struct TraceBuffer {
+	///events
+	AutoArray<TraceEvent> events;
+	///pointer to the first event
+	TraceEvent *data;
+	///mask to calculate index from the position
+	natural mask;
+	///count of written events
+	atomic writePos;
+	///events before this position have been cleared
+	atomic clearPos;
+	///buffer is not used by any thread
+	bool free;
+	///next buffer in the list of all buffers
+	TraceBuffer *next;
+};
+
+atomic Tracer::enabledFlag = 0;
+
+static FastLock traceLock;
+static TraceBuffer *traceBuffers = 0;
+static natural traceBufferSize = 8192;
+static atomic traceThreadCounter = 0;
+
+#ifdef LIGHTSPEED_PLATFORM_WINDOWS
+static _declspec(thread) TraceBuffer *traceCurBuffer = 0;
+static _declspec(thread) natural traceThreadId = 0;
+static _declspec(thread) natural traceSpanCounter = 0;
+static _declspec(thread) natural traceCurTrace = 0;
+static _declspec(thread) natural traceCurSpan = 0;
+#else
+static __thread TraceBuffer *traceCurBuffer = 0;
+static __thread natural traceThreadId = 0;
+static __thread natural traceSpanCounter = 0;
+static __thread natural traceCurTrace = 0;
+static __thread natural traceCurSpan = 0;
+#endif
+
+///Returns buffer of the exited thread to the pool
+class TraceThreadHook: public AbstractThreadHook {
+public:
+	virtual void onThreadExit(Thread &) {release();}
+	virtual void onThreadException(Thread &) throw() {release();}
+
+	static void release() {
+		TraceBuffer *b = traceCurBuffer;
+		if (b == 0) return;
+		traceCurBuffer = 0;
+		Synchronized<FastLock> _(traceLock);
+		b->free = true;
+	}
+};
+
+static TraceThreadHook traceThreadHook;
+
+static TraceBuffer *acquireTraceBuffer() {
+	Synchronized<FastLock> _(traceLock);
+	TraceBuffer *b = traceBuffers;
+	while (b && !b->free) b = b->next;
+	if (b == 0) {
+		b = new TraceBuffer;
+		b->events.resize(traceBufferSize);
+		b->data = b->events.data();
+		b->mask = traceBufferSize - 1;
+		b->writePos = 0;
+		b->clearPos = 0;
+		b->next = traceBuffers;
+		traceBuffers = b;
+	}
+	b->free = false;
+	traceCurBuffer = b;
+	return b;
+}
+
+TraceContext TraceContext::current() {
+	return TraceContext(traceCurTrace, traceCurSpan);
+}
+
+TraceContextScope::TraceContextScope(const TraceContext &ctx)
+	:prev(traceCurTrace, traceCurSpan) {
+	traceCurTrace = ctx.traceId;
+	traceCurSpan = ctx.spanId;
+}
+
+TraceContextScope::~TraceContextScope() {
+	traceCurTrace = prev.traceId;
+	traceCurSpan = prev.spanId;
+}
+
+void Tracer::enable(bool enable) {
+	//buffers of the exited threads are returned through the hook
+	if (enable) traceThreadHook.install();
+	writeRelease(&enabledFlag, enable?1:0);
+}
+
+void Tracer::setBufferSize(natural events) {
+	natural r = 2;
+	while (r < events) r <<= 1;
+	Synchronized<FastLock> _(traceLock);
+	traceBufferSize = r;
+}
+
+natural Tracer::newSpanId() {
+	natural tid = traceThreadId;
+	if (tid == 0) {
+		tid = (natural)lockInc(traceThreadCounter);
+		traceThreadId = tid;
+	}
+	natural cnt = ++traceSpanCounter;
+	//64-bit ids combine thread and counter, so no shared counter is touched
+	if (sizeof(natural) >= 8) return (tid << 40) | (cnt & (((natural)1 << 40) - 1));
+	else return (tid << 20) | (cnt & 0xFFFFF);
+}
+
+void Tracer::record(const TraceEvent &ev) {
+	if (!isEnabled()) return;
+	TraceBuffer *b = traceCurBuffer;
+	if (b == 0) b = acquireTraceBuffer();
+	atomicValue pos = b->writePos;
+	b->data[pos & b->mask] = ev;
+	writeRelease(&b->writePos, pos + 1);
+}
+
+void Tracer::collect(AutoArray<TraceEvent> &out) {
+	Synchronized<FastLock> _(traceLock);
+	for (TraceBuffer *b = traceBuffers; b; b = b->next) {
+		natural size = b->mask + 1;
+		natural wp = (natural)readAcquire(&b->writePos);
+		natural from = wp > size?wp - size:0;
+		natural cp = (natural)readAcquire(&b->clearPos);
+		if (from < cp) from = cp;
+		natural start = out.length();
+		for (natural i = from; i < wp; i++) out.add(b->data[i & b->mask]);
+		//writer could overwrite oldest events meanwhile, drop them
+		natural wp2 = (natural)readAcquire(&b->writePos);
+		natural valid = wp2 >= size?wp2 - size + 1:0;
+		if (valid > from) out.erase(start, valid - from < wp - from?valid - from:wp - from);
+	}
+}
+
+void Tracer::clear() {
+	Synchronized<FastLock> _(traceLock);
+	for (TraceBuffer *b = traceBuffers; b; b = b->next) {
+		writeRelease(&b->clearPos, readAcquire(&b->writePos));
+	}
+}
+
+static void writeJsonString(PrintTextA &print, const char *text) {
+	AutoArray<char, SmallAlloc<256> > buff;
+	buff.add('"');
+	for (const char *c = text?text:""; *c; c++) {
+		switch (*c) {
+		case '"': buff.append(ConstStrA("\\\""));break;
+		case '\\': buff.append(ConstStrA("\\\\"));break;
+		default: if ((unsigned char)*c < 32) buff.add(' '); else buff.add(*c);break;
+		}
+	}
+	buff.add('"');
+	print("%1") << ConstStrA(buff);
+}
+
+void Tracer::exportChromeJson(PrintTextA &print) {
+	AutoArray<TraceEvent> events;
+	collect(events);
+	//timestamps are relative to the oldest event
+	natural base = naturalNull;
+	for (natural i = 0; i < events.length(); i++) {
+		if (events[i].begin < base) base = events[i].begin;
+	}
+	print("{\"traceEvents\":[");
+	for (natural i = 0; i < events.length(); i++) {
+		const TraceEvent &ev = events[i];
+		natural ts = ev.begin - base;
+		natural dur = ev.end - ev.begin;
+		print(i?",\n{\"name\":":"\n{\"name\":");
+		writeJsonString(print, ev.name);
+		print(",\"cat\":\"lightspeed\",\"ph\":\"X\",\"pid\":1,\"tid\":%1,\"ts\":%2.%{03}3,\"dur\":%4.%{03}5")
+			<< ev.threadId << ts / 1000 << ts % 1000 << dur / 1000 << dur % 1000;
+		print(",\"args\":{\"trace\":%1,\"span\":%2,\"parent\":%3,\"line\":%4,\"function\":")
+			<< ev.traceId << ev.spanId << ev.parentId << ev.line;
+		writeJsonString(print, ev.function);
+		print(",\"file\":");
+		writeJsonString(print, ev.file);
+		print("}}");
+	}
+	print("\n],\"displayTimeUnit\":\"ns\"}\n");
+}
+
+void TraceSpan::open(const char *name, const ProgramLocation &loc) {
+	prev = TraceContext(traceCurTrace, traceCurSpan);
+	ev.name = name;
+	ev.file = loc.file;
+	ev.function = loc.function;
+	ev.line = loc.line;
+	ev.spanId = Tracer::newSpanId();
+	ev.threadId = traceThreadId;
+	ev.parentId = prev.spanId;
+	ev.traceId = prev.traceId?prev.traceId:ev.spanId;
+	traceCurTrace = ev.traceId;
+	traceCurSpan = ev.spanId;
+	ev.begin = PerfCounters::getTimeNs();
+}
+
+void TraceSpan::close() {
+	ev.end = PerfCounters::getTimeNs();
+	traceCurTrace = prev.traceId;
+	traceCurSpan = prev.spanId;
+	Tracer::record(ev);
+}
+
+}
@@ -0,0 +1,128 @@
+/*
+ * tracing.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_DEBUG_TRACING_H_
+#define LIGHTSPEED_DEBUG_TRACING_H_
+
+#include "programlocation.h"
+#include "traceContext.h"
+#include "../types.h"
+#include "../containers/autoArray.h"
+#include "../text/textstream.h"
+#include "../../mt/atomic.h"
+
+namespace LightSpeed {
+
+	///Recorded span
+	struct TraceEvent {
+		///name of the span (static string)
+		const char *name;
+		///location where the span has been opened
+		const char *file;
+		const char *function;
+		int line;
+		///thread which recorded the span (Tracer's own numbering, starting by 1)
+		natural threadId;
+		///begin and end time in nanoseconds (PerfCounters::getTimeNs)
+		natural begin;
+		natural end;
+		natural traceId;
+		natural spanId;
+		///parent span, zero for root
+		natural parentId;
+	};
+
+	///Collects spans into per-thread ring buffers
+	/**
+	 * Tracing is disabled by default. When disabled, each span costs one test of a global flag.
+	 * When enabled, span reads the clock twice and writes one event into the ring buffer
+	 * of the current thread. Writing never locks, the oldest events are overwritten when
+	 * the buffer is full. Buffers are allocated on first span recorded by the thread. Buffers
+	 * of the exited threads are reused by the new threads, their events remain available until
+	 * they are overwritten.
+	 */
+	class Tracer {
+	public:
+		///Enables or disables recording
+		static void enable(bool enable);
+		///Returns true, if recording is enabled
+		static bool isEnabled() {return enabledFlag != 0;}
+
+		///Sets count of events in buffers allocated after this call
+		/**
+		 * @param events count of events, rounded up to power of two. Default is 8192
+		 */
+		static void setBufferSize(natural events);
+
+		///Writes event into the buffer of the current thread
+		static void record(const TraceEvent &ev);
+
+		///Collects events of all threads
+		/**
+		 * @param out array receives events. Events are ordered by threads, not by time.
+		 * Events which are overwritten during collection are skipped
+		 */
+		static void collect(AutoArray<TraceEvent> &out);
+
+		///Discards all recorded events
+		/** @note events recorded during the call can remain in the buffers */
+		static void clear();
+
+		///Writes events in the Chrome trace-event JSON format
+		/**
+		 * Output can be opened by chrome://tracing or by the Perfetto UI. Every span
+		 * is written as complete event ("ph":"X") with trace and span ids in arguments.
+		 */
+		static void exportChromeJson(PrintTextA &print);
+
+		///Generates identifier of the span
+		static natural newSpanId();
+
+	protected:
+		static atomic enabledFlag;
+	};
+
+	///Records the span from the construction to the destruction
+	/**
+	 * Span becomes active context of the current thread. Spans opened during its lifetime
+	 * (in this or in other thread through propagated context) become its children.
+	 *
+	 * Use macro LS_TRACE_SPAN to declare span in the current scope
+	 */
+	class TraceSpan {
+	public:
+		///Opens the span
+		/**
+		 * @param name name of the span. Pointer is stored, so it must be static string
+		 * @param loc location in the source code
+		 */
+		TraceSpan(const char *name, const ProgramLocation &loc) {
+			if (Tracer::isEnabled()) open(name, loc);
+			else ev.spanId = 0;
+		}
+		~TraceSpan() {
+			if (ev.spanId) close();
+		}
+
+	protected:
+		TraceEvent ev;
+		TraceContext prev;
+
+		void open(const char *name, const ProgramLocation &loc);
+		void close();
+
+	private:
+		TraceSpan(const TraceSpan &);
+		TraceSpan &operator=(const TraceSpan &);
+	};
+
+}
+
+///Records span named by the argument from this point to the end of the scope
+#define LS_TRACE_SPAN(name) ::LightSpeed::TraceSpan _ls_trace_span(name, THISLOCATION)
+
+#endif /* LIGHTSPEED_DEBUG_TRACING_H_ */
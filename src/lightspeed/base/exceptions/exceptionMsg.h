@@ -50,6 +50,7 @@ namespace LightSpeed {
 		virtual ExceptionMsg &setBase(natural b)= 0;
 		virtual ExceptionMsg &setPrecision(natural p)= 0;
 		virtual ExceptionMsg &setSci(natural p)= 0;
+		virtual ExceptionMsg &setShortest()= 0;
 		void resetArgs();
 		virtual ~ExceptionMsg() {}
 
@@ -103,6 +104,7 @@ namespace LightSpeed {
 		virtual ExceptionMsgSink &setBase(natural b) {ref.setBase(b);return *this;}
 		virtual ExceptionMsgSink &setPrecision(natural p) {ref.setPrecision(p);return *this;}
 		virtual ExceptionMsgSink &setSci(natural p) {ref.setSci(p);return *this;}
+		virtual ExceptionMsgSink &setShortest() {ref.setShortest();return *this;}
 
 		ExceptionMsgSink(ExceptionMsg &ref):ref(ref) {}
 		virtual ~ExceptionMsgSink() {if (!isShared()) ref.flush();}
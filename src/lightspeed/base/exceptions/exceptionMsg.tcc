@@ -48,6 +48,9 @@ public:
 	virtual ExceptionMsg &setSci(natural p){
 		formater.setSci(p);return *this;
 	}
+	virtual ExceptionMsg &setShortest(){
+		formater.setShortest();return *this;
+	}
 	void resetArgs() {
 		formater.resetArgs();
 	}
@@ -86,6 +86,7 @@ namespace LightSpeed {
  const char *SubsectionException::msgText = "Exception has been thrown inside of section '%1'";
  const char *RequiredSectionException::msgText = "Section '%1' is required but missing";
  const char *UnexpectedSectionException::msgText = "Section '%1' is not allowed or expected: ";
+ const char *BinReaderSyncException::msgText = "Input stream out of sync reading using iterator: %1";
  const char *NoCurrentApplicationException::msgText = "No current application. You have to declare at least one object that extends App class";
 //const char *ServiceNotFoundException::msgText = "Service '%1' is not registered";
  const char *SynchronizedException::msgText = "Lock or resource is busy (tryLock failed)";
@@ -3,6 +3,7 @@
 
 #include "exception.h"
 #include "../framework/iservices.h"
+#include "../containers/string.h"
 
 namespace LightSpeed
 {
@@ -118,6 +119,24 @@ namespace LightSpeed
 			msg(msgText) << section;
 		}
 	};
+
+	///Thrown by BinaryReader, when data in the stream are not expected
+	class BinReaderSyncException: public SerializerException {
+	public:
+		LIGHTSPEED_EXCEPTIONFINAL;
+		BinReaderSyncException(const ProgramLocation &loc, const std::type_info &iterType)
+			:SerializerException(loc),iterType(iterType) {}
+		const std::type_info &getIteratorType() const {return iterType;}
+
+		static LIGHTSPEED_EXPORT const char *msgText;;
+	protected:
+		const std::type_info &iterType;
+
+		virtual void message(ExceptionMsg &msg) const {
+			msg(msgText) << iterType.name();
+		}
+
+	};
 } // namespace LightSpeed
 
 
@@ -10,13 +10,47 @@
 #include "../interface.tcc"
 #include "../containers/autoArray.tcc"
 #include "../containers/map.tcc"
+#include "metrics.h"
+#include "../debug/tracing.h"
 
 namespace LightSpeed {
 
+class TCPServer::Instruments {
+public:
+	StringA label;
+	MetricGauge connections;
+	MetricCounter accepted;
+	MetricHistogram handlerTime;
+
+	StringA name;
+
+	Instruments()
+		:label(Metric::label("server","default"))
+		,connections("lightspeed_tcpserver_connections","Count of opened connections",label)
+		,accepted("lightspeed_tcpserver_accepted_total","Count of accepted connections",label)
+		,handlerTime("lightspeed_tcpserver_handler_microseconds","Time spent in the connection handler",label) {}
+
+	void setName(ConstStrA name) {
+		this->name = name;
+		label = Metric::label("server",name);
+		connections.setLabels(label);
+		accepted.setLabels(label);
+		handlerTime.setLabels(label);
+	}
+};
+
+void TCPServer::setMetricsName(ConstStrA name) {
+	Sync _(lock);
+	instruments->setName(name);
+	if (internalExecutor != nil) internalExecutor->setMetricsName(name);
+	if (eventListener != nil) eventListener->setMetricsName(name);
+}
+
 
 TCPServer::TCPServer(ITCPServerConnHandler &handler,natural maxThreads)
 :internalExecutor(new ParallelExecutor(maxThreads))
 ,handler2(&handler),shutdown(1),sleeper(*this)
+,instruments(new Instruments)
 {
 	executor = internalExecutor;
 }
@@ -24,6 +58,7 @@ TCPServer::TCPServer(ITCPServerConnHandler &handler,natural maxThreads)
 TCPServer::TCPServer(ITCPServerConnHandler &handler, IExecutor *connExecutor)
 :executor(connExecutor)
 ,handler2(&handler),shutdown(1),sleeper(*this)
+,instruments(new Instruments)
 {
 
 
@@ -47,6 +82,7 @@ void TCPServer::start(NetworkStreamSource tcpsource)
 	if (lockCompareExchange(shutdown,1,0) != 1) return;
 
 	eventListener = INetworkServices::getNetServices().createEventListener();
+	if (!instruments->name.empty()) eventListener->setMetricsName(instruments->name);
 
 	shutdown = 0;
 	mother = tcpsource;
@@ -101,6 +137,7 @@ void TCPServer::stop()
 
 	//reset all open descriptors
 	connList.clear();
+	instruments->connections.set(0);
 
 	//clear other ports
 	otherPorts.clear();
@@ -140,6 +177,8 @@ void TCPServer::acceptConn(NetworkStreamSource& listenSock, natural sourceId) th
 		PConnection conn(new Connection(this,stream,ctx,sourceId));
 		//register connection
 		connList.insert(conn.getMT());
+		instruments->accepted.add();
+		instruments->connections.set(connList.size());
 		//ask handler for first action
 		ITCPServerConnHandler::Command cmd =  handler2->onAccept(conn,ctx);
 		//carry out the action
@@ -239,6 +278,7 @@ void TCPServer::close(Connection *k) {
 	Sync _(lock);
 	PConnection key(k);
 	connList.erase(key.getMT());
+	instruments->connections.set(connList.size());
 }
 
 void TCPServer::reuse(Connection *k) {
@@ -285,6 +325,8 @@ void TCPServer::workerEx(Connection *owner, natural eventId) {
 
 	ITCPServerConnHandler::Command cmdout;
 	try {
+		MetricTimer _(instruments->handlerTime);
+		LS_TRACE_SPAN("tcpserver.handler");
 		switch (eventId) {
 		case INetworkResource::waitForInput:
 			cmdout = handler2->onDataReady(owner->getStream(),owner->getContext());break;
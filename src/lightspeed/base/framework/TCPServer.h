@@ -79,6 +79,11 @@ public:
 
 	PNetworkEventListener getEventListener();
 
+	///Sets name of the server exported as the label of its metrics
+	/** Name is also given to the internal executor and to the event listener.
+	 * Servers without the name share the label server="default" */
+	void setMetricsName(ConstStrA name);
+
 	bool isRunning();
 
 	natural addPort(natural port, bool bindLocalOnly = true, natural connTimeout = 30000);
@@ -231,6 +236,10 @@ protected:
 	class RunWorkerEx;
 	class RunWorkerCompletion;
 	class RunDisconnect;
+
+	///Metrics of the server (see MetricsRegistry)
+	class Instruments;
+	AllocPointer<Instruments> instruments;
 };
 
 
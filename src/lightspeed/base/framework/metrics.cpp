@@ -0,0 +1,290 @@
+/*
+ * metrics.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "metrics.h"
+#include "../containers/autoArray.tcc"
+#include "../text/textstream.tcc"
+#include "../text/textFormat.tcc"
+#include "../sync/synchronize.h"
+#include <string.h>
+
+namespace LightSpeed {
+
+#ifdef LIGHTSPEED_PLATFORM_WINDOWS
+static _declspec(thread) natural metricShardOfThread = 0;
+#else
+static __thread natural metricShardOfThread = 0;
+#endif
+
+static atomic metricShardCounter = 0;
+
+natural Metric::getShard() {
+	natural s = metricShardOfThread;
+	if (s == 0) {
+		//threads are assigned to shards round-robin, zero means not assigned yet
+		s = (natural)lockInc(metricShardCounter) % shardCount + 1;
+		metricShardOfThread = s;
+	}
+	return s - 1;
+}
+
+StringA Metric::label(ConstStrA key, ConstStrA value) {
+	AutoArray<char, SmallAlloc<256> > buff;
+	buff.append(key);
+	buff.append(ConstStrA("=\""));
+	for (natural i = 0; i < value.length(); i++) {
+		char c = value[i];
+		if (c == '\\' || c == '"') buff.add('\\');
+		if (c == '\n') {buff.append(ConstStrA("\\n"));continue;}
+		buff.add(c);
+	}
+	buff.add('"');
+	return StringA(ConstStrA(buff.data(), buff.length()));
+}
+
+void Metric::setLabels(ConstStrA labels) {
+	//labels are read by the registry during the scrape
+	MetricsRegistry &reg = MetricsRegistry::getInstance();
+	Synchronized<FastLock> _(reg.lock);
+	this->labels = labels;
+}
+
+Metric::Metric(Type type, ConstStrA name, ConstStrA help, ConstStrA labels)
+	:type(type),name(name),help(help),labels(labels),registered(false) {}
+
+Metric::~Metric() {
+	unregisterMetric();
+}
+
+void Metric::registerMetric() {
+	MetricsRegistry::getInstance().add(this);
+	registered = true;
+}
+
+void Metric::unregisterMetric() {
+	if (registered) {
+		MetricsRegistry::getInstance().remove(this);
+		registered = false;
+	}
+}
+
+void Metric::writeName(PrintTextA &print, ConstStrA suffix, ConstStrA extraLabel) const {
+	print("%1%%2") << name << suffix;
+	if (labels.empty() && extraLabel.empty()) return;
+	if (labels.empty()) print("{%1}") << extraLabel;
+	else if (extraLabel.empty()) print("{%1}") << labels;
+	else print("{%1,%2}") << labels << extraLabel;
+}
+
+MetricCounter::MetricCounter(ConstStrA name, ConstStrA help, ConstStrA labels)
+	:Metric(typeCounter, name, help, labels),observed(&own) {
+	for (natural i = 0; i < shardCount; i++) own.cell[i].value = 0;
+	registerMetric();
+}
+
+MetricCounter::MetricCounter(ConstStrA name, ConstStrA help, ConstStrA labels, const Cells &observed)
+	:Metric(typeCounter, name, help, labels),observed(&observed) {
+	for (natural i = 0; i < shardCount; i++) own.cell[i].value = 0;
+	registerMetric();
+}
+
+MetricCounter::~MetricCounter() {
+	unregisterMetric();
+}
+
+natural MetricCounter::getValue() const {
+	natural sum = 0;
+	for (natural i = 0; i < shardCount; i++) sum += (natural)observed->cell[i].value;
+	return sum;
+}
+
+void MetricCounter::exportText(PrintTextA &print, const Metric *const *same, natural count) const {
+	natural v = getValue();
+	for (natural i = 0; i < count; i++) v += static_cast<const MetricCounter *>(same[i])->getValue();
+	writeName(print, ConstStrA());
+	print(" %1\n") << v;
+}
+
+MetricGauge::MetricGauge(ConstStrA name, ConstStrA help, ConstStrA labels)
+	:Metric(typeGauge, name, help, labels),value(0),observed(&value) {
+	registerMetric();
+}
+
+MetricGauge::MetricGauge(ConstStrA name, ConstStrA help, ConstStrA labels, const volatile atomic &observed)
+	:Metric(typeGauge, name, help, labels),value(0),observed(&observed) {
+	registerMetric();
+}
+
+MetricGauge::~MetricGauge() {
+	unregisterMetric();
+}
+
+void MetricGauge::exportText(PrintTextA &print, const Metric *const *same, natural count) const {
+	integer v = getValue();
+	for (natural i = 0; i < count; i++) v += static_cast<const MetricGauge *>(same[i])->getValue();
+	writeName(print, ConstStrA());
+	print(" %1\n") << v;
+}
+
+MetricHistogram::MetricHistogram(ConstStrA name, ConstStrA help, ConstStrA labels)
+	:Metric(typeHistogram, name, help, labels) {
+	for (natural i = 0; i < shardCount; i++) {
+		shards[i] = new Shard;
+		memset(shards[i], 0, sizeof(Shard));
+	}
+	registerMetric();
+}
+
+MetricHistogram::~MetricHistogram() {
+	unregisterMetric();
+	for (natural i = 0; i < shardCount; i++) delete shards[i];
+}
+
+natural MetricHistogram::getBucket(natural value) {
+	if (value == 0) return 0;
+	natural w = value - 1;
+	if (w < subBuckets) return w + 1;
+	natural e = 0;
+	for (natural x = w; x > 1; x >>= 1) e++;
+	natural sub = (w >> (e - 3)) & (subBuckets - 1);
+	return 1 + subBuckets + (e - 3) * subBuckets + sub;
+}
+
+natural MetricHistogram::getUpperBound(natural bucket) {
+	if (bucket == 0) return 0;
+	natural idx = bucket - 1;
+	if (idx < subBuckets) return idx + 1;
+	natural e = (idx - subBuckets) / subBuckets + 3;
+	natural sub = (idx - subBuckets) % subBuckets;
+	natural base = subBuckets + 1 + sub;
+	if (base > (naturalNull >> (e - 3))) return naturalNull;
+	return base << (e - 3);
+}
+
+MetricHistogram::Snapshot MetricHistogram::getSnapshot() const {
+	Snapshot snap;
+	snap.count = 0;
+	snap.sum = 0;
+	snap.buckets.resize(bucketCount, 0);
+	for (natural i = 0; i < shardCount; i++) {
+		const Shard &s = *shards[i];
+		snap.sum += (natural)s.sum;
+		for (natural j = 0; j < bucketCount; j++) {
+			natural v = (natural)s.buckets[j];
+			snap.buckets(j) += v;
+			snap.count += v;
+		}
+	}
+	return snap;
+}
+
+natural MetricHistogram::Snapshot::getQuantile(double q) const {
+	if (count == 0) return 0;
+	natural limit = (natural)(q * count);
+	if (limit >= count) limit = count - 1;
+	natural cum = 0;
+	for (natural i = 0; i < buckets.length(); i++) {
+		cum += buckets[i];
+		if (cum > limit) return getUpperBound(i);
+	}
+	return naturalNull;
+}
+
+void MetricHistogram::exportText(PrintTextA &print, const Metric *const *same, natural count) const {
+	Snapshot snap = getSnapshot();
+	for (natural i = 0; i < count; i++) {
+		Snapshot other = static_cast<const MetricHistogram *>(same[i])->getSnapshot();
+		snap.count += other.count;
+		snap.sum += other.sum;
+		for (natural j = 0; j < bucketCount; j++) snap.buckets(j) += other.buckets[j];
+	}
+	natural cum = 0;
+	TextFormatBuff<char> fmt;
+	//power of two boundaries are also boundaries of the buckets
+	for (natural i = 0; i < bucketCount && cum < snap.count; i++) {
+		cum += snap.buckets[i];
+		natural ub = getUpperBound(i);
+		if (ub == 0 || ub == naturalNull || (ub & (ub - 1)) != 0) continue;
+		fmt("le=\"%1\"") << ub;
+		writeName(print, "_bucket", fmt.write());
+		print(" %1\n") << cum;
+	}
+	writeName(print, "_bucket", "le=\"+Inf\"");
+	print(" %1\n") << snap.count;
+	writeName(print, "_sum");
+	print(" %1\n") << snap.sum;
+	writeName(print, "_count");
+	print(" %1\n") << snap.count;
+}
+
+MetricsRegistry &MetricsRegistry::getInstance() {
+	//never destroyed, because static metrics can be destroyed after the registry
+	static MetricsRegistry *inst = new MetricsRegistry;
+	return *inst;
+}
+
+void MetricsRegistry::add(Metric *m) {
+	Synchronized<FastLock> _(lock);
+	metrics.add(m);
+}
+
+void MetricsRegistry::remove(Metric *m) {
+	Synchronized<FastLock> _(lock);
+	for (natural i = 0; i < metrics.length(); i++) {
+		if (metrics[i] == m) {
+			metrics.erase(i);
+			return;
+		}
+	}
+}
+
+static ConstStrA metricTypeName(Metric::Type t) {
+	switch (t) {
+	case Metric::typeCounter: return "counter";
+	case Metric::typeGauge: return "gauge";
+	default: return "histogram";
+	}
+}
+
+void MetricsRegistry::exportText(PrintTextA &print) const {
+	Synchronized<FastLock> _(lock);
+	//metrics with the same name must be written together
+	AutoArray<bool> done;
+	done.resize(metrics.length(), false);
+	for (natural i = 0; i < metrics.length(); i++) {
+		if (done[i]) continue;
+		const Metric *m = metrics[i];
+		print("# HELP %1 %2\n") << m->getName() << m->getHelp();
+		print("# TYPE %1 %2\n") << m->getName() << metricTypeName(m->getType());
+		for (natural j = i; j < metrics.length(); j++) {
+			const Metric *s = metrics[j];
+			if (done[j] || s->getName() != m->getName()) continue;
+			done(j) = true;
+			//instances sharing the labels are exported as one series
+			AutoArray<const Metric *, SmallAlloc<16> > same;
+			for (natural k = j + 1; k < metrics.length(); k++) {
+				const Metric *o = metrics[k];
+				if (!done[k] && o->getType() == s->getType() && o->getName() == s->getName()
+						&& o->getLabels() == s->getLabels()) {
+					same.add(o);
+					done(k) = true;
+				}
+			}
+			s->exportText(print, same.data(), same.length());
+		}
+	}
+}
+
+const Metric *MetricsRegistry::find(ConstStrA name, ConstStrA labels) const {
+	Synchronized<FastLock> _(lock);
+	for (natural i = 0; i < metrics.length(); i++) {
+		if (metrics[i]->getName() == name && metrics[i]->getLabels() == labels) return metrics[i];
+	}
+	return 0;
+}
+
+}
@@ -0,0 +1,275 @@
+/*
+ * metrics.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_FRAMEWORK_METRICS_H_
+#define LIGHTSPEED_FRAMEWORK_METRICS_H_
+
+#include "../containers/string.h"
+#include "../containers/autoArray.h"
+#include "../text/textstream.h"
+#include "../../mt/atomic.h"
+#include "../../mt/fastlock.h"
+#include "perfCounters.h"
+
+namespace LightSpeed {
+
+	///Base class of all metrics
+	/**
+	 * Metric registers self to the MetricsRegistry during construction and
+	 * unregisters during destruction, so it can be declared as member of
+	 * the instrumented object. Updates of the metrics never lock, values are
+	 * collected into per-thread shards and aggregated when the registry is scraped.
+	 *
+	 * Name of the metric should follow Prometheus conventions (snake_case, unit suffix, _total for counters).
+	 * Labels are written in the text format without the braces, for example @c executor="main"
+	 *
+	 * Instances with the same name and labels are exported as one series, their values are summed.
+	 */
+	class Metric {
+	public:
+		enum Type {
+			///monotonic counter
+			typeCounter,
+			///value which can go up and down
+			typeGauge,
+			///distribution of values
+			typeHistogram
+		};
+
+		Metric(Type type, ConstStrA name, ConstStrA help, ConstStrA labels);
+		virtual ~Metric();
+
+		Type getType() const {return type;}
+		ConstStrA getName() const {return name;}
+		ConstStrA getHelp() const {return help;}
+		ConstStrA getLabels() const {return labels;}
+
+		///Writes samples of the metric in the Prometheus text format
+		/**
+		 * Function writes only samples, HELP and TYPE lines are written by the registry
+		 */
+		void exportText(PrintTextA &print) const {exportText(print, 0, 0);}
+
+		///Writes samples of the metric summed with the other instances of the same series
+		/**
+		 * @param print output
+		 * @param same other metrics with the same type, name and labels
+		 * @param count count of the other metrics
+		 */
+		virtual void exportText(PrintTextA &print, const Metric *const *same, natural count) const = 0;
+
+		///Count of shards. Each thread updates one shard
+		static const natural shardCount = 16;
+		///Retrieves shard index of the current thread
+		static natural getShard();
+
+		///Creates label
+		/**
+		 * @param key name of the label
+		 * @param value value of the label, it is escaped
+		 * @return label in form key="value"
+		 */
+		static StringA label(ConstStrA key, ConstStrA value);
+
+		///Changes labels of the metric
+		/** Use it to give the instrumented object a stable name after construction */
+		void setLabels(ConstStrA labels);
+
+	protected:
+		Type type;
+		StringA name;
+		StringA help;
+		StringA labels;
+		bool registered;
+
+		///Registers metric, called at the end of the constructor of the derived class
+		void registerMetric();
+		///Unregisters metric, called at the beginning of the destructor of the derived class
+		void unregisterMetric();
+		///Writes name with labels
+		void writeName(PrintTextA &print, ConstStrA suffix, ConstStrA extraLabel = ConstStrA()) const;
+
+		///Shard cell, aligned to the cache line to prevent false sharing
+		struct Cell {
+			atomic value;
+			byte padding[64 - sizeof(atomic)];
+		};
+
+	private:
+		Metric(const Metric &);
+		Metric &operator=(const Metric &);
+	};
+
+	///Monotonic counter
+	class MetricCounter: public Metric {
+	public:
+
+		///Shards of the counter
+		/**
+		 * Declared as a static variable, shards are zero-initialised before
+		 * any constructor runs. Code which can run during the static initialisation
+		 * (allocators) updates them directly, and the counter only reads them.
+		 */
+		struct Cells {
+			Cell cell[shardCount];
+
+			void add(natural value = 1) {
+				lockExchangeAdd(cell[getShard()].value, (atomicValue)value);
+			}
+		};
+
+		MetricCounter(ConstStrA name, ConstStrA help, ConstStrA labels = ConstStrA());
+		///Creates counter reading external shards
+		/**
+		 * @param observed shards. They must remain valid during lifetime of the counter
+		 */
+		MetricCounter(ConstStrA name, ConstStrA help, ConstStrA labels, const Cells &observed);
+		~MetricCounter();
+
+		///Increases the counter
+		void add(natural value = 1) {
+			own.add(value);
+		}
+
+		///Retrieves current value (sum of all shards)
+		natural getValue() const;
+
+		using Metric::exportText;
+		virtual void exportText(PrintTextA &print, const Metric *const *same, natural count) const;
+
+	protected:
+		Cells own;
+		const Cells *observed;
+	};
+
+	///Gauge - value which can go up and down
+	/**
+	 * Gauge can hold own value, or it can observe an atomic variable of the instrumented object.
+	 * Observed variable is read during the scrape, so object doesn't need to update anything
+	 */
+	class MetricGauge: public Metric {
+	public:
+		///Creates gauge holding own value
+		MetricGauge(ConstStrA name, ConstStrA help, ConstStrA labels = ConstStrA());
+		///Creates gauge observing the variable
+		/**
+		 * @param observed variable. It must remain valid during lifetime of the gauge
+		 */
+		MetricGauge(ConstStrA name, ConstStrA help, ConstStrA labels, const volatile atomic &observed);
+		~MetricGauge();
+
+		void set(integer v) {value = v;}
+		void add(integer v) {lockExchangeAdd(value, v);}
+		void inc() {lockInc(value);}
+		void dec() {lockDec(value);}
+		integer getValue() const {return *observed;}
+
+		using Metric::exportText;
+		virtual void exportText(PrintTextA &print, const Metric *const *same, natural count) const;
+
+	protected:
+		atomic value;
+		const volatile atomic *observed;
+	};
+
+	///Histogram with logarithmic buckets
+	/**
+	 * Values are integers (choose unit, for example microseconds). Each power of two is split into
+	 * 8 linear sub-buckets, so relative error of the percentiles is below 12.5%, similar to HDR histograms
+	 * with one significant digit. Prometheus export uses power of two boundaries.
+	 */
+	class MetricHistogram: public Metric {
+	public:
+		MetricHistogram(ConstStrA name, ConstStrA help, ConstStrA labels = ConstStrA());
+		~MetricHistogram();
+
+		///Records the value
+		void record(natural value) {
+			Shard &s = *shards[getShard()];
+			lockInc(s.buckets[getBucket(value)]);
+			lockExchangeAdd(s.sum, (atomicValue)value);
+		}
+
+		struct Snapshot {
+			natural count;
+			natural sum;
+			AutoArray<natural> buckets;
+
+			///Retrieves value at given quantile
+			/**
+			 * @param q quantile (0.5 - median, 0.99 - 99th percentile)
+			 * @return upper bound of the bucket containing the quantile
+			 */
+			natural getQuantile(double q) const;
+		};
+
+		///Aggregates all shards
+		Snapshot getSnapshot() const;
+
+		using Metric::exportText;
+		virtual void exportText(PrintTextA &print, const Metric *const *same, natural count) const;
+
+		static const natural subBuckets = 8;
+		///bucket 0 holds zeroes, others cover (lower,upper]
+		static const natural bucketCount = 1 + subBuckets + (sizeof(natural) * 8 - 3) * subBuckets;
+
+		///Retrieves bucket of the value
+		static natural getBucket(natural value);
+		///Retrieves upper bound of the bucket (inclusive)
+		static natural getUpperBound(natural bucket);
+
+	protected:
+		struct Shard {
+			atomic sum;
+			atomic buckets[bucketCount];
+		};
+		///shards are allocated separately to keep them on different cache lines
+		Shard *shards[shardCount];
+	};
+
+	///Measures time between construction and destruction and records it in microseconds
+	class MetricTimer {
+	public:
+		MetricTimer(MetricHistogram &hist):hist(hist),start(PerfCounters::getTimeNs()) {}
+		~MetricTimer() {hist.record((PerfCounters::getTimeNs() - start) / 1000);}
+	protected:
+		MetricHistogram &hist;
+		natural start;
+	};
+
+	///Global registry of the metrics
+	class MetricsRegistry {
+	public:
+		///Retrieves global instance
+		static MetricsRegistry &getInstance();
+
+		void add(Metric *m);
+		void remove(Metric *m);
+
+		///Writes all metrics in the Prometheus text exposition format
+		void exportText(PrintTextA &print) const;
+
+		///Finds metric
+		/**
+		 * @param name name of the metric
+		 * @param labels labels of the metric
+		 * @return pointer to metric or NULL, if not found
+		 *
+		 * @note pointer can become invalid, when the metric is destroyed. Use it only when metric is known to exist
+		 */
+		const Metric *find(ConstStrA name, ConstStrA labels = ConstStrA()) const;
+
+	protected:
+		friend class Metric;
+
+		mutable FastLock lock;
+		AutoArray<Metric *> metrics;
+	};
+
+}
+
+#endif /* LIGHTSPEED_FRAMEWORK_METRICS_H_ */
@@ -0,0 +1,78 @@
+/*
+ * metricsExporter.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "metricsExporter.h"
+#include "../containers/autoArray.tcc"
+#include "../text/textstream.tcc"
+#include "../streams/fileiobuff.tcc"
+
+namespace LightSpeed {
+
+///maximum size of the request header
+static const natural metricsMaxRequest = 8192;
+
+MetricsExporter::MetricsExporter(const MetricsRegistry &registry):registry(registry) {}
+
+MetricsExporter::~MetricsExporter() {
+	stop();
+}
+
+natural MetricsExporter::start(natural port, bool bindLocalOnly) {
+	stop();
+	server = new TCPServer(*this, 2);
+	return server->start(port, bindLocalOnly, 5000);
+}
+
+void MetricsExporter::stop() {
+	if (server != nil) {
+		server->stop();
+		server = nil;
+	}
+}
+
+ITCPServerContext *MetricsExporter::onIncome(const NetworkAddress &) throw() {
+	return new Context;
+}
+
+ITCPServerConnHandler::Command MetricsExporter::onAccept(ITCPServerConnControl *controlObject, ITCPServerContext *) {
+	controlObject->setDataReadyTimeout(5000);
+	return cmdWaitRead;
+}
+
+ITCPServerConnHandler::Command MetricsExporter::onDataReady(const PNetworkStream &stream, ITCPServerContext *context) throw() {
+	try {
+		Context *ctx = static_cast<Context *>(context);
+		char buff[1024];
+		natural rd = stream->read(buff, sizeof(buff));
+		if (rd == 0) return cmdRemove;
+		ctx->request.append(ConstStrA(buff, rd));
+		ConstStrA req(ctx->request);
+		if (req.find(ConstStrA("\r\n\r\n")) == naturalNull && req.find(ConstStrA("\n\n")) == naturalNull) {
+			return req.length() > metricsMaxRequest?cmdRemove:cmdWaitRead;
+		}
+		sendResponse(stream, req);
+	} catch (...) {
+
+	}
+	return cmdRemove;
+}
+
+void MetricsExporter::sendResponse(const PNetworkStream &stream, ConstStrA request) {
+	SeqFileOutBuff<> out(stream.get());
+	SeqTextOutA txt(out);
+	PrintTextA print(txt);
+	bool head = request.head(5) == ConstStrA("HEAD ");
+	if (request.head(4) != ConstStrA("GET ") && !head) {
+		print("HTTP/1.0 405 Method Not Allowed\r\nAllow: GET, HEAD\r\nConnection: close\r\n\r\n");
+	} else {
+		print("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n\r\n");
+		if (!head) registry.exportText(print);
+	}
+	out.flush();
+}
+
+}
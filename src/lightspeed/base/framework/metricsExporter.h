@@ -0,0 +1,72 @@
+/*
+ * metricsExporter.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_FRAMEWORK_METRICSEXPORTER_H_
+#define LIGHTSPEED_FRAMEWORK_METRICSEXPORTER_H_
+
+#include "metrics.h"
+#include "TCPServer.h"
+
+namespace LightSpeed {
+
+	///Serves metrics over HTTP in the Prometheus text format
+	/**
+	 * Object is handler of the TCPServer. Every GET request is answered by
+	 * the content of the registry, path of the request is ignored. Connection
+	 * is closed after the response (HTTP/1.0).
+	 *
+	 * Exporter can start own server on given port through the function start(). It can be also
+	 * passed as handler to any other TCPServer.
+	 *
+	 * @code
+	 * MetricsExporter exporter;
+	 * exporter.start(9100, false);
+	 * @endcode
+	 */
+	class MetricsExporter: public ITCPServerConnHandler {
+	public:
+		///Constructs exporter
+		/**
+		 * @param registry registry to export
+		 */
+		MetricsExporter(const MetricsRegistry &registry = MetricsRegistry::getInstance());
+		~MetricsExporter();
+
+		///Starts own server
+		/**
+		 * @param port port number, zero picks a random port
+		 * @param bindLocalOnly true to accept local connections only
+		 * @return port number
+		 */
+		natural start(natural port = 0, bool bindLocalOnly = true);
+		///Stops own server
+		void stop();
+
+		virtual Command onDataReady(const PNetworkStream &stream, ITCPServerContext *context) throw();
+		virtual Command onWriteReady(const PNetworkStream &, ITCPServerContext *) throw() {return cmdRemove;}
+		virtual Command onTimeout(const PNetworkStream &, ITCPServerContext *) throw () {return cmdRemove;}
+		virtual Command onUserWakeup(const PNetworkStream &, ITCPServerContext *, natural) throw() {return cmdRemove;}
+		virtual void onDisconnectByPeer(ITCPServerContext *) throw () {}
+		virtual ITCPServerContext *onIncome(const NetworkAddress &addr) throw();
+		virtual Command onAccept(ITCPServerConnControl *controlObject, ITCPServerContext *context);
+
+	protected:
+		///Collects the request header
+		class Context: public ITCPServerContext {
+		public:
+			AutoArray<char> request;
+		};
+
+		const MetricsRegistry &registry;
+		AllocPointer<TCPServer> server;
+
+		void sendResponse(const PNetworkStream &stream, ConstStrA request);
+	};
+
+}
+
+#endif /* LIGHTSPEED_FRAMEWORK_METRICSEXPORTER_H_ */
@@ -0,0 +1,62 @@
+/*
+ * perfCounters.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_FRAMEWORK_PERFCOUNTERS_H_
+#define LIGHTSPEED_FRAMEWORK_PERFCOUNTERS_H_
+
+#include "../types.h"
+
+namespace LightSpeed {
+
+	///Reads hardware performance counters of the current thread
+	/**
+	 * On Linux, counters are opened through perf_event_open. The kernel can refuse
+	 * access to the counters (perf_event_paranoid, containers, virtual machines).
+	 * In this case, the unavailable counters are reported as naturalNull. Object never
+	 * throws because of missing counters, because they are optional.
+	 *
+	 * Object must be used by the same thread which created it.
+	 */
+	class PerfCounters {
+	public:
+
+		struct Values {
+			///CPU cycles
+			natural cycles;
+			///retired instructions
+			natural instructions;
+			///cache misses (last level)
+			natural cacheMisses;
+		};
+
+		PerfCounters();
+		~PerfCounters();
+
+		///Returns true, if at least one counter is available
+		bool isAvailable() const;
+
+		///Resets and starts counting
+		void start();
+		///Stops counting and returns counted values
+		Values stop();
+
+		///Retrieves monotonic time in nanoseconds
+		/** Value has no meaning itself, use it to measure differences */
+		static natural getTimeNs();
+
+	protected:
+		static const natural counterCount = 3;
+		integer handles[counterCount];
+
+	private:
+		PerfCounters(const PerfCounters &);
+		PerfCounters &operator=(const PerfCounters &);
+	};
+
+}
+
+#endif /* LIGHTSPEED_FRAMEWORK_PERFCOUNTERS_H_ */
@@ -16,6 +16,7 @@
 #define SZN_FETCHSTATS_PROGINSTANCE_H_
 
 #include "../containers/string.h"
+#include "../containers/autoArray.h"
 #include "../exceptions/exception.h"
 #include "../exceptions/systemException.h"
 #include "../export.h"
@@ -30,10 +31,11 @@ struct ProgInstanceBuffer;
  * of single instance of the program. Second, it implements simple mailbox for
  * controlling the process without need to use signals.
  *
- * The implemented mailbox is very simple and allows to hold only one request
- * at time. It always blocking - requesting process must wait for
- * reply. During waiting, other processes must wait until current request
- * is processed.
+ * The mailbox is always blocking - requesting process must wait for
+ * reply. Under Linux, mailbox has multiple slots, so many processes can
+ * post their requests at the same time without waiting to each other. Requests and
+ * replies larger than the slot are transferred in chunks. Other platforms
+ * can hold only one request at time.
  *
  * Called process can periodically check the mailbox, or can wait for message
  * while it is blocked. Once request arrives, it can accept the request,
@@ -66,14 +68,25 @@ public:
 	 *
 	 * @param requestMaxSize defines size of request in bytes. Calling
 	 * this function without parameter, object will initialize this
-	 * property to use remaining space of instance-file, which can be
-	 * near to 4KB
+	 * property to default value (64KB under Linux, near to 4KB on other platforms)
 	 *
 	 * @exception AlreadyRunningException_t process already running
 	 * @exception SystemException thrown, when file cannot be created
 	 */
 	void create(natural requestMaxSize);
 
+	///Creates program instance file
+	/**
+	 * @param requestMaxSize defines size of request in bytes.
+	 * @param slotCount count of requests which can be posted at the same time. Requests
+	 * above this count wait for a free slot. Platforms which don't support
+	 * slots ignore this value
+	 *
+	 * @exception AlreadyRunningException_t process already running
+	 * @exception SystemException thrown, when file cannot be created
+	 */
+	void create(natural requestMaxSize, natural slotCount);
+
 
 	///Opens program instance file for requests
 	/**
@@ -508,6 +521,10 @@ protected:
 	String name;
 	ProgInstanceBuffer *buffer;
 	ProgInstance *prevInstance;
+	///accepted request (assembled from the chunks) and buffer for the reply
+	AutoArray<byte> curRequest;
+	///slot of the accepted request
+	natural curSlot;
 	
 };
 
@@ -8,6 +8,9 @@
 #include "../streams/standardIO.tcc"
 #include "../exceptions/errorMessageException.h"
 #include "../containers/stack.tcc"
+#include "../containers/fastSort.tcc"
+#include "../memory/countingAlloc.h"
+#include "perfCounters.h"
 
 
 namespace LightSpeed {
@@ -89,15 +92,7 @@ namespace LightSpeed {
 		else {
 			TestApp *x = firstTest;
 			while (x != 0) {
-				ConstStrA name = x->getTestName();
-				ConstStrA::SplitIterator testIter = testList.split(',');
-				while (testIter.hasItems()) {
-					ConstStrA curTest = testIter.getNext();
-					curTest = curTest.trim(' ');
-					if (curTest == name || (curTest.tail(1) == ConstStrA('*') && curTest.crop(0,1) == name.head(curTest.length()-1))) {
-						tests.push(x);
-					}
-				}
+				if (matchName(testList, x->getTestName())) tests.push(x);
 				x = x->previousTest;
 			}
 
@@ -111,6 +106,18 @@ namespace LightSpeed {
 		return retval;
 	}
 
+	bool TestCollector::matchName(ConstStrA testList, ConstStrA name) {
+		ConstStrA::SplitIterator testIter = testList.split(',');
+		while (testIter.hasItems()) {
+			ConstStrA curTest = testIter.getNext();
+			curTest = curTest.trim(' ');
+			if (curTest == name || (curTest.tail(1) == ConstStrA('*') && curTest.crop(0,1) == name.head(curTest.length()-1))) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	StringA TestCollector::listTests() const {
 		AutoArrayStream<char> out;
 		if (firstTest == 0) throw ErrorMessageException(THISLOCATION, "No tests available");
@@ -162,6 +169,127 @@ namespace LightSpeed {
 
 	}
 
+	TestCollector::BenchmarkResults TestCollector::runBenchmarks(ConstStrA benchList, SeqFileOutput console) {
+		Stack<BenchmarkApp *> benchs;
+		bool all = benchList.empty() || benchList == "all";
+		BenchmarkApp *x = firstBench;
+		while (x != 0) {
+			if (all || matchName(benchList, x->getBenchName())) benchs.push(x);
+			x = x->previousBench;
+		}
+
+		SeqFileOutBuff<> bufout(console);
+		SeqTextOutA textOut(bufout);
+		TextOut<SeqTextOutA> print(textOut);
+
+		BenchmarkResults results;
+		while (!benchs.empty()) {
+			BenchmarkApp *x = benchs.top();
+			ConstStrA benchName(x->getBenchName());
+			print("%1 %2 ") << benchName << ConstStrA("..............................................").crop(0, benchName.length());
+			bufout.flush();
+
+			BenchmarkRecord rec;
+			rec.name = x->getBenchName();
+			rec.result = x->runBenchmark();
+			results.add(rec);
+
+			print("min %{ 10}1 ns, median %{ 10}2 ns, p99 %{ 10}3 ns, allocs %4")
+				<< setPrecision(1) << rec.result.minNs << rec.result.medianNs << rec.result.p99Ns
+				<< rec.result.allocs;
+			if (rec.result.cycles >= 0) print(", cycles %1") << rec.result.cycles;
+			if (rec.result.instructions >= 0) print(", instr %1") << rec.result.instructions;
+			if (rec.result.cacheMisses >= 0) print(", cache-miss %1") << rec.result.cacheMisses;
+			print("\n");
+			bufout.flush();
+			benchs.pop();
+		}
+		return results;
+	}
+
+	StringA TestCollector::listBenchmarks() const {
+		AutoArrayStream<char> out;
+		BenchmarkApp *x = firstBench;
+		while (x != 0) {
+			if (!out.empty()) out.write(',');
+			out.blockWrite(ConstStrA(x->getBenchName()));
+			x = x->previousBench;
+		}
+		return out.getArray();
+	}
+
+	void TestCollector::addBenchmark(BenchmarkApp *bench) {
+		bench->previousBench = firstBench;
+		firstBench = bench;
+	}
+
+	BenchmarkApp::BenchmarkApp(const char *benchName, BenchMain benchMain)
+		:benchName(benchName), benchMain(benchMain), previousBench(0)
+	{
+		TestCollector &collector = Singleton<TestCollector>::getInstance();
+		collector.addBenchmark(this);
+	}
+
+	const char * BenchmarkApp::getBenchName() const
+	{
+		return benchName;
+	}
+
+	static double perIteration(natural value, natural iterations) {
+		if (value == naturalNull) return -1;
+		return (double)value / (double)iterations;
+	}
+
+	BenchmarkApp::Result BenchmarkApp::runBenchmark() const {
+
+		CountingAlloc alloc;
+
+		//calibrate - find count of iterations to reach sampleTimeNs
+		natural count = 1;
+		while (true) {
+			natural start = PerfCounters::getTimeNs();
+			benchMain(count, alloc);
+			natural dur = PerfCounters::getTimeNs() - start;
+			if (dur >= sampleTimeNs) break;
+			//grow fast when we are far from the target
+			if (dur < sampleTimeNs / 100) count *= 10; else count *= 2;
+		}
+
+		for (natural i = 0; i < warmUpCount; i++) benchMain(count, alloc);
+
+		PerfCounters counters;
+		AutoArray<double> samples;
+		samples.reserve(sampleCount);
+		natural cycles = 0, instructions = 0, cacheMisses = 0;
+		alloc.reset();
+
+		for (natural i = 0; i < sampleCount; i++) {
+			counters.start();
+			natural start = PerfCounters::getTimeNs();
+			benchMain(count, alloc);
+			natural dur = PerfCounters::getTimeNs() - start;
+			PerfCounters::Values v = counters.stop();
+			samples.add((double)dur / (double)count);
+			if (cycles != naturalNull) cycles = v.cycles == naturalNull ? naturalNull : cycles + v.cycles;
+			if (instructions != naturalNull) instructions = v.instructions == naturalNull ? naturalNull : instructions + v.instructions;
+			if (cacheMisses != naturalNull) cacheMisses = v.cacheMisses == naturalNull ? naturalNull : cacheMisses + v.cacheMisses;
+		}
+
+		introSort(samples);
+
+		natural total = count * sampleCount;
+		Result res;
+		res.iterations = total;
+		res.minNs = samples[0];
+		res.medianNs = samples[sampleCount / 2];
+		res.p99Ns = samples[(sampleCount * 99 + 99) / 100 - 1];
+		res.allocs = perIteration(alloc.getAllocCount(), total);
+		res.cycles = perIteration(cycles, total);
+		res.instructions = perIteration(instructions, total);
+		res.cacheMisses = perIteration(cacheMisses, total);
+		return res;
+	}
+
 	static void testFn(PrintTextA &print) {
 		print("OK");
 	}
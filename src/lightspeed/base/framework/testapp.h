@@ -2,6 +2,7 @@
 #include "../containers/constStr.h"
 #include "../streams/fileio.h"
 #include "../text/textstream.h"
+#include "../containers/autoArray.h"
 
 namespace LightSpeed {
 #ifdef _MSC_VER
@@ -55,6 +56,73 @@ protected:
 };
 
 
+///Defines microbenchmark
+/**
+ * Benchmark is registered in TestCollector as well as tests. Instead comparing output, benchmark
+ * measures time of the benchmark function.
+ *
+ * Measurement is calibrated automatically. Count of iterations is increased until one sample
+ * takes at least sampleTimeNs. Calibration runs also act as warm-up, then the function is
+ * executed sampleCount times. Result contains minimal, median and 99-percentile time of one iteration.
+ *
+ * The benchmark function receives allocator, which counts allocations. If benchmark uses this
+ * allocator for its allocations, the result contains allocations per iteration. Hardware counters
+ * (cycles, instructions, cache misses) are reported when they are available (see PerfCounters)
+ */
+class BenchmarkApp {
+public:
+
+	///Benchmark function
+	/**
+	 * @param iterations count of iterations of the measured operation
+	 * @param alloc allocator which counts allocations.
+	 */
+	typedef void(*BenchMain)(natural iterations, IRuntimeAlloc &alloc);
+
+	///Result of the benchmark. All values are related to one iteration
+	struct Result {
+		///count of measured iterations (calibration and warm-up is not included)
+		natural iterations;
+		///minimal time in nanoseconds
+		double minNs;
+		///median time in nanoseconds
+		double medianNs;
+		///99-percentile time in nanoseconds
+		double p99Ns;
+		///allocations per iteration
+		double allocs;
+		///CPU cycles per iteration, negative if not available
+		double cycles;
+		///instructions per iteration, negative if not available
+		double instructions;
+		///cache misses per iteration, negative if not available
+		double cacheMisses;
+	};
+
+	///count of samples
+	static const natural sampleCount = 100;
+	///minimal time of one sample
+	static const natural sampleTimeNs = 2000000;
+	///count of samples executed after calibration before measurement starts
+	static const natural warmUpCount = 3;
+
+	BenchmarkApp(const char *benchName, BenchMain benchMain);
+
+	const char *getBenchName() const;
+
+	///Runs benchmark
+	Result runBenchmark() const;
+
+protected:
+
+	friend class TestCollector;
+
+	const char *benchName;
+	BenchMain benchMain;
+	BenchmarkApp *previousBench;
+};
+
+
 class TestCollector {
 public:
 	natural runTests(ConstStrW testList);
@@ -65,13 +133,36 @@ public:
 	
 	void addTest(TestApp *test);
 	bool runSingleTest(TestApp * x, SeqFileOutput console);
+
+	struct BenchmarkRecord {
+		const char *name;
+		BenchmarkApp::Result result;
+	};
+
+	typedef AutoArray<BenchmarkRecord> BenchmarkResults;
+
+	///Runs benchmarks
+	/**
+	 * @param benchList list of benchmarks separated by comma. Empty or "all" runs all benchmarks.
+	 *  Names ending by asterisk are matched as prefix (the same rules as runTests())
+	 * @param console output for the report
+	 * @return results of all executed benchmarks
+	 */
+	BenchmarkResults runBenchmarks(ConstStrA benchList, SeqFileOutput console);
+	StringA listBenchmarks() const;
+
+	void addBenchmark(BenchmarkApp *bench);
 protected:
 
 	TestApp *firstTest;
+	BenchmarkApp *firstBench;
+
+	static bool matchName(ConstStrA testList, ConstStrA name);
 	
 
 };
 
 typedef TestApp defineTest;
+typedef BenchmarkApp defineBenchmark;
 
 }
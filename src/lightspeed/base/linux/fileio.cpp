@@ -7,6 +7,9 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
 #include <fcntl.h>
 #include <string.h>
 #include "../exceptions/unsupportedFeature.h"
@@ -20,7 +23,9 @@
 #include "fileio.h"
 #include "../exceptions/invalidParamException.h"
 #include "../../mt/linux/systime.h"
+#include "../debug/progress.h"
 #include <sys/mman.h>
+#include <sys/resource.h>
 
 #include "../interface.tcc"
 #include "linuxhttp.h"
@@ -673,37 +678,58 @@ namespace LightSpeed {
 			virtual const struct stat64 &getFileStat() const {return *this;}
 		};
 
+		///entry returned by getdents64
+		struct LinuxDirent64 {
+			ino64_t d_ino;
+			off64_t d_off;
+			unsigned short d_reclen;
+			unsigned char d_type;
+			char d_name[1];
+		};
+
+		///size of buffer for getdents64. Large buffer reduces count of syscalls
+		static const natural direntBufferSize = 65536;
+
     	public:
 
-    		DIR *dir;
+    		int fd;
     		mutable StatInfo statInfo;
-    		struct dirent *entryInfo;
+    		char *dents;
     		char *srcpath;
     		char *buffer;
     		wchar_t *wsrcpath;
     		wchar_t *wbuffer;
+    		natural dentPos;
+    		natural dentEnd;
     		mutable bool statLoaded;
     		IFileIOServices &svc;
 
     		DirState(IFileIOServices &svc, ConstStrA name, size_t maxpath)
-    			:dir(opendir(name.data()))
-    			,entryInfo(reinterpret_cast<struct dirent *>(this+1))
-    			,srcpath(reinterpret_cast<char *>(entryInfo) + offsetof(struct dirent, d_name) + maxpath)
+    			:fd(::open(name.data(),O_RDONLY|O_DIRECTORY|O_CLOEXEC))
+    			,dents(reinterpret_cast<char *>(this+1))
+    			,srcpath(dents + direntBufferSize)
     			,buffer(srcpath+name.length()+1)
-    			,wsrcpath(reinterpret_cast<wchar_t *>(buffer + maxpath+1))
+    			,wsrcpath(alignWide(buffer + maxpath+1))
     			,wbuffer(wsrcpath+name.length()+1)
+    			,dentPos(0)
+    			,dentEnd(0)
     			,statLoaded(false)
     			,svc(svc) {
-    			if (dir == 0) throw FileOpenError(THISLOCATION, errno, name);
+    			if (fd == -1) throw FileOpenError(THISLOCATION, errno, name);
     			strcpy(srcpath,name.data());
     			srcpath[name.length()] = '/';
     			this->source = ConstStrW(wsrcpath,name.length());
     		}
 
+    		static wchar_t *alignWide(char *ptr) {
+    			size_t a = reinterpret_cast<size_t>(ptr);
+    			return reinterpret_cast<wchar_t *>((a + sizeof(wchar_t) - 1) & ~(sizeof(wchar_t) - 1));
+    		}
+
     		void *operator new(size_t sz,size_t maxpath, size_t dirpathlen) {
-    			size_t entryLen = offsetof(struct dirent, d_name) +
-    					2*maxpath + dirpathlen + 1
-    					+ sizeof(wchar_t) * (maxpath + dirpathlen + 1)
+    			size_t entryLen = direntBufferSize +
+    					maxpath + dirpathlen + 2
+    					+ sizeof(wchar_t) * (maxpath + dirpathlen + 2)
     					+ sz + 20;
     			return malloc(entryLen);
     		}
@@ -715,51 +741,62 @@ namespace LightSpeed {
     		}
 
     		virtual ~DirState() {
-    			closedir(dir);
+    			::close(fd);
     		}
 
     		bool getNext() {
-    			struct dirent *res;
-    			int i = readdir_r(dir,entryInfo,&res);
-    			if (i) throw FileIOError(THISLOCATION,i,source);
-    			if (res == 0) return false;
-    			if (strcmp(res->d_name,".") == 0 || strcmp(res->d_name,"..") == 0) return getNext();
-    			strcpy(buffer,res->d_name);
-    			convert(ConstStrA(srcpath),wsrcpath);
-    			this->entryName = ConstStrW(wbuffer);
-    			link = false;
-    			statLoaded = false;
-    			switch (res->d_type) {
-    			case DT_REG: type = file; break;
-    			case DT_DIR: type = directory;break;
-    			case DT_FIFO:
-    			case DT_CHR:
-    			case DT_SOCK: type = seqfile;break;
-    			case DT_BLK: type = special;break;
-    			case DT_LNK: link = true;
-    						determineType();
-    						break;
-    			case DT_UNKNOWN:
-    						determineType();
-    						break;
+    			for(;;) {
+    				if (dentPos >= dentEnd) {
+    					long rd = syscall(SYS_getdents64, fd, dents, direntBufferSize);
+    					if (rd < 0) throw FileIOError(THISLOCATION,errno,source);
+    					if (rd == 0) return false;
+    					dentPos = 0;
+    					dentEnd = rd;
+    				}
+    				const LinuxDirent64 *res = reinterpret_cast<const LinuxDirent64 *>(dents + dentPos);
+    				dentPos += res->d_reclen;
+    				const char *name = res->d_name;
+    				if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) continue;
+    				strcpy(buffer,name);
+    				convert(ConstStrA(srcpath),wsrcpath);
+    				this->entryName = ConstStrW(wbuffer);
+    				link = false;
+    				statLoaded = false;
+    				//type is known from the entry, stat is called only when type is unknown
+    				switch (res->d_type) {
+    				case DT_REG: type = file; break;
+    				case DT_DIR: type = directory;break;
+    				case DT_FIFO:
+    				case DT_CHR:
+    				case DT_SOCK: type = seqfile;break;
+    				case DT_BLK: type = special;break;
+    				case DT_LNK: link = true;
+    							determineType();
+    							break;
+    				case DT_UNKNOWN:
+    							determineType();
+    							break;
+    				}
+    				return true;
     			}
-    			return true;
     		}
 
     		void determineType() {
     			int i;
+    			//stat relative to the directory, so path is not resolved again
     			if (link == false) {
-    				i = lstat64(srcpath,&statInfo);
+    				i = fstatat64(fd,buffer,&statInfo,AT_SYMLINK_NOFOLLOW);
     				if (i != 0) throw FileOpenError(THISLOCATION,errno,wsrcpath);
     				if (S_ISLNK(statInfo.st_mode)) {
     					link = true;
-    					i = stat64(srcpath,&statInfo);
+    					i = fstatat64(fd,buffer,&statInfo,0);
         				if (i != 0) throw FileOpenError(THISLOCATION,errno,wsrcpath);
     				}
     			} else {
-					i = stat64(srcpath,&statInfo);
+					i = fstatat64(fd,buffer,&statInfo,0);
     				if (i != 0) FileOpenError(THISLOCATION,errno,wsrcpath);
     			}
+    			statLoaded = i == 0;
     			if (S_ISREG(statInfo.st_mode)) type = file;
     			else if (S_ISDIR(statInfo.st_mode)) type = directory;
     			else if (S_ISFIFO(statInfo.st_mode) || S_ISCHR(statInfo.st_mode) || S_ISSOCK(statInfo.st_mode)) type = seqfile;
@@ -776,11 +813,18 @@ namespace LightSpeed {
     			*wtrg = 0;
     		}
         	virtual void rewind() {
-        		rewinddir(dir);
+        		lseek(fd,0,SEEK_SET);
+        		dentPos = dentEnd = 0;
         	}
 
         	virtual lnatural getSize() const {
-        		loadStat();
+        		if (!statLoaded) {
+#ifdef STATX_SIZE
+        			struct statx stx;
+        			if (loadStatx(STATX_SIZE, stx)) return stx.stx_size;
+#endif
+        			loadStat();
+        		}
         		return statInfo.st_size;
         	}
 
@@ -790,17 +834,24 @@ namespace LightSpeed {
         	}
 
         	virtual TimeStamp getModifiedTime() const {
-        		loadStat();
+        		if (!statLoaded) {
+#ifdef STATX_MTIME
+        			struct statx stx;
+        			if (loadStatx(STATX_MTIME, stx))
+        				return TimeStamp::fromUnix(stx.stx_mtime.tv_sec,stx.stx_mtime.tv_nsec/1000000);
+#endif
+        			loadStat();
+        		}
         		return TimeStamp::fromUnix(statInfo.st_mtim.tv_sec,statInfo.st_mtim.tv_nsec/1000000);
         	}
 
         	virtual IFileIOServices::FileOpenMode getAllowedOpenMode() const {
-        		if (access(srcpath,R_OK) == 0)
-        			if (access(srcpath, W_OK) == 0)
+        		if (faccessat(fd,buffer,R_OK,0) == 0)
+        			if (faccessat(fd,buffer,W_OK,0) == 0)
         				return IFileIOServices::fileOpenReadWrite;
         			else
         				return IFileIOServices::fileOpenRead;
-        		else if (access(srcpath,W_OK) == 0)
+        		else if (faccessat(fd,buffer,W_OK,0) == 0)
         			return IFileIOServices::fileOpenWrite;
         		else
         			return IFileIOServices::fileAccessible;
@@ -808,11 +859,28 @@ namespace LightSpeed {
 
         	void loadStat() const {
         		if (statLoaded) return;
-        		if (stat64(srcpath,&statInfo))
+        		if (fstatat64(fd,buffer,&statInfo,0))
         			 throw ErrNoException(THISLOCATION,errno);
         		statLoaded = true;
         	}
 
+#ifdef STATX_BASIC_STATS
+        	///Retrieves only requested fields
+        	/**
+        	 * @param mask requested fields
+        	 * @param stx result
+        	 * @retval true success
+        	 * @retval false statx is not supported, use stat
+        	 */
+        	bool loadStatx(unsigned int mask, struct statx &stx) const {
+        		if (statx(fd,buffer,AT_STATX_SYNC_AS_STAT,mask,&stx) == 0)
+        			return (stx.stx_mask & mask) == mask;
+        		int e = errno;
+        		if (e == ENOSYS || e == EINVAL) return false;
+        		throw ErrNoException(THISLOCATION,e);
+        	}
+#endif
+
         	virtual PFolderIterator openFolder() const {
         		if (type != directory) throw FileMsgException(THISLOCATION,0,wbuffer,ConstStrW(L"Directory not found"));
         		size_t maxpath = pathconf(srcpath, _PC_NAME_MAX) + 1;
@@ -896,6 +964,134 @@ namespace LightSpeed {
 
 
     }
+    ///size of block copied by one syscall
+    static const natural copyChunkSize = 64*1024*1024;
+
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+
+    static long sysCopyFileRange(int ifd, off64_t *inOff, int ofd, off64_t *outOff, natural len) {
+#ifdef SYS_copy_file_range
+    	return syscall(SYS_copy_file_range, ifd, inOff, ofd, outOff, len, 0);
+#else
+    	errno = ENOSYS;
+    	return -1;
+#endif
+    }
+
+    ///Copies range of the file using the fastest available method
+    /**
+     * @param ifd source
+     * @param ofd target
+     * @param offset offset of the range, same for both files
+     * @param length length of the range
+     * @param progress progress in KB
+     * @return error code, or 0 on success
+     */
+    static int copyFileRange(int ifd, int ofd, off64_t offset, lnatural length, Progress &progress) {
+    	//shared by all threads, set once the kernel reports that the call is missing
+    	static atomic copyFileRangeMissing = 0;
+    	off64_t end = offset + length;
+    	//copy_file_range - kernel copies data and can share extents on CoW filesystems
+    	while (readAcquire(&copyFileRangeMissing) == 0 && offset < end) {
+    		off64_t inOff = offset, outOff = offset;
+    		natural chunk = (end - offset) > (off64_t)copyChunkSize?copyChunkSize:(natural)(end - offset);
+    		long res = sysCopyFileRange(ifd, &inOff, ofd, &outOff, chunk);
+    		if (res > 0) {
+    			offset += res;
+    			progress.set((natural)(offset >> 10));
+    		} else if (res == 0) {
+    			//source has been truncated meanwhile
+    			return 0;
+    		} else {
+    			int e = errno;
+    			if (e == EINTR) continue;
+    			//not supported for this pair of files - fall back to sendfile
+    			if (e != ENOSYS && e != EXDEV && e != EINVAL && e != EOPNOTSUPP) return e;
+    			if (e == ENOSYS) writeRelease(&copyFileRangeMissing, 1);
+    			break;
+    		}
+    	}
+    	//sendfile - writes at current position of the target
+    	if (offset < end && lseek64(ofd, offset, SEEK_SET) == -1) return errno;
+    	while (offset < end) {
+    		off64_t inOff = offset;
+    		natural chunk = (end - offset) > (off64_t)copyChunkSize?copyChunkSize:(natural)(end - offset);
+    		ssize_t res = sendfile64(ofd, ifd, &inOff, chunk);
+    		if (res > 0) {
+    			offset += res;
+    			progress.set((natural)(offset >> 10));
+    		} else if (res == 0) {
+    			return 0;
+    		} else {
+    			int e = errno;
+    			if (e == EINTR) continue;
+    			if (e != EINVAL && e != ENOSYS) return e;
+    			break;
+    		}
+    	}
+    	//read and write
+    	char buffer[65536];
+    	while (offset < end) {
+    		natural chunk = (end - offset) > (off64_t)sizeof(buffer)?sizeof(buffer):(natural)(end - offset);
+    		ssize_t rd = pread64(ifd, buffer, chunk, offset);
+    		if (rd == 0) return 0;
+    		if (rd < 0) {
+    			if (errno == EINTR) continue;
+    			return errno;
+    		}
+    		ssize_t pos = 0;
+    		while (pos < rd) {
+    			ssize_t wr = pwrite64(ofd, buffer + pos, rd - pos, offset + pos);
+    			if (wr < 0) {
+    				if (errno == EINTR) continue;
+    				return errno;
+    			}
+    			pos += wr;
+    		}
+    		offset += rd;
+    		progress.set((natural)(offset >> 10));
+    	}
+    	return 0;
+    }
+
+    ///Copies content of the file
+    /**
+     * Tries to clone the file first (reflink), which is instant on CoW filesystems. Otherwise
+     * copies only data areas of the file, so holes of sparse file are preserved.
+     *
+     * @return error code, or 0 on success
+     */
+    static int copyFileContent(int ifd, int ofd, lnatural size) {
+    	Progress progress((natural)(size >> 10));
+    	if (ioctl(ofd, FICLONE, ifd) == 0) {
+    		progress.set((natural)(size >> 10));
+    		return 0;
+    	}
+    	off64_t offset = 0;
+    	off64_t end = size;
+    	while (offset < end) {
+    		off64_t data = lseek64(ifd, offset, SEEK_DATA);
+    		if (data == -1) {
+    			int e = errno;
+    			//no more data - rest of the file is hole
+    			if (e == ENXIO) break;
+    			//holes are not supported - copy everything
+    			if (e != EINVAL) return e;
+    			data = offset;
+    		}
+    		off64_t hole = lseek64(ifd, data, SEEK_HOLE);
+    		if (hole == -1 || hole > end) hole = end;
+    		int err = copyFileRange(ifd, ofd, data, hole - data, progress);
+    		if (err) return err;
+    		offset = hole;
+    	}
+    	//creates hole at the end of the file
+    	if (ftruncate64(ofd, size) == -1) return errno;
+    	return 0;
+    }
+
     void LinuxFileServices::copy(ConstStrW from, ConstStrW to, bool overwrite) {
 
     	IFileIOHandler *h1 = findHandler(from);
@@ -907,14 +1103,12 @@ namespace LightSpeed {
     	StringA t = wideToUtf8(to);
     	int ifd = open(f.cStr(),O_RDONLY|O_LARGEFILE|O_CLOEXEC);
     	if (ifd == -1) {int e = errno; throw FileIOError(THISLOCATION,e,from);}
-    	struct stat st;
-    	if (fstat(ifd,&st) == -1) {int e = errno;close(ifd);throw FileIOError(THISLOCATION,e,from);}
+    	struct stat64 st;
+    	if (fstat64(ifd,&st) == -1) {int e = errno;close(ifd);throw FileIOError(THISLOCATION,e,from);}
     	int ofd = open(t.cStr(),O_WRONLY|O_LARGEFILE|O_CLOEXEC|O_CREAT|(overwrite?O_TRUNC:O_EXCL), st.st_mode);
     	if (ofd == -1) {int e = errno;close(ifd);throw FileIOError(THISLOCATION,e,to);}
 
-    	int err = 0;
-    	ssize_t res = sendfile(ofd,ifd,0,st.st_size);
-    	if (res == -1) err = errno;
+    	int err = copyFileContent(ifd, ofd, st.st_size);
     	close(ifd);
     	close(ofd);
 
@@ -978,6 +1172,12 @@ namespace LightSpeed {
     	}
 
     }
+#ifndef MADV_HUGEPAGE
+#define MADV_HUGEPAGE 14
+#endif
+    ///MADV_POPULATE_READ, available since Linux 5.14
+    static const int madvPopulateRead = 22;
+
     PMappedFile LinuxFileServices::mapFile(ConstStrW filename, FileOpenMode mode) {
 
     	IFileIOHandler *h1 = findHandler(filename);
@@ -1004,8 +1204,12 @@ namespace LightSpeed {
 
     		virtual MappedRegion map(IFileIOServices::FileOpenMode mode,
     													bool copyOnWrite) {
+    			return map(mode,copyOnWrite,0);
+    		}
+
+    		virtual MappedRegion map(IFileIOServices::FileOpenMode mode,
+    													bool copyOnWrite, natural flags) {
 
-    			int proto = getProto(mode);
     			struct stat64 st;
     			if (fstat64(fd,&st)) throw FileMsgException(THISLOCATION,errno,fname,"stat failed");
 
@@ -1013,29 +1217,31 @@ namespace LightSpeed {
     				return MappedRegion(this,0,0,0);
     			}
 
-        		void *res = mmap(0,st.st_size,proto, (copyOnWrite?MAP_PRIVATE:MAP_SHARED),fd,0);
-        		if (res == MAP_FAILED) {
-        			int e = errno;
-        			throw FileMsgException(THISLOCATION,e,fname,"MMAP failed");
-        		}
-        		return MappedRegion(this,res,st.st_size,0);
-
-
+    			return map(0,st.st_size,mode,copyOnWrite,flags);
     		}
 
 
 	        virtual MappedRegion map(IRndFileHandle::FileOffset offset, natural size, IFileIOServices::FileOpenMode mode, bool copyOnWrite)
+	        {
+	        	return map(offset,size,mode,copyOnWrite,0);
+	        }
+
+	        virtual MappedRegion map(IRndFileHandle::FileOffset offset, natural size, IFileIOServices::FileOpenMode mode, bool copyOnWrite, natural flags)
 	        {
 	            int proto = getProto(mode);
 
         		//TODO: fix offset
 
-        		void *res = mmap(0,size,proto, (copyOnWrite?MAP_PRIVATE:MAP_SHARED),fd,offset);
+	            int mflags = copyOnWrite?MAP_PRIVATE:MAP_SHARED;
+	            if (flags & mapPopulate) mflags |= MAP_POPULATE;
+        		void *res = mmap(0,size,proto,mflags,fd,offset);
         		if (res == MAP_FAILED) {
         			int e = errno;
         			throw FileMsgException(THISLOCATION,e,fname,"MMAP failed");
         		}
-        		return MappedRegion(this,res,size,offset);
+        		MappedRegion reg(this,res,size,offset);
+        		if (flags & mapHugePages) reg.advise(hintHugePages);
+        		return reg;
 
         	}
         	virtual void unmap(MappedRegion &reg) {
@@ -1054,6 +1260,47 @@ namespace LightSpeed {
         		if (reg.size == 0) return;
         		munlock(reg.address,reg.size);
         	}
+        	virtual bool advise(const MappedRegion &reg, AccessHint hint, natural from, natural length) {
+        		if (length == 0) return true;
+        		//madvise requires page aligned address
+        		natural pageSize = getpagesize();
+        		natural align = from % pageSize;
+        		void *addr = reinterpret_cast<byte *>(reg.address) + (from - align);
+        		length += align;
+        		switch (hint) {
+        		case hintNormal: return madvise(addr,length,MADV_NORMAL) == 0;
+        		case hintSequential: return madvise(addr,length,MADV_SEQUENTIAL) == 0;
+        		case hintRandom: return madvise(addr,length,MADV_RANDOM) == 0;
+        		case hintWillNeed: return madvise(addr,length,MADV_WILLNEED) == 0;
+        		case hintDontNeed: return madvise(addr,length,MADV_DONTNEED) == 0;
+        		case hintHugePages: return madvise(addr,length,MADV_HUGEPAGE) == 0;
+        		case hintPopulate:
+        			//older kernels don't know MADV_POPULATE_READ, so at least start reading ahead
+        			if (madvise(addr,length,madvPopulateRead) == 0) return true;
+        			return madvise(addr,length,MADV_WILLNEED) == 0;
+        		default: return false;
+        		}
+        	}
+        	virtual RegionStats getStats(const MappedRegion &reg) {
+        		RegionStats st = {0,0,0};
+        		natural pageSize = getpagesize();
+        		natural pages = (reg.size + pageSize - 1) / pageSize;
+        		if (pages) {
+        			AutoArray<unsigned char> vec;
+        			vec.resize(pages);
+        			if (mincore(reg.address,reg.size,vec.data()) == 0) {
+        				for (natural i = 0; i < pages; i++)
+        					if (vec[i] & 1) st.residentBytes += pageSize;
+        				if (st.residentBytes > reg.size) st.residentBytes = reg.size;
+        			}
+        		}
+        		struct rusage ru;
+        		if (getrusage(RUSAGE_SELF,&ru) == 0) {
+        			st.minorFaults = ru.ru_minflt;
+        			st.majorFaults = ru.ru_majflt;
+        		}
+        		return st;
+        	}
 
 
     	protected:
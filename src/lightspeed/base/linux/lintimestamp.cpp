@@ -1,13 +1,13 @@
 #include <unistd.h>
 #include "../timestamp.h"
-#include <sys/time.h>
+#include <time.h>
 namespace LightSpeed {
 
 	TimeStamp TimeStamp::now() {
 		
-		struct timeval tv;
-		gettimeofday(&tv,NULL);
-		return TimeStamp::fromUnix(tv.tv_sec,tv.tv_usec/1000);
+		struct timespec tv;
+		clock_gettime(CLOCK_REALTIME,&tv);
+		return TimeStamp::fromUnix(tv.tv_sec,tv.tv_nsec/1000000);
 	}
 
 }
@@ -10,6 +10,7 @@
 #include "../text/textFormat.tcc"
 #include "../memory/smallAlloc.h"
 #include <string.h>
+#include <sys/un.h>
 
 namespace LightSpeed {
 
@@ -31,6 +32,19 @@ LinuxNetAddress::~LinuxNetAddress() {
 StringA LinuxNetAddress::asString(bool resolve) {
 	if (addrinfo == 0) return StringA();
 	TextFormatBuff<char, SmallAlloc<256> > buff;
+	if (addrinfo->ai_family == AF_UNIX) {
+		//abstract namespace is shown with '@'
+		const struct sockaddr_un *un = reinterpret_cast<const struct sockaddr_un *>(addrinfo->ai_addr);
+		natural len = addrinfo->ai_addrlen - offsetof(struct sockaddr_un, sun_path);
+		ConstStrA path(un->sun_path, len);
+		if (!path.empty() && path[0] == 0) {
+			buff("unix:@%1") << path.offset(1);
+		} else {
+			natural z = path.find(0);
+			buff("unix:%1") << (z == naturalNull?path:path.head(z));
+		}
+		return StringA(buff.write());
+	}
 	char hostbuff[512];
 	char svcbuff[256];
 
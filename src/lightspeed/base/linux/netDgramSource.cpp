@@ -17,6 +17,20 @@
 #include <stdlib.h>
 #include "../exceptions/outofmemory.h"
 #include "linsocket.tcc"
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/un.h>
+#include <algorithm>
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
 
 namespace LightSpeed {
 
@@ -28,8 +42,18 @@ ConstStringT<byte> LinuxNetDatagram::peekOutputBuffer() const {
 
 LinuxNetDgamSource::LinuxNetDgamSource(natural port, natural timeout, natural startDID)
 	:LinuxSocketResource<INetworkDatagramSource>(createDatagramSocket(port),timeout),dgrId(startDID)
+	,groEnabled(false),groSupported(true)
 {
+	int v = 0;
+	socklen_t l = sizeof(v);
+	gsoSupported = getsockopt(sock,SOL_UDP,UDP_SEGMENT,&v,&l) == 0;
+}
 
+LinuxNetDgamSource::LinuxNetDgamSource(PNetworkAddress bindAddr, natural timeout, natural startDID)
+	:LinuxSocketResource<INetworkDatagramSource>(createLocalDatagramSocket(bindAddr),waitForInput),dgrId(startDID)
+	,gsoSupported(false),groEnabled(false),groSupported(false)
+{
+	setTimeout(timeout);
 }
 
 PNetworkDatagram LinuxNetDgamSource::receive() {
@@ -86,6 +110,184 @@ PNetworkDatagram LinuxNetDgamSource :: create(PNetworkAddress adr) {
 }
 
 
+///count of messages passed to the one recvmmsg/sendmmsg call
+static const natural maxBatchMsgs = 64;
+///maximum count of segments of the one UDP_SEGMENT packet
+static const natural maxGsoSegments = 64;
+///maximum size of the one UDP_SEGMENT packet
+static const natural maxGsoBytes = 65000;
+
+union BatchCtlBuff {
+	struct cmsghdr hdr;
+	char buff[CMSG_SPACE(sizeof(int))];
+};
+
+void LinuxNetDgamSource::enableGro(bool enable) {
+	if (enable == groEnabled || (enable && !groSupported)) return;
+	int v = enable?1:0;
+	if (setsockopt(sock,SOL_UDP,UDP_GRO,&v,sizeof(v)) == 0) groEnabled = enable;
+	else groSupported = false;
+}
+
+natural LinuxNetDgamSource::receiveBatch(DatagramBatch &batch) {
+	batch.clear();
+	if (wait(waitForInput) == waitTimeout) return 0;
+	//coalesced packets can be received only into large slots
+	enableGro(batch.getPacketSize() >= 65535);
+
+	struct mmsghdr msgs[maxBatchMsgs];
+	struct iovec iov[maxBatchMsgs];
+	BatchCtlBuff ctl[maxBatchMsgs];
+	natural cap = batch.getCapacity();
+	natural slot = 0;
+	while (slot < cap) {
+		natural cnt = std::min(cap - slot, maxBatchMsgs);
+		for (natural i = 0; i < cnt; i++) {
+			iov[i].iov_base = batch.getSlot(slot + i);
+			iov[i].iov_len = batch.getPacketSize();
+			struct msghdr &h = msgs[i].msg_hdr;
+			h.msg_name = batch.getAddrSlot(slot + i);
+			h.msg_namelen = DatagramBatch::maxAddrSize;
+			h.msg_iov = iov + i;
+			h.msg_iovlen = 1;
+			h.msg_control = groEnabled?ctl[i].buff:0;
+			h.msg_controllen = groEnabled?sizeof(ctl[i].buff):0;
+			h.msg_flags = 0;
+		}
+		int r = recvmmsg(sock,msgs,cnt,MSG_DONTWAIT,0);
+		if (r == -1) {
+			int err = errno;
+			if (err == EINTR) continue;
+			//report received packets, error will be reported by next call
+			if (err == EAGAIN || err == EWOULDBLOCK || slot) break;
+			throw NetworkIOError(THISLOCATION,err,"recvmmsg failed");
+		}
+		for (int i = 0; i < r; i++) {
+			struct msghdr &h = msgs[i].msg_hdr;
+			natural size = msgs[i].msg_len;
+			natural segSize = size;
+			if (groEnabled) {
+				for (struct cmsghdr *c = CMSG_FIRSTHDR(&h); c; c = CMSG_NXTHDR(&h,c)) {
+					if (c->cmsg_level == SOL_UDP && c->cmsg_type == UDP_GRO) {
+						int v;
+						memcpy(&v,CMSG_DATA(c),sizeof(v));
+						if (v > 0) segSize = v;
+					}
+				}
+			}
+			//split coalesced packet to original datagrams, all share one address
+			natural offset = (slot + i) * batch.getPacketSize();
+			do {
+				natural sz = std::min(segSize,size);
+				batch.putPacket(offset,sz,slot + i,h.msg_namelen);
+				offset += sz;
+				size -= sz;
+			} while (size);
+		}
+		slot += r;
+		if ((natural)r < cnt) break;
+	}
+	return batch.length();
+}
+
+///Converts IPv4 address to IPv4-mapped IPv6 address, because socket is always IPv6
+static const void *mapToInet6(ConstBin addr, struct sockaddr_in6 &out, socklen_t &len) {
+	const struct sockaddr *sa = reinterpret_cast<const struct sockaddr *>(addr.data());
+	if (addr.length() >= sizeof(struct sockaddr_in) && sa->sa_family == AF_INET) {
+		const struct sockaddr_in *in = reinterpret_cast<const struct sockaddr_in *>(sa);
+		memset(&out,0,sizeof(out));
+		out.sin6_family = AF_INET6;
+		out.sin6_port = in->sin_port;
+		out.sin6_addr.s6_addr[10] = 0xFF;
+		out.sin6_addr.s6_addr[11] = 0xFF;
+		memcpy(out.sin6_addr.s6_addr + 12,&in->sin_addr,4);
+		len = sizeof(out);
+		return &out;
+	}
+	len = addr.length();
+	return addr.data();
+}
+
+natural LinuxNetDgamSource::sendPackets(DatagramBatch &batch, natural from, bool allowGso) {
+	struct mmsghdr msgs[maxBatchMsgs];
+	struct iovec iov[maxBatchMsgs];
+	struct sockaddr_in6 mapped[maxBatchMsgs];
+	BatchCtlBuff ctl[maxBatchMsgs];
+	natural msgPackets[maxBatchMsgs];
+
+	natural len = batch.length();
+	natural pos = from;
+	natural cnt = 0;
+	while (pos < len && cnt < maxBatchMsgs) {
+		const DatagramBatch::Packet &p = batch.getPacket(pos);
+		natural n = 1;
+		natural total = p.size;
+		if (allowGso && p.size > 0) {
+			//equal sized packets to the same target are sent as one segmented packet
+			while (pos + n < len && n < maxGsoSegments) {
+				const DatagramBatch::Packet &q = batch.getPacket(pos + n);
+				if (q.size == 0 || q.size > p.size || q.offset != p.offset + total
+						|| total + q.size > maxGsoBytes || !batch.sameAddress(pos, pos + n)) break;
+				total += q.size;
+				n++;
+				//shorter packet must be the last one
+				if (q.size < p.size) break;
+			}
+		}
+		iov[cnt].iov_base = const_cast<byte *>(batch.getData(pos).data());
+		iov[cnt].iov_len = total;
+		struct msghdr &h = msgs[cnt].msg_hdr;
+		socklen_t alen;
+		h.msg_name = const_cast<void *>(mapToInet6(batch.getSockAddr(pos),mapped[cnt],alen));
+		h.msg_namelen = alen;
+		h.msg_iov = iov + cnt;
+		h.msg_iovlen = 1;
+		h.msg_flags = 0;
+		if (n > 1) {
+			h.msg_control = ctl[cnt].buff;
+			h.msg_controllen = CMSG_SPACE(sizeof(Bin::natural16));
+			struct cmsghdr *c = CMSG_FIRSTHDR(&h);
+			c->cmsg_level = SOL_UDP;
+			c->cmsg_type = UDP_SEGMENT;
+			c->cmsg_len = CMSG_LEN(sizeof(Bin::natural16));
+			Bin::natural16 segSize = (Bin::natural16)p.size;
+			memcpy(CMSG_DATA(c),&segSize,sizeof(segSize));
+		} else {
+			h.msg_control = 0;
+			h.msg_controllen = 0;
+		}
+		msgPackets[cnt] = n;
+		cnt++;
+		pos += n;
+	}
+
+	int r = sendmmsg(sock,msgs,cnt,0);
+	if (r == -1) {
+		int err = errno;
+		if (err == EAGAIN || err == EWOULDBLOCK || err == EINTR) return 0;
+		//segmentation can be rejected (for example, segment is larger than MTU)
+		if (msgPackets[0] > 1) {
+			//device or kernel doesn't support segmentation, don't try it again on this socket
+			if (err == EIO || err == EINVAL || err == ENOPROTOOPT) gsoSupported = false;
+			return sendPackets(batch,from,false);
+		}
+		throw NetworkIOError(THISLOCATION,err,"sendmmsg failed");
+	}
+	natural sent = 0;
+	for (int i = 0; i < r; i++) sent += msgPackets[i];
+	return sent;
+}
+
+natural LinuxNetDgamSource::sendBatch(DatagramBatch &batch) {
+	natural pos = 0;
+	while (pos < batch.length()) {
+		natural r = sendPackets(batch,pos,gsoSupported);
+		if (r == 0 && wait(waitForOutput) == waitTimeout) break;
+		pos += r;
+	}
+	return pos;
+}
+
 integer LinuxNetDgamSource ::getSocket(int index) const {
 	return index?-1:sock;
 }
@@ -278,4 +480,32 @@ int LinuxNetDgamSource::createDatagramSocket(natural port) {
 
 }
 
+int LinuxNetDgamSource::createLocalDatagramSocket(PNetworkAddress bindAddr) {
+	struct sockaddr_un autoAddr;
+	const struct sockaddr *saddr;
+	socklen_t saddrlen;
+	if (bindAddr == nil) {
+		//binding of the family only assigns unique abstract address
+		autoAddr.sun_family = AF_UNIX;
+		saddr = reinterpret_cast<const struct sockaddr *>(&autoAddr);
+		saddrlen = sizeof(sa_family_t);
+	} else {
+		LinuxNetAddress *a = dynamic_cast<LinuxNetAddress *>(bindAddr.get());
+		if (a == 0 || a->getAddrInfo() == 0 || a->getAddrInfo()->ai_family != AF_UNIX)
+			throw NetworkInvalidAddressException(THISLOCATION,bindAddr);
+		saddr = a->getAddrInfo()->ai_addr;
+		saddrlen = a->getAddrInfo()->ai_addrlen;
+	}
+	int s = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	if (s == -1) throw NetworkPortOpenException(THISLOCATION,errno,0);
+	if (bind(s,saddr,saddrlen) != 0) {
+		int err = errno;
+		close(s);
+		throw NetworkPortOpenException(THISLOCATION,err,0);
+	}
+	u_long nonblk = 1;
+	ioctl(s,FIONBIO,&nonblk);
+	return s;
+}
+
 }
@@ -14,6 +14,7 @@
 #include <netdb.h>
 #include "../memory/poolalloc.h"
 #include "linsocket.h"
+#include "../streams/datagramBatch.h"
 
 namespace LightSpeed {
 
@@ -26,7 +27,7 @@ public:
 	MemFile<SmallAlloc<4096> > outputData;
 	LinuxNetDgamSource *owner;
 
-	byte addrbuff[64];
+	byte addrbuff[DatagramBatch::maxAddrSize];
 	socklen_t addrlen;
 	PNetworkAddress assignedAddr;
 	mutable natural dgrid;
@@ -74,6 +75,14 @@ protected:
 class LinuxNetDgamSource: public LinuxSocketResource<INetworkDatagramSource>, public INetworkSocket {
 public:
 	LinuxNetDgamSource(natural port, natural timeout, natural startDID);
+	///Creates datagram source on the local (unix domain) socket
+	/**
+	 * @param bindAddr address where socket is bound. If it is nil, socket
+	 * is bound to unused address in the abstract namespace
+	 * @param timeout timeout for receiving
+	 * @param startDID first datagram ID
+	 */
+	LinuxNetDgamSource(PNetworkAddress bindAddr, natural timeout, natural startDID);
 
 	virtual natural getDefaultWait() const {return waitForInput;}
 
@@ -87,13 +96,27 @@ public:
 
 	virtual void setUID(natural id) {dgrId = id;}
 
+	virtual natural receiveBatch(DatagramBatch &batch);
+
+	virtual natural sendBatch(DatagramBatch &batch);
+
 
 protected:
 	static int createDatagramSocket(natural port);
+	static int createLocalDatagramSocket(PNetworkAddress bindAddr);
 	friend class LinuxNetDatagram;
 	PoolAlloc dgmpool;
 
 	natural dgrId;
+	///kernel supports UDP_SEGMENT (sending segmented packets), cleared when the send is rejected
+	bool gsoSupported;
+	///UDP_GRO is enabled on the socket
+	bool groEnabled;
+	///UDP_GRO can be enabled
+	bool groSupported;
+
+	void enableGro(bool enable);
+	natural sendPackets(DatagramBatch &batch, natural from, bool allowGso);
 
 
 };
@@ -19,13 +19,19 @@
 #include "../text/textParser.tcc"
 #include "linuxNetWaitingObj.h"
 #include "../exceptions/outofmemory.h"
+#include "shmRingStream.h"
+#include <sys/un.h>
 
 namespace LightSpeed {
 
 
 
+static ConstStrA localAddrPrefix("unix:");
+
 PNetworkAddress LinuxNetService::createAddr(ConstStrA remoteAddr, natural Port)
 {
+	if (remoteAddr.head(localAddrPrefix.length()) == localAddrPrefix)
+		return createLocalAddr(remoteAddr.offset(localAddrPrefix.length()));
 	TextParser<char, StaticAlloc<256> > fmt;
 	if (fmt("[%1]:%2",remoteAddr)) {
 		ConstStrA addr = fmt[1];
@@ -43,6 +49,8 @@ PNetworkAddress LinuxNetService::createAddr(ConstStrA remoteAddr, natural Port)
 }
 
 PNetworkAddress LinuxNetService::createAddr(ConstStrA remoteAddr,ConstStrA service) {
+	if (remoteAddr.head(localAddrPrefix.length()) == localAddrPrefix)
+		return createLocalAddr(remoteAddr.offset(localAddrPrefix.length()));
 
 	StringA a = remoteAddr;
 	StringA b = service;
@@ -81,7 +89,7 @@ PNetworkAddress LinuxNetService::createAddr(const void *addr, natural len)
 	nfo->ai_family = nfo->ai_addr->sa_family;
 	nfo->ai_flags = 0;
 	nfo->ai_next = 0;
-	nfo->ai_protocol = IPPROTO_UDP;
+	nfo->ai_protocol = nfo->ai_family == AF_UNIX?0:IPPROTO_UDP;
 	nfo->ai_socktype = SOCK_STREAM;
 	try {
 		PNetworkAddress assignedAddr = new LinuxNetAddress(nfo,&localfreeaddrinfo);
@@ -197,4 +205,36 @@ ConstStrA LinuxNetService::getLoopbackAddr(IPVersion ) const {
 	return "localhost";
 }
 
+PNetworkAddress LinuxNetService::createLocalAddr(ConstStrA path) {
+	struct sockaddr_un addr;
+	memset(&addr,0,sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.empty() || path.length() >= sizeof(addr.sun_path))
+		throw NetworkResolveError(THISLOCATION,ENAMETOOLONG,String(path));
+	memcpy(addr.sun_path,path.data(),path.length());
+	natural len = offsetof(struct sockaddr_un, sun_path) + path.length();
+	if (path[0] == '@') {
+		//abstract namespace, name is not terminated by zero
+		addr.sun_path[0] = 0;
+	} else {
+		len++;
+	}
+	return createAddr(&addr,len);
+}
+
+PNetworkDatagramSource LinuxNetService::createLocalDatagramSource(
+		PNetworkAddress bindAddr, natural timeout) {
+	return new LinuxNetDgamSource(bindAddr,timeout,1);
+}
+
+PNetworkStreamSource LinuxNetService::createSharedMemStreamSource(
+		PNetworkAddress address, StreamOpenMode::Type mode, natural count,
+		natural timeout, natural streamDefTimeout, natural ringSize) {
+	bool passive = mode == StreamOpenMode::passive;
+	PNetworkStreamSource local = createStreamSource(address,
+			passive?StreamOpenMode::passive:StreamOpenMode::active,
+			count,timeout,streamDefTimeout);
+	return new LinuxShmRingStreamSource(local,passive,ringSize);
+}
+
 }
@@ -14,7 +14,8 @@ struct sockaddr;
 
 namespace LightSpeed {
 
-class LinuxNetService: public INetworkServices, public INetworkServicesIP {
+class LinuxNetService: public INetworkServices, public INetworkServicesIP,
+					   public INetworkServicesLocal {
 public:
 
 
@@ -51,6 +52,19 @@ public:
 
 	virtual ConstStrA getLoopbackAddr(IPVersion ver = ipVerAny) const ;
 
+	virtual PNetworkAddress createLocalAddr(ConstStrA path);
+
+	virtual PNetworkDatagramSource createLocalDatagramSource(
+			PNetworkAddress bindAddr, natural timeout = naturalNull);
+
+	virtual PNetworkStreamSource createSharedMemStreamSource(
+			PNetworkAddress address,
+			StreamOpenMode::Type mode,
+			natural count = 1,
+			natural timeout = naturalNull,
+			natural streamDefTimeout = naturalNull,
+			natural ringSize = 65536);
+
 
 
 };
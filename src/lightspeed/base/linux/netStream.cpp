@@ -14,6 +14,9 @@
 #include <sys/ioctl.h>
 #include <poll.h>
 #include "linsocket.tcc"
+#include "../containers/autoArray.tcc"
+#include "../memory/smallAlloc.h"
+#include <string.h>
 
 namespace LightSpeed {
 
@@ -138,5 +141,80 @@ void LinuxNetStream::closeOutput() {
 }
 
 
+///Buffer for control message carrying descriptors
+typedef AutoArray<byte, SmallAlloc<256> > CtlMsgBuffer;
+
+natural LinuxNetStream::sendHandles(const void *data, natural size,
+		const integer *handles, natural count) {
+	if (foundEof)
+		throw NetworkIOError(THISLOCATION,0,"send failed - connection closed");
+	if (size == 0)
+		throw NetworkIOError(THISLOCATION,EINVAL,"sendmsg failed - no data");
+	if (!wait(INetworkResource::waitForOutput))
+		throw NetworkTimeoutException(THISLOCATION,getTimeout(),
+			NetworkTimeoutException::writing);
+	struct iovec iov;
+	iov.iov_base = const_cast<void *>(data);
+	iov.iov_len = size;
+	struct msghdr h;
+	memset(&h,0,sizeof(h));
+	h.msg_iov = &iov;
+	h.msg_iovlen = 1;
+	CtlMsgBuffer ctl;
+	if (count) {
+		ctl.resize(CMSG_SPACE(count * sizeof(int)),0);
+		h.msg_control = ctl.data();
+		h.msg_controllen = ctl.length();
+		struct cmsghdr *c = CMSG_FIRSTHDR(&h);
+		c->cmsg_level = SOL_SOCKET;
+		c->cmsg_type = SCM_RIGHTS;
+		c->cmsg_len = CMSG_LEN(count * sizeof(int));
+		int *fds = reinterpret_cast<int *>(CMSG_DATA(c));
+		for (natural i = 0; i < count; i++) fds[i] = (int)handles[i];
+	}
+	int res = sendmsg(sock,&h,MSG_NOSIGNAL);
+	if (res == -1)
+		throw NetworkIOError(THISLOCATION,errno,"sendmsg failed");
+	return (natural)res;
+}
+
+natural LinuxNetStream::receiveHandles(void *buffer, natural size,
+		integer *handles, natural &count) {
+	natural maxCount = count;
+	count = 0;
+	if (foundEof) return 0;
+	if (!wait(INetworkResource::waitForInput))
+		throw NetworkTimeoutException(THISLOCATION,getTimeout(),
+					NetworkTimeoutException::reading);
+	struct iovec iov;
+	iov.iov_base = buffer;
+	iov.iov_len = size;
+	struct msghdr h;
+	memset(&h,0,sizeof(h));
+	h.msg_iov = &iov;
+	h.msg_iovlen = 1;
+	CtlMsgBuffer ctl;
+	ctl.resize(CMSG_SPACE((maxCount?maxCount:1) * sizeof(int)),0);
+	h.msg_control = ctl.data();
+	h.msg_controllen = ctl.length();
+	int res = recvmsg(sock,&h,MSG_CMSG_CLOEXEC);
+	if (res == -1)
+		throw NetworkIOError(THISLOCATION,errno,"recvmsg failed");
+	for (struct cmsghdr *c = CMSG_FIRSTHDR(&h); c; c = CMSG_NXTHDR(&h,c)) {
+		if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+			natural n = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+			const int *fds = reinterpret_cast<const int *>(CMSG_DATA(c));
+			for (natural i = 0; i < n; i++) {
+				//descriptors which don't fit to the array are closed
+				if (count < maxCount) handles[count++] = fds[i];
+				else ::close(fds[i]);
+			}
+		}
+	}
+	if (res == 0) foundEof = true;
+	natural rd = (natural)res;
+	if (rd > countReady) countReady = 0; else countReady -= rd;
+	return rd;
 }
 
+}
@@ -15,7 +15,8 @@ namespace LightSpeed {
 
 
 
-class LinuxNetStream: public LinuxSocketResource<INetworkStream>, public INetworkSocket {
+class LinuxNetStream: public LinuxSocketResource<INetworkStream>, public INetworkSocket,
+					  public INetworkHandlePassing {
 public:
 	LinuxNetStream(int socket, natural timeout);
 	virtual ~LinuxNetStream();
@@ -31,6 +32,10 @@ public:
 	virtual void flush() {}
 	virtual natural dataReady() const;
 	virtual void closeOutput();
+	virtual natural sendHandles(const void *data, natural size,
+			const integer *handles, natural count);
+	virtual natural receiveHandles(void *buffer, natural size,
+			integer *handles, natural &count);
 
 
 protected:
@@ -13,6 +13,7 @@
 #include <string.h>
 #include <unistd.h>
 #include "linuxFdSelect.h"
+#include <sys/un.h>
 
 namespace LightSpeed {
 
@@ -27,6 +28,19 @@ static int getPortNumber(struct addrinfo *ainfo) {
 
 }
 
+///Removes socket file left by the previous instance of the server
+/** File is removed only when nobody listens on it */
+static void removeStaleSocket(struct addrinfo *ainfo) {
+	const struct sockaddr_un *un = reinterpret_cast<const struct sockaddr_un *>(ainfo->ai_addr);
+	if (ainfo->ai_addrlen <= offsetof(struct sockaddr_un, sun_path) || un->sun_path[0] == 0)
+		return;
+	int s = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (s == -1) return;
+	if (connect(s,ainfo->ai_addr,ainfo->ai_addrlen) == -1 && errno == ECONNREFUSED)
+		unlink(un->sun_path);
+	close(s);
+}
+
 static int createListenSocket(PNetworkAddress addr) {
 
 	LinuxNetAddress *a = dynamic_cast<LinuxNetAddress *>(addr.get());
@@ -43,6 +57,7 @@ static int createListenSocket(PNetworkAddress addr) {
 	u_long nonblk = 1;
 	ioctl(s,FIONBIO,&nonblk);
 
+	if (ainfo->ai_family == AF_UNIX) removeStaleSocket(ainfo);
 	int e = bind(s,ainfo->ai_addr,ainfo->ai_addrlen);
 	if (e != 0)
 		throw NetworkPortOpenException(THISLOCATION,errno,getPortNumber(ainfo));
@@ -64,10 +79,10 @@ bool LinuxNetAccept::hasItems() const
 PNetworkAddress LinuxNetAccept::getLocalAddr() const
 {
 	if (localAddr == nil) {
-		char buff[sizeof(struct sockaddr_in6)];
-		unsigned int len = sizeof(buff);
-		getsockname(acceptSock,(struct sockaddr *)buff,&len);
-		localAddr =  INetworkServices::getNetServices().createAddr(buff,len);
+		struct sockaddr_storage buff;
+		socklen_t len = sizeof(buff);
+		getsockname(acceptSock,(struct sockaddr *)&buff,&len);
+		localAddr =  INetworkServices::getNetServices().createAddr(&buff,len);
 	}
 	return localAddr;
 }
@@ -15,12 +15,39 @@
 #include "../containers/map.h"
 #include "../interface.tcc"
 #include "../framework/app.h"
+#include "../framework/metrics.h"
 
 typedef struct epoll_event EPOLL_EVENT;
 
 namespace LightSpeed {
 
+class LinuxNetworkEventListener::Instruments {
+public:
+	StringA label;
+	MetricCounter events;
+	MetricCounter timeouts;
+	MetricGauge queued;
+
+	Instruments(const LinuxNetworkEventListener &owner)
+		:label(Metric::label("listener","default"))
+		,events("lightspeed_eventlistener_events_total","Count of dispatched network events",label)
+		,timeouts("lightspeed_eventlistener_timeouts_total","Count of dispatched timeouts",label)
+		,queued("lightspeed_eventlistener_queued_requests","Count of requests waiting in the queue of the listener",label,owner.queueLen) {}
+
+	void setName(ConstStrA name) {
+		label = Metric::label("listener",name);
+		events.setLabels(label);
+		timeouts.setLabels(label);
+		queued.setLabels(label);
+	}
+};
+
+void LinuxNetworkEventListener::setMetricsName(ConstStrA name) {
+	instruments->setName(name);
+}
+
 LinuxNetworkEventListener::LinuxNetworkEventListener()
+	:instruments(new Instruments(*this))
 {
 	enableMTAccess();
 }
@@ -152,10 +179,12 @@ protected:
 
 void LinuxNetworkEventListener::workerProc() {
 
+	CachedClock clock;
 	while (!Thread::canFinish()) {
 		try {
 			PollBase::Result res;
 			PollBase::WaitStatus wt = fdSelect.wait(nil, res);
+			clock.refresh();
 
 			if (wt == PollBase::waitWakeUp) {
 				while (pumpMessage());
@@ -163,7 +192,7 @@ void LinuxNetworkEventListener::workerProc() {
 
 				AutoArray<std::pair<ISleepingObject *, natural>,SmallAlloc<32> > tocall;
 
-				SysTime tm  = SysTime::now();
+				SysTime tm  = SysTime::cached();
 				FdData *listeners = reinterpret_cast<FdData *>(res.userData);
 				for (ListenerMap::Iterator iter = listeners->listeners.getFwIter(); iter.hasItems();) {
 					const FdListener &l = iter.peek();
@@ -182,6 +211,7 @@ void LinuxNetworkEventListener::workerProc() {
 				updateFdData(listeners,res.fd);
 
 				for (natural i = 0; i < tocall.length(); i++) {
+					if (tocall[i].second) instruments->events.add(); else instruments->timeouts.add();
 					tocall[i].first->wakeUp(tocall[i].second);
 				}
 			}
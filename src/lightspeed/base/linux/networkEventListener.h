@@ -14,6 +14,7 @@
 #include "../memory/clusterAllocFactory.h"
 #include "../../mt/thread.h"
 #include "../memory/poolalloc.h"
+#include "../memory/allocPointer.h"
 #include "epollSelect.h"
 
 
@@ -26,6 +27,7 @@ public:
 	virtual ~LinuxNetworkEventListener();
 
 	virtual void set(const Request &request);
+	virtual void setMetricsName(ConstStrA name);
 
 
 protected:
@@ -77,6 +79,10 @@ protected:
 	void workerProc();
 	void cleanFd(int fd, void *data);
 
+	///Metrics of the listener (see MetricsRegistry)
+	class Instruments;
+	AllocPointer<Instruments> instruments;
+
 
 
 
@@ -0,0 +1,78 @@
+/*
+ * perfCounters.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "../framework/perfCounters.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+
+namespace LightSpeed {
+
+	static int openCounter(__u32 type, __u64 config) {
+		struct perf_event_attr attr;
+		memset(&attr,0,sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = type;
+		attr.config = config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		return (int)syscall(SYS_perf_event_open,&attr,0,-1,-1,PERF_FLAG_FD_CLOEXEC);
+	}
+
+	PerfCounters::PerfCounters() {
+		handles[0] = openCounter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_CPU_CYCLES);
+		handles[1] = openCounter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_INSTRUCTIONS);
+		handles[2] = openCounter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_CACHE_MISSES);
+	}
+
+	PerfCounters::~PerfCounters() {
+		for (natural i = 0; i < counterCount; i++)
+			if (handles[i] != -1) close((int)handles[i]);
+	}
+
+	bool PerfCounters::isAvailable() const {
+		for (natural i = 0; i < counterCount; i++)
+			if (handles[i] != -1) return true;
+		return false;
+	}
+
+	void PerfCounters::start() {
+		for (natural i = 0; i < counterCount; i++) {
+			if (handles[i] != -1) {
+				ioctl((int)handles[i],PERF_EVENT_IOC_RESET,0);
+				ioctl((int)handles[i],PERF_EVENT_IOC_ENABLE,0);
+			}
+		}
+	}
+
+	static natural readCounter(integer fd) {
+		if (fd == -1) return naturalNull;
+		ioctl((int)fd,PERF_EVENT_IOC_DISABLE,0);
+		__u64 val;
+		if (read((int)fd,&val,sizeof(val)) != (ssize_t)sizeof(val)) return naturalNull;
+		return (natural)val;
+	}
+
+	PerfCounters::Values PerfCounters::stop() {
+		Values v;
+		v.cycles = readCounter(handles[0]);
+		v.instructions = readCounter(handles[1]);
+		v.cacheMisses = readCounter(handles[2]);
+		return v;
+	}
+
+	natural PerfCounters::getTimeNs() {
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC,&ts);
+		return (natural)ts.tv_sec * 1000000000 + (natural)ts.tv_nsec;
+	}
+
+}
@@ -14,16 +14,20 @@
 
 #include <unistd.h>
 #include <sys/mman.h>
-#include <semaphore.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <limits.h>
 #include <fcntl.h>
 #include <sys/types.h>
 #include <signal.h>
 #include "../framework/proginstance.h"
 #include "../exceptions/systemException.h"
 #include "../containers/string.tcc"
-#include <sys/time.h>
+#include "../containers/autoArray.tcc"
+#include "../../mt/linux/systime.h"
+#include "../../mt/timeout.h"
 #include <string.h>
 #include <pthread.h>
 #include <wait.h>
@@ -41,42 +45,259 @@ namespace LightSpeed {
 static natural restartCount = 0;
 static time_t startTime, restartTime;
 
+///identifies layout of the instance file
+static const Bin::natural32 progInstanceMagic = 0x32495350;
+///default count of slots
+static const natural defaultSlotCount = 16;
+///default maximum size of the request or reply
+static const natural defaultMessageSize = 65536;
+///size of the slot including its header
+static const natural slotStride = 4096;
+///how long server waits for the next chunk of the message (ms)
+static const natural chunkTimeout = 10000;
+
+///States of the slot
+/** Every state has exactly one owner, which is allowed to touch the data
+ * of the slot. Ownership is passed by changing the state
+ */
+enum SlotState {
+	///slot is free, any client can allocate it (nobody owns it)
+	slotFree = 0,
+	///client writes the chunk of the request
+	slotWriting = 1,
+	///chunk of the request is ready, waiting for server
+	slotRequest = 2,
+	///server is reading the request or preparing the reply
+	slotProcessing = 3,
+	///server read the chunk, client can write next one
+	slotRequestAck = 4,
+	///chunk of the reply is ready for client
+	slotReply = 5,
+	///client read the chunk of the reply, server can write next one
+	slotReplyAck = 6,
+	///client gave up the request, server will release the slot
+	slotAbandoned = 7
+};
+
+struct ProgInstanceSlot {
+	///state of the slot - also used as futex
+	volatile int state;
+	///pid of the client which allocated the slot
+	volatile int clientPid;
+	///total size of the message
+	natural totalSize;
+	///offset of the chunk in the message
+	natural chunkOffset;
+	///size of the chunk
+	natural chunkSize;
+	///chunk data
+	char data[1];
+};
 
 struct ProgInstanceBuffer {
 	///owner of this file
 	pid_t pid;
+	///identifies layout of the file
+	Bin::natural32 magic;
 	///thread id of the owner
 	pthread_t tid;
 	///pointer to owner - used only internally to identify master object
 	ProgInstance *owner;
 	///size of this file (including pid)
 	natural size;
-	///size reserved for request
+	///maximum size of request or reply
 	natural requestSize;
-	///size of current request
-	natural curRequestSize;
-	///accessing the buffer by caller
-	sem_t semAccess;
-	///triggered after request is placed
-	sem_t semRequest;
-	///locked when processing the request
-	sem_t semInProgress;
-	///triggered after reply is placed
-	sem_t semReply;
+	///count of slots
+	natural slotCount;
+	///offset of the first slot
+	natural slotOffset;
+	///size of the data of the single slot
+	natural slotDataSize;
+	///incremented after request is placed - server waits on it as on futex
+	volatile int requestSeq;
+	///nonzero, if server can sleep on requestSeq
+	volatile int serverWaiting;
+	///nonzero, if waiting for request has been canceled
+	volatile int cancelFlag;
+	///where next client starts to search for free slot
+	volatile int allocHint;
 	///in daemon mode
 	bool indaemon;
-	///data reserved for request/reply
-	char data[1];
+
+	ProgInstanceSlot *getSlot(natural idx) {
+		return reinterpret_cast<ProgInstanceSlot *>(
+				reinterpret_cast<char *>(this) + slotOffset + idx * slotStride);
+	}
 };
 
+///waits on futex until absolute time, null means infinite
+static inline int futexWait(volatile int *addr, int val, const timespec *expire) {
+	//futex is shared between processes, so it cannot be private
+	//expiration is taken from SysTime::now(), which is CLOCK_MONOTONIC as the futex expects
+	return (int)syscall(SYS_futex, addr, FUTEX_WAIT_BITSET, val,
+			expire, 0, FUTEX_BITSET_MATCH_ANY);
+}
+
+static inline int futexWait(volatile int *addr, int val, const Timeout &tm) {
+	timespec tmspc;
+	timespec *tmptr = 0;
+	if (!tm.isInfinite()) {
+		tmspc = tm.getExpireTime().getTimeSpec();
+		tmptr = &tmspc;
+	}
+	return futexWait(addr, val, tmptr);
+}
+
+static inline void futexWake(volatile int *addr) {
+	syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, 0, 0, 0);
+}
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#endif
+}
+
+///count of checks before thread goes to the futex. Spinning has no sense on single CPU
+static natural getSpinCount() {
+	static natural spins = sysconf(_SC_NPROCESSORS_ONLN) > 1?200:0;
+	return spins;
+}
+
+static inline int loadState(ProgInstanceSlot *slot) {
+	return __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+}
+
+static inline void setState(ProgInstanceSlot *slot, int state) {
+	__atomic_store_n(&slot->state, state, __ATOMIC_SEQ_CST);
+	futexWake(&slot->state);
+}
+
+static inline bool changeState(ProgInstanceSlot *slot, int from, int to) {
+	if (__atomic_compare_exchange_n(&slot->state, &from, to, false,
+			__ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE)) {
+		futexWake(&slot->state);
+		return true;
+	} else {
+		return false;
+	}
+}
+
+///Releases the slot owned by the caller
+/** Owner pid is cleared before the slot becomes free, so the dead-client
+ * sweep never sees pid of the previous client on the reallocated slot */
+static inline void releaseSlot(ProgInstanceSlot *slot) {
+	__atomic_store_n(&slot->clientPid, 0, __ATOMIC_RELAXED);
+	setState(slot, slotFree);
+}
+
+///Waits while slot is in given state
+/**
+ * @return new state. If returned value equal to state, timeout elapsed
+ */
+static int waitWhile(ProgInstanceSlot *slot, int state, const Timeout &tm) {
+	natural spins = getSpinCount();
+	for (natural i = 0; i < spins; i++) {
+		int s = loadState(slot);
+		if (s != state) return s;
+		cpuRelax();
+	}
+	int s;
+	while ((s = loadState(slot)) == state) {
+		if (futexWait(&slot->state, state, tm) == -1) {
+			int e = errno;
+			if (e == ETIMEDOUT) return loadState(slot);
+			if (e != EAGAIN && e != EINTR) throw ErrNoException(THISLOCATION, e);
+		}
+	}
+	return s;
+}
+
+///Waits until slot reaches given state
+/**
+ * @retval true state reached
+ * @retval false timeout
+ */
+static bool waitFor(ProgInstanceSlot *slot, int state, const Timeout &tm) {
+	int s;
+	while ((s = loadState(slot)) != state) {
+		if (waitWhile(slot, s, tm) == s) return false;
+	}
+	return true;
+}
+
+///Notifies server about new request
+static void notifyServer(ProgInstanceBuffer *buffer) {
+	__atomic_add_fetch(&buffer->requestSeq, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&buffer->serverWaiting, __ATOMIC_SEQ_CST))
+		futexWake(&buffer->requestSeq);
+}
+
+///Allocates free slot
+/** Slots are allocated without locking. Slots held by dead clients are released */
+static ProgInstanceSlot *allocSlot(ProgInstanceBuffer *buffer, const Timeout &tm) {
+	int pid = getpid();
+	for(;;) {
+		natural start = (unsigned int)__atomic_fetch_add(&buffer->allocHint, 1, __ATOMIC_RELAXED);
+		for (natural i = 0; i < buffer->slotCount; i++) {
+			ProgInstanceSlot *slot = buffer->getSlot((start + i) % buffer->slotCount);
+			if (loadState(slot) == slotFree && changeState(slot, slotFree, slotWriting)) {
+				//until the pid is stored, the sweep below ignores the slot
+				__atomic_store_n(&slot->clientPid, pid, __ATOMIC_RELEASE);
+				return slot;
+			}
+		}
+		//no free slot - release slots which are owned by dead clients
+		for (natural i = 0; i < buffer->slotCount; i++) {
+			ProgInstanceSlot *slot = buffer->getSlot(i);
+			int s = loadState(slot);
+			if (s != slotWriting && s != slotRequestAck && s != slotReply) continue;
+			int cpid = __atomic_load_n(&slot->clientPid, __ATOMIC_ACQUIRE);
+			//zero pid - slot is being allocated or released
+			if (cpid == 0 || kill(cpid, 0) == 0 || errno != ESRCH) continue;
+			//clearing the pid fails, if the slot has been reallocated meanwhile
+			if (__atomic_compare_exchange_n(&slot->clientPid, &cpid, 0, false,
+					__ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+				changeState(slot, s, slotFree);
+		}
+		if (tm.expired()) throw ProgInstance::TimeoutException(THISLOCATION);
+		usleep(1000);
+	}
+}
+
+///Client gives up the slot
+/** If server currently owns the slot, slot is marked abandoned and server releases it */
+static void abandonSlot(ProgInstanceSlot *slot) {
+	__atomic_store_n(&slot->clientPid, 0, __ATOMIC_RELAXED);
+	for(;;) {
+		int s = loadState(slot);
+		switch (s) {
+		case slotWriting:
+		case slotRequest:
+		case slotRequestAck:
+		case slotReply:
+			if (changeState(slot, s, slotFree)) return;
+			break;
+		case slotProcessing:
+		case slotReplyAck:
+			if (changeState(slot, s, slotAbandoned)) return;
+			break;
+		default:
+			return;
+		}
+	}
+}
+
 
 ProgInstance::ProgInstance(const String &name):name(name) {
 	buffer = 0;
+	curSlot = naturalNull;
 	initializeStartTime();
 }
 
 ProgInstance::ProgInstance(const ProgInstance &other):name(other.name) {
 	buffer = 0;
+	curSlot = naturalNull;
 	initializeStartTime();
 }
 
@@ -87,9 +308,7 @@ ProgInstance::~ProgInstance() {
 
 void ProgInstance::create()
 {
-	long pgsize = sysconf(_SC_PAGESIZE);
-	long requestSize = pgsize - sizeof(ProgInstanceBuffer);
-	return create(requestSize);
+	return create(defaultMessageSize);
 }
 
 void ProgInstance::open()
@@ -103,6 +322,10 @@ void ProgInstance::open()
 		::close(fd);
 		throw ErrNoException(THISLOCATION, errno);
 	}
+	if ((natural)statbuf.st_size < sizeof(ProgInstanceBuffer)) {
+		::close(fd);
+		throw NotRunningException(THISLOCATION);
+	}
 
 	void *mb = mmap(0,statbuf.st_size,PROT_WRITE|PROT_READ,MAP_SHARED,fd,0);
 	::close(fd);
@@ -110,7 +333,10 @@ void ProgInstance::open()
 		throw ErrNoException(THISLOCATION, errno);
 
 	ProgInstanceBuffer *buf = reinterpret_cast<ProgInstanceBuffer *>(mb);
-	if (kill(buf->pid,0) != 0) {
+	//file created by incompatible version is treated as not running
+	if (kill(buf->pid,0) != 0 || buf->magic != progInstanceMagic
+			|| buf->size != (natural)statbuf.st_size) {
+		munmap(mb,statbuf.st_size);
 		throw NotRunningException(THISLOCATION);
 	}
 
@@ -122,15 +348,11 @@ bool ProgInstance::anyRequest()
 	//not initialized - error
 	if (buffer == 0)
 		throw NotInitialized(THISLOCATION);
-	//try to wait for semaphore
-	if (sem_trywait(&buffer->semRequest)) {
-		//if not success - probably no request
-		return false;
+	for (natural i = 0; i < buffer->slotCount; i++) {
+		ProgInstanceSlot *slot = buffer->getSlot(i);
+		if (loadState(slot) == slotRequest && slot->chunkOffset == 0) return true;
 	}
-	//successed, but we don't want to accept request now - post the semaphore
-	sem_post(&buffer->semRequest);
-	return true;
-
+	return false;
 }
 
 bool ProgInstance::check() const {
@@ -143,39 +365,41 @@ bool ProgInstance::check() const {
 	return svc.canOpenFile(path,IFileIOServices::fileOpenReadWrite);
 }
 
-static void sem_throwException(const ProgramLocation &loc, int err) {
-	if (err == EINTR) throw ProgInstance::InterruptedWaitingException(loc,err);
-	else throw ErrNoException(loc,err);
-}
-
-static bool sem_wait(sem_t &sem,natural timeout) {
-
-	if (timeout == naturalNull) {
-		if (sem_wait(&sem)) {
-			sem_throwException(THISLOCATION, errno);
-		} return true;
-	}
-
-	struct timeval tmval;
-	gettimeofday(&tmval,0);
-	tmval.tv_usec += (timeout % 1000)*1000;
-	tmval.tv_sec += timeout / 1000;
-	if (tmval.tv_usec >= 1000000) {
-		tmval.tv_sec++;
-		tmval.tv_usec -= 1000000;
+///Receives rest of the request into the buffer
+/**
+ * @param buffer instance buffer
+ * @param slot slot in state slotProcessing, first chunk is ready
+ * @param target buffer for request
+ * @retval true request received, slot stays in state slotProcessing
+ * @retval false client gave up the request
+ */
+static bool receiveRequest(ProgInstanceBuffer *buffer, ProgInstanceSlot *slot, AutoArray<byte> &target) {
+	natural total = slot->totalSize;
+	if (total > buffer->requestSize) {
+		//invalid request, client will receive timeout
+		setState(slot, slotAbandoned);
+		return false;
 	}
-
-	struct timespec tmspec;
-	tmspec.tv_sec = tmval.tv_sec;
-	tmspec.tv_nsec = tmval.tv_usec * 1000;
-
-	int i = sem_timedwait(&sem,&tmspec);
-	if (i == -1) {
-		int e = errno;
-		if (e == EAGAIN || e==ETIMEDOUT) return false;
-		else sem_throwException(THISLOCATION,errno);
+	for(;;) {
+		natural ofs = slot->chunkOffset;
+		natural sz = slot->chunkSize;
+		if (ofs + sz > total || sz > buffer->slotDataSize) {
+			setState(slot, slotAbandoned);
+			return false;
+		}
+		memcpy(target.data() + ofs, slot->data, sz);
+		if (ofs + sz >= total) return true;
+		if (!changeState(slot, slotProcessing, slotRequestAck)) {
+			//abandoned
+			releaseSlot(slot);
+			return false;
+		}
+		Timeout tm(SysTime::now(), chunkTimeout);
+		//client can also release the slot while we are waiting
+		if (waitWhile(slot, slotRequestAck, tm) != slotRequest
+				|| !changeState(slot, slotRequest, slotProcessing))
+			return false;
 	}
-	return true;
 }
 
 void *ProgInstance::waitForRequest(natural timeout)
@@ -184,17 +408,49 @@ void *ProgInstance::waitForRequest(natural timeout)
 	if (buffer == 0)
 		throw NotInitialized(THISLOCATION);
 
-	if (sem_wait(buffer->semRequest,timeout)) {
-		if (buffer->curRequestSize == 0) {
-			sendReply(0,0);
-			return 0;
+	//expiration is computed only for finite timeout, null means infinite
+	timespec expire;
+	const timespec *expirePtr = 0;
+	if (timeout != naturalNull) {
+		expire = (SysTime::now() + SysTime(0,0,0,0,timeout)).getTimeSpec();
+		expirePtr = &expire;
+	}
+	if (curRequest.length() != buffer->requestSize)
+		curRequest.resize(buffer->requestSize);
+	natural nextSlot = 0;
+	bool expired = false;
+	for(;;) {
+		if (__atomic_exchange_n(&buffer->cancelFlag, 0, __ATOMIC_SEQ_CST)) break;
+		__atomic_store_n(&buffer->serverWaiting, 1, __ATOMIC_SEQ_CST);
+		int seq = __atomic_load_n(&buffer->requestSeq, __ATOMIC_SEQ_CST);
+		//search for new request, continue where previous search stopped
+		for (natural i = 0; i < buffer->slotCount; i++) {
+			natural idx = (nextSlot + i) % buffer->slotCount;
+			ProgInstanceSlot *slot = buffer->getSlot(idx);
+			int s = loadState(slot);
+			if (s == slotAbandoned) {
+				releaseSlot(slot);
+			} else if (s == slotRequest && slot->chunkOffset == 0
+					&& changeState(slot, slotRequest, slotProcessing)) {
+				nextSlot = idx + 1;
+				if (receiveRequest(buffer, slot, curRequest)) {
+					__atomic_store_n(&buffer->serverWaiting, 0, __ATOMIC_RELAXED);
+					curSlot = idx;
+					return curRequest.data();
+				}
+			}
 		}
-		else {
-			return buffer->data;
+		//slots are searched once more after the timeout
+		if (expired) break;
+		if (futexWait(&buffer->requestSeq, seq, expirePtr) == -1) {
+			int e = errno;
+			if (e == ETIMEDOUT) expired = true;
+			else if (e != EAGAIN && e != EINTR)
+				throw ErrNoException(THISLOCATION, e);
 		}
-	} else {
-		return 0;
 	}
+	__atomic_store_n(&buffer->serverWaiting, 0, __ATOMIC_RELAXED);
+	return 0;
 }
 
 natural ProgInstance::getReplyMaxSize()
@@ -207,37 +463,46 @@ natural ProgInstance::getReplyMaxSize()
 }
 
 void ProgInstance::create(natural requestMaxSize)
+{
+	create(requestMaxSize, defaultSlotCount);
+}
+
+void ProgInstance::create(natural requestMaxSize, natural slotCount)
 {
 
 	StringA namea = name.getUtf8();
 	if (buffer != 0) return;
-	natural totalSize = requestMaxSize + sizeof(ProgInstanceBuffer);
+	if (slotCount == 0) slotCount = 1;
+	natural slotOffset = (sizeof(ProgInstanceBuffer) + 63) & ~(natural)63;
+	natural totalSize = slotOffset + slotCount * slotStride;
 	int fd = ::open(namea.c_str(),O_RDWR);
 	if (fd != -1) {
 
-		void *mb = mmap(0,sizeof(ProgInstanceBuffer),PROT_READ,MAP_SHARED,fd,0);
-		::close(fd);
-		if (mb == MAP_FAILED)
-			throw ErrNoException(THISLOCATION,errno);
-
-		ProgInstanceBuffer *buf = reinterpret_cast<ProgInstanceBuffer *>(mb);
-		if (kill(buf->pid,0) == 0) {
-			throw AlreadyRunningException(THISLOCATION,buf->pid);
+		struct stat statbuf;
+		if (fstat(fd,&statbuf) == 0 && (natural)statbuf.st_size >= sizeof(pid_t)) {
+			void *mb = mmap(0,sizeof(pid_t),PROT_READ,MAP_SHARED,fd,0);
+			::close(fd);
+			if (mb == MAP_FAILED)
+				throw ErrNoException(THISLOCATION,errno);
+
+			pid_t pid = *reinterpret_cast<pid_t *>(mb);
+			munmap(mb,sizeof(pid_t));
+			if (kill(pid,0) == 0) {
+				throw AlreadyRunningException(THISLOCATION,pid);
+			}
+		} else {
+			::close(fd);
 		}
-
-		munmap(mb,sizeof(ProgInstanceBuffer));
 		unlink(namea.c_str());
 	}
 	fd = ::open(namea.c_str(),O_RDWR | O_CREAT | O_EXCL, S_IRUSR|S_IWUSR );
 	if (fd == -1)
 		throw ErrNoException(THISLOCATION,errno);
 
-	char prebuf[256];
-	natural cursize = 0;
-	while (cursize < totalSize) {
-		natural c = (totalSize - cursize) > 256?256:(totalSize - cursize);
-		natural n = write(fd,prebuf,c);
-		cursize +=n;
+	if (ftruncate(fd,totalSize) != 0) {
+		int e = errno;
+		::close(fd);
+		throw ErrNoException(THISLOCATION,e);
 	}
 
 	void *mb = mmap(0,totalSize,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
@@ -247,66 +512,67 @@ void ProgInstance::create(natural requestMaxSize)
 
 	buffer =reinterpret_cast<ProgInstanceBuffer *>(mb);
 
-
+	//file is filled by zeroes, so all slots are free
 	buffer->requestSize = requestMaxSize;
-	buffer->pid = getpid();
+	buffer->slotCount = slotCount;
+	buffer->slotOffset = slotOffset;
+	buffer->slotDataSize = slotStride - offsetof(ProgInstanceSlot, data);
 	buffer->tid = pthread_self();
 	buffer->owner = this;
-	sem_init(&buffer->semAccess,1,1);
-	sem_init(&buffer->semRequest,1,0);
-	sem_init(&buffer->semReply,1,0);
-	sem_init(&buffer->semInProgress,1,1);
 	buffer->size = totalSize;
 	buffer->indaemon = false;
+	buffer->magic = progInstanceMagic;
+	__atomic_store_n(&buffer->pid, getpid(), __ATOMIC_RELEASE);
 }
 
 natural ProgInstance::request(const void *req, natural reqsize, void *reply, natural replySize,natural timeout)
 {
 	if (buffer == 0) throw NotInitialized(THISLOCATION);
 	if (reqsize > buffer->requestSize) throw RequestTooLarge(THISLOCATION);
-	//wait for accessing the buffer
-	//there can be another client waiting for reply.
-	//check for timeout and throw exception, if operation takes long
-	if (!sem_wait(buffer->semAccess,timeout)) throw TimeoutException(THISLOCATION);
+	Timeout tm(SysTime::now(), timeout);
+	//there can be another clients, wait for free slot
+	ProgInstanceSlot *slot = allocSlot(buffer, tm);
 	try {
-		//for placing request, we must also lock the buffer
-		//because there can be also server, which currently processing
-		//the request of client, which previously given up the waiting
-		if (!sem_wait(buffer->semInProgress,timeout))
-			throw TimeoutException(THISLOCATION);
-		//reset any stored requests, we did not placed any yet
-		while (sem_trywait(&buffer->semRequest) == 0) {}
-		//reset any stored reply, we don't expect any yet
-		while (sem_trywait(&buffer->semReply) == 0) {}
-		//all semaphores reset and no one has chance to change this
-		//now place the request data
-		memcpy(buffer->data, req, reqsize);
-		//set request size
-		buffer->curRequestSize = reqsize;
-		//release semInProgress, we don't need access the buffer anymore
-		sem_post(&buffer->semInProgress);
-		//notify server, that request is available
-		sem_post(&buffer->semRequest);
-		//now, wait for reply
-		if (!sem_wait(buffer->semReply,timeout))
-			//in case of timeout, we give up
-			//any semaphore state leaved, this is job of next client
-						throw TimeoutException(THISLOCATION);
-		//check reply size
-		if (buffer->curRequestSize > replySize) throw ReplyTooLarge(THISLOCATION);
-		//we can get data now, without need locking
-		//because server did not access the buffer until new request is placed
-		//and no-one can accesss the buffer now
-		memcpy(reply,buffer->data, buffer->curRequestSize);
-		natural result = buffer->curRequestSize;
-		//unlock the whole access to allow next client enter
-		sem_post(&buffer->semAccess);
-		//send result
-		return result;
+		const char *src = reinterpret_cast<const char *>(req);
+		natural pos = 0;
+		//send request in chunks, each chunk must be acknowledged by server
+		for(;;) {
+			natural sz = reqsize - pos;
+			if (sz > buffer->slotDataSize) sz = buffer->slotDataSize;
+			memcpy(slot->data, src + pos, sz);
+			slot->totalSize = reqsize;
+			slot->chunkOffset = pos;
+			slot->chunkSize = sz;
+			pos += sz;
+			setState(slot, slotRequest);
+			if (pos == sz) notifyServer(buffer);
+			if (pos >= reqsize) break;
+			if (!waitFor(slot, slotRequestAck, tm))
+				throw TimeoutException(THISLOCATION);
+		}
+		//receive reply in chunks
+		char *trg = reinterpret_cast<char *>(reply);
+		natural total;
+		for(;;) {
+			if (!waitFor(slot, slotReply, tm))
+				throw TimeoutException(THISLOCATION);
+			total = slot->totalSize;
+			if (total > replySize) throw ReplyTooLarge(THISLOCATION);
+			natural ofs = slot->chunkOffset;
+			natural sz = slot->chunkSize;
+			//chunk is described by the shared memory, check it as the server does
+			if (sz > buffer->slotDataSize || ofs > total || sz > total - ofs)
+				throw ErrNoException(THISLOCATION, EPROTO);
+			memcpy(trg + ofs, slot->data, sz);
+			if (ofs + sz >= total) break;
+			setState(slot, slotReplyAck);
+		}
+		releaseSlot(slot);
+		return total;
 	} catch (...) {
 		//in case of any exception
-		//release access lock
-		sem_post(&buffer->semAccess);
+		//release the slot or leave it to the server
+		abandonSlot(slot);
 		//rethrow exception
 		throw;
 	}
@@ -323,23 +589,40 @@ void *ProgInstance::acceptRequest()
 {
 	if (buffer == 0) return 0;
 	///test, whether there is request
-	if (sem_trywait(&buffer->semRequest)) return 0;
-	///if there is request, lock the buffer
-	::sem_wait(&buffer->semInProgress);
-	///not, we can work with the data
-	return buffer->data;
+	if (!anyRequest()) return 0;
+	///if there is request, receive it without waiting
+	return waitForRequest(0);
 }
 
 void ProgInstance::sendReply(const void *data, natural sz)
 {
 	if (buffer == 0) throw NotInitialized(THISLOCATION);
 	if (sz > buffer->requestSize) throw ReplyTooLarge(THISLOCATION);
-	memcpy(buffer->data,data,sz);
-	buffer->curRequestSize = sz;
-	///unlock the buffer
-	sem_post(&buffer->semInProgress);
-	///trigger reply
-	sem_post(&buffer->semReply);
+	if (curSlot == naturalNull) return;
+	ProgInstanceSlot *slot = buffer->getSlot(curSlot);
+	curSlot = naturalNull;
+	const char *src = reinterpret_cast<const char *>(data);
+	natural pos = 0;
+	int expect = slotProcessing;
+	for(;;) {
+		natural csz = sz - pos;
+		if (csz > buffer->slotDataSize) csz = buffer->slotDataSize;
+		memcpy(slot->data, src + pos, csz);
+		slot->totalSize = sz;
+		slot->chunkOffset = pos;
+		slot->chunkSize = csz;
+		pos += csz;
+		if (!changeState(slot, expect, slotReply)) {
+			//client gave up
+			releaseSlot(slot);
+			return;
+		}
+		if (pos >= sz) return;
+		Timeout tm(SysTime::now(), chunkTimeout);
+		//if client is gone, it will release the slot itself
+		if (waitWhile(slot, slotReply, tm) != slotReplyAck) return;
+		expect = slotReplyAck;
+	}
 }
 
 void ProgInstance::close() {
@@ -355,17 +638,15 @@ void ProgInstance::close() {
 
 
 void *ProgInstance::getReplyBuffer() {
-	return buffer->data;
+	if (curRequest.length() != buffer->requestSize)
+		curRequest.resize(buffer->requestSize);
+	return curRequest.data();
 }
 void ProgInstance::sendReply(natural sz)
 {
 	if (buffer == 0) throw NotInitialized(THISLOCATION);
 	if (sz > buffer->requestSize) throw ReplyTooLarge(THISLOCATION);
-	buffer->curRequestSize = sz;
-	//unlick the buffer
-	sem_post(&buffer->semInProgress);
-	//trigger reply
-	sem_post(&buffer->semReply);
+	sendReply(curRequest.data(),sz);
 }
 
 
@@ -444,7 +725,8 @@ void ProgInstance::InterruptedWaitingException::message(ExceptionMsg &msg) const
 void ProgInstance::cancelWaitForRequest() {
 	if (buffer == 0) throw NotInitialized(THISLOCATION);
 	if (pthread_self() == buffer->tid) return;
-	request(0,0,0,0,0);
+	__atomic_store_n(&buffer->cancelFlag, 1, __ATOMIC_SEQ_CST);
+	notifyServer(buffer);
 }
 
 bool ProgInstance::inDaemonMode() const {
@@ -0,0 +1,458 @@
+/*
+ * shmRingStream.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "shmRingStream.h"
+#include "../../mt/atomic.h"
+#include "../exceptions/netExceptions.h"
+#include "../interface.tcc"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 1
+#endif
+
+namespace LightSpeed {
+
+static const natural cacheLine = 64;
+
+///Header of the ring in the shared memory
+/** Positions are not wrapped, they only grow. Each counter has own cache line */
+struct LinuxShmRingStream::Header {
+	///position of the writer, changed by the writer only
+	atomic writePos;
+	byte pad1[cacheLine - sizeof(atomic)];
+	///position of the reader, changed by the reader only
+	atomic readPos;
+	byte pad2[cacheLine - sizeof(atomic)];
+	///reader is going to sleep, writer has to signal the eventfd
+	atomic readerWaiting;
+	///reader is monitored by poller, writer has to signal every write
+	atomic readerMonitored;
+	///writer is going to sleep, reader has to signal the eventfd
+	atomic writerWaiting;
+	///writer closed output
+	atomic closed;
+	byte pad3[cacheLine - 4 * sizeof(atomic)];
+};
+
+///Message sent through control stream along with descriptors
+struct ShmRingHandshake {
+	Bin::natural32 magic;
+	Bin::natural32 ringSize;
+};
+
+static const Bin::natural32 shmRingMagic = 0x4C53524E;
+///memfd and four eventfds
+static const natural shmRingHandles = 5;
+///minimal size of the ring
+static const natural minRingSize = 4096;
+
+///count of checks before thread waits for event. Spinning has no sense on single CPU
+static natural getShmSpinCount() {
+	static natural spins = sysconf(_SC_NPROCESSORS_ONLN) > 1?2000:0;
+	return spins;
+}
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#endif
+}
+
+static natural monotonicMs() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (natural)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static natural roundRingSize(natural size) {
+	natural r = minRingSize;
+	while (r < size) r <<= 1;
+	return r;
+}
+
+LinuxShmRingStream::LinuxShmRingStream(PNetworkStream control, bool passive, natural ringSize, natural timeout)
+	:control(control),controlSock(-1),shmBase(0),shmSize(0),ringSize(0)
+	,foundEof(false),peerGone(false),outputClosed(false),monitored(false)
+{
+	rx.hdr = tx.hdr = 0;
+	rx.data = tx.data = 0;
+	rx.dataEvent = rx.spaceEvent = tx.dataEvent = tx.spaceEvent = -1;
+	setTimeout(timeout);
+	controlSock = (int)control->getIfc<INetworkSocket>().getSocket(0);
+	try {
+		if (passive) createShm(ringSize);
+		else openShm();
+	} catch (...) {
+		if (shmBase) munmap(shmBase,shmSize);
+		int fds[4] = {rx.dataEvent, rx.spaceEvent, tx.dataEvent, tx.spaceEvent};
+		for (natural i = 0; i < 4; i++) if (fds[i] != -1) ::close(fds[i]);
+		throw;
+	}
+}
+
+LinuxShmRingStream::~LinuxShmRingStream() {
+	closeOutput();
+	munmap(shmBase,shmSize);
+	::close(rx.dataEvent);
+	::close(rx.spaceEvent);
+	::close(tx.dataEvent);
+	::close(tx.spaceEvent);
+}
+
+void LinuxShmRingStream::createShm(natural size) {
+	size = roundRingSize(size);
+	int memfd = (int)syscall(SYS_memfd_create, "lightspeed-shmring", MFD_CLOEXEC);
+	if (memfd == -1)
+		throw NetworkIOError(THISLOCATION,errno,"memfd_create failed");
+	int fds[shmRingHandles] = {memfd, -1, -1, -1, -1};
+	try {
+		if (ftruncate(memfd, getShmSize(size)) == -1)
+			throw NetworkIOError(THISLOCATION,errno,"ftruncate failed");
+		for (natural i = 1; i < shmRingHandles; i++) {
+			fds[i] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+			if (fds[i] == -1)
+				throw NetworkIOError(THISLOCATION,errno,"eventfd failed");
+		}
+		ringSize = size;
+		mapRings(memfd, true, fds + 1);
+		ShmRingHandshake msg;
+		msg.magic = shmRingMagic;
+		msg.ringSize = (Bin::natural32)size;
+		integer handles[shmRingHandles];
+		for (natural i = 0; i < shmRingHandles; i++) handles[i] = fds[i];
+		control->getIfc<INetworkHandlePassing>().sendHandles(&msg, sizeof(msg), handles, shmRingHandles);
+	} catch (...) {
+		//eventfds are closed by the caller once they are mapped
+		if (tx.hdr == 0)
+			for (natural i = 1; i < shmRingHandles; i++) if (fds[i] != -1) ::close(fds[i]);
+		::close(memfd);
+		throw;
+	}
+	::close(memfd);
+}
+
+void LinuxShmRingStream::openShm() {
+	ShmRingHandshake msg;
+	integer handles[shmRingHandles];
+	natural count = shmRingHandles;
+	natural rd = control->getIfc<INetworkHandlePassing>().receiveHandles(&msg, sizeof(msg), handles, count);
+	int fds[shmRingHandles];
+	for (natural i = 0; i < count; i++) fds[i] = (int)handles[i];
+	try {
+		if (rd != sizeof(msg) || count != shmRingHandles || msg.magic != shmRingMagic
+				|| msg.ringSize < minRingSize || (msg.ringSize & (msg.ringSize - 1)) != 0)
+			throw NetworkIOError(THISLOCATION,EPROTO,"shared memory handshake failed");
+		struct stat st;
+		if (fstat(fds[0],&st) == -1 || (natural)st.st_size < getShmSize(msg.ringSize))
+			throw NetworkIOError(THISLOCATION,EPROTO,"shared memory handshake failed");
+		ringSize = msg.ringSize;
+		mapRings(fds[0], false, fds + 1);
+	} catch (...) {
+		if (tx.hdr == 0)
+			for (natural i = 1; i < count; i++) ::close(fds[i]);
+		if (count) ::close(fds[0]);
+		throw;
+	}
+	::close(fds[0]);
+}
+
+void LinuxShmRingStream::mapRings(int memfd, bool passive, const int *events) {
+	natural sz = getShmSize(ringSize);
+	void *p = mmap(0, sz, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+	if (p == MAP_FAILED)
+		throw NetworkIOError(THISLOCATION,errno,"mmap failed");
+	shmBase = p;
+	shmSize = sz;
+	//ring 0 is written by the passive side, ring 1 by the active side
+	Ring r[2];
+	for (natural i = 0; i < 2; i++) {
+		byte *b = reinterpret_cast<byte *>(p) + i * (sizeof(Header) + ringSize);
+		r[i].hdr = reinterpret_cast<Header *>(b);
+		r[i].data = b + sizeof(Header);
+		r[i].dataEvent = events[i * 2];
+		r[i].spaceEvent = events[i * 2 + 1];
+	}
+	tx = r[passive?0:1];
+	rx = r[passive?1:0];
+}
+
+//positions are in the memory shared with the peer, they cannot be trusted
+natural LinuxShmRingStream::getAvail() const {
+	natural avail = (natural)(readAcquire(&rx.hdr->writePos) - rx.hdr->readPos);
+	if (avail > ringSize)
+		throw NetworkIOError(THISLOCATION,EPROTO,"shared memory ring is corrupted");
+	return avail;
+}
+
+natural LinuxShmRingStream::getUsed() const {
+	natural used = (natural)(tx.hdr->writePos - readAcquire(&tx.hdr->readPos));
+	if (used > ringSize)
+		throw NetworkIOError(THISLOCATION,EPROTO,"shared memory ring is corrupted");
+	return used;
+}
+
+natural LinuxShmRingStream::checkReady(natural waitFor) const {
+	natural res = 0;
+	if ((waitFor & waitForInput)
+			&& (getAvail() || readAcquire(&rx.hdr->closed) || peerGone))
+		res |= waitForInput;
+	if ((waitFor & waitForOutput)
+			&& (peerGone || outputClosed
+				|| getUsed() < ringSize))
+		res |= waitForOutput;
+	return res;
+}
+
+natural LinuxShmRingStream::getShmSize(natural ringSize) {
+	return 2 * (sizeof(Header) + ringSize);
+}
+
+void LinuxShmRingStream::signalEvent(int fd) {
+	eventfd_t v = 1;
+	::write(fd, &v, sizeof(v));
+}
+
+void LinuxShmRingStream::drainEvent(int fd) {
+	eventfd_t v;
+	::read(fd, &v, sizeof(v));
+}
+
+natural LinuxShmRingStream::doWait(natural waitFor, natural timeout) const {
+	if (waitFor == 0) waitFor = waitForInput;
+	natural r = checkReady(waitFor);
+	if (r) return r;
+	natural spins = getShmSpinCount();
+	for (natural i = 0; i < spins; i++) {
+		cpuRelax();
+		r = checkReady(waitFor);
+		if (r) return r;
+	}
+	if (timeout == 0) return waitTimeout;
+	natural deadline = timeout == naturalNull?naturalNull:monotonicMs() + timeout;
+	while (true) {
+		//announce waiting, then check again - writer checks flags after it publishes data
+		if (waitFor & waitForInput) lockExchange(rx.hdr->readerWaiting, 1);
+		if (waitFor & waitForOutput) lockExchange(tx.hdr->writerWaiting, 1);
+		r = checkReady(waitFor);
+		int res = 0;
+		struct pollfd pfd[3];
+		if (r == 0) {
+			nfds_t n = 0;
+			pfd[n].fd = controlSock;
+			pfd[n].events = POLLIN;
+			pfd[n++].revents = 0;
+			if (waitFor & waitForInput) {
+				pfd[n].fd = rx.dataEvent;
+				pfd[n].events = POLLIN;
+				pfd[n++].revents = 0;
+			}
+			if (waitFor & waitForOutput) {
+				pfd[n].fd = tx.spaceEvent;
+				pfd[n].events = POLLIN;
+				pfd[n++].revents = 0;
+			}
+			int tm = -1;
+			if (deadline != naturalNull) {
+				natural now = monotonicMs();
+				tm = now >= deadline?0:(int)(deadline - now);
+			}
+			res = poll(pfd, n, tm);
+			if (res == -1 && errno != EINTR)
+				throw NetworkIOError(THISLOCATION,errno,"poll failed");
+			if (res > 0) {
+				//control stream carries no data after handshake, any event means hangup
+				if (pfd[0].revents) peerGone = true;
+				for (nfds_t i = 1; i < n; i++)
+					if (pfd[i].revents & POLLIN) drainEvent(pfd[i].fd);
+			}
+			r = checkReady(waitFor);
+		}
+		if (waitFor & waitForInput) writeRelease(&rx.hdr->readerWaiting, 0);
+		if (waitFor & waitForOutput) writeRelease(&tx.hdr->writerWaiting, 0);
+		if (r) return r;
+		if (res == 0) return waitTimeout;
+	}
+}
+
+void LinuxShmRingStream::copyFromRing(void *buffer, natural pos, natural size) const {
+	natural offs = pos & (ringSize - 1);
+	natural part = ringSize - offs;
+	if (part >= size) {
+		memcpy(buffer, rx.data + offs, size);
+	} else {
+		memcpy(buffer, rx.data + offs, part);
+		memcpy(reinterpret_cast<byte *>(buffer) + part, rx.data, size - part);
+	}
+}
+
+natural LinuxShmRingStream::read(void *buffer, natural size) {
+	if (foundEof || size == 0) return 0;
+	while (true) {
+		natural avail = getAvail();
+		if (avail) {
+			natural sz = avail < size?avail:size;
+			natural pos = rx.hdr->readPos;
+			copyFromRing(buffer, pos, sz);
+			lockExchangeAdd(rx.hdr->readPos, (atomicValue)sz);
+			if (readAcquire(&rx.hdr->writerWaiting)) signalEvent(rx.spaceEvent);
+			if (monitored) {
+				//keep eventfd readable while there are data for the poller
+				drainEvent(rx.dataEvent);
+				if (getAvail()) signalEvent(rx.dataEvent);
+			}
+			return sz;
+		}
+		if (readAcquire(&rx.hdr->closed) || peerGone) {
+			if (getAvail()) continue;
+			foundEof = true;
+			return 0;
+		}
+		if (!wait(waitForInput))
+			throw NetworkTimeoutException(THISLOCATION,getTimeout(),
+						NetworkTimeoutException::reading);
+	}
+}
+
+natural LinuxShmRingStream::peek(void *buffer, natural size) const {
+	if (foundEof || size == 0) return 0;
+	while (true) {
+		natural avail = getAvail();
+		if (avail) {
+			natural sz = avail < size?avail:size;
+			copyFromRing(buffer, rx.hdr->readPos, sz);
+			return sz;
+		}
+		if (readAcquire(&rx.hdr->closed) || peerGone) {
+			if (getAvail()) continue;
+			foundEof = true;
+			return 0;
+		}
+		if (!wait(waitForInput))
+			throw NetworkTimeoutException(THISLOCATION,getTimeout(),
+						NetworkTimeoutException::reading);
+	}
+}
+
+natural LinuxShmRingStream::write(const void *buffer, natural size) {
+	if (size == 0) return 0;
+	while (true) {
+		if (outputClosed || peerGone)
+			throw NetworkIOError(THISLOCATION,EPIPE,"write failed - connection closed");
+		natural wpos = tx.hdr->writePos;
+		natural space = ringSize - getUsed();
+		if (space) {
+			natural sz = space < size?space:size;
+			natural offs = wpos & (ringSize - 1);
+			natural part = ringSize - offs;
+			if (part >= sz) {
+				memcpy(tx.data + offs, buffer, sz);
+			} else {
+				memcpy(tx.data + offs, buffer, part);
+				memcpy(tx.data, reinterpret_cast<const byte *>(buffer) + part, sz - part);
+			}
+			//full barrier - reader announces waiting before it checks position
+			lockExchangeAdd(tx.hdr->writePos, (atomicValue)sz);
+			if (readAcquire(&tx.hdr->readerWaiting) || readAcquire(&tx.hdr->readerMonitored))
+				signalEvent(tx.dataEvent);
+			return sz;
+		}
+		if (!wait(waitForOutput))
+			throw NetworkTimeoutException(THISLOCATION,getTimeout(),
+						NetworkTimeoutException::writing);
+	}
+}
+
+bool LinuxShmRingStream::canRead() const {
+	if (foundEof) return false;
+	if (getAvail()) return true;
+	if (wait(waitForInput) & waitForInput) {
+		return getAvail() != 0;
+	} else {
+		throw NetworkTimeoutException(THISLOCATION,getTimeout(),NetworkTimeoutException::reading);
+	}
+}
+
+bool LinuxShmRingStream::canWrite() const {
+	return !outputClosed;
+}
+
+natural LinuxShmRingStream::dataReady() const {
+	if (foundEof) return 1;
+	natural avail = getAvail();
+	if (avail) return avail;
+	if (readAcquire(&rx.hdr->closed) || peerGone) return 1;
+	return 0;
+}
+
+void LinuxShmRingStream::closeOutput() {
+	if (outputClosed) return;
+	outputClosed = true;
+	lockExchange(tx.hdr->closed, 1);
+	signalEvent(tx.dataEvent);
+}
+
+integer LinuxShmRingStream::getSocket(int index) const {
+	if (index == 0) {
+		if (!monitored) {
+			monitored = true;
+			lockExchange(rx.hdr->readerMonitored, 1);
+			//data written before monitoring started
+			if (getAvail() || readAcquire(&rx.hdr->closed)) signalEvent(rx.dataEvent);
+		}
+		return rx.dataEvent;
+	} else if (index == 1) {
+		return controlSock;
+	} else {
+		return -1;
+	}
+}
+
+
+LinuxShmRingStreamSource::LinuxShmRingStreamSource(PNetworkStreamSource local, bool passive, natural ringSize)
+	:local(local),passive(passive),ringSize(ringSize) {
+	setTimeout(local->getTimeout());
+}
+
+bool LinuxShmRingStreamSource::hasItems() const {
+	return local->hasItems();
+}
+
+PNetworkStream LinuxShmRingStreamSource::getNext() {
+	PNetworkStream s = local->getNext();
+	return new LinuxShmRingStream(s, passive, ringSize, s->getTimeout());
+}
+
+PNetworkAddress LinuxShmRingStreamSource::getPeerAddr() const {
+	return local->getPeerAddr();
+}
+
+PNetworkAddress LinuxShmRingStreamSource::getLocalAddr() const {
+	return local->getLocalAddr();
+}
+
+integer LinuxShmRingStreamSource::getSocket(int idx) const {
+	return local->getIfc<INetworkSocket>().getSocket(idx);
+}
+
+natural LinuxShmRingStreamSource::getDefaultWait() const {
+	return local->getDefaultWait();
+}
+
+natural LinuxShmRingStreamSource::doWait(natural waitFor, natural timeout) const {
+	return local->wait(waitFor, timeout);
+}
+
+}
@@ -0,0 +1,124 @@
+/*
+ * shmRingStream.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_LINUX_SHMRINGSTREAM_H_
+#define LIGHTSPEED_BASE_LINUX_SHMRINGSTREAM_H_
+#include "../streams/netio_ifc.h"
+
+namespace LightSpeed {
+
+
+///Network stream which transfers data through the ring buffers in the shared memory
+/**
+ * Stream is created over connected local socket (control stream). Passive side
+ * creates shared memory containing two single producer - single consumer rings and
+ * four eventfd descriptors and passes them to the active side. Control stream is
+ * then used only to detect, that other side has gone.
+ *
+ * Reader and writer don't make any system call while the other side is able to
+ * process data. Eventfd is signaled only when other side is waiting or when
+ * stream is monitored by the external poller.
+ */
+class LinuxShmRingStream: public NetworkResourceCommon<INetworkStream>, public INetworkSocket {
+public:
+	///Creates stream
+	/**
+	 * @param control connected local stream
+	 * @param passive true for passive side, which creates the shared memory
+	 * @param ringSize size of the ring (passive side only)
+	 * @param timeout default timeout
+	 */
+	LinuxShmRingStream(PNetworkStream control, bool passive, natural ringSize, natural timeout);
+	virtual ~LinuxShmRingStream();
+
+	virtual natural read(void *buffer,  natural size);
+	virtual natural write(const void *buffer,  natural size);
+	virtual natural peek(void *buffer, natural size) const;
+	virtual bool canRead() const;
+	virtual bool canWrite() const;
+	virtual void flush() {}
+	virtual natural dataReady() const;
+	virtual void closeOutput();
+	virtual natural getDefaultWait() const {return waitForInput;}
+	///Returns eventfd of input ring (index 0) and control socket (index 1)
+	/** Calling this function switches stream to monitored mode, where
+	 * writer signals every write.
+	 */
+	virtual integer getSocket(int index) const;
+
+	///Retrieves size of the ring
+	natural getRingSize() const {return ringSize;}
+
+protected:
+
+	struct Header;
+
+	struct Ring {
+		Header *hdr;
+		byte *data;
+		///eventfd signaled by the writer
+		int dataEvent;
+		///eventfd signaled by the reader
+		int spaceEvent;
+	};
+
+	PNetworkStream control;
+	int controlSock;
+	void *shmBase;
+	natural shmSize;
+	natural ringSize;
+	Ring rx, tx;
+	mutable bool foundEof;
+	mutable bool peerGone;
+	bool outputClosed;
+	mutable bool monitored;
+
+	virtual natural doWait(natural waitFor, natural timeout) const;
+
+	void createShm(natural ringSize);
+	void openShm();
+	void mapRings(int memfd, bool passive, const int *events);
+	natural checkReady(natural waitFor) const;
+	natural getAvail() const;
+	natural getUsed() const;
+	void copyFromRing(void *buffer, natural pos, natural size) const;
+	static natural getShmSize(natural ringSize);
+	static void signalEvent(int fd);
+	static void drainEvent(int fd);
+};
+
+
+///Stream source which creates LinuxShmRingStream over local streams
+class LinuxShmRingStreamSource: public NetworkResourceCommon<INetworkStreamSource>,
+								public INetworkSocket {
+public:
+	///Creates source
+	/**
+	 * @param local source of local streams (unix domain socket)
+	 * @param passive true if streams are accepted (passive side creates shared memory)
+	 * @param ringSize size of ring for each direction
+	 */
+	LinuxShmRingStreamSource(PNetworkStreamSource local, bool passive, natural ringSize);
+
+	virtual bool hasItems() const;
+	virtual PNetworkStream getNext();
+	virtual PNetworkAddress getPeerAddr() const;
+	virtual PNetworkAddress getLocalAddr() const;
+	virtual integer getSocket(int idx) const;
+	virtual natural getDefaultWait() const;
+
+protected:
+	PNetworkStreamSource local;
+	bool passive;
+	natural ringSize;
+
+	virtual natural doWait(natural waitFor, natural timeout) const;
+};
+
+}
+
+#endif /* LIGHTSPEED_BASE_LINUX_SHMRINGSTREAM_H_ */
@@ -4,6 +4,7 @@
 #include "staticAlloc.h"
 #include "../containers/autoArray.tcc"
 #include "../containers/avltreenode.tcc"
+#include "../framework/metrics.h"
 
 namespace LightSpeed {
 
@@ -11,6 +12,16 @@ static const natural allocClusterSize
 	= (sizeof(AllocCluster) + sizeof(natural) - 1) & (~(sizeof(natural) -1));
 
 
+//clusters can be created during the static initialisation of other files, so the allocator
+//updates zero-initialised variables and the metrics only read them
+static MetricCounter::Cells clusterCreatedCells;
+static MetricCounter::Cells clusterReleasedCells;
+static atomic clusterBytesValue = 0;
+
+static MetricCounter clusterCreated("lightspeed_clusteralloc_clusters_created_total","Count of clusters allocated by the cluster allocators",ConstStrA(),clusterCreatedCells);
+static MetricCounter clusterReleased("lightspeed_clusteralloc_clusters_released_total","Count of clusters released by the cluster allocators",ConstStrA(),clusterReleasedCells);
+static MetricGauge clusterBytes("lightspeed_clusteralloc_bytes","Memory held by clusters of the cluster allocators",ConstStrA(),clusterBytesValue);
+
 AllocCluster::AllocCluster(IRuntimeAlloc *alloc, IMaster *master, byte count, natural bksize)
 :AvlTreeNode<char>(0),llnext(0),owner(alloc),master(master),usedCount(0),firstFree(0),count(count)
 {
@@ -102,6 +113,8 @@ void AllocCluster::makeDealloc( void *ptr, natural bksize )
 void AllocCluster::destroy(natural bksize)
 {
 	natural s = getMemoryUsage(bksize);
+	clusterReleasedCells.add();
+	lockExchangeAdd(clusterBytesValue,-(integer)s);
 	IRuntimeAlloc &alloc = *owner;
 	this->~AllocCluster();
 	alloc.dealloc(this,s);	
@@ -131,6 +144,8 @@ void * AllocMulticluster::alloc(IRuntimeAlloc *&owner)
 {	
 	if (freeClusters == nil) {
 		AllocCluster *k = AllocCluster::create(rtalloc,this,nextCnt,bkSize);
+		clusterCreatedCells.add();
+		lockExchangeAdd(clusterBytesValue,(integer)k->getMemoryUsage(bkSize));
 		if (nextCnt < 255) nextCnt++;
 		allClusters.insert(k);
 		freeClusters = k;
@@ -0,0 +1,84 @@
+/*
+ * countingAlloc.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_MEMORY_COUNTINGALLOC_H_
+#define LIGHTSPEED_MEMORY_COUNTINGALLOC_H_
+
+#include "runtimeAlloc.h"
+#include "stdAlloc.h"
+#include "../../mt/atomic.h"
+
+namespace LightSpeed {
+
+	///Runtime allocator which counts allocations passed to another allocator
+	/**
+	 * Object acts as hook on IRuntimeAlloc. All requests are forwarded to the target
+	 * allocator, and the object only counts them. Counters are updated atomically,
+	 * so the object can be shared between threads.
+	 *
+	 * The object is used by benchmarks to report allocations per iteration, but
+	 * it can be used anywhere, where an allocator can be specified.
+	 */
+	class CountingAlloc: public IRuntimeAlloc {
+	public:
+
+		///Creates counter using StdAlloc as target
+		CountingAlloc():target(StdAlloc::getInstance()),allocCount(0),deallocCount(0),allocBytes(0) {}
+		///Creates counter for given allocator
+		CountingAlloc(IRuntimeAlloc &target):target(target),allocCount(0),deallocCount(0),allocBytes(0) {}
+
+		virtual void *alloc(natural objSize) {
+			void *p = target.alloc(objSize);
+			count(objSize);
+			return p;
+		}
+		virtual void *alloc(natural objSize, IRuntimeAlloc * &owner) {
+			//owner is chosen by the target, block may not be released by the target itself
+			void *p = target.alloc(objSize,owner);
+			count(objSize);
+			return p;
+		}
+		virtual void dealloc(void *ptr, natural objSize) {
+			target.dealloc(ptr,objSize);
+			lockIncNoBarrier(deallocCount);
+		}
+
+		virtual natural getObjectSize() const {return sizeof(CountingAlloc);}
+		virtual CountingAlloc *clone(IRuntimeAlloc &) const {throwUnsupportedFeature(THISLOCATION,this,"clone");return 0;}
+		virtual CountingAlloc *clone() const {throwUnsupportedFeature(THISLOCATION,this,"clone");return 0;}
+
+		///Retrieves count of allocations
+		natural getAllocCount() const {return readAcquire(&allocCount);}
+		///Retrieves count of deallocations
+		/** Counts only blocks released through this object. Blocks allocated
+		 * with the owner are released by the owner reported by the target */
+		natural getDeallocCount() const {return readAcquire(&deallocCount);}
+		///Retrieves total allocated bytes
+		natural getAllocBytes() const {return readAcquire(&allocBytes);}
+
+		///Resets all counters
+		void reset() {
+			writeRelease(&allocCount,0);
+			writeRelease(&deallocCount,0);
+			writeRelease(&allocBytes,0);
+		}
+
+	protected:
+		IRuntimeAlloc &target;
+		atomic allocCount;
+		atomic deallocCount;
+		atomic allocBytes;
+
+		void count(natural objSize) {
+			lockIncNoBarrier(allocCount);
+			lockExchangeAdd(allocBytes,(atomicValue)objSize);
+		}
+	};
+
+}
+
+#endif /* LIGHTSPEED_MEMORY_COUNTINGALLOC_H_ */
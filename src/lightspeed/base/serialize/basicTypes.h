@@ -6,6 +6,7 @@
 
 #include "../types.h"
 #include "binaryType.h"
+#include "../meta/truefalse.h"
 
 namespace LightSpeed
 {
@@ -103,11 +104,39 @@ namespace LightSpeed
 
 	};
 	
+	///Declares, whether array of the type can be serialized as one memory block
+	/** Formatters which support blocks (BinaryWriter, BinaryReader) write arrays
+	 * of such types as memory image instead of item by item. Type must be
+	 * trivially copyable and must not contain pointers. Specialize this
+	 * template and derive BlockSerializableAtom to allow blocks for own types.
+	 *
+	 * Member swapUnit contains size of the unit which is swapped when byte order
+	 * of the stream is different.
+	 */
+	template<typename T>
+	struct BlockSerializable: MFalse {
+		static const natural swapUnit = 1;
+	};
 
-	
-
-
+	///Type can be serialized as block, byte order is swapped per item
+	template<typename T>
+	struct BlockSerializableAtom: MTrue {
+		static const natural swapUnit = sizeof(T);
+	};
 
+	template<> struct BlockSerializable<signed char>: BlockSerializableAtom<signed char> {};
+	template<> struct BlockSerializable<unsigned char>: BlockSerializableAtom<unsigned char> {};
+	template<> struct BlockSerializable<char>: BlockSerializableAtom<char> {};
+	template<> struct BlockSerializable<signed short>: BlockSerializableAtom<signed short> {};
+	template<> struct BlockSerializable<unsigned short>: BlockSerializableAtom<unsigned short> {};
+	template<> struct BlockSerializable<signed int>: BlockSerializableAtom<signed int> {};
+	template<> struct BlockSerializable<unsigned int>: BlockSerializableAtom<unsigned int> {};
+	template<> struct BlockSerializable<signed long>: BlockSerializableAtom<signed long> {};
+	template<> struct BlockSerializable<unsigned long>: BlockSerializableAtom<unsigned long> {};
+	template<> struct BlockSerializable<signed long long>: BlockSerializableAtom<signed long long> {};
+	template<> struct BlockSerializable<unsigned long long>: BlockSerializableAtom<unsigned long long> {};
+	template<> struct BlockSerializable<float>: BlockSerializableAtom<float> {};
+	template<> struct BlockSerializable<double>: BlockSerializableAtom<double> {};
 
 } // namespace LightSpeed
 
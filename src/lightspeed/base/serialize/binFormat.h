@@ -5,7 +5,10 @@
 #include "../types.h"
 #include "formatter_concept.h"
 #include "../streams/compressNumb.h"
-#include "../streams/memoryStream.h"
+#include "../containers/autoArray.h"
+#include "../memory/smallAlloc.h"
+#include "../streams/multibyte.h"
+#include <string.h>
 #include "../exceptions/serializerException.h"
 #include "../streams/utf.h"
 
@@ -20,6 +23,72 @@ namespace LightSpeed
 		static const byte endSection = 0xE5;
 		static const byte beginArray = 0xAA;
 		static const byte endArray = 0xEA;
+		static const byte beginBlock = 0xAB;
+		///byte order of the block
+		static const byte littleEndianBlock = 1;
+		static const byte bigEndianBlock = 2;
+		///alignment of data of the block relative to begin of the stream
+		static const natural maxBlockAlign = 8;
+
+		inline byte hostByteOrder() {
+			return MultibyteOrder::detect() == MultibyteOrder::littleEndian?littleEndianBlock:bigEndianBlock;
+		}
+	}
+
+	///Input iterator over memory (for example mapped file)
+	/** When BinaryReader reads from this iterator, it is able to return arrays
+	 * stored as blocks directly from the memory without copying (see BinaryReader::mapArray)
+	 */
+	class BinaryMemInput: public IteratorBase<byte, BinaryMemInput> {
+	public:
+		BinaryMemInput(ConstBin data):pos(data.data()),end(data.data() + data.length()) {}
+
+		bool hasItems() const {return pos < end;}
+		const byte &getNext() {
+			if (pos >= end) throwIteratorNoMoreItems(THISLOCATION,typeid(byte));
+			return *pos++;
+		}
+		const byte &peek() const {
+			if (pos >= end) throwIteratorNoMoreItems(THISLOCATION,typeid(byte));
+			return *pos;
+		}
+		void skip() {getNext();}
+		natural getRemain() const {return end - pos;}
+
+		template<class Traits>
+		natural blockRead(FlatArrayRef<byte,Traits> buffer, bool readAll) {
+			natural sz = buffer.length();
+			if (sz > getRemain()) {
+				if (readAll) throwIteratorNoMoreItems(THISLOCATION,typeid(byte));
+				sz = getRemain();
+			}
+			memcpy(buffer.data(), pos, sz);
+			pos += sz;
+			return sz;
+		}
+
+		///Returns pointer to the next bytes and skips them
+		const byte *map(natural count) {
+			if (count > getRemain()) throwIteratorNoMoreItems(THISLOCATION,typeid(byte));
+			const byte *p = pos;
+			pos += count;
+			return p;
+		}
+		///Returns pointer to the next byte
+		const byte *getPos() const {return pos;}
+
+	protected:
+		const byte *pos;
+		const byte *end;
+	};
+
+	namespace _intr {
+		template<typename Iter>
+		const void *mapBinaryInput(Iter &, natural , natural ) {return 0;}
+		inline const void *mapBinaryInput(BinaryMemInput &input, natural bytes, natural align) {
+			if (((natural)input.getPos() & (align - 1)) != 0) return 0;
+			return input.map(bytes);
+		}
 	}
 
 	template<typename Iterator>
@@ -29,7 +98,15 @@ namespace LightSpeed
 
 		typedef Iterator IteratorType ;
 
-		BinaryWriter(IteratorType iterator):iterator(iterator) {}
+		///Creates writer
+		/**
+		 * @param iterator output iterator
+		 * @param offset position of the iterator in the stream (count of bytes
+		 * which are already in the stream). Blocks are aligned relative to the begin
+		 * of the stream, so specify the offset when the writer doesn't start at the
+		 * begin of the stream
+		 */
+		BinaryWriter(IteratorType iterator, natural offset = 0):iterator(iterator),written(offset) {}
 
 
 		void exchange(const bool &object) {
@@ -122,18 +199,66 @@ namespace LightSpeed
 			writeByte(BinarySerializer::endArray);
 		}
 
+		///Writes items as one block
+		/**
+		 * Block contains header (tag, byte order, swap unit, item size, count, padding)
+		 * followed by memory image of the items. Data are aligned relative to begin
+		 * of the stream, so they can be mapped by the reader.
+		 *
+		 * @param items pointer to the first item
+		 * @param count count of items
+		 */
+		template<typename T>
+		void writeBlock(const T *items, natural count) {
+			natural unit = BlockSerializable<T>::swapUnit;
+			writeByte(BinarySerializer::beginBlock);
+			writeByte(BinarySerializer::hostByteOrder());
+			writeUnsigned(unit);
+			writeUnsigned(sizeof(T));
+			writeUnsigned(count);
+			natural align = unit < BinarySerializer::maxBlockAlign?unit:BinarySerializer::maxBlockAlign;
+			natural pad = (align - (written + 1) % align) % align;
+			writeByte((byte)pad);
+			for (natural i = 0; i < pad; i++) writeByte(0);
+			writeBytes(reinterpret_cast<const byte *>(items), count * sizeof(T));
+		}
+
+		///Writes array
+		/**
+		 * Arrays of BlockSerializable types are written as one block, other
+		 * arrays are written item by item
+		 */
+		template<typename T, typename Impl>
+		void exchangeArray(const FlatArray<T,Impl> &arr) {
+			exchangeArray(arr, BlockSerializable<T>());
+		}
 
 	protected:
 		Iterator iterator;
+		///position in the stream (offset + count of bytes written), used to align blocks
+		natural written;
+
+		template<typename T, typename Impl>
+		void exchangeArray(const FlatArray<T,Impl> &arr, MTrue) {
+			writeBlock(arr.data(), arr.length());
+		}
+
+		template<typename T, typename Impl>
+		void exchangeArray(const FlatArray<T,Impl> &arr, MFalse) {
+			openArray(arr.length());
+			for (natural i = 0; i < arr.length(); i++) exchange(arr[i]);
+			closeArray();
+		}
 
 		void writeByte(byte b) {
 			iterator.write(b);
+			written++;
 		}
 
 		void writeBytes(const byte *b, natural count) {
 			ArrayRef<const byte> arr(b,count);
-			ArrayRef<const byte>::Iterator iter = arr.getFwIter();
-			iterator.copy(iter);
+			iterator.blockWrite(arr, true);
+			written += count;
 		}
 		void writeSigned(Bin::integer64 numb) {
 			byte buffer[10];
@@ -149,22 +274,6 @@ namespace LightSpeed
     };
 
 
-	class BinReaderSyncException: public SerializerException {
-	public:
-		LIGHTSPEED_EXCEPTIONFINAL;
-		BinReaderSyncException(const ProgramLocation &loc, const std::type_info &iterType)
-			:SerializerException(loc),iterType(iterType) {}
-		const std::type_info &getIteratorType() const {return iterType;}
-	protected:
-		const std::type_info &iterType;
-
-		virtual void message(ExceptionMsg &msg) const {
-			msg.string(L"Input stream out of sync reading using iterator: ")
-				.cString(iterType.name());
-		}
-
-	};
-
 	template<typename Iterator, typename Alloc = StdAlloc>
 	class BinaryReader: public Formatter_Concept {
 
@@ -172,7 +281,7 @@ namespace LightSpeed
 
 		typedef Iterator IteratorType ;
 
-		BinaryReader(IteratorType iterator):iterator(iterator) {}
+		BinaryReader(IteratorType iterator):iterator(iterator),blockSwap(1) {}
 
 
 		void exchange(bool &object) {
@@ -241,29 +350,27 @@ namespace LightSpeed
 			if (dynSection.empty()) {				
 				if (readByte() != BinarySerializer::beginSection)
 					throw BinReaderSyncException(THISLOCATION,typeid(iterator));
-				//prepare stream
-				MemoryStream<char,1024,MemoryStreamClusterSetup<Alloc> > stream;
-				//read section name byte per byte
+				//read section name byte per byte, store it including terminating zero
 				byte x = readByte();
 				if (x != BinarySerializer::nullSection) {
 					while (x != 0) {
-						stream.write((char)x);
+						dynSection.add((char)x);
 						x = readByte();
 					}
+					dynSection.add(0);
 				}
-				//copy section name into string
-				dynSection = StringT<char,StringTraits::CmpS<char>,Alloc>(
-					stream.getIterator(),stream.size());
 			}
 			//requested blockname is NULL?
 			if (blockName == 0) {
 				//if reached NULL section, return also NULL
 				if (dynSection.empty()) return 0;
 				//otherwise, return pointer to section name
-				else return dynSection.c_str();
+				else return dynSection.data();
 			} else {
+				ConstStrA name;
+				if (!dynSection.empty()) name = ConstStrA(dynSection.data(), dynSection.length() - 1);
 				//specified name of section ... is same as found<
-				if (ConstStrC(dynSection) == ConstStrC(blockName)) {
+				if (name == ConstStrA(blockName)) {
 					//yes, clear the name - to mark section opened
 					dynSection.clear();
 					//return blockName as name of opened section
@@ -305,9 +412,116 @@ namespace LightSpeed
 				throw BinReaderSyncException(THISLOCATION,typeid(iterator));
 		}
 
+		///Opens block written by BinaryWriter::writeBlock
+		/**
+		 * @param itemSize size of the item
+		 * @param swapUnit swap unit of the item
+		 * @return count of items in the block. Function returns naturalNull, if next data
+		 * is not a block. Use openArray() to read items one by one in this case.
+		 * @exception BinReaderSyncException item size or swap unit doesn't match
+		 */
+		natural openBlock(natural itemSize, natural swapUnit) {
+			if (iterator.peek() != BinarySerializer::beginBlock) return naturalNull;
+			iterator.skip();
+			byte order = readByte();
+			natural unit = (natural)readUnsigned();
+			natural size = (natural)readUnsigned();
+			natural count = (natural)readUnsigned();
+			natural pad = readByte();
+			if ((order != BinarySerializer::littleEndianBlock && order != BinarySerializer::bigEndianBlock)
+					|| unit != swapUnit || size != itemSize)
+				throw BinReaderSyncException(THISLOCATION,typeid(iterator));
+			for (natural i = 0; i < pad; i++) readByte();
+			blockSwap = order == BinarySerializer::hostByteOrder()?1:unit;
+			return count;
+		}
+
+		///Reads data of the opened block
+		/**
+		 * @param data pointer to the buffer
+		 * @param bytes size of the data in bytes (count of items * item size)
+		 */
+		void readBlock(void *data, natural bytes) {
+			readBytes(reinterpret_cast<byte *>(data), bytes);
+			if (blockSwap > 1) swapBytes(reinterpret_cast<byte *>(data), bytes, blockSwap);
+		}
+
+		///Maps data of the opened block without copying
+		/**
+		 * @param bytes size of the data in bytes
+		 * @param align required alignment
+		 * @return pointer to the data in the input. Function returns NULL, when
+		 * data cannot be mapped (iterator is not BinaryMemInput, data are misaligned
+		 * or they have different byte order). Use readBlock() in this case.
+		 */
+		const void *mapBlock(natural bytes, natural align) {
+			if (blockSwap > 1) return 0;
+			return _intr::mapBinaryInput(iterator, bytes, align);
+		}
+
+		///Reads array into the container
+		/**
+		 * Accepts arrays written by BinaryWriter::exchangeArray. Block is read
+		 * directly into resized container.
+		 */
+		template<typename T, typename A>
+		void exchangeArray(AutoArray<T,A> &arr) {
+			natural cnt = openBlock(sizeof(T), BlockSerializable<T>::swapUnit);
+			arr.clear();
+			if (cnt != naturalNull && BlockSerializable<T>::value) {
+				arr.resize(cnt);
+				readBlock(arr.data(), cnt * sizeof(T));
+			} else {
+				cnt = openArray(naturalNull);
+				arr.reserve(cnt);
+				for (natural i = 0; i < cnt; i++) {
+					T x;
+					exchange(x);
+					arr.add(x);
+				}
+				closeArray();
+			}
+		}
+
+		///Reads array, returns it directly from the input when it is possible
+		/**
+		 * @param storage container used when array cannot be mapped
+		 * @return array which refers either input data (when reading from
+		 * BinaryMemInput) or the storage. Mapped data are valid while the input
+		 * buffer exists.
+		 */
+		template<typename T, typename A>
+		ArrayRef<const T> mapArray(AutoArray<T,A> &storage) {
+			natural unit = BlockSerializable<T>::swapUnit;
+			natural cnt = openBlock(sizeof(T), unit);
+			if (cnt != naturalNull) {
+				natural align = unit < BinarySerializer::maxBlockAlign?unit:BinarySerializer::maxBlockAlign;
+				const void *p = mapBlock(cnt * sizeof(T), align);
+				if (p) return ArrayRef<const T>(reinterpret_cast<const T *>(p), cnt);
+				storage.resize(cnt);
+				readBlock(storage.data(), cnt * sizeof(T));
+			} else {
+				exchangeArray(storage);
+			}
+			return ArrayRef<const T>(storage.data(), storage.length());
+		}
+
 	protected:
 		Iterator iterator;
-		StringT<char,StringTraits::CmpS<char>,Alloc> dynSection;
+		///name of the section read ahead, allocated by Alloc
+		AutoArray<char, Alloc> dynSection;
+		///swap unit of the opened block, 1 when swap is not needed
+		natural blockSwap;
+
+		static void swapBytes(byte *data, natural bytes, natural unit) {
+			for (natural i = 0; i + unit <= bytes; i += unit) {
+				for (natural a = i, b = i + unit - 1; a < b; a++, b--) {
+					byte t = data[a];
+					data[a] = data[b];
+					data[b] = t;
+				}
+			}
+		}
 
 		byte readByte() {
 			return (byte)iterator.getNext();
@@ -315,9 +529,8 @@ namespace LightSpeed
 
 
 		void readBytes(byte *b, natural count) {
-			for (natural i = 0; i < count; i++) {
-				b[i] = readByte();
-			}
+			ArrayRef<byte> arr(b,count);
+			iterator.blockRead(arr.ref(), true);
 		}
 		Bin::integer64 readSigned() {					
 			byte buffer[10];
@@ -193,6 +193,17 @@ namespace LightSpeed
 		///Closes array section
 		void closeArray();
 
+		///Exchanges whole array of BlockSerializable items
+		/** Formatter may store the array as one memory block. Called
+		 * by the Serializable<AutoArray> for types declared by BlockSerializable.
+		 * Formatter without block support can implement this function using
+		 * openArray(), exchange() and closeArray()
+		 *
+		 * @param arr array to store or load
+		 */
+		template<typename T, typename A>
+		void exchangeArray(AutoArray<T,A> &arr);
+
 		///Returns true, if there is no more information in current section and can be closed
 		/**
 		 * @retval true there are data in the section
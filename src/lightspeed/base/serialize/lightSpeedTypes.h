@@ -64,6 +64,18 @@ namespace LightSpeed
 	public:
 		template<typename Archive>
 		static void serialize(AutoArray<T,Allocator> &object, Archive &arch) {
+			serialize(object, arch, BlockSerializable<T>());
+		}
+
+	protected:
+		///items can be exchanged as one block
+		template<typename Archive>
+		static void serialize(AutoArray<T,Allocator> &object, Archive &arch, MTrue) {
+			arch.getFormatter().exchangeArray(object);
+		}
+
+		template<typename Archive>
+		static void serialize(AutoArray<T,Allocator> &object, Archive &arch, MFalse) {
 			typename Archive::Array arrsect(arch,object.length());
 			if (arch.loading()) {
 				object.clear();
@@ -0,0 +1,72 @@
+/*
+ * datagramBatch.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "datagramBatch.h"
+#include <string.h>
+#include "../containers/autoArray.tcc"
+
+namespace LightSpeed {
+
+DatagramBatch::DatagramBatch(natural capacity, natural packetSize)
+	:capacity(capacity),packetSize(packetSize),used(0)
+{
+	data.resize(capacity * packetSize);
+	addrs.resize(capacity * maxAddrSize);
+	addrLens.resize(capacity, 0);
+	packets.reserve(capacity);
+}
+
+bool DatagramBatch::sameAddress(natural index1, natural index2) const {
+	ConstBin a = getSockAddr(index1);
+	ConstBin b = getSockAddr(index2);
+	return a.length() == b.length() && memcmp(a.data(), b.data(), a.length()) == 0;
+}
+
+bool DatagramBatch::checkAddress(natural index, const INetworkAddress &address) const {
+	byte buff[maxAddrSize];
+	natural len = address.getSockAddress(buff, maxAddrSize);
+	ConstBin a = getSockAddr(index);
+	return a.length() == len && memcmp(a.data(), buff, len) == 0;
+}
+
+PNetworkAddress DatagramBatch::createAddress(natural index) const {
+	ConstBin a = getSockAddr(index);
+	return INetworkServices::getNetServices().createAddr(a.data(), a.length());
+}
+
+void DatagramBatch::clear() {
+	packets.clear();
+	used = 0;
+}
+
+bool DatagramBatch::add(ConstBin content, ConstBin sockAddr) {
+	natural idx = packets.length();
+	if (idx >= capacity || used + content.length() > data.length()
+			|| sockAddr.length() > maxAddrSize) return false;
+	//packets are stored continuously, so equal sized packets can be sent as one segmented packet
+	memcpy(data.data() + used, content.data(), content.length());
+	memcpy(getAddrSlot(idx), sockAddr.data(), sockAddr.length());
+	addrLens(idx) = sockAddr.length();
+	Packet p = {used, content.length(), idx};
+	packets.add(p);
+	used += content.length();
+	return true;
+}
+
+bool DatagramBatch::add(ConstBin content, const INetworkAddress &target) {
+	byte buff[maxAddrSize];
+	natural len = target.getSockAddress(buff, maxAddrSize);
+	return add(content, ConstBin(buff, len));
+}
+
+void DatagramBatch::putPacket(natural offset, natural size, natural addrIndex, natural addrLen) {
+	addrLens(addrIndex) = addrLen;
+	Packet p = {offset, size, addrIndex};
+	packets.add(p);
+}
+
+}
@@ -0,0 +1,152 @@
+/*
+ * datagramBatch.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_STREAMS_DATAGRAMBATCH_H_
+#define LIGHTSPEED_BASE_STREAMS_DATAGRAMBATCH_H_
+
+#include "../containers/autoArray.h"
+#include "../containers/constStr.h"
+#include "netio_ifc.h"
+
+namespace LightSpeed {
+
+	///Pre-allocated set of datagrams used by batch I/O
+	/**
+	 * Object holds buffers for many datagrams and their source or target addresses
+	 * in two continuous blocks of memory. It is allocated once and reused for
+	 * every call of INetworkDatagramSource::receiveBatch() and
+	 * INetworkDatagramSource::sendBatch(), so there is no allocation per packet.
+	 *
+	 * Addresses are kept in raw form (sockaddr). Address object is created
+	 * only on request by createAddress().
+	 *
+	 * @code
+	 * DatagramBatch in(64), out(64);
+	 * while (src->receiveBatch(in)) {
+	 *    out.clear();
+	 *    for (natural i = 0; i < in.length(); i++)
+	 *         out.reply(process(in.getData(i)), in, i);
+	 *    src->sendBatch(out);
+	 * }
+	 * @endcode
+	 *
+	 * @note object is not MT safe
+	 */
+	class DatagramBatch {
+	public:
+
+		///Maximum size of raw address
+		static const natural maxAddrSize = 128;
+
+		///Describes one packet
+		struct Packet {
+			///offset of data in the data buffer
+			natural offset;
+			///size of data
+			natural size;
+			///index of address slot
+			natural addrIndex;
+		};
+
+		///Creates batch
+		/**
+		 * @param capacity count of packets (and addresses)
+		 * @param packetSize size of one packet. For receiving, packet larger than
+		 * this size is truncated. When packetSize is at least 65535 bytes, the
+		 * Linux implementation enables UDP_GRO and single slot can receive
+		 * many coalesced packets.
+		 */
+		DatagramBatch(natural capacity, natural packetSize = 2048);
+
+		///Returns count of packets which fits to the batch
+		natural getCapacity() const {return capacity;}
+		///Returns size of one packet slot
+		natural getPacketSize() const {return packetSize;}
+		///Returns count of packets in the batch
+		natural length() const {return packets.length();}
+		///Returns true, if batch is empty
+		bool empty() const {return packets.empty();}
+
+		///Retrieves data of the packet
+		ConstBin getData(natural index) const {
+			const Packet &p = packets[index];
+			return ConstBin(data.data() + p.offset, p.size);
+		}
+		///Retrieves raw address (sockaddr) of the packet
+		ConstBin getSockAddr(natural index) const {
+			natural a = packets[index].addrIndex;
+			return ConstBin(addrs.data() + a * maxAddrSize, addrLens[a]);
+		}
+		///Compares addresses of two packets
+		bool sameAddress(natural index1, natural index2) const;
+		///Compares address of the packet with the address
+		bool checkAddress(natural index, const INetworkAddress &address) const;
+		///Creates address object for the packet
+		PNetworkAddress createAddress(natural index) const;
+
+		///Removes all packets
+		void clear();
+		///Adds packet to send
+		/**
+		 * @param data content of the packet
+		 * @param sockAddr raw address of the target
+		 * @retval true added
+		 * @retval false batch is full
+		 */
+		bool add(ConstBin data, ConstBin sockAddr);
+		///Adds packet to send
+		/**
+		 * @param data content of the packet
+		 * @param target target address
+		 * @retval true added
+		 * @retval false batch is full
+		 */
+		bool add(ConstBin data, const INetworkAddress &target);
+		///Adds packet which is sent to the source of the other packet
+		/**
+		 * @param data content of the packet
+		 * @param src batch contains received packet
+		 * @param index index of received packet
+		 * @retval true added
+		 * @retval false batch is full
+		 */
+		bool reply(ConstBin data, const DatagramBatch &src, natural index) {
+			return add(data, src.getSockAddr(index));
+		}
+
+		///@name Interface for implementations of INetworkDatagramSource
+		//@{
+		///Retrieves packet description
+		const Packet &getPacket(natural index) const {return packets[index];}
+		///Retrieves buffer of the slot (size of the buffer is getPacketSize())
+		byte *getSlot(natural index) {return data.data() + index * packetSize;}
+		///Retrieves buffer of the address slot (size of the buffer is maxAddrSize)
+		byte *getAddrSlot(natural index) {return addrs.data() + index * maxAddrSize;}
+		///Stores packet received into the slot
+		/**
+		 * @param offset offset of the data in the data buffer
+		 * @param size size of the data
+		 * @param addrIndex index of the address slot
+		 * @param addrLen length of the address
+		 */
+		void putPacket(natural offset, natural size, natural addrIndex, natural addrLen);
+		//@}
+
+	protected:
+		natural capacity;
+		natural packetSize;
+		///count of bytes used by packets to send
+		natural used;
+		AutoArray<byte> data;
+		AutoArray<byte> addrs;
+		AutoArray<natural> addrLens;
+		AutoArray<Packet> packets;
+	};
+
+}
+
+#endif /* LIGHTSPEED_BASE_STREAMS_DATAGRAMBATCH_H_ */
@@ -819,6 +819,45 @@ namespace LightSpeed {
     class IMappedFile: public RefCntObj {
     public:
 
+    	///Hints about expected access to the mapped region
+    	/**
+    	 * Hints are advisory. They are ignored on platforms which don't support them
+    	 */
+    	enum AccessHint {
+    		///no special treatment (default)
+    		hintNormal,
+    		///region will be read sequentially, pages can be read ahead aggressively and freed soon after reading
+    		hintSequential,
+    		///region will be accessed randomly, read ahead is disabled
+    		hintRandom,
+    		///region will be accessed soon, operating system starts to read it in background
+    		hintWillNeed,
+    		///region will not be accessed soon, pages can be released. Content of the private pages is lost
+    		hintDontNeed,
+    		///region should be backed by huge pages
+    		hintHugePages,
+    		///maps all pages of the region now. Function blocks until pages are read
+    		hintPopulate
+    	};
+
+    	///Flags for the map() function
+    	enum MapFlags {
+    		///read whole region during mapping to avoid page faults at first access
+    		mapPopulate = 1,
+    		///request huge pages for the region
+    		mapHugePages = 2
+    	};
+
+    	///Diagnostic information about the mapped region
+    	struct RegionStats {
+    		///count of bytes of the region resident in memory
+    		natural residentBytes;
+    		///count of minor page faults of the process
+    		natural minorFaults;
+    		///count of major page faults (faults which required reading from the disk) of the process
+    		natural majorFaults;
+    	};
+
 
     	///Part of file mapped into the memory.
     	/**
@@ -887,6 +926,35 @@ namespace LightSpeed {
     		void unlock() {
     			owner->unlock(*this);
     		}
+
+    		///Advises operating system about expected access to the whole region
+    		/**
+    		 * @param hint access hint
+    		 * @retval true hint accepted
+    		 * @retval false hint is not supported
+    		 */
+    		bool advise(AccessHint hint) const {
+    			return owner->advise(*this, hint, 0, size);
+    		}
+
+    		///Advises operating system about expected access to the part of the region
+    		/**
+    		 * @param hint access hint
+    		 * @param from offset relative to the beginning of the region. It is aligned down to the page
+    		 * @param length length of the part in bytes. It is trimmed to the size of the region
+    		 * @retval true hint accepted
+    		 * @retval false hint is not supported
+    		 */
+    		bool advise(AccessHint hint, natural from, natural length) const {
+    			if (from >= size) return true;
+    			if (length > size - from) length = size - from;
+    			return owner->advise(*this, hint, from, length);
+    		}
+
+    		///Retrieves diagnostic information about the region
+    		RegionStats getStats() const {
+    			return owner->getStats(*this);
+    		}
 };
 
     	///Creates mapped region of the file
@@ -937,6 +1005,38 @@ namespace LightSpeed {
 		virtual MappedRegion map(IFileIOServices::FileOpenMode mode, 
 				bool copyOnWrite) = 0;
 
+		///Creates mapped region of the file with additional flags
+		/**
+		 * @param offset see map()
+		 * @param size see map()
+		 * @param mode see map()
+		 * @param copyOnWrite see map()
+		 * @param flags combination of MapFlags
+		 * @return On success, creates object MappedRegion
+		 *
+		 * @note Default implementation maps the region and applies flags as hints
+		 */
+		virtual MappedRegion map(IRndFileHandle::FileOffset offset, natural size,
+				IFileIOServices::FileOpenMode mode, bool copyOnWrite, natural flags) {
+			MappedRegion reg = map(offset, size, mode, copyOnWrite);
+			applyFlags(reg, flags);
+			return reg;
+		}
+
+		///Maps whole file into the memory with additional flags
+		/**
+		 * @param mode see map()
+		 * @param copyOnWrite see map()
+		 * @param flags combination of MapFlags
+		 * @return On success, creates object MappedRegion
+		 */
+		virtual MappedRegion map(IFileIOServices::FileOpenMode mode,
+				bool copyOnWrite, natural flags) {
+			MappedRegion reg = map(mode, copyOnWrite);
+			applyFlags(reg, flags);
+			return reg;
+		}
+
     	virtual ~IMappedFile() {}
     protected:
     	friend class MappedRegion;
@@ -944,6 +1044,18 @@ namespace LightSpeed {
     	virtual void sync(MappedRegion &reg) = 0;
     	virtual void lock(MappedRegion &reg) = 0;
     	virtual void unlock(MappedRegion &reg) = 0;
+    	///Applies hint to the part of the region, default implementation ignores hints
+    	virtual bool advise(const MappedRegion &, AccessHint , natural , natural ) {return false;}
+    	///Retrieves statistics of the region, default implementation reports whole region resident
+    	virtual RegionStats getStats(const MappedRegion &reg) {
+    		RegionStats st = {reg.size, 0, 0};
+    		return st;
+    	}
+
+    	void applyFlags(const MappedRegion &reg, natural flags) {
+    		if (flags & mapHugePages) reg.advise(hintHugePages);
+    		if (flags & mapPopulate) reg.advise(hintPopulate);
+    	}
     };
 
 
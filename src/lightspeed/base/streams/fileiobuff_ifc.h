@@ -1,3 +1,4 @@
+#pragma once
 #include "../memory/refcntifc.h"
 #include "fileio_ifc.h"
 #include "../platform.h"
@@ -0,0 +1,144 @@
+/*
+ * folderWalker.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "folderWalker.h"
+#include "../actions/message.h"
+#include "../containers/autoArray.tcc"
+#include "../containers/string.tcc"
+#include "../sync/synchronize.h"
+#include "../exceptions/systemException.h"
+
+namespace LightSpeed {
+
+class FolderWalker::WalkAction {
+public:
+	WalkAction(FolderWalker &owner, const String &path, natural depth)
+		:owner(owner),path(path),depth(depth) {}
+	void operator()() const {
+		owner.walkFolder(path, depth);
+	}
+protected:
+	FolderWalker &owner;
+	String path;
+	natural depth;
+};
+
+FolderWalker::FolderWalker(IFileIOServices &svc, IExecutor &executor, natural queueSize)
+	:svc(svc),executor(executor),fields(0),filter(0),queueHead(0),queueCount(0)
+	,freeSlots(queueSize),queued(0),pending(0),canceled(false),running(false)
+{
+	queue.resize(queueSize);
+}
+
+FolderWalker::~FolderWalker() {
+	try {
+		stop();
+	} catch (...) {
+
+	}
+}
+
+void FolderWalker::start(ConstStrW root, natural fields, IFolderWalkFilter *filter) {
+	stop();
+	this->fields = fields;
+	this->filter = filter;
+	failure = nil;
+	canceled = false;
+	running = true;
+	enqueueFolder(root, 0);
+}
+
+void FolderWalker::enqueueFolder(const String &path, natural depth) {
+	lockInc(pending);
+	try {
+		executor.execute(Message<void>::create(WalkAction(*this, path, depth)));
+	} catch (...) {
+		finishFolder();
+		throw;
+	}
+}
+
+void FolderWalker::walkFolder(const String &path, natural depth) {
+	try {
+		PFolderIterator iter = svc.openFolder(path);
+		while (!canceled && iter->getNext()) {
+			if (iter->isDot()) continue;
+			FolderWalkEntry e;
+			e.path = iter->getFullPath();
+			e.nameOffset = e.path.length() - iter->entryName.length();
+			e.depth = depth;
+			e.type = iter->type;
+			e.link = iter->link;
+			try {
+				if (fields & fieldSize) e.size = iter->getSize();
+				if (fields & fieldModified) e.modified = iter->getModifiedTime();
+			} catch (const ErrNoException &) {
+				//entry has been removed meanwhile
+				continue;
+			}
+			bool enter = e.isDirectory() && !e.link && (filter == 0 || filter->enterFolder(e));
+			if (filter == 0 || filter->acceptEntry(e)) push(e);
+			if (enter) enqueueFolder(e.path, depth + 1);
+		}
+	} catch (...) {
+		Synchronized<FastLock> _(lock);
+		if (failure == nil) failure = Exception::getCurrentException();
+		canceled = true;
+	}
+	finishFolder();
+}
+
+void FolderWalker::push(const FolderWalkEntry &entry) {
+	freeSlots.lock();
+	Synchronized<FastLock> _(lock);
+	queue((queueHead + queueCount) % queue.length()) = entry;
+	queueCount++;
+	queued.unlock();
+}
+
+void FolderWalker::finishFolder() {
+	//last folder - wake up reader to report end of walking
+	if (lockDec(pending) == 0) queued.unlock();
+}
+
+bool FolderWalker::getNext(FolderWalkEntry &entry) {
+	if (!running) return false;
+	queued.lock();
+	{
+		Synchronized<FastLock> _(lock);
+		if (queueCount) {
+			FolderWalkEntry &e = queue(queueHead);
+			entry = e;
+			e = FolderWalkEntry();
+			queueHead = (queueHead + 1) % queue.length();
+			queueCount--;
+			freeSlots.unlock();
+			return true;
+		}
+	}
+	running = false;
+	if (failure != nil) {
+		PException f = failure;
+		failure = nil;
+		f->throwAgain(THISLOCATION);
+	}
+	return false;
+}
+
+void FolderWalker::stop() {
+	if (!running) return;
+	canceled = true;
+	//pick remaining entries to unblock actions waiting for free space
+	FolderWalkEntry e;
+	try {
+		while (getNext(e)) {}
+	} catch (...) {
+		//errors are ignored after stop
+	}
+}
+
+}
@@ -0,0 +1,154 @@
+/*
+ * folderWalker.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_STREAMS_FOLDERWALKER_H_
+#define LIGHTSPEED_STREAMS_FOLDERWALKER_H_
+
+#include "fileio_ifc.h"
+#include "../containers/string.h"
+#include "../containers/autoArray.h"
+#include "../actions/executor.h"
+#include "../exceptions/exception.h"
+#include "../../mt/fastlock.h"
+#include "../../mt/semaphore.h"
+#include "../../mt/atomic.h"
+
+namespace LightSpeed {
+
+	///Entry found by the FolderWalker
+	struct FolderWalkEntry {
+		///full path of the entry
+		String path;
+		///position of the name in the path
+		natural nameOffset;
+		///depth in the tree, entries of the root folder have depth 0
+		natural depth;
+		///type of the entry
+		IFolderIterator::DirEntryType type;
+		///true, if entry is symbolic link
+		bool link;
+		///size of the file. Valid only when FolderWalker::fieldSize has been requested
+		lnatural size;
+		///time of the last modification. Valid only when FolderWalker::fieldModified has been requested
+		TimeStamp modified;
+
+		FolderWalkEntry():nameOffset(0),depth(0),type(IFolderIterator::unknown),link(false),size(0) {}
+
+		///Retrieves name of the entry
+		ConstStrW getName() const {return path.offset(nameOffset);}
+		bool isDirectory() const {return type == IFolderIterator::directory;}
+	};
+
+	///Filter of the FolderWalker
+	/**
+	 * Functions are called from threads of the executor, so they must be MT safe
+	 */
+	class IFolderWalkFilter {
+	public:
+		///Decides, whether entry is reported
+		virtual bool acceptEntry(const FolderWalkEntry &entry) = 0;
+		///Decides, whether walker enters the folder
+		/**
+		 * @param entry folder
+		 * @retval true enter folder
+		 * @retval false skip whole subtree. Folder itself is still reported when acceptEntry() accepts it
+		 */
+		virtual bool enterFolder(const FolderWalkEntry &entry) = 0;
+		virtual ~IFolderWalkFilter() {}
+	};
+
+	///Walks the tree of folders in parallel
+	/**
+	 * Every folder is enumerated by a separate action of the executor, so subfolders
+	 * are processed concurrently. Found entries are passed to the caller through bounded
+	 * queue. When queue is full, walking is paused until caller picks some entries.
+	 *
+	 * @code
+	 * FolderWalker walker(IFileIOServices::getIOServices(), executor);
+	 * walker.start(L"/data", FolderWalker::fieldSize);
+	 * FolderWalkEntry e;
+	 * while (walker.getNext(e)) {
+	 *    ...
+	 * }
+	 * @endcode
+	 *
+	 * Order of the entries is not defined. Symbolic links to folders are reported,
+	 * but not followed. Entries which disappear during walking are skipped.
+	 *
+	 * @note Executor must accept actions from its own threads (for example QueueExecutor)
+	 * and it must not run in the thread which reads the entries.
+	 */
+	class FolderWalker {
+	public:
+
+		///Fields, which are retrieved for every entry. Other fields don't need to call stat()
+		enum Fields {
+			fieldSize = 1,
+			fieldModified = 2
+		};
+
+		///Constructs walker
+		/**
+		 * @param svc file services
+		 * @param executor executor which enumerates the folders
+		 * @param queueSize maximum count of entries found but not picked by the caller
+		 */
+		FolderWalker(IFileIOServices &svc, IExecutor &executor, natural queueSize = 4096);
+		///Destructor stops walking
+		~FolderWalker();
+
+		///Starts walking
+		/**
+		 * @param root root folder. Root folder itself is not reported
+		 * @param fields combination of Fields
+		 * @param filter optional filter. Object must remain valid until walking is finished
+		 */
+		void start(ConstStrW root, natural fields = 0, IFolderWalkFilter *filter = 0);
+
+		///Retrieves next entry
+		/**
+		 * @param entry variable which receives the entry
+		 * @retval true entry retrieved
+		 * @retval false walking finished
+		 * @exception any exception thrown while folder was enumerated
+		 */
+		bool getNext(FolderWalkEntry &entry);
+
+		///Stops walking and waits until all pending actions finish
+		void stop();
+
+	protected:
+
+		class WalkAction;
+		friend class WalkAction;
+
+		IFileIOServices &svc;
+		IExecutor &executor;
+		natural fields;
+		IFolderWalkFilter *filter;
+		FastLock lock;
+		///queued entries (ring buffer)
+		AutoArray<FolderWalkEntry> queue;
+		natural queueHead;
+		natural queueCount;
+		Semaphore freeSlots;
+		Semaphore queued;
+		///count of folders being enumerated
+		atomic pending;
+		volatile bool canceled;
+		bool running;
+		PException failure;
+
+		void walkFolder(const String &path, natural depth);
+		void enqueueFolder(const String &path, natural depth);
+		void push(const FolderWalkEntry &entry);
+		void finishFolder();
+	};
+
+}
+
+#endif /* LIGHTSPEED_STREAMS_FOLDERWALKER_H_ */
@@ -0,0 +1,38 @@
+/*
+ * mappedPrefetcher.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "mappedPrefetcher.h"
+
+namespace LightSpeed {
+
+MappedPrefetcher::MappedPrefetcher(const IMappedFile::MappedRegion &region, natural windowSize,
+		natural windowsAhead, bool dropBehind)
+	:region(region),windowSize(windowSize?windowSize:1),windowsAhead(windowsAhead)
+	,dropBehind(dropBehind),prefetched(0),released(0),nextWindow(0) {
+	update(0);
+}
+
+void MappedPrefetcher::update(natural position) {
+	natural window = position / windowSize;
+	nextWindow = (window + 1) * windowSize;
+	natural target = (window + 1 + windowsAhead) * windowSize;
+	if (target > region.size) target = region.size;
+	if (target > prefetched) {
+		region.advise(IMappedFile::hintWillNeed, prefetched, target - prefetched);
+		prefetched = target;
+	}
+	//previous window is kept, reader can still look back a little
+	if (dropBehind && window > 1) {
+		natural releaseEnd = (window - 1) * windowSize;
+		if (releaseEnd > released) {
+			region.advise(IMappedFile::hintDontNeed, released, releaseEnd - released);
+			released = releaseEnd;
+		}
+	}
+}
+
+}
@@ -0,0 +1,79 @@
+/*
+ * mappedPrefetcher.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_STREAMS_MAPPEDPREFETCHER_H_
+#define LIGHTSPEED_STREAMS_MAPPEDPREFETCHER_H_
+
+#include "fileio_ifc.h"
+
+namespace LightSpeed {
+
+	///Sliding window prefetcher for sequential reading of the mapped region
+	/**
+	 * Region is divided into windows. Each time the reader enters a new window,
+	 * prefetcher asks the operating system to read next windows in background
+	 * (IMappedFile::hintWillNeed), so reader doesn't wait for the disk at the page faults.
+	 * Optionally, windows already passed can be released (IMappedFile::hintDontNeed)
+	 * to keep memory for other data.
+	 *
+	 * @code
+	 * IMappedFile::MappedRegion reg = file->map(IFileIOServices::fileOpenRead, false);
+	 * MappedPrefetcher pf(reg);
+	 * for (natural pos = 0; pos < reg.size; pos += recordSize) {
+	 *     pf.access(pos);
+	 *     process(reinterpret_cast<const byte *>(reg.address) + pos);
+	 * }
+	 * @endcode
+	 *
+	 * Object is not MT safe, it should be used by the reader only.
+	 */
+	class MappedPrefetcher {
+	public:
+		///Constructs prefetcher and starts to read first windows
+		/**
+		 * @param region mapped region. Reference must remain valid during lifetime of the prefetcher
+		 * @param windowSize size of the window in bytes. It should be multiple of the page size
+		 * @param windowsAhead count of windows read ahead of the current window
+		 * @param dropBehind release windows which are already passed. Don't use this
+		 * 	 for private mapping with modified pages, because modifications are lost
+		 */
+		MappedPrefetcher(const IMappedFile::MappedRegion &region, natural windowSize = 4*1024*1024,
+				natural windowsAhead = 2, bool dropBehind = false);
+
+		///Reports current position of the reader
+		/**
+		 * @param position offset relative to the beginning of the region.
+		 *
+		 * Function is cheap when reader stays in the current window.
+		 */
+		void access(natural position) {
+			if (position >= nextWindow) update(position);
+		}
+
+		///Retrieves count of bytes, which has been requested to prefetch
+		natural getPrefetched() const {return prefetched;}
+		///Retrieves count of bytes from the beginning, which has been released
+		natural getReleased() const {return released;}
+
+	protected:
+		const IMappedFile::MappedRegion &region;
+		natural windowSize;
+		natural windowsAhead;
+		bool dropBehind;
+		///end of the prefetched part
+		natural prefetched;
+		///end of the released part
+		natural released;
+		///beginning of the next window
+		natural nextWindow;
+
+		void update(natural position);
+	};
+
+}
+
+#endif /* LIGHTSPEED_STREAMS_MAPPEDPREFETCHER_H_ */
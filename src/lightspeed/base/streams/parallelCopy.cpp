@@ -0,0 +1,73 @@
+/*
+ * parallelCopy.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "parallelCopy.h"
+#include "../actions/message.h"
+#include "../containers/string.tcc"
+#include "../sync/synchronize.h"
+#include "../debug/progress.h"
+
+namespace LightSpeed {
+
+class ParallelFileCopy::CopyAction {
+public:
+	CopyAction(ParallelFileCopy &owner, const String &from, const String &to, bool overwrite)
+		:owner(owner),from(from),to(to),overwrite(overwrite) {}
+	void operator()() const {
+		owner.copyFile(from, to, overwrite);
+	}
+protected:
+	ParallelFileCopy &owner;
+	String from;
+	String to;
+	bool overwrite;
+};
+
+ParallelFileCopy::ParallelFileCopy(IFileIOServices &svc, IExecutor &executor)
+	:svc(svc),executor(executor),finished(0),scheduled(0) {}
+
+ParallelFileCopy::~ParallelFileCopy() {
+	try {
+		wait();
+	} catch (...) {
+
+	}
+}
+
+void ParallelFileCopy::add(ConstStrW from, ConstStrW to, bool overwrite) {
+	executor.execute(Message<void>::create(CopyAction(*this, from, to, overwrite)));
+	scheduled++;
+}
+
+void ParallelFileCopy::copyFile(const String &from, const String &to, bool overwrite) {
+	try {
+		svc.copy(from, to, overwrite);
+	} catch (...) {
+		Synchronized<FastLock> _(lock);
+		if (failure == nil) failure = Exception::getCurrentException();
+	}
+	finished.unlock();
+}
+
+void ParallelFileCopy::wait() {
+	Progress progress(scheduled);
+	while (scheduled) {
+		finished.lock();
+		scheduled--;
+		//count the file only after it has been reported as finished
+		progress.adv(1);
+	}
+	PException f;
+	{
+		Synchronized<FastLock> _(lock);
+		f = failure;
+		failure = nil;
+	}
+	if (f != nil) f->throwAgain(THISLOCATION);
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * parallelCopy.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_STREAMS_PARALLELCOPY_H_
+#define LIGHTSPEED_STREAMS_PARALLELCOPY_H_
+
+#include "fileio_ifc.h"
+#include "../containers/string.h"
+#include "../actions/executor.h"
+#include "../exceptions/exception.h"
+#include "../../mt/fastlock.h"
+#include "../../mt/semaphore.h"
+
+namespace LightSpeed {
+
+	///Copies many files in parallel
+	/**
+	 * Every file is copied by IFileIOServices::copy() called in a thread of the executor.
+	 *
+	 * @code
+	 * ParallelFileCopy cp(IFileIOServices::getIOServices(), executor);
+	 * cp.add(L"a.bin", L"out/a.bin", true);
+	 * cp.add(L"b.bin", L"out/b.bin", true);
+	 * cp.wait();
+	 * @endcode
+	 *
+	 * Progress of each file is reported by the thread which copies it. Function wait()
+	 * reports count of finished files through the Progress
+	 */
+	class ParallelFileCopy {
+	public:
+		///Constructs object
+		/**
+		 * @param svc file services
+		 * @param executor executor which performs copying
+		 */
+		ParallelFileCopy(IFileIOServices &svc, IExecutor &executor);
+		///Destructor waits for all copies
+		~ParallelFileCopy();
+
+		///Schedules copying of the file
+		/**
+		 * @param from source file
+		 * @param to target file
+		 * @param overwrite allows to overwrite the target
+		 */
+		void add(ConstStrW from, ConstStrW to, bool overwrite);
+
+		///Waits until all scheduled files are copied
+		/**
+		 * @exception any first exception thrown during copying. Other files are still copied
+		 */
+		void wait();
+
+	protected:
+
+		class CopyAction;
+		friend class CopyAction;
+
+		IFileIOServices &svc;
+		IExecutor &executor;
+		FastLock lock;
+		///unlocked after each file is finished
+		Semaphore finished;
+		///count of files not picked by wait()
+		natural scheduled;
+		PException failure;
+
+		void copyFile(const String &from, const String &to, bool overwrite);
+	};
+
+}
+
+#endif /* LIGHTSPEED_STREAMS_PARALLELCOPY_H_ */
@@ -0,0 +1,248 @@
+/*
+ * readAheadBuffer.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "readAheadBuffer.h"
+#include "../containers/autoArray.tcc"
+#include "../iter/iteratorFilter.tcc"
+#include <string.h>
+
+namespace LightSpeed {
+
+BackgroundStreamWorker::BackgroundStreamWorker()
+	:request(0),done(0),pending(false),exitFlag(false) {}
+
+BackgroundStreamWorker::~BackgroundStreamWorker() {}
+
+void BackgroundStreamWorker::startJob() const {
+	pending = true;
+	if (!worker.isRunning()) {
+		BackgroundStreamWorker *me = const_cast<BackgroundStreamWorker *>(this);
+		worker.start(ThreadFunction::create(me, &BackgroundStreamWorker::worker_run));
+	}
+	request.unlock();
+}
+
+void BackgroundStreamWorker::waitJob() const {
+	if (!pending) return;
+	done.lock();
+	pending = false;
+	if (failure != nil) {
+		PException e = failure;
+		failure = nil;
+		e->throwAgain(THISLOCATION);
+	}
+}
+
+void BackgroundStreamWorker::stopWorker() {
+	if (pending) {
+		done.lock();
+		pending = false;
+	}
+	if (worker.isRunning()) {
+		exitFlag = true;
+		request.unlock();
+		worker.join();
+	}
+}
+
+void BackgroundStreamWorker::worker_run() {
+	for(;;) {
+		request.lock();
+		if (exitFlag) break;
+		try {
+			runJob();
+		} catch (...) {
+			failure = Exception::getCurrentException();
+		}
+		done.unlock();
+	}
+}
+
+ReadAheadBuffer::ReadAheadBuffer(IInputStream *source, natural initialSize, natural maxSize)
+	:source(source),rdpos(0),rdend(0),blockSize(initialSize?initialSize:1)
+	,maxSize(maxSize < blockSize?blockSize:maxSize),backOffset(0),backLength(0),eof(false) {}
+
+ReadAheadBuffer::~ReadAheadBuffer() {
+	stopWorker();
+}
+
+void ReadAheadBuffer::runJob() const {
+	backLength = source->read(back.data() + backOffset, back.length() - backOffset);
+}
+
+void ReadAheadBuffer::startFill() const {
+	if (eof || isPending()) return;
+	if (autoflush != nil) autoflush->flush();
+	//space before the block receives unread data of the front block
+	backOffset = blockSize / 4;
+	back.resize(backOffset + blockSize);
+	backLength = 0;
+	startJob();
+}
+
+natural ReadAheadBuffer::fetch() const {
+	natural remain = rdend - rdpos;
+	if (remain >= maxSize) return 0;
+	if (!isPending()) {
+		if (eof) return 0;
+		startFill();
+	}
+	waitJob();
+	natural fetched = backLength;
+	if (fetched == 0) {
+		eof = true;
+		return 0;
+	}
+	natural start;
+	if (remain <= backOffset) {
+		start = backOffset - remain;
+		memcpy(back.data() + start, front.data() + rdpos, remain);
+	} else {
+		//long unread part, make new block
+		AutoArray<byte> joined;
+		joined.resize(remain + fetched);
+		memcpy(joined.data(), front.data() + rdpos, remain);
+		memcpy(joined.data() + remain, back.data() + backOffset, fetched);
+		back.swap(joined);
+		start = 0;
+	}
+	front.swap(back);
+	rdpos = start;
+	rdend = start + remain + fetched;
+	//source is able to fill whole block, it is probably file, so use larger block
+	if (fetched == blockSize && blockSize < maxSize) {
+		blockSize *= 2;
+		if (blockSize > maxSize) blockSize = maxSize;
+	}
+	startFill();
+	return fetched;
+}
+
+natural ReadAheadBuffer::read(void *buffer, natural size) {
+	if (rdpos == rdend && fetch() == 0) return 0;
+	natural s = rdend - rdpos;
+	if (s > size) s = size;
+	memcpy(buffer, front.data() + rdpos, s);
+	rdpos += s;
+	return s;
+}
+
+natural ReadAheadBuffer::peek(void *buffer, natural size) const {
+	while (rdend - rdpos < size && fetch() != 0) {}
+	natural s = rdend - rdpos;
+	if (s > size) s = size;
+	memcpy(buffer, front.data() + rdpos, s);
+	return s;
+}
+
+bool ReadAheadBuffer::canRead() const {
+	return rdpos < rdend || fetch() != 0;
+}
+
+natural ReadAheadBuffer::dataReady() const {
+	return rdend - rdpos;
+}
+
+natural ReadAheadBuffer::lookup(ConstBin seq, natural fetchedCount) const {
+	if (seq.empty()) return 0;
+	natural s = rdend - rdpos;
+	if (fetchedCount > s) fetchedCount = s;
+	else {
+		fetchedCount += seq.length() - 1;
+		if (fetchedCount > s) fetchedCount = s;
+	}
+	return getInputBuffer().find(seq, s - fetchedCount);
+}
+
+void ReadAheadBuffer::putBack(ConstBin seq) {
+	if (rdpos < seq.length()) throwWriteIteratorNoSpace(THISLOCATION, typeid(*this));
+	rdpos -= seq.length();
+	memcpy(front.data() + rdpos, seq.data(), seq.length());
+}
+
+void ReadAheadBuffer::discardInput(natural count) {
+	natural l = rdend - rdpos;
+	if (l < count) count = l;
+	rdpos += count;
+}
+
+WriteBehindBuffer::WriteBehindBuffer(IOutputStream *target, natural initialSize, natural maxSize)
+	:target(target),backLength(0),wrpos(0),blockSize(initialSize?initialSize:1)
+	,maxSize(maxSize < blockSize?blockSize:maxSize),outputClosed(false) {
+	front.resize(blockSize);
+}
+
+WriteBehindBuffer::~WriteBehindBuffer() {
+	try {
+		submit();
+		waitJob();
+	} catch (...) {
+
+	}
+	stopWorker();
+}
+
+void WriteBehindBuffer::runJob() const {
+	target->writeAll(back.data(), backLength);
+}
+
+void WriteBehindBuffer::submit() {
+	if (wrpos == 0) return;
+	waitJob();
+	//target accepts full blocks, use larger block
+	bool grow = wrpos == front.length() && blockSize < maxSize;
+	backLength = wrpos;
+	front.swap(back);
+	startJob();
+	if (grow) {
+		blockSize *= 2;
+		if (blockSize > maxSize) blockSize = maxSize;
+	}
+	if (front.length() != blockSize) front.resize(blockSize);
+	wrpos = 0;
+}
+
+natural WriteBehindBuffer::write(const void *buffer, natural size) {
+	if (wrpos == front.length()) submit();
+	natural s = front.length() - wrpos;
+	if (s > size) s = size;
+	memcpy(front.data() + wrpos, buffer, s);
+	wrpos += s;
+	return s;
+}
+
+bool WriteBehindBuffer::canWrite() const {
+	return target != nil && !outputClosed;
+}
+
+void WriteBehindBuffer::flush() {
+	submit();
+	waitJob();
+	target->flush();
+}
+
+void WriteBehindBuffer::closeOutput() {
+	outputClosed = true;
+	try {
+		submit();
+		waitJob();
+	} catch (...) {
+		try {
+			target->closeOutput();
+		} catch (...) {
+
+		}
+		throw;
+	}
+	target->closeOutput();
+}
+
+void WriteBehindBuffer::discardOutput(natural count) {
+	if (count > wrpos) wrpos = 0; else wrpos -= count;
+}
+
+}
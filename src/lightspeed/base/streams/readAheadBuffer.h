@@ -0,0 +1,211 @@
+/*
+ * readAheadBuffer.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_STREAMS_READAHEADBUFFER_H_
+#define LIGHTSPEED_STREAMS_READAHEADBUFFER_H_
+
+#include "fileio.h"
+#include "fileiobuff_ifc.h"
+#include "../containers/autoArray.h"
+#include "../exceptions/exception.h"
+#include "../../mt/thread.h"
+#include "../../mt/semaphore.h"
+
+namespace LightSpeed {
+
+	///Runs I/O operations of the buffer in the background thread
+	/**
+	 * Object holds one thread, which is started with the first job. Only one job
+	 * can be pending at time. Exception thrown by the job is rethrown by waitJob()
+	 */
+	class BackgroundStreamWorker {
+	public:
+		BackgroundStreamWorker();
+		virtual ~BackgroundStreamWorker();
+
+	protected:
+		///Starts the job in the background, previous job must be finished
+		void startJob() const;
+		///Waits for the pending job
+		/**
+		 * @exception any exception thrown by the job
+		 */
+		void waitJob() const;
+		///Returns true, when job is pending
+		bool isPending() const {return pending;}
+		///Waits for the pending job and stops the thread. Must be called by the destructor of the derived class
+		void stopWorker();
+
+		///Performs the job, called in the background thread
+		virtual void runJob() const = 0;
+
+	private:
+		mutable Thread worker;
+		mutable Semaphore request, done;
+		mutable bool pending;
+		mutable bool exitFlag;
+		mutable PException failure;
+
+		void worker_run();
+	};
+
+	///Input buffer, which reads next block of the stream in the background
+	/**
+	 * Buffer holds two blocks. While consumer processes one block, the other one is filled in
+	 * the background thread, so I/O and processing overlaps. Size of the block is determined
+	 * at runtime. Buffer starts with the small block and doubles its size every time the source
+	 * fills whole block up to the maximum size, so sequential reading of the files
+	 * uses large blocks while interactive streams keep small blocks.
+	 *
+	 * Buffer reads ahead the source stream. Don't use it, when the source is shared with
+	 * other readers, or when data after current position cannot be read yet. Because the
+	 * blocking read cannot be interrupted, destructor waits for the pending read.
+	 *
+	 * Object is not MT safe, but it can be used by a thread other than the thread created it.
+	 */
+	class ReadAheadBuffer: public IInputBuffer, private BackgroundStreamWorker {
+	public:
+		///Constructs buffer
+		/**
+		 * @param source source stream
+		 * @param initialSize initial size of the block
+		 * @param maxSize maximum size of the block
+		 */
+		ReadAheadBuffer(IInputStream *source, natural initialSize = 65536, natural maxSize = 1024*1024);
+		~ReadAheadBuffer();
+
+		virtual natural read(void *buffer,  natural size);
+		///Peeks data
+		/** Function can block until requested count of bytes is available */
+		virtual natural peek(void *buffer, natural size) const;
+		virtual bool canRead() const;
+		virtual natural dataReady() const;
+
+		virtual void setAutoflush(IBufferFlush *flushStream) {autoflush = flushStream;}
+		virtual IBufferFlush *getAutoflush() const {return autoflush;}
+		virtual PInputStream getSource() const {return source;}
+		///Fetches next block
+		/**
+		 * Function waits for the block being read in the background and appends it to the buffered data.
+		 * Then it starts reading of the next block.
+		 *
+		 * @return count of bytes fetched. Function returns zero at the end of stream, or
+		 * when the buffer contains more than maximum size of the block.
+		 */
+		virtual natural fetch() const;
+		virtual natural lookup(ConstBin seq, natural fetchedCount = naturalNull) const;
+		virtual void putBack(ConstBin seq);
+		virtual natural getInputLength() const {return rdend - rdpos;}
+		virtual natural getInputCapacity() const {return front.length();}
+		virtual ConstBin getInputBuffer() const {return ConstBin(front.data() + rdpos, rdend - rdpos);}
+		virtual void discardInput(natural count);
+
+		///Retrieves current size of the block
+		natural getBlockSize() const {return blockSize;}
+
+	protected:
+		PInputStream source;
+		Pointer<IBufferFlush> autoflush;
+		///block processed by the consumer
+		mutable AutoArray<byte> front;
+		///block filled in the background
+		mutable AutoArray<byte> back;
+		mutable natural rdpos, rdend;
+		mutable natural blockSize;
+		natural maxSize;
+		///position in the back block, where the reading starts. Space before is used to join unread data
+		mutable natural backOffset;
+		///count of bytes read into the back block
+		mutable natural backLength;
+		mutable bool eof;
+
+		virtual void runJob() const;
+		void startFill() const;
+	};
+
+	///Output buffer, which writes the data to the target in the background
+	/**
+	 * Buffer holds two blocks. When the block is full, it is passed to the background thread and
+	 * the consumer continues to write into the other block. Size of the block is
+	 * doubled every time the full block is written up to the maximum size.
+	 *
+	 * Errors of the background writing are reported by the next write, flush() or closeOutput(). Data
+	 * are not written to the target, until the flush() is called or the block is full.
+	 *
+	 * Object is not MT safe, but it can be used by a thread other than the thread created it.
+	 */
+	class WriteBehindBuffer: public IOutputBuffer, private BackgroundStreamWorker {
+	public:
+		///Constructs buffer
+		/**
+		 * @param target target stream
+		 * @param initialSize initial size of the block
+		 * @param maxSize maximum size of the block
+		 */
+		WriteBehindBuffer(IOutputStream *target, natural initialSize = 65536, natural maxSize = 1024*1024);
+		///Destructor writes all data, errors are ignored
+		~WriteBehindBuffer();
+
+		virtual natural write(const void *buffer,  natural size);
+		virtual bool canWrite() const;
+		///Writes all buffered data and flushes the target
+		virtual void flush();
+		virtual void closeOutput();
+
+		virtual natural getOutputLength() const {return wrpos;}
+		virtual natural getOutputCapacity() const {return front.length();}
+		virtual natural getOutputAvailable() const {return front.length() - wrpos;}
+		virtual void discardOutput(natural count);
+		virtual POutputStream getTarget() const {return target;}
+
+		///Retrieves current size of the block
+		natural getBlockSize() const {return blockSize;}
+
+	protected:
+		POutputStream target;
+		///block filled by the consumer
+		AutoArray<byte> front;
+		///block written in the background
+		AutoArray<byte> back;
+		///count of bytes in the back block
+		natural backLength;
+		natural wrpos;
+		natural blockSize;
+		natural maxSize;
+		bool outputClosed;
+
+		virtual void runJob() const;
+		///passes the front block to the background thread
+		void submit();
+	};
+
+
+	///Input stream with the read ahead buffer
+	class SeqFileInAhead: public SeqFileInput {
+	public:
+		explicit SeqFileInAhead(const SeqFileInput &input, natural initialSize = 65536, natural maxSize = 1024*1024)
+			:SeqFileInput(new ReadAheadBuffer(input.getStream(), initialSize, maxSize)) {}
+		explicit SeqFileInAhead(IInputStream *handle, natural initialSize = 65536, natural maxSize = 1024*1024)
+			:SeqFileInput(new ReadAheadBuffer(handle, initialSize, maxSize)) {}
+		explicit SeqFileInAhead(ConstStrW fname, natural openFlags)
+			:SeqFileInput(new ReadAheadBuffer(SeqFileInput(fname, openFlags).getStream())) {}
+	};
+
+	///Output stream with the write behind buffer
+	class SeqFileOutBehind: public SeqFileOutput {
+	public:
+		explicit SeqFileOutBehind(const SeqFileOutput &output, natural initialSize = 65536, natural maxSize = 1024*1024)
+			:SeqFileOutput(new WriteBehindBuffer(output.getStream(), initialSize, maxSize)) {}
+		explicit SeqFileOutBehind(IOutputStream *handle, natural initialSize = 65536, natural maxSize = 1024*1024)
+			:SeqFileOutput(new WriteBehindBuffer(handle, initialSize, maxSize)) {}
+		explicit SeqFileOutBehind(ConstStrW fname, natural openFlags)
+			:SeqFileOutput(new WriteBehindBuffer(SeqFileOutput(fname, openFlags).getStream())) {}
+	};
+
+}
+
+#endif /* LIGHTSPEED_STREAMS_READAHEADBUFFER_H_ */
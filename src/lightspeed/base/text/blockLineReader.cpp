@@ -0,0 +1,197 @@
+/*
+ * blockLineReader.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "blockLineReader.h"
+#include "../containers/autoArray.tcc"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LIGHTSPEED_SCAN_X86
+#endif
+
+namespace LightSpeed {
+
+static const char *scanForCharGeneric(const char *begin, const char *end, char c) {
+	const void *r = memchr(begin, c, end - begin);
+	return r?reinterpret_cast<const char *>(r):end;
+}
+
+#ifdef LIGHTSPEED_SCAN_X86
+
+__attribute__((target("sse2")))
+static const char *scanForCharSSE2(const char *begin, const char *end, char c) {
+	__m128i pattern = _mm_set1_epi8(c);
+	while (end - begin >= 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, pattern));
+		if (mask) return begin + __builtin_ctz(mask);
+		begin += 16;
+	}
+	while (begin < end && *begin != c) ++begin;
+	return begin;
+}
+
+__attribute__((target("avx2")))
+static const char *scanForCharAVX2(const char *begin, const char *end, char c) {
+	__m256i pattern = _mm256_set1_epi8(c);
+	while (end - begin >= 64) {
+		__m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+		__m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + 32));
+		unsigned int m1 = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v1, pattern));
+		unsigned int m2 = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v2, pattern));
+		if (m1) return begin + __builtin_ctz(m1);
+		if (m2) return begin + 32 + __builtin_ctz(m2);
+		begin += 64;
+	}
+	return scanForCharSSE2(begin, end, c);
+}
+
+typedef const char *(*ScanForCharFn)(const char *, const char *, char);
+
+static ScanForCharFn selectScanForChar() {
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return &scanForCharAVX2;
+	if (__builtin_cpu_supports("sse2")) return &scanForCharSSE2;
+	return &scanForCharGeneric;
+}
+
+const char *scanForChar(const char *begin, const char *end, char c) {
+	static ScanForCharFn fn = selectScanForChar();
+	return fn(begin, end, c);
+}
+
+#else
+
+const char *scanForChar(const char *begin, const char *end, char c) {
+	return scanForCharGeneric(begin, end, c);
+}
+
+#endif
+
+const char *scanForSeparator(const char *begin, const char *end, ConstStrA sep) {
+	natural l = sep.length();
+	if (l == 0) return end;
+	const char *s = sep.data();
+	if (l == 1) return scanForChar(begin, end, s[0]);
+	while ((natural)(end - begin) >= l) {
+		//separator cannot start at last l-1 characters
+		const char *last = end - l + 1;
+		const char *p = scanForChar(begin, last, s[0]);
+		if (p == last) break;
+		if (memcmp(p + 1, s + 1, l - 1) == 0) return p;
+		begin = p + 1;
+	}
+	return end;
+}
+
+BlockLineReader::BlockLineReader(ConstStrA text)
+	:input(0),text(text),sep(DefaultNLString<char>()),pendingDiscard(0),needFetch(true),lineReady(false) {}
+
+BlockLineReader::BlockLineReader(ConstStrA text, ConstStrA sep)
+	:input(0),text(text),sep(sep),pendingDiscard(0),needFetch(true),lineReady(false) {}
+
+BlockLineReader::BlockLineReader(const IMappedFile::MappedRegion &region)
+	:input(0),region(region)
+	,text(reinterpret_cast<const char *>(region.address), region.size)
+	,sep(DefaultNLString<char>()),pendingDiscard(0),needFetch(true),lineReady(false) {
+	region.advise(IMappedFile::hintSequential);
+}
+
+BlockLineReader::BlockLineReader(const IMappedFile::MappedRegion &region, ConstStrA sep)
+	:input(0),region(region)
+	,text(reinterpret_cast<const char *>(region.address), region.size)
+	,sep(sep),pendingDiscard(0),needFetch(true),lineReady(false) {
+	region.advise(IMappedFile::hintSequential);
+}
+
+BlockLineReader::BlockLineReader(IInputBuffer &input)
+	:input(&input),sep(DefaultNLString<char>()),pendingDiscard(0),needFetch(true),lineReady(false) {}
+
+BlockLineReader::BlockLineReader(IInputBuffer &input, ConstStrA sep)
+	:input(&input),sep(sep),pendingDiscard(0),needFetch(true),lineReady(false) {}
+
+bool BlockLineReader::fetchLine() const {
+	if (needFetch) {
+		lineReady = input?fetchFromInput():fetchFromText();
+		needFetch = false;
+	}
+	return lineReady;
+}
+
+bool BlockLineReader::fetchFromText() const {
+	if (text.empty()) return false;
+	const char *b = text.data();
+	const char *e = b + text.length();
+	const char *p = scanForSeparator(b, e, sep);
+	line = ConstStrA(b, p - b);
+	if (p == e) text = ConstStrA();
+	else text = ConstStrA(p + sep.length(), e - p - sep.length());
+	return true;
+}
+
+bool BlockLineReader::fetchFromInput() const {
+	//release previous line from the buffer
+	input->discardInput(pendingDiscard);
+	pendingDiscard = 0;
+	spill.clear();
+	//separator can be split between two fetches
+	natural keep = sep.empty()?0:sep.length() - 1;
+	natural scanned = 0;
+	for(;;) {
+		ConstBin buff = input->getInputBuffer();
+		const char *b = reinterpret_cast<const char *>(buff.data());
+		const char *e = b + buff.length();
+		natural from = scanned > keep?scanned - keep:0;
+		const char *p = scanForSeparator(b + from, e, sep);
+		if (p != e) {
+			natural len = p - b;
+			pendingDiscard = len + sep.length();
+			if (spill.empty()) {
+				line = ConstStrA(b, len);
+			} else {
+				spill.append(ConstStrA(b, len));
+				line = ConstStrA(spill);
+			}
+			return true;
+		}
+		scanned = buff.length();
+		if (input->fetch() == 0) {
+			if (buff.length() > keep) {
+				//buffer is full or end of stream reached, move the line out of the buffer
+				natural sz = buff.length() - keep;
+				spill.append(ConstStrA(b, sz));
+				input->discardInput(sz);
+				scanned = keep;
+			} else {
+				//end of stream
+				if (buff.length() == 0 && spill.empty()) return false;
+				spill.append(ConstStrA(b, buff.length()));
+				input->discardInput(buff.length());
+				line = ConstStrA(spill);
+				return true;
+			}
+		}
+	}
+}
+
+bool BlockLineReader::hasItems() const {
+	return fetchLine();
+}
+
+const ConstStrA &BlockLineReader::getNext() {
+	if (!fetchLine()) throwIteratorNoMoreItems(THISLOCATION, typeid(*this));
+	needFetch = true;
+	return line;
+}
+
+const ConstStrA &BlockLineReader::peek() const {
+	if (!fetchLine()) throwIteratorNoMoreItems(THISLOCATION, typeid(*this));
+	return line;
+}
+
+}
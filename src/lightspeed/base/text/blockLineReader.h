@@ -0,0 +1,196 @@
+/*
+ * blockLineReader.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_TEXT_BLOCKLINEREADER_H_
+#define LIGHTSPEED_TEXT_BLOCKLINEREADER_H_
+
+#include "../containers/autoArray.h"
+#include "../containers/constStr.h"
+#include "../containers/optional.h"
+#include "../iter/iterator.h"
+#include "../streams/fileio_ifc.h"
+#include "../streams/fileiobuff_ifc.h"
+#include "../actions/executor.h"
+#include "../actions/message.h"
+#include "../exceptions/exception.h"
+#include "../sync/synchronize.h"
+#include "../../mt/fastlock.h"
+#include "../../mt/semaphore.h"
+#include "../../mt/atomic.h"
+#include "newline.h"
+
+namespace LightSpeed {
+
+	///Finds first occurrence of the character
+	/**
+	 * Uses AVX2 or SSE2 instructions when they are supported by the CPU
+	 *
+	 * @param begin begin of the text
+	 * @param end end of the text
+	 * @param c character to search
+	 * @return pointer to found character or end, if not found
+	 */
+	const char *scanForChar(const char *begin, const char *end, char c);
+
+	///Finds first occurrence of the separator
+	/**
+	 * @param begin begin of the text
+	 * @param end end of the text
+	 * @param sep separator
+	 * @return pointer to first character of found separator or end, if not found
+	 */
+	const char *scanForSeparator(const char *begin, const char *end, ConstStrA sep);
+
+
+	///Iterator reads lines from the block of memory
+	/**
+	 * Unlike TextLineReader, which reads the source character by character, this reader
+	 * searches for separators in whole blocks using SIMD instructions and returns lines as
+	 * slices of the source memory. No data are copied. Returned line is valid until next line is
+	 * requested.
+	 *
+	 * Reader can read from:
+	 *  - contiguous memory block (ConstStrA)
+	 *  - mapped region of the file (IMappedFile::MappedRegion). Reader keeps the region mapped
+ *    and advises sequential access to the region.
+	 *  - input buffer of the stream (IInputBuffer, for example IOBuffer). Lines
+	 *    are returned directly from the buffer. Only the line which doesn't fit into the buffer
+	 *    and the last line of the stream are copied into the internal buffer.
+	 *
+	 * Iterator works with the same rules as TextLineReader. Separator is not part of the line, text
+	 * after last separator is returned as last line, when it is not empty.
+	 */
+	class BlockLineReader: public IteratorBase<ConstStrA, BlockLineReader> {
+	public:
+
+		///Reads lines from memory separated by default new line separator
+		BlockLineReader(ConstStrA text);
+		///Reads lines from memory separated by given separator
+		BlockLineReader(ConstStrA text, ConstStrA sep);
+		///Reads lines from mapped region separated by default new line separator
+		BlockLineReader(const IMappedFile::MappedRegion &region);
+		///Reads lines from mapped region separated by given separator
+		BlockLineReader(const IMappedFile::MappedRegion &region, ConstStrA sep);
+		///Reads lines from input buffer separated by default new line separator
+		/**
+		 * @param input input buffer. Object must remain valid during lifetime of the reader
+		 */
+		BlockLineReader(IInputBuffer &input);
+		///Reads lines from input buffer separated by given separator
+		/**
+		 * @param input input buffer. Object must remain valid during lifetime of the reader
+		 * @param sep separator
+		 */
+		BlockLineReader(IInputBuffer &input, ConstStrA sep);
+
+		const ConstStrA &peek() const;
+		const ConstStrA &getNext();
+		bool hasItems() const;
+
+	protected:
+		///input buffer, or 0 when reading from memory
+		IInputBuffer *input;
+		///keeps region mapped
+		Optional<IMappedFile::MappedRegion> region;
+		///remaining text, when reading from memory
+		mutable ConstStrA text;
+		const ConstStrA sep;
+		///current line
+		mutable ConstStrA line;
+		///line which has been read from multiple fetches
+		mutable AutoArray<char> spill;
+		///count of bytes consumed from the input by current line
+		mutable natural pendingDiscard;
+		mutable bool needFetch;
+		mutable bool lineReady;
+
+		bool fetchLine() const;
+		bool fetchFromText() const;
+		bool fetchFromInput() const;
+	};
+
+
+	///Job processes lines of one chunk, used by forEachLineParallel
+	template<typename Fn>
+	class ParallelLineJob {
+	public:
+		struct Shared {
+			const Fn &fn;
+			atomic pending;
+			Semaphore done;
+			FastLock lock;
+			PException failure;
+
+			Shared(const Fn &fn):fn(fn),pending(1),done(0) {}
+		};
+
+		ParallelLineJob(Shared &shared, ConstStrA chunk, ConstStrA sep)
+			:shared(shared),chunk(chunk),sep(sep) {}
+
+		void operator()() const {
+			try {
+				BlockLineReader rd(chunk, sep);
+				while (rd.hasItems()) shared.fn(rd.getNext());
+			} catch (...) {
+				Synchronized<FastLock> _(shared.lock);
+				if (shared.failure == nil) shared.failure = Exception::getCurrentException();
+			}
+			if (lockDec(shared.pending) == 0) shared.done.unlock();
+		}
+
+	protected:
+		Shared &shared;
+		ConstStrA chunk;
+		ConstStrA sep;
+	};
+
+	///Splits the text into chunks at line boundaries and processes lines of the chunks by the executor
+	/**
+	 * @param executor executor which processes the chunks
+	 * @param text text to process
+	 * @param sep separator of lines
+	 * @param chunkSize approximate size of the chunk in bytes. Chunk is extended to the nearest separator
+	 * @param fn function called for every line (ConstStrA). Function is called concurrently from threads of the executor.
+	 *  Lines of the same chunk are processed in order.
+	 *
+	 * Function returns after all lines are processed. If any call of the function throws an exception,
+	 * remaining lines of the chunk are skipped and first exception is rethrown after all chunks are finished.
+	 */
+	template<typename Fn>
+	void forEachLineParallel(IExecutor &executor, ConstStrA text, ConstStrA sep, natural chunkSize, const Fn &fn) {
+		typedef ParallelLineJob<Fn> Job;
+		//caller holds one reference until all chunks are queued
+		typename Job::Shared shared(fn);
+		const char *b = text.data();
+		const char *e = b + text.length();
+		natural overlap = sep.empty()?0:sep.length() - 1;
+		if (chunkSize <= overlap) chunkSize = overlap + 1;
+		while (b < e) {
+			const char *c = e;
+			if ((natural)(e - b) > chunkSize) {
+				//separator can start before the boundary
+				const char *p = scanForSeparator(b + chunkSize - overlap, e, sep);
+				if (p != e) c = p + sep.length();
+			}
+			lockInc(shared.pending);
+			executor.execute(Message<void>::create(Job(shared, ConstStrA(b, c - b), sep)));
+			b = c;
+		}
+		if (lockDec(shared.pending) != 0) shared.done.lock();
+		if (shared.failure != nil) shared.failure->throwAgain(THISLOCATION);
+	}
+
+	///Splits the text into chunks at line boundaries and processes lines of the chunks by the executor
+	/** Lines are separated by default new line separator */
+	template<typename Fn>
+	void forEachLineParallel(IExecutor &executor, ConstStrA text, natural chunkSize, const Fn &fn) {
+		forEachLineParallel(executor, text, DefaultNLString<char>(), chunkSize, fn);
+	}
+
+}
+
+#endif /* LIGHTSPEED_TEXT_BLOCKLINEREADER_H_ */
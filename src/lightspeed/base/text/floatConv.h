@@ -0,0 +1,61 @@
+/*
+ * floatConv.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_BASE_TEXT_FLOATCONV_H_
+#define LIGHTSPEED_BASE_TEXT_FLOATCONV_H_
+
+#include "../containers/constStr.h"
+
+namespace LightSpeed {
+
+	///Size of buffer enough to hold any result of the formatShortest()
+	static const natural shortestFloatBufferSize = 32;
+
+	///Formats double to the shortest text which converts back to the same number
+	/**
+	 * Function uses Grisu2 algorithm, which needs only integer arithmetic
+	 * and a small table of cached powers of ten. It doesn't depend on locale,
+	 * decimal separator is always a dot.
+	 *
+	 * Number is written in decimal notation when 1e-6 <= |val| < 1e21 and
+	 * in the scientific notation otherwise ("1e+21", "5e-324"). Integral
+	 * numbers are written without decimal point. Special values are written
+	 * as "nan", "inf" and "-inf".
+	 *
+	 * @param val value to format
+	 * @param buffer output buffer, it must have at least shortestFloatBufferSize
+	 *  characters. Result is not terminated by zero.
+	 * @return count of characters written
+	 */
+	natural formatShortest(double val, char *buffer);
+
+	///Formats float to the shortest text which converts back to the same float
+	/**
+	 * @copydetails formatShortest(double,char *)
+	 */
+	natural formatShortest(float val, char *buffer);
+
+	///Parses floating point number
+	/**
+	 * Function accepts optional leading whitespaces, sign, digits with an optional
+	 * decimal dot and an optional exponent. Result is always correctly rounded.
+	 *
+	 * Most of numbers are converted by the Clinger's fast path or by
+	 * the Eisel-Lemire algorithm using a table of 128-bit powers of five.
+	 * Rare ambiguous cases (more than 19 significant digits close to half-way)
+	 * are passed to the C library.
+	 *
+	 * @param string text to parse
+	 * @param chrRead receives count of characters used by the number. If no
+	 *  number has been found, it receives zero
+	 * @return parsed value. Values out of range are returned as infinity or zero
+	 */
+	double strtod(ConstStrA string, natural *chrRead);
+
+}
+
+#endif /* LIGHTSPEED_BASE_TEXT_FLOATCONV_H_ */
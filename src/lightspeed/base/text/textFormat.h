@@ -156,6 +156,11 @@ enum SimpleManipulators {
 		TextFormat &setPrecision(natural p);
 		TextFormat &setSci(natural decimals);
 		TextFormat &setFixed(natural decimals);
+		///Formats floating point numbers to the shortest text which converts back to the same value
+		/**
+		 * Mode is active until setPrecision(), setSci() or setFixed() is called
+		 */
+		TextFormat &setShortest();
 
 		TextFormat &setNumberFormat(INumberFormatter *fmt);
 
@@ -153,6 +153,12 @@ TextFormat<T,Alloc> &TextFormat<T,Alloc>::operator << (linteger num) {
 
 template<typename T, typename Alloc>
 TextFormat<T,Alloc> &TextFormat<T,Alloc>::operator << (float num) {
+	if (decimals == naturalNull) {
+		ToString<float> str(num);
+		ConstStrA txt =  str;
+		if (formatter != nil) txt = (*formatter)(txt);
+		return setArgChar(txt);
+	}
 	ToString<float> str(num,decimals,sciFormat);
 	ConstStrA txt =  str;
 	if (formatter != nil) txt = (*formatter)(txt);
@@ -161,6 +167,12 @@ TextFormat<T,Alloc> &TextFormat<T,Alloc>::operator << (float num) {
 
 template<typename T, typename Alloc>
 TextFormat<T,Alloc> &TextFormat<T,Alloc>::operator << (double num) {
+	if (decimals == naturalNull) {
+		ToString<double> str(num);
+		ConstStrA txt =  str;
+		if (formatter != nil) txt = (*formatter)(txt);
+		return setArgChar(txt);
+	}
 	ToString<double> str(num,decimals,sciFormat);
 	ConstStrA txt =  str;
 	if (formatter != nil) txt = (*formatter)(txt);
@@ -192,6 +204,13 @@ TextFormat<T,Alloc> &TextFormat<T,Alloc>::setSci(natural p) {
 	return *this;
 }
 
+template<typename T, typename Alloc>
+TextFormat<T,Alloc> &TextFormat<T,Alloc>::setShortest() {
+	sciFormat = false;
+	decimals = naturalNull;
+	return *this;
+}
+
 
 template<typename T, typename Alloc>
 TextFormat<T,Alloc> &TextFormat<T,Alloc>::setNumberFormat(INumberFormatter *fmt) {
@@ -19,6 +19,7 @@ namespace LightSpeed {
 		setBase,
 		setPrecision,
 		setSci,
+		setShortest,
 	};
 
 	Manip m;
@@ -34,6 +35,7 @@ namespace LightSpeed {
 	inline TextFormatManip setPrecision(natural p) {return TextFormatManip(TextFormatManip::setPrecision,p);}
 	inline TextFormatManip setSci(natural decimals) {return TextFormatManip(TextFormatManip::setSci,decimals);}
 	inline TextFormatManip setSciMax(natural p) {return TextFormatManip(TextFormatManip::setSci,p);}
+	inline TextFormatManip setShortest() {return TextFormatManip(TextFormatManip::setShortest,0);}
 
 
 	template<typename T>
@@ -42,6 +44,7 @@ namespace LightSpeed {
 		case TextFormatManip::setBase: tt.setBase(param);break;
 		case TextFormatManip::setPrecision: tt.setPrecision(param);break;
 		case TextFormatManip::setSci: tt.setSci(param);break;
+		case TextFormatManip::setShortest: tt.setShortest();break;
 		}
 	}
 
@@ -16,6 +16,9 @@ namespace LightSpeed {
 	            allows nearly unlimited lines. You can limit lines using different allocator, such a StaticAlloc. If the
 				line is longer than secified, exception is thrown. Allocator is used everytime buffer need expansion. Otherwise
 				object reuses already allocated memory to reduce allocation overhead
+
+	  @note To read large amount of text from memory, mapped file or buffered stream, use BlockLineReader,
+	        which finds the separators by blocks and doesn't copy the lines
 	*/
 	template <typename Iterator, typename Allocator = StdAlloc>
 	class TextLineReader : public IteratorBase<ConstStringT<typename ConstObject<typename OriginT<Iterator>::T::ItemT>::Remove>, TextLineReader<Iterator, Allocator> > {	
@@ -59,11 +62,13 @@ namespace LightSpeed {
 		if (needFetch) {			
 			if (iter.hasItems()) {
 				buffer.clear();
+				natural seplen = sep.length();
 				do {
 					const T &ch = iter.getNext();
 					buffer.add(ch);
-					if (buffer.tail(sep.length()) == sep) {
-						buffer.trunc(sep.length());
+					//compare whole separator only when its last character arrives
+					if (seplen == 0 || (ch == sep[seplen - 1] && buffer.tail(seplen) == sep)) {
+						buffer.trunc(seplen);
 						break;
 					}
 				} while (iter.hasItems());
@@ -64,6 +64,7 @@ namespace LightSpeed {
 		TextOut &setBase(natural b);
 		TextOut &setPrecision(natural p);
 		TextOut &setSci(natural p);
+		TextOut &setShortest();
 		TextOut &setNumberFormat(INumberFormatter *fmt);
 
 #if _MSC_VER == 1800
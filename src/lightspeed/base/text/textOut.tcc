@@ -56,6 +56,11 @@ template<typename Iter, typename Alloc> TextOut<Iter,Alloc> & TextOut<Iter,Alloc
 	fmt.setSci(p);return *this;
 }
 
+template<typename Iter, typename Alloc> TextOut<Iter,Alloc> & TextOut<Iter,Alloc>::setShortest()
+{
+	fmt.setShortest();return *this;
+}
+
 
 
 
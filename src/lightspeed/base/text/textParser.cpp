@@ -8,13 +8,12 @@
 #include "../memory/stdAlloc.h"
 #include "textParser.tcc"
 #include "../exceptions/invalidNumberFormat.h"
+#include "floatConv.h"
 #include <math.h>
 
 namespace LightSpeed {
 
 
-double strtod(ConstStrA string, natural *chrRead);
-
 namespace _intr {
 
 template<typename T>
@@ -9,6 +9,7 @@
 
 
 #include "toString.tcc"
+#include "floatConv.h"
 
 namespace LightSpeed {
 
@@ -35,10 +36,9 @@ ToString<float, char>::ToString(float val, integer precision, bool sci)
 
 ToString<float, char>::ToString(float val)
 {
-	char buff[256];
-	snprintf(buff,255,"%g",double(val));
-	char *c = buff;
-	while (*c) this->buffer.write(*c++);
+	char buff[shortestFloatBufferSize];
+	natural len = formatShortest(val,buff);
+	for (natural i = 0; i < len; i++) this->buffer.write(buff[i]);
 	commitBuffer();
 
 }
@@ -60,10 +60,9 @@ ToString<double, char>::ToString(double val, integer precision, bool sci)
 
 ToString<double, char>::ToString(double val)
 {
-	char buff[256];
-	snprintf(buff,255,"%g",double(val));
-	char *c = buff;
-	while (*c) this->buffer.write(*c++);
+	char buff[shortestFloatBufferSize];
+	natural len = formatShortest(val,buff);
+	for (natural i = 0; i < len; i++) this->buffer.write(buff[i]);
 	commitBuffer();
 
 }
@@ -134,6 +134,7 @@ namespace LightSpeed {
 	class ToString<float,char>: public ToStringBase<char,50> {
 	public:
 		 ToString(float val, integer precision, bool sci = false);
+		 ///Formats shortest text which converts back to the same value
 		 ToString(float val);
 	};
 
@@ -141,6 +142,7 @@ namespace LightSpeed {
 	class ToString<double,char>: public ToStringBase<char,50> {
 	public:
 		 ToString(double val, integer precision, bool sci = false);
+		 ///Formats shortest text which converts back to the same value
 		 ToString(double val);
 	};
 
@@ -79,6 +79,45 @@ PNetworkDatagram WindowsNetDgamSource :: create(PNetworkAddress adr) {
 
 }
 
+natural WindowsNetDgamSource::receiveBatch(DatagramBatch &batch) {
+	batch.clear();
+	if (wait(waitForInput) == waitTimeout) return 0;
+	//there is no recvmmsg, packets are received one by one until socket is empty
+	natural cap = batch.getCapacity();
+	for (natural i = 0; i < cap; i++) {
+		int len = (int)DatagramBatch::maxAddrSize;
+		int r = ::recvfrom(sock,reinterpret_cast<char *>(batch.getSlot(i)),
+				(int)batch.getPacketSize(),0,
+				reinterpret_cast<struct sockaddr *>(batch.getAddrSlot(i)),&len);
+		if (r == SOCKET_ERROR) {
+			int err = WSAGetLastError();
+			if (err == WSAEWOULDBLOCK || i) break;
+			throw NetworkIOError(THISLOCATION,err,"recvfrom failed");
+		}
+		batch.putPacket(i * batch.getPacketSize(),r,i,len);
+	}
+	return batch.length();
+}
+
+natural WindowsNetDgamSource::sendBatch(DatagramBatch &batch) {
+	natural pos = 0;
+	while (pos < batch.length()) {
+		ConstBin data = batch.getData(pos);
+		ConstBin addr = batch.getSockAddr(pos);
+		int r = ::sendto(sock,reinterpret_cast<const char *>(data.data()),(int)data.length(),0,
+				reinterpret_cast<const struct sockaddr *>(addr.data()),(int)addr.length());
+		if (r == SOCKET_ERROR) {
+			int err = WSAGetLastError();
+			if (err != WSAEWOULDBLOCK)
+				throw NetworkIOError(THISLOCATION,err,"Cannot send datagram");
+			if (wait(waitForOutput) == waitTimeout) break;
+		} else {
+			pos++;
+		}
+	}
+	return pos;
+}
+
 integer WindowsNetDgamSource ::getSocket(int index) const {
 	return (integer)(index?-1:sock);
 }
@@ -12,6 +12,7 @@
 #include "../streams/memfile.h"
 #include "../memory/smallAlloc.h"
 #include "winsocket.h"
+#include "../streams/datagramBatch.h"
 
 namespace LightSpeed {
 
@@ -84,6 +85,10 @@ public:
 
 	virtual void setUID(natural id) {dgrId = id;}
 
+	virtual natural receiveBatch(DatagramBatch &batch);
+
+	virtual natural sendBatch(DatagramBatch &batch);
+
 
 protected:
 	static UINT_PTR createDatagramSocket(natural port);
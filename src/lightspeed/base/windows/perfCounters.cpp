@@ -0,0 +1,42 @@
+/*
+ * perfCounters.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "winpch.h"
+#include "../framework/perfCounters.h"
+
+namespace LightSpeed {
+
+	//hardware counters are not available without a driver, only time is measured
+
+	PerfCounters::PerfCounters() {
+		for (natural i = 0; i < counterCount; i++) handles[i] = -1;
+	}
+
+	PerfCounters::~PerfCounters() {}
+
+	bool PerfCounters::isAvailable() const {
+		return false;
+	}
+
+	void PerfCounters::start() {}
+
+	PerfCounters::Values PerfCounters::stop() {
+		Values v;
+		v.cycles = naturalNull;
+		v.instructions = naturalNull;
+		v.cacheMisses = naturalNull;
+		return v;
+	}
+
+	natural PerfCounters::getTimeNs() {
+		LARGE_INTEGER cnt, freq;
+		QueryPerformanceCounter(&cnt);
+		QueryPerformanceFrequency(&freq);
+		return (natural)((double)cnt.QuadPart * 1000000000.0 / (double)freq.QuadPart);
+	}
+
+}
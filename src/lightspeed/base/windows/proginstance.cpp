@@ -219,6 +219,11 @@ void ProgInstance::create( natural requestMaxSize )
 	create();
 }
 
+void ProgInstance::create( natural requestMaxSize, natural )
+{
+	create(requestMaxSize);
+}
+
 void ProgInstance::open()
 {
 	if (buffer != 0) {
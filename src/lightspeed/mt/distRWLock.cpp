@@ -0,0 +1,61 @@
+/*
+ * distRWLock.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "distRWLock.h"
+
+namespace LightSpeed {
+
+static const natural cacheLineSize = 64;
+static const natural maxSlots = 256;
+static const natural drainSpinCount = 1000;
+
+DistRWLockBase::DistRWLockBase():writer(0) {
+	natural cpus = getCPUCount();
+	natural count = 1;
+	while (count < cpus && count < maxSlots) count <<= 1;
+	slotMask = count - 1;
+	slotBuffer = new char[(count + 1) * sizeof(Slot)];
+	slots = reinterpret_cast<Slot *>(
+			((natural)slotBuffer + cacheLineSize - 1) & ~(cacheLineSize - 1));
+	for (natural i = 0; i < count; i++) slots[i].readers = 0;
+}
+
+DistRWLockBase::~DistRWLockBase() {
+	delete [] slotBuffer;
+}
+
+atomicValue DistRWLockBase::countReaders() const {
+	atomicValue sum = 0;
+	for (natural i = 0; i <= slotMask; i++) sum += readAcquire(&slots[i].readers);
+	return sum;
+}
+
+void DistRWLockBase::lockWrite() {
+	writers.lock();
+	lockExchange(writer, 1);
+	natural spin = 0;
+	while (countReaders() != 0) {
+		//readers are short, so wait actively for a while
+		if (spin < drainSpinCount) spin++;
+		else drained.sleep(Timeout());
+	}
+}
+
+void DistRWLockBase::unlockWrite() {
+	writeRelease(&writer, 0);
+	writers.unlock();
+}
+
+bool DistRWLockBase::tryLockWrite() {
+	if (!writers.tryLock()) return false;
+	lockExchange(writer, 1);
+	if (countReaders() == 0) return true;
+	unlockWrite();
+	return false;
+}
+
+}
@@ -0,0 +1,183 @@
+/*
+ * distRWLock.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_MT_DISTRWLOCK_H_
+#define LIGHTSPEED_MT_DISTRWLOCK_H_
+
+#include "fastlock.h"
+#include "threadSleeper.h"
+
+namespace LightSpeed {
+
+///Read/Write lock optimized for data which are read often and written rarely
+/** Readers are counted in several counters (slots), one per CPU. Every slot
+ * occupies whole cache line, so readers running on different CPUs don't share
+ * any written memory. Reading is just one interlocked increment of the
+ * counter of the current CPU and one check of the writer's flag.
+ *
+ * Writer sets the flag and waits until all readers leave. Readers, which see
+ * the flag, step back and wait on the internal FastLock held by the writer.
+ * Writers are serialized by the same lock. Because readers step back when
+ * a writer is pending, writers cannot starve.
+ *
+ * Reader may migrate to other CPU while it holds the lock. The writer sums all
+ * slots, so it doesn't matter, which slot is decremented in unlockRead().
+ *
+ * Lock is not recursive. Don't lock for reading again while the lock is held
+ * for reading, it can deadlock when a writer is pending.
+ *
+ * Object takes one cache line per CPU (up to 256 lines), so it is not suitable for
+ * locks which exist in many instances. Use RWLock there.
+ *
+ * As RWLock, object can be used as ReadLock or WriteLock through the Synchronized class.
+ */
+class DistRWLockBase {
+public:
+
+	DistRWLockBase();
+	~DistRWLockBase();
+
+	///Lock for reading
+	void lockRead() {
+		while (!tryLockRead()) {
+			//wait for the writer
+			writers.lock();
+			writers.unlock();
+		}
+	}
+
+	///unlocks for reading
+	void unlockRead() {
+		lockDec(getSlot());
+		if (readAcquire(&writer) != 0) drained.wakeUp();
+	}
+
+	///try lock for reading
+	/**
+	 * @retval true locked
+	 * @retval false there is a writer which owns the lock or waits for it
+	 */
+	bool tryLockRead() {
+		volatile atomic &slot = getSlot();
+		lockInc(slot);
+		if (readAcquire(&writer) == 0) return true;
+		lockDec(slot);
+		drained.wakeUp();
+		return false;
+	}
+
+	///locks for write
+	void lockWrite();
+
+	///unlocks write
+	void unlockWrite();
+
+	///try lock for writing
+	bool tryLockWrite();
+
+	class WriteLock {
+	public:
+		void lock();
+		void unlock();
+		bool tryLock();
+	};
+
+	class ReadLock {
+	public:
+		void lock();
+		void unlock();
+		bool tryLock();
+	};
+
+	///Returns index of CPU, which runs the current thread
+	static natural getCurCPU();
+	///Returns count of CPUs in the system
+	static natural getCPUCount();
+
+protected:
+
+	///Counter of readers, one per cache line
+	struct Slot {
+		atomic readers;
+		char padding[64 - sizeof(atomic)];
+	};
+
+	///slots aligned to cache line
+	Slot *slots;
+	///count of slots - 1 (count is power of two)
+	natural slotMask;
+	///nonzero when writer owns the lock or waits for it
+	atomic writer;
+	///serializes writers, readers wait here while writer is active
+	FastLock writers;
+	///woken up when a reader leaves while the writer is waiting
+	ThreadSleeper drained;
+	///allocated memory of the slots
+	char *slotBuffer;
+
+	volatile atomic &getSlot() {
+		return slots[getCurCPU() & slotMask].readers;
+	}
+
+	///sum of all slots (total count of readers)
+	atomicValue countReaders() const;
+
+private:
+	DistRWLockBase(const DistRWLockBase &);
+	DistRWLockBase &operator=(const DistRWLockBase &);
+};
+
+
+///Read/Write lock with per-CPU reader counters
+/** See DistRWLockBase. Object can be cast to ReadLock or WriteLock to be used
+ * with the Synchronized class
+ *
+ * @code
+ * DistRWLock lock;
+ * Synchronized<DistRWLock::ReadLock> _(lock);
+ * @endcode
+ */
+class DistRWLock: public DistRWLockBase,
+				  public DistRWLockBase::WriteLock,
+				  public DistRWLockBase::ReadLock {
+public:
+
+	///Cast object to this class to receive read lock with standard lock-interface
+	typedef DistRWLockBase::ReadLock ReadLock;
+	///Cast object to this class to receive write lock with standard lock-interface
+	typedef DistRWLockBase::WriteLock WriteLock;
+
+};
+
+
+inline void DistRWLockBase::WriteLock::lock() {
+	static_cast<DistRWLock *>(this)->lockWrite();
+}
+
+inline void DistRWLockBase::WriteLock::unlock() {
+	static_cast<DistRWLock *>(this)->unlockWrite();
+}
+
+inline bool DistRWLockBase::WriteLock::tryLock() {
+	return static_cast<DistRWLock *>(this)->tryLockWrite();
+}
+
+inline void DistRWLockBase::ReadLock::lock() {
+	static_cast<DistRWLock *>(this)->lockRead();
+}
+
+inline void DistRWLockBase::ReadLock::unlock() {
+	static_cast<DistRWLock *>(this)->unlockRead();
+}
+
+inline bool DistRWLockBase::ReadLock::tryLock() {
+	return static_cast<DistRWLock *>(this)->tryLockRead();
+}
+
+}
+
+#endif /* LIGHTSPEED_MT_DISTRWLOCK_H_ */
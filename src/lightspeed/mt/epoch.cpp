@@ -0,0 +1,120 @@
+/*
+ * epoch.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "epoch.h"
+#include "../base/containers/autoArray.tcc"
+#include "../base/memory/singleton.h"
+
+namespace LightSpeed {
+
+///count of retired nodes which triggers advancing of the epoch
+static const natural collectThreshold = 64;
+///epochs are stored multiplied by two, bit 0 is used as active flag
+static const atomicValue epochStep = 2;
+
+EpochDomain::Participant::Participant(EpochDomain &domain)
+	:domain(domain),localEpoch(0),used(1),nesting(0),retireCount(0)
+	,rndState((Bin::natural64)(natural)this | 1),next(0) {
+	for (natural i = 0; i < 3; i++) limboEpoch[i] = 0;
+}
+
+EpochDomain::Participant::~Participant() {
+	for (natural i = 0; i < 3; i++) freeBucket(i);
+}
+
+void EpochDomain::Participant::freeBucket(natural b) {
+	AutoArray<Retired> &bucket = limbo[b];
+	for (natural i = 0; i < bucket.length(); i++)
+		bucket[i].delFn(bucket[i].ptr);
+	bucket.clear();
+}
+
+void EpochDomain::Participant::retire(void *ptr, DeleteFunction delFn) {
+	atomicValue e = readAcquire(&domain.globalEpoch);
+	natural b = (natural)(e / epochStep) % 3;
+	//bucket contains nodes retired three epochs ago, they are safe now
+	if (limboEpoch[b] != e) {
+		freeBucket(b);
+		limboEpoch[b] = e;
+	}
+	Retired r = {ptr, delFn};
+	limbo[b].add(r);
+	if (++retireCount >= collectThreshold) {
+		retireCount = 0;
+		domain.tryAdvance();
+		collect();
+	}
+}
+
+void EpochDomain::Participant::collect() {
+	atomicValue e = readAcquire(&domain.globalEpoch);
+	for (natural i = 0; i < 3; i++) {
+		if (limboEpoch[i] + 2 * epochStep <= e) freeBucket(i);
+	}
+}
+
+EpochDomain::EpochDomain():globalEpoch(0),participants(0) {}
+
+EpochDomain::~EpochDomain() {
+	tlsParticipant.unset(ITLSTable::getInstance());
+	Participant *p = participants;
+	while (p) {
+		Participant *n = p->next;
+		delete p;
+		p = n;
+	}
+}
+
+EpochDomain::Participant &EpochDomain::getParticipant() {
+	ITLSTable &tls = ITLSTable::getInstance();
+	Participant *p = tlsParticipant[tls];
+	if (p == 0) {
+		p = &acquireParticipant();
+		tlsParticipant.set(tls, p, &releaseParticipant);
+	}
+	return *p;
+}
+
+EpochDomain::Participant &EpochDomain::acquireParticipant() {
+	//reuse record of exited thread
+	for (Participant *p = readAcquirePtr(&participants); p; p = p->next) {
+		if (readAcquire(&p->used) == 0 && lockCompareExchange(p->used, 0, 1) == 0) {
+			p->collect();
+			return *p;
+		}
+	}
+	Participant *p = new Participant(*this);
+	Participant *top = participants, *cur;
+	do {
+		cur = top;
+		p->next = cur;
+		top = lockCompareExchangePtr<Participant>(&participants, cur, p);
+	} while (top != cur);
+	return *p;
+}
+
+void EpochDomain::releaseParticipant(void *ptr) {
+	Participant *p = reinterpret_cast<Participant *>(ptr);
+	p->nesting = 0;
+	writeRelease(&p->localEpoch, 0);
+	writeRelease(&p->used, 0);
+}
+
+bool EpochDomain::tryAdvance() {
+	atomicValue e = readAcquire(&globalEpoch);
+	for (Participant *p = readAcquirePtr(&participants); p; p = p->next) {
+		atomicValue l = readAcquire(&p->localEpoch);
+		if ((l & 1) && (l & ~1) != e) return false;
+	}
+	return lockCompareExchange(globalEpoch, e, e + epochStep) == e;
+}
+
+EpochDomain &EpochDomain::getInstance() {
+	return Singleton<EpochDomain,true>::getInstance();
+}
+
+}
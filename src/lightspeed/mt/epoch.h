@@ -0,0 +1,161 @@
+/*
+ * epoch.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_MT_EPOCH_H_
+#define LIGHTSPEED_MT_EPOCH_H_
+
+#include "atomic.h"
+#include "fastlock.h"
+#include "../base/containers/autoArray.h"
+#include "../base/sync/threadVar.h"
+
+namespace LightSpeed {
+
+///Epoch based memory reclamation
+/**
+ * Lock-free containers cannot delete removed nodes immediately, because other
+ * threads can still read them. The domain defers deletion until all threads,
+ * which could see the node, leave their critical sections.
+ *
+ * Threads access shared nodes inside of the critical section guarded by
+ * EpochGuard. Node removed from the container is passed to retire(). It is deleted
+ * once the global epoch advances twice, because every thread, which was inside
+ * of the critical section during the removal, has left it at that time.
+ *
+ * Each thread has own participant record, which is registered on the first
+ * use and stored in the TLS. Records are recycled when threads exit. Nodes
+ * retired by the exited thread are deleted by the next thread which takes
+ * the record, or by destructor of the domain.
+ *
+ * Critical sections should be short. A thread which stays in the section
+ * blocks deletion of all nodes retired meanwhile (but it never blocks other threads).
+ *
+ * Use getInstance() to receive the global domain, which is never destroyed.
+ * Other domains must exist until all threads which used them exit.
+ */
+class EpochDomain {
+public:
+
+	typedef void (*DeleteFunction)(void *ptr);
+
+	///Per thread state
+	class Participant {
+	public:
+
+		///Enters the critical section (can be nested)
+		void enter() {
+			if (nesting++ == 0) {
+				//full barrier, next reads cannot happen before epoch is published
+				lockExchange(localEpoch, readAcquire(&domain.globalEpoch) | 1);
+			}
+		}
+		///Leaves the critical section
+		void leave() {
+			if (--nesting == 0) writeRelease(&localEpoch, localEpoch & ~1);
+		}
+
+		///Retires the pointer, it will be deleted by the function later
+		void retire(void *ptr, DeleteFunction delFn);
+
+		///Deletes nodes which are no longer accessible
+		void collect();
+
+		///Fast random generator for the containers (skip list levels)
+		natural random() {
+			rndState ^= rndState << 13;
+			rndState ^= rndState >> 7;
+			rndState ^= rndState << 17;
+			return (natural)rndState;
+		}
+
+	protected:
+		friend class EpochDomain;
+
+		struct Retired {
+			void *ptr;
+			DeleteFunction delFn;
+		};
+
+		Participant(EpochDomain &domain);
+		~Participant();
+
+		EpochDomain &domain;
+		///epoch observed when section entered multiplied by two, bit 0 set when active
+		atomic localEpoch;
+		///nonzero when the record is used by a thread
+		atomic used;
+		natural nesting;
+		natural retireCount;
+		Bin::natural64 rndState;
+		Participant * volatile next;
+		AutoArray<Retired> limbo[3];
+		atomicValue limboEpoch[3];
+
+		void freeBucket(natural b);
+	};
+
+	///Scope guard of the critical section
+	class Guard {
+	public:
+		Guard(EpochDomain &domain):p(domain.getParticipant()) {p.enter();}
+		///Faster version, use when the participant is already known
+		Guard(Participant &p):p(p) {p.enter();}
+		~Guard() {p.leave();}
+
+		Participant &getParticipant() const {return p;}
+		///Retires the object of type T, it will be deleted by operator delete
+		template<typename T>
+		void retire(T *ptr) {p.retire(ptr, &deleteFunction<T>);}
+		///Retires the pointer, it will be deleted by the function
+		void retire(void *ptr, DeleteFunction delFn) {p.retire(ptr, delFn);}
+
+	protected:
+		Participant &p;
+	private:
+		Guard(const Guard &);
+		Guard &operator=(const Guard &);
+	};
+
+	EpochDomain();
+	///Deletes all retired nodes. Domain must not be used anymore
+	~EpochDomain();
+
+	///Returns participant record of the current thread, registers it when needed
+	Participant &getParticipant();
+
+	///Tries to advance the global epoch
+	/**
+	 * @retval true advanced
+	 * @retval false some thread is still in the section of the older epoch
+	 */
+	bool tryAdvance();
+
+	///Returns the global domain
+	static EpochDomain &getInstance();
+
+protected:
+
+	///global epoch multiplied by two
+	atomic globalEpoch;
+	///list of all records
+	Participant * volatile participants;
+	///TLS variable which keeps the record of the thread
+	ThreadVar<Participant> tlsParticipant;
+
+	Participant &acquireParticipant();
+	static void releaseParticipant(void *ptr);
+
+private:
+	EpochDomain(const EpochDomain &);
+	EpochDomain &operator=(const EpochDomain &);
+};
+
+typedef EpochDomain::Guard EpochGuard;
+
+}
+
+#endif /* LIGHTSPEED_MT_EPOCH_H_ */
@@ -0,0 +1,25 @@
+/*
+ * distRWLock.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "../distRWLock.h"
+#include <sched.h>
+#include <unistd.h>
+
+namespace LightSpeed {
+
+natural DistRWLockBase::getCurCPU() {
+	//sched_getcpu() is served by vDSO, it doesn't enter the kernel
+	int cpu = sched_getcpu();
+	return cpu < 0?0:(natural)cpu;
+}
+
+natural DistRWLockBase::getCPUCount() {
+	long cnt = sysconf(_SC_NPROCESSORS_CONF);
+	return cnt < 1?1:(natural)cnt;
+}
+
+}
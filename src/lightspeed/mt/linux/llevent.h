@@ -17,7 +17,12 @@ namespace LightSpeed {
     public:
 
         LLEvent(bool manualReset = false):manualReset(manualReset) {
-            int err = pthread_cond_init(&cond,0);
+            //deadlines are computed from SysTime::now(), which is CLOCK_MONOTONIC
+            pthread_condattr_t attr;
+            pthread_condattr_init(&attr);
+            pthread_condattr_setclock(&attr,CLOCK_MONOTONIC);
+            int err = pthread_cond_init(&cond,&attr);
+            pthread_condattr_destroy(&attr);
             if (err)
                 throw ErrNoWithDescException(THISLOCATION,err,
                 		String(L"LLEvent initialization failed"));
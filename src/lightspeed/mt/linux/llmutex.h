@@ -43,8 +43,13 @@ namespace LightSpeed {
         }
 
         bool lock(const Timeout &tm) const {
+#ifdef LIGHTSPEED_HAS_CLOCKWAIT
         	struct timespec tmsp = tm.getExpireTime().getTimeSpec();
+            int err = pthread_mutex_clocklock(&mutex,CLOCK_MONOTONIC,&tmsp);
+#else
+        	struct timespec tmsp = tm.getExpireTime().getRealTimeSpec();
             int err = pthread_mutex_timedlock(&mutex,&tmsp);
+#endif
             if (err == ETIMEDOUT) return false;
             if (err)
                 throw ErrNoWithDescException(THISLOCATION,err,
@@ -16,6 +16,9 @@
 #include "../../base/memory/smallAlloc.h"
 #include <fcntl.h>
 #include <wait.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
 #include "../../base/linux/env.h"
 #include "../../base/memory/singleton.h"
 #include <string.h>
@@ -382,6 +385,77 @@ namespace LightSpeed {
 		return h;
 	}
 
+#ifndef HAVE_POSIX_SPAWN
+#define HAVE_POSIX_SPAWN 0
+#endif
+
+#ifndef HAVE_POSIX_SPAWN_ADDCHDIR_NP
+#define HAVE_POSIX_SPAWN_ADDCHDIR_NP 0
+#endif
+
+#if HAVE_POSIX_SPAWN
+
+	//glibc 2.29+ clears FD_CLOEXEC when posix_spawn_file_actions_adddup2 has the same source and target
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2,29)
+#define LIGHTSPEED_SPAWN_DUP2_CLEARS_CLOEXEC 1
+#endif
+#endif
+
+#ifndef LIGHTSPEED_SPAWN_DUP2_CLEARS_CLOEXEC
+#define LIGHTSPEED_SPAWN_DUP2_CLEARS_CLOEXEC 0
+#endif
+
+	///Starts the process through posix_spawn
+	/**
+	 * posix_spawn is implemented through clone(CLONE_VM|CLONE_VFORK), so page tables
+	 * of the parent are not copied and there is no need for the status pipe, because
+	 * exec failure is reported directly as return value. Function cannot handle
+	 * every configuration supported by fork-exec path.
+	 *
+	 * @param pid receives pid of the new process
+	 * @param errn receives error code, or zero if process has been started
+	 * @retval true request has been handled, check errn for result
+	 * @retval false request cannot be handled, caller have to use fork-exec
+	 */
+	static bool posixSpawnProcess(const LinuxProcessContext &ctx, const char *fname,
+			char **cmdLine, char **envTable, const char *cwd,
+			int hInput, int hOutput, int hError, int &pid, int &errn) {
+
+		//redirections in range 0-2 can collide each other, fork-exec handles this
+		if ((hInput >= 0 && hInput <= 2)
+			|| (hOutput >= 0 && hOutput <= 2)
+			|| (hError >= 0 && hError <= 2)) return false;
+		//there is no way to change working directory
+		if (*cwd != 0 && !HAVE_POSIX_SPAWN_ADDCHDIR_NP) return false;
+		//there is no way to clear FD_CLOEXEC on extra streams
+		if (!ctx.extraStreams.empty() && !LIGHTSPEED_SPAWN_DUP2_CLEARS_CLOEXEC) return false;
+
+		posix_spawn_file_actions_t factions;
+		errn = posix_spawn_file_actions_init(&factions);
+		if (errn) return true;
+
+		if (hInput >= 0) posix_spawn_file_actions_adddup2(&factions,hInput,0);
+		if (hOutput >= 0) posix_spawn_file_actions_adddup2(&factions,hOutput,1);
+		if (hError >= 0) posix_spawn_file_actions_adddup2(&factions,hError,2);
+
+		//dup2 to itself exports the stream to the child process
+		for (natural i = 0; i < ctx.extraStreams.length(); i++) {
+			int fd;
+			ctx.extraStreams[i]->getIfc<IFileExtractHandle>().getHandle(&fd,sizeof(fd));
+			posix_spawn_file_actions_adddup2(&factions,fd,fd);
+		}
+
+#if HAVE_POSIX_SPAWN_ADDCHDIR_NP
+		if (*cwd != 0) posix_spawn_file_actions_addchdir_np(&factions,cwd);
+#endif
+
+		errn = posix_spawn(&pid,fname,&factions,0,cmdLine,envTable);
+		posix_spawn_file_actions_destroy(&factions);
+		return true;
+	}
+#endif
+
 	void Process::start() {
 
 		LinuxProcessContext &ctx = LinuxProcessContext::getCtx(*context);
@@ -439,6 +513,27 @@ namespace LightSpeed {
 		StringA cwdutf8 = cwd.getUtf8();
 		const char *cwdchr = cwdutf8.c_str();
 
+#if HAVE_POSIX_SPAWN
+		{
+			int spawnPid, errn;
+			if (posixSpawnProcess(ctx,fname.cStr(),cmdLine,envTable,cwdchr,
+					hInput,hOutput,hError,spawnPid,errn)) {
+				//close all fds duplicated into child
+				ctx.input = nil;
+				ctx.output = nil;
+				ctx.error = nil;
+				ctx.extraStreams.clear();
+				if (errn)
+					throw UnableToStartProcessException(THISLOCATION,errn,getCmdLine());
+				//store pid of new process
+				ctx.pid = spawnPid;
+				//close finish gate
+				finishGate.close();
+				return;
+			}
+		}
+#endif
+
 		//create pipe to exec status
 		Pipe ipcstatus;
 		//store read end to statusRead stream
@@ -917,6 +1012,159 @@ namespace LightSpeed {
 	}
 
 
+	///opens pidfd for the process. Returns -1 if not supported by the kernel
+	static int openPidFd(int pid) {
+#ifdef SYS_pidfd_open
+		return (int)syscall(SYS_pidfd_open,pid,0);
+#else
+		(void)pid;
+		return -1;
+#endif
+	}
+
+	///period of checking processes without pidfd (in milliseconds)
+	static const natural processGroupPollInterval = 10;
+
+	ProcessGroup::ProcessGroup():epollfd(epoll_create1(EPOLL_CLOEXEC)) {
+		if (epollfd == -1) throw ErrNoException(THISLOCATION,errno);
+	}
+
+	ProcessGroup::~ProcessGroup() {
+		for (natural i = 0; i < members.length(); i++) untrack(members(i));
+		close(epollfd);
+	}
+
+	ProcessGroup &ProcessGroup::add(Process &p) {
+		members.add(Member(&p));
+		track(members(members.length()-1));
+		return *this;
+	}
+
+	ProcessGroup &ProcessGroup::remove(Process &p) {
+		for (natural i = 0; i < members.length(); i++) {
+			if (members[i].proc == &p) {
+				untrack(members(i));
+				members.erase(i);
+				break;
+			}
+		}
+		return *this;
+	}
+
+	void ProcessGroup::track(Member &m) {
+		if (m.pidfd != -1 || !m.proc->isRunning()) return;
+		LinuxProcessContext &ctx = LinuxProcessContext::getCtx(*m.proc->context);
+		int fd = openPidFd(ctx.pid);
+		//not supported, process will be checked periodically
+		if (fd == -1) return;
+		struct epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.ptr = m.proc;
+		if (epoll_ctl(epollfd,EPOLL_CTL_ADD,fd,&ev) == -1) {
+			int e = errno;
+			close(fd);
+			throw ErrNoException(THISLOCATION,e);
+		}
+		m.pidfd = fd;
+	}
+
+	void ProcessGroup::untrack(Member &m) {
+		if (m.pidfd != -1) {
+			//descriptor can be still referenced by a child which has not executed exec yet,
+			//so closing doesn't remove it from the epoll
+			epoll_ctl(epollfd,EPOLL_CTL_DEL,m.pidfd,0);
+			close(m.pidfd);
+			m.pidfd = -1;
+		}
+	}
+
+	natural ProcessGroup::start() {
+		natural cnt = 0;
+		for (natural i = 0; i < members.length(); i++) {
+			Member &m = members(i);
+			if (!m.proc->isRunning()) {
+				untrack(m);
+				m.proc->start();
+				track(m);
+				cnt++;
+			}
+		}
+		return cnt;
+	}
+
+	Process *ProcessGroup::reap(natural index) {
+		Member &m = members(index);
+		untrack(m);
+		m.proc->join();
+		return m.proc;
+	}
+
+	Process *ProcessGroup::waitAny(const Timeout &tm) {
+
+		while (true) {
+			bool anyRunning = false;
+			bool needPoll = false;
+			//check processes without pidfd, they can be reaped without waiting
+			for (natural i = 0; i < members.length(); i++) {
+				Member &m = members(i);
+				if (!m.proc->isRunning()) continue;
+				anyRunning = true;
+				//process could be started outside of the group
+				if (m.pidfd == -1) track(m);
+				if (m.pidfd == -1) {
+					LinuxProcessContext &ctx = LinuxProcessContext::getCtx(*m.proc->context);
+					if (processWaitPid(ctx,WNOHANG) != -256) {
+						m.proc->finishGate.open();
+						ctx.cmdLine.clear();
+						return m.proc;
+					}
+					needPoll = true;
+				}
+			}
+			if (!anyRunning) return 0;
+
+			natural remain = tm.getRemain().msecs();
+			if (needPoll && remain > processGroupPollInterval)
+				remain = processGroupPollInterval;
+
+			struct epoll_event ev;
+			int res = epoll_wait(epollfd,&ev,1,(int)remain);
+			if (res == -1) {
+				int e = errno;
+				if (e != EINTR) throw ErrNoException(THISLOCATION,e);
+			} else if (res == 1) {
+				Process *p = reinterpret_cast<Process *>(ev.data.ptr);
+				for (natural i = 0; i < members.length(); i++) {
+					if (members[i].proc == p) return reap(i);
+				}
+			} else if (tm.expired()) {
+				return 0;
+			}
+		}
+	}
+
+	bool ProcessGroup::joinAll(const Timeout &tm) {
+		while (getRunningCount() != 0) {
+			if (waitAny(tm) == 0 && tm.expired()) return false;
+		}
+		return true;
+	}
+
+	void ProcessGroup::stopAll(bool force) {
+		for (natural i = 0; i < members.length(); i++) {
+			if (members[i].proc->isRunning()) members[i].proc->stop(force);
+		}
+	}
+
+	natural ProcessGroup::getRunningCount() const {
+		natural cnt = 0;
+		for (natural i = 0; i < members.length(); i++) {
+			if (members[i].proc->isRunning()) cnt++;
+		}
+		return cnt;
+	}
+
+
 }
 
 
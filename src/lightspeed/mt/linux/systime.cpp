@@ -0,0 +1,36 @@
+/*
+ * systime.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "systime.h"
+
+namespace LightSpeed {
+
+static __thread bool clockCacheEnabled = false;
+static __thread struct timeval clockCache;
+
+SysTime SysTime::cached() {
+	if (clockCacheEnabled) return SysTime(clockCache);
+	else return now();
+}
+
+CachedClock::CachedClock():prevEnabled(clockCacheEnabled),prevTime(clockCache) {
+	clockCacheEnabled = true;
+	refresh();
+}
+
+CachedClock::~CachedClock() {
+	clockCacheEnabled = prevEnabled;
+	clockCache = prevTime.getTimeVal();
+}
+
+SysTime CachedClock::refresh() {
+	SysTime t = SysTime::now();
+	clockCache = t.getTimeVal();
+	return t;
+}
+
+}
@@ -6,6 +6,13 @@
 #include "../../base/types.h"
 #include "../../base/compare.h"
 
+///glibc supports waiting with CLOCK_MONOTONIC (sem_clockwait, pthread_mutex_clocklock)
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2,30)
+#define LIGHTSPEED_HAS_CLOCKWAIT 1
+#endif
+#endif
+
 namespace LightSpeed
 {
 
@@ -65,13 +72,49 @@ namespace LightSpeed
             }   
             
             ///Returns current system time
-            /** Makes snapshot and returns it as SysTime
+            /** Makes snapshot and returns it as SysTime. Time is read from
+             * the CLOCK_MONOTONIC, so it is not affected by changes of the
+             * wall-clock time.
+             *
+             * @note Time is counted from an unspecified point, so hour(), min(),
+             * sec() and msec() don't return the time of the day. Use wallClock()
+             * for that.
              */
             static SysTime now() {
+                struct timespec tm;
+                clock_gettime(CLOCK_MONOTONIC,&tm);
+                return SysTime(tm.tv_sec, tm.tv_nsec / 1000);
+            }
+
+            ///Returns current wall-clock time
+            /** Time is read from the CLOCK_REALTIME. Use it where the time of
+             * the day is needed. Don't use it to measure intervals, because it
+             * jumps when the system time is adjusted. Result cannot be mixed with
+             * the result of now()
+             */
+            static SysTime wallClock() {
                 struct timeval tm;
                 gettimeofday(&tm,0);
                 return tm;
             }
+
+            ///Returns current system time with reduced resolution
+            /** Time is read from the CLOCK_MONOTONIC_COARSE. It is cheaper
+             * than now(), but resolution is limited by the kernel tick
+             * (typically 1-4 ms). Use it, where time is only compared
+             * with long intervals.
+             */
+            static SysTime coarse() {
+                struct timespec tm;
+                clock_gettime(CLOCK_MONOTONIC_COARSE,&tm);
+                return SysTime(tm.tv_sec, tm.tv_nsec / 1000);
+            }
+
+            ///Returns time cached by the current thread
+            /** If the thread runs CachedClock, function returns the time of
+             * the last CachedClock::refresh(). Otherwise, it returns now()
+             */
+            static SysTime cached();
             
                         
             SysTime operator+(const SysTime &other) const {
@@ -186,6 +229,12 @@ namespace LightSpeed
             	return res;
             }
 
+            ///Converts time returned by now() to absolute time of the CLOCK_REALTIME
+            /** Use for functions, which don't accept monotonic clock */
+            const struct timespec getRealTimeSpec() const {
+            	return (wallClock() + (*this - now())).getTimeSpec();
+            }
+
             template<typename Arch>
             void serialize(Arch &arch) {
             	arch(curTime.tv_sec);
@@ -224,7 +273,34 @@ namespace LightSpeed
             }
 
         };
-    
+
+
+        ///Enables cache of the current time in the current thread
+        /** Event loops create this object for the duration of the loop and
+         * call refresh() once per iteration. While the object exists,
+         * SysTime::cached() and the Timeout created in this thread use time of the
+         * last refresh and don't need to read the clock.
+         *
+         * Objects can be nested, destructor restores the previous state.
+         */
+        class CachedClock {
+        public:
+            CachedClock();
+            ~CachedClock();
+
+            ///Reads the clock and stores the time to the cache
+            /**
+             * @return current time
+             */
+            SysTime refresh();
+
+        protected:
+            bool prevEnabled;
+            SysTime prevTime;
+
+            CachedClock(const CachedClock &);
+            CachedClock &operator=(const CachedClock &);
+        };
 
 
 
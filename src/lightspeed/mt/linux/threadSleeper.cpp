@@ -8,14 +8,59 @@
 
 #include "threadSleeper.h"
 #include <errno.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include "../../base/exceptions/systemException.h"
+#include "../../base/exceptions/invalidParamException.h"
 #include "atomic.h"
 
+#ifndef __NR_futex_waitv
+#define __NR_futex_waitv 449
+#endif
+
 namespace LightSpeed {
 
+///Entry of futex_waitv(), defined here, because older headers don't have it
+struct FutexWaitV {
+	Bin::natural64 val;
+	Bin::natural64 uaddr;
+	Bin::natural32 flags;
+	Bin::natural32 reserved;
+};
+
+static const Bin::natural32 futexSize32 = 2;
+static const natural maxSleepAny = 128;
+
+static inline int futexWait(volatile int *addr, int val, const timespec *absTime) {
+	//FUTEX_WAIT_BITSET uses absolute time measured by CLOCK_MONOTONIC
+	return (int)syscall(SYS_futex, addr, FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, val,
+			absTime, 0, FUTEX_BITSET_MATCH_ANY);
+}
+
+static inline void futexWake(volatile int *addr) {
+	syscall(SYS_futex, addr, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1, 0, 0, 0);
+}
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#endif
+}
+
+///count of checks before thread is parked. Spinning has no sense on single CPU
+static natural getSpinCount() {
+	static natural spins = sysconf(_SC_NPROCESSORS_ONLN) > 1?100:0;
+	return spins;
+}
+
+static inline bool casState(volatile int &state, int expect, int value) {
+	return __atomic_compare_exchange_n(&state, &expect, value, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
 
-ThreadSleeper::ThreadSleeper():reason(0) {
-	sem_init(&semaphore,0,0);
+ThreadSleeper::ThreadSleeper():state(stateIdle),reason(0) {
 	enableMTAccess();
 }
 
@@ -24,33 +69,120 @@ natural ThreadSleeper::getReason() const {
 }
 
 void ThreadSleeper::wakeUp(natural reason ) throw() {
-	int val = 0;
 	this->reason = reason;
-	sem_getvalue(&semaphore,&val);
-	if (val < 1) sem_post(&semaphore);
-
+	//kernel is entered only when somebody is parked
+	if (__atomic_exchange_n(&state, stateSignaled, __ATOMIC_ACQ_REL) == stateParked)
+		futexWake(&state);
 }
 
 ThreadSleeper::~ThreadSleeper() {
-	sem_destroy(&semaphore);
+}
+
+bool ThreadSleeper::tryConsume() {
+	return casState(state, stateSignaled, stateIdle);
 }
 
 bool ThreadSleeper::sleep(Timeout timeout) {
-	if (timeout.isInfinite()) {
-		sem_wait(&semaphore);
-	} else {
-		timespec tmspc = timeout.getExpireTime().getTimeSpec();
-		int res = sem_timedwait(&semaphore,&tmspc);
+	for (natural i = 0, cnt = getSpinCount(); i < cnt; i++) {
+		if (__atomic_load_n(&state, __ATOMIC_RELAXED) == stateSignaled && tryConsume()) return false;
+		cpuRelax();
+	}
+	timespec tmspc;
+	const timespec *tmptr = 0;
+	if (!timeout.isInfinite()) {
+		tmspc = timeout.getExpireTime().getTimeSpec();
+		tmptr = &tmspc;
+	}
+	while (true) {
+		int s = __atomic_load_n(&state, __ATOMIC_ACQUIRE);
+		if (s == stateSignaled) {
+			if (tryConsume()) return false;
+			continue;
+		}
+		if (s == stateIdle && !casState(state, stateIdle, stateParked)) continue;
+		if (futexWait(&state, stateParked, tmptr) == -1) {
+			int e = errno;
+			if (e == EAGAIN) continue;
+			if (e == ETIMEDOUT || e == EINTR) {
+				if (casState(state, stateParked, stateIdle)) {
+					//Consider EINTR as wakeUp
+					return e == ETIMEDOUT;
+				}
+				//wake up arrived meanwhile
+				continue;
+			}
+			throw ErrNoException(THISLOCATION,e);
+		}
+	}
+}
+
+natural ThreadSleeper::sleepAny(ThreadSleeper *const *sleepers, natural count, Timeout tm) {
+	if (count > maxSleepAny)
+		throw InvalidParamException(THISLOCATION,2,"Too many sleepers (max 128)");
+	FutexWaitV waiters[maxSleepAny];
+	//shared by all threads, set once the kernel reports that futex_waitv is missing
+	static atomic waitvMissing = 0;
+	timespec tmspc;
+	const timespec *tmptr = 0;
+	if (!tm.isInfinite()) {
+		tmspc = tm.getExpireTime().getTimeSpec();
+		tmptr = &tmspc;
+	}
+	natural found = naturalNull;
+	while (found == naturalNull) {
+		//register as sleeping on all sleepers or find one which is signaled
+		for (natural i = 0; i < count && found == naturalNull; i++) {
+			volatile int &s = sleepers[i]->state;
+			while (true) {
+				int v = __atomic_load_n(&s, __ATOMIC_ACQUIRE);
+				if (v == stateSignaled) {
+					if (sleepers[i]->tryConsume()) {found = i;break;}
+				} else if (v == stateParked || casState(s, stateIdle, stateParked)) {
+					break;
+				}
+			}
+			waiters[i].val = stateParked;
+			waiters[i].uaddr = (Bin::natural64)(natural)&s;
+			waiters[i].flags = futexSize32 | FUTEX_PRIVATE_FLAG;
+			waiters[i].reserved = 0;
+		}
+		if (found != naturalNull) break;
+
+		//flag is read once, other thread can set it meanwhile
+		bool useWaitv = readAcquire(&waitvMissing) == 0;
+		int res = 0;
+		if (useWaitv) {
+			res = (int)syscall(__NR_futex_waitv, waiters, (unsigned int)count, 0, tmptr, CLOCK_MONOTONIC);
+			if (res == -1 && errno == ENOSYS) {
+				writeRelease(&waitvMissing, 1);
+				useWaitv = false;
+			}
+		}
+		if (!useWaitv) {
+			//wait on first sleeper, check others after 1 ms
+			Timeout part(SysTime::now(), 1);
+			if (!tm.isInfinite() && tm < part) part = tm;
+			timespec partspc = part.getExpireTime().getTimeSpec();
+			res = futexWait(&sleepers[0]->state, stateParked, &partspc);
+			if (res == -1 && errno == ETIMEDOUT && !tm.expired()) res = 0;
+		}
 		if (res == -1) {
 			int e = errno;
-			if (e == ETIMEDOUT) return true;
-			if (e != EINTR) throw ErrNoException(THISLOCATION,e);
-			//Consider EINTR as wakeUp
-			return false;
+			if (e != EAGAIN && e != EINTR && e != ETIMEDOUT)
+				throw ErrNoException(THISLOCATION,e);
+			if (e == ETIMEDOUT) break;
 		}
 	}
-	while (sem_trywait(&semaphore) == 0) {}
-	return false;
+	//unregister from other sleepers
+	for (natural i = 0; i < count; i++) {
+		casState(sleepers[i]->state, stateParked, stateIdle);
+	}
+	if (found == naturalNull) {
+		//last chance - wake up could arrive after timeout
+		for (natural i = 0; i < count; i++)
+			if (sleepers[i]->tryConsume()) return i;
+	}
+	return found;
 }
 
 }
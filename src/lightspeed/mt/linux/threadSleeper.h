@@ -8,8 +8,6 @@
 #ifndef LIGHTSPEED_LINUX_MT_THREADSLEEPER_H_
 #define LIGHTSPEED_LINUX_MT_THREADSLEEPER_H_
 
-#include <semaphore.h>
-
 #include "../threadSleeper.h"
 
 
@@ -24,10 +22,36 @@ namespace LightSpeed {
 		void wakeUp(natural reason = 0) throw();
 		bool sleep(Timeout tm);
 
+		///Sleeps until any of the sleepers is woken up
+		/**
+		 * Function uses futex_waitv() when it is supported by the kernel (5.16+).
+		 * On older kernels it waits on the first sleeper and checks other sleepers
+		 * periodically. As with sleep(), only one thread can sleep on the
+		 * sleeper at the time.
+		 *
+		 * @param sleepers array of sleepers
+		 * @param count count of sleepers (max 128)
+		 * @param tm timeout
+		 * @exception InvalidParamException too many sleepers
+		 * @return index of sleeper which has been woken up (its wake up is consumed),
+		 *  or naturalNull, when timeout ellapsed
+		 */
+		static natural sleepAny(ThreadSleeper *const *sleepers, natural count, Timeout tm);
+
 	protected:
-		sem_t semaphore;
+		///futex word - one of stateIdle, stateSignaled, stateParked
+		volatile int state;
 		natural reason;
 
+		///no wake up pending, nobody is sleeping
+		static const int stateIdle = 0;
+		///wake up is pending
+		static const int stateSignaled = 1;
+		///thread is (or is going to be) parked in kernel
+		static const int stateParked = 2;
+
+		bool tryConsume();
+
 
 	};
 
@@ -0,0 +1,87 @@
+/*
+ * tscClock.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "../tscClock.h"
+#include "../atomic.h"
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define LIGHTSPEED_TSC_SUPPORTED 1
+#endif
+
+namespace LightSpeed {
+
+///0 - not initialized, 1 - initializing, 2 - ready
+static atomic tscState = 0;
+static bool tscUsed = false;
+static double tscNsPerTick = 1.0;
+
+static Bin::natural64 monotonicNs() {
+	struct timespec tm;
+	clock_gettime(CLOCK_MONOTONIC,&tm);
+	return (Bin::natural64)tm.tv_sec * 1000000000 + tm.tv_nsec;
+}
+
+#ifdef LIGHTSPEED_TSC_SUPPORTED
+static bool hasInvariantTsc() {
+	unsigned int a,b,c,d;
+	if (!__get_cpuid(0x80000000,&a,&b,&c,&d) || a < 0x80000007) return false;
+	__get_cpuid(0x80000007,&a,&b,&c,&d);
+	return (d & (1 << 8)) != 0;
+}
+#endif
+
+static void initTsc() {
+	if (lockCompareExchange(tscState,0,1) != 0) {
+		//other thread calibrates
+		while (readAcquire(&tscState) != 2) {}
+		return;
+	}
+#ifdef LIGHTSPEED_TSC_SUPPORTED
+	if (hasInvariantTsc()) {
+		Bin::natural64 t1 = monotonicNs();
+		Bin::natural64 c1 = __rdtsc();
+		Bin::natural64 t2;
+		do {
+			t2 = monotonicNs();
+		} while (t2 - t1 < 10000000);
+		Bin::natural64 c2 = __rdtsc();
+		if (c2 > c1) {
+			tscNsPerTick = (double)(t2 - t1) / (double)(c2 - c1);
+			tscUsed = true;
+		}
+	}
+#endif
+	writeRelease(&tscState,2);
+}
+
+TscClock::Ticks TscClock::read() {
+	if (readAcquire(&tscState) != 2) initTsc();
+#ifdef LIGHTSPEED_TSC_SUPPORTED
+	if (tscUsed) return __rdtsc();
+#endif
+	return monotonicNs();
+}
+
+Bin::natural64 TscClock::toNanosecs(Ticks ticks) {
+	if (readAcquire(&tscState) != 2) initTsc();
+	if (!tscUsed) return ticks;
+	return (Bin::natural64)((double)ticks * tscNsPerTick);
+}
+
+bool TscClock::isTsc() {
+	if (readAcquire(&tscState) != 2) initTsc();
+	return tscUsed;
+}
+
+double TscClock::getFrequency() {
+	if (readAcquire(&tscState) != 2) initTsc();
+	return 1e9 / tscNsPerTick;
+}
+
+}
@@ -0,0 +1,302 @@
+/*
+ * lockFreeMap.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_MT_LOCKFREEMAP_H_
+#define LIGHTSPEED_MT_LOCKFREEMAP_H_
+
+#include "epoch.h"
+#include <new>
+#include <functional>
+
+namespace LightSpeed {
+
+///Lock-free ordered map implemented as skip list
+/**
+ * Map uses lock-free skip list (Herlihy, Shavit). Removed nodes are
+ * marked, unlinked by any thread which passes them and deleted through
+ * the EpochDomain once they are unlinked from all levels.
+ *
+ * Values are immutable while they are in the map. To change a value, erase
+ * it and insert again.
+ *
+ * All functions are MT safe. Lookups never write shared memory.
+ *
+ * @tparam K type of key
+ * @tparam V type of value. It must be copy constructible and assignable
+ * @tparam Cmp compare operator (less)
+ */
+template<typename K, typename V, typename Cmp = std::less<K> >
+class LockFreeMap {
+public:
+
+	static const natural maxLevels = 24;
+
+	LockFreeMap(EpochDomain &domain = EpochDomain::getInstance(), const Cmp &cmp = Cmp())
+		:head(createNode(0, 0, maxLevels)),domain(domain),cmp(cmp) {}
+	~LockFreeMap() {
+		//unlink removed nodes, which can be still linked at the upper levels
+		for (natural l = maxLevels; l-- > 0;) {
+			Node *pred = head;
+			Node *cur = ptrOf(pred->next[l]);
+			while (cur) {
+				Node *n = ptrOf(cur->next[l]);
+				if (isMarked(cur->next[0])) {
+					pred->next[l] = (atomicValue)n;
+					if (--cur->links == 0) deleteNode(cur);
+				} else {
+					pred = cur;
+				}
+				cur = n;
+			}
+		}
+		Node *p = head;
+		while (p) {
+			Node *n = ptrOf(p->next[0]);
+			deleteNode(p);
+			p = n;
+		}
+	}
+
+	///Inserts new key
+	/**
+	 * @param key key
+	 * @param value value
+	 * @retval true inserted
+	 * @retval false key already exists
+	 */
+	bool insert(const K &key, const V &value) {
+		EpochGuard guard(domain);
+		Node *preds[maxLevels], *succs[maxLevels];
+		EpochDomain::Participant &p = guard.getParticipant();
+		natural height = randomHeight(p);
+		Node *nd = 0;
+		while (true) {
+			if (find(key, preds, succs, p)) {
+				if (nd) deleteNode(nd);
+				return false;
+			}
+			if (nd == 0) nd = createNode(&key, &value, height);
+			for (natural l = 0; l < height; l++) nd->next[l] = (atomicValue)succs[l];
+			if (casNext(preds[0], 0, succs[0], nd)) break;
+		}
+		//node is published, link upper levels
+		natural linked = 1;
+		bool abort = false;
+		for (natural l = 1; l < height && !abort; l++) {
+			while (true) {
+				atomicValue succ = nd->next[l];
+				//node has been erased meanwhile
+				if (isMarked(succ)) {abort = true;break;}
+				if (ptrOf(succ) != succs[l]
+						&& lockCompareExchange(nd->next[l], succ, (atomicValue)succs[l]) != succ)
+					continue;
+				if (casNext(preds[l], l, succs[l], nd)) {
+					linked++;
+					break;
+				}
+				if (!find(key, preds, succs, p) || succs[0] != nd) {abort = true;break;}
+			}
+		}
+		//node could be erased during linking, ensure, that it is unlinked
+		if (isMarked(nd->next[0])) find(key, preds, succs, p);
+		if (lockExchangeAdd(nd->links, (atomicValue)linked - linkBias) == linkBias - (atomicValue)linked)
+			p.retire(nd, &deleteNodeFn);
+		return true;
+	}
+
+	///Finds the key
+	/**
+	 * @param key key to find
+	 * @param value variable which receives the value
+	 * @retval true found
+	 * @retval false not found
+	 */
+	bool find(const K &key, V &value) const {
+		EpochGuard guard(domain);
+		Node *pred = head;
+		Node *cur = 0;
+		for (natural l = maxLevels; l-- > 0;) {
+			cur = ptrOf(readAcquire(&pred->next[l]));
+			while (cur) {
+				atomicValue succ = readAcquire(&cur->next[l]);
+				//skip removed nodes without unlinking
+				if (isMarked(succ)) {cur = ptrOf(succ);continue;}
+				if (cmp(cur->kv->key, key)) {
+					pred = cur;
+					cur = ptrOf(succ);
+				} else {
+					break;
+				}
+			}
+		}
+		if (cur == 0 || cmp(key, cur->kv->key) || isMarked(readAcquire(&cur->next[0])))
+			return false;
+		value = cur->kv->value;
+		return true;
+	}
+
+	///Returns true, when key is in the map
+	bool contains(const K &key) const {
+		V v;
+		return find(key, v);
+	}
+
+	///Erases the key
+	/**
+	 * @param key key to erase
+	 * @retval true erased
+	 * @retval false not found
+	 */
+	bool erase(const K &key) {
+		EpochGuard guard(domain);
+		Node *preds[maxLevels], *succs[maxLevels];
+		EpochDomain::Participant &p = guard.getParticipant();
+		if (!find(key, preds, succs, p)) return false;
+		Node *victim = succs[0];
+		for (natural l = victim->height; l-- > 1;) {
+			atomicValue succ = readAcquire(&victim->next[l]);
+			while (!isMarked(succ)) {
+				lockCompareExchange(victim->next[l], succ, succ | 1);
+				succ = readAcquire(&victim->next[l]);
+			}
+		}
+		atomicValue succ = readAcquire(&victim->next[0]);
+		while (true) {
+			if (isMarked(succ)) return false;
+			atomicValue r = lockCompareExchange(victim->next[0], succ, succ | 1);
+			if (r == succ) break;
+			succ = r;
+		}
+		//unlink from all levels
+		find(key, preds, succs, p);
+		return true;
+	}
+
+	///Calls function for every item in order
+	/**
+	 * @param fn function called with (const K &, const V &). Items inserted or erased
+	 * during the iteration may or may not be visited
+	 */
+	template<typename Fn>
+	void forEach(Fn fn) const {
+		EpochGuard guard(domain);
+		Node *p = ptrOf(readAcquire(&head->next[0]));
+		while (p) {
+			atomicValue n = readAcquire(&p->next[0]);
+			if (!isMarked(n)) fn(p->kv->key, p->kv->value);
+			p = ptrOf(n);
+		}
+	}
+
+protected:
+
+	struct KeyValue {
+		K key;
+		V value;
+		KeyValue(const K &key, const V &value):key(key),value(value) {}
+	};
+
+	struct Node {
+		///key and value, NULL for the head
+		KeyValue *kv;
+		natural height;
+		///count of linked levels plus bias while the node is linked
+		atomic links;
+		///pointers to next nodes, bit 0 marks the node removed
+		atomic next[1];
+	};
+
+	///bias of links counter while the inserting thread is linking node
+	static const atomicValue linkBias = 1 << 16;
+
+	Node *head;
+	EpochDomain &domain;
+	Cmp cmp;
+
+	static Node *ptrOf(atomicValue v) {return reinterpret_cast<Node *>(v & ~(atomicValue)1);}
+	static bool isMarked(atomicValue v) {return (v & 1) != 0;}
+
+	///offset of KeyValue in the block of the node
+	static natural kvOffset(natural height) {
+		natural sz = sizeof(Node) + (height - 1) * sizeof(atomic);
+		return (sz + 15) & ~(natural)15;
+	}
+	///Node and its KeyValue are allocated in one block
+	static Node *createNode(const K *key, const V *value, natural height) {
+		natural offs = kvOffset(height);
+		void *space = ::operator new(key?offs + sizeof(KeyValue):offs);
+		Node *nd = reinterpret_cast<Node *>(space);
+		nd->kv = 0;
+		if (key) {
+			try {
+				nd->kv = new((char *)space + offs) KeyValue(*key, *value);
+			} catch (...) {
+				::operator delete(space);
+				throw;
+			}
+		}
+		nd->height = height;
+		nd->links = linkBias;
+		for (natural i = 0; i < height; i++) nd->next[i] = 0;
+		return nd;
+	}
+	static void deleteNode(Node *nd) {
+		if (nd->kv) nd->kv->~KeyValue();
+		::operator delete(nd);
+	}
+	static void deleteNodeFn(void *ptr) {
+		deleteNode(reinterpret_cast<Node *>(ptr));
+	}
+
+	bool casNext(Node *pred, natural level, Node *expect, Node *value) {
+		return lockCompareExchange(pred->next[level], (atomicValue)expect, (atomicValue)value)
+				== (atomicValue)expect;
+	}
+
+	static natural randomHeight(EpochDomain::Participant &p) {
+		natural r = p.random();
+		natural h = 1;
+		while ((r & 1) && h < maxLevels) {
+			h++;
+			r >>= 1;
+		}
+		return h;
+	}
+
+	///Finds predecessors and successors of the key, unlinks removed nodes
+	bool find(const K &key, Node **preds, Node **succs, EpochDomain::Participant &p) {
+		retry:
+		Node *pred = head;
+		for (natural l = maxLevels; l-- > 0;) {
+			Node *cur = ptrOf(readAcquire(&pred->next[l]));
+			while (cur) {
+				atomicValue succ = readAcquire(&cur->next[l]);
+				if (isMarked(succ)) {
+					if (!casNext(pred, l, cur, ptrOf(succ))) goto retry;
+					if (lockDec(cur->links) == 0) p.retire(cur, &deleteNodeFn);
+					cur = ptrOf(succ);
+				} else if (cmp(cur->kv->key, key)) {
+					pred = cur;
+					cur = ptrOf(succ);
+				} else {
+					break;
+				}
+			}
+			preds[l] = pred;
+			succs[l] = cur;
+		}
+		return succs[0] != 0 && !cmp(key, succs[0]->kv->key);
+	}
+
+private:
+	LockFreeMap(const LockFreeMap &);
+	LockFreeMap &operator=(const LockFreeMap &);
+};
+
+}
+
+#endif /* LIGHTSPEED_MT_LOCKFREEMAP_H_ */
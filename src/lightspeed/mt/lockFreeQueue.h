@@ -0,0 +1,112 @@
+/*
+ * lockFreeQueue.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_MT_LOCKFREEQUEUE_H_
+#define LIGHTSPEED_MT_LOCKFREEQUEUE_H_
+
+#include "epoch.h"
+
+namespace LightSpeed {
+
+///Lock-free multiple producers - multiple consumers queue (FIFO)
+/**
+ * Queue is implemented as linked list with the dummy node (Michael & Scott).
+ * Removed nodes are deleted through the EpochDomain.
+ *
+ * All functions are MT safe
+ *
+ * @tparam T type of the value. It must be default constructible, copy
+ * constructible and assignable
+ */
+template<typename T>
+class LockFreeQueue {
+public:
+
+	LockFreeQueue(EpochDomain &domain = EpochDomain::getInstance()):domain(domain) {
+		head = tail = new Node(T());
+	}
+	~LockFreeQueue() {
+		Node *p = head;
+		while (p) {
+			Node *n = p->next;
+			delete p;
+			p = n;
+		}
+	}
+
+	///Adds value to the end of the queue
+	void push(const T &val) {
+		Node *nd = new Node(val);
+		EpochGuard guard(domain);
+		while (true) {
+			Node *t = readAcquirePtr(&tail);
+			Node *n = readAcquirePtr(&t->next);
+			if (n == 0) {
+				if (lockCompareExchangePtr<Node>(&t->next, 0, nd) == 0) {
+					lockCompareExchangePtr<Node>(&tail, t, nd);
+					return;
+				}
+			} else {
+				//help other producer to move tail
+				lockCompareExchangePtr<Node>(&tail, t, n);
+			}
+		}
+	}
+
+	///Removes value from the front of the queue
+	/**
+	 * @param val variable which receives the value
+	 * @retval true value removed
+	 * @retval false queue is empty
+	 */
+	bool pop(T &val) {
+		EpochGuard guard(domain);
+		while (true) {
+			Node *h = readAcquirePtr(&head);
+			Node *t = readAcquirePtr(&tail);
+			Node *n = readAcquirePtr(&h->next);
+			if (n == 0) return false;
+			if (h == t) {
+				lockCompareExchangePtr<Node>(&tail, t, n);
+				continue;
+			}
+			//read value before the node becomes dummy, next pop can delete it
+			T v = n->value;
+			if (lockCompareExchangePtr<Node>(&head, h, n) == h) {
+				val = v;
+				guard.retire(h);
+				return true;
+			}
+		}
+	}
+
+	///Returns true, when queue is empty (value can be obsolete)
+	bool empty() const {
+		return readAcquirePtr(&readAcquirePtr(&head)->next) == 0;
+	}
+
+protected:
+
+	struct Node {
+		T value;
+		Node * volatile next;
+
+		Node(const T &value):value(value),next(0) {}
+	};
+
+	Node * volatile head;
+	Node * volatile tail;
+	EpochDomain &domain;
+
+private:
+	LockFreeQueue(const LockFreeQueue &);
+	LockFreeQueue &operator=(const LockFreeQueue &);
+};
+
+}
+
+#endif /* LIGHTSPEED_MT_LOCKFREEQUEUE_H_ */
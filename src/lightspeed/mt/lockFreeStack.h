@@ -0,0 +1,93 @@
+/*
+ * lockFreeStack.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_MT_LOCKFREESTACK_H_
+#define LIGHTSPEED_MT_LOCKFREESTACK_H_
+
+#include "epoch.h"
+
+namespace LightSpeed {
+
+///Lock-free stack (LIFO) of values
+/**
+ * Unlike SList, stack allocates own nodes and it deletes them through the EpochDomain,
+ * so no thread can access released node and stack is not vulnerable to ABA problem.
+ *
+ * All functions are MT safe
+ *
+ * @tparam T type of the value. It must be copy constructible and assignable
+ */
+template<typename T>
+class LockFreeStack {
+public:
+
+	LockFreeStack(EpochDomain &domain = EpochDomain::getInstance()):top(0),domain(domain) {}
+	~LockFreeStack() {
+		Node *p = top;
+		while (p) {
+			Node *n = p->next;
+			delete p;
+			p = n;
+		}
+	}
+
+	///Pushes value to the stack
+	void push(const T &val) {
+		Node *nd = new Node(val);
+		Node *t = readAcquirePtr(&top), *cur;
+		do {
+			cur = t;
+			nd->next = cur;
+			t = lockCompareExchangePtr<Node>(&top, cur, nd);
+		} while (t != cur);
+	}
+
+	///Pops value from the stack
+	/**
+	 * @param val variable which receives the value
+	 * @retval true value popped
+	 * @retval false stack is empty
+	 */
+	bool pop(T &val) {
+		EpochGuard guard(domain);
+		Node *t = readAcquirePtr(&top), *cur;
+		do {
+			cur = t;
+			if (cur == 0) return false;
+			//node cannot be deleted while the guard is held
+			t = lockCompareExchangePtr<Node>(&top, cur, cur->next);
+		} while (t != cur);
+		val = cur->value;
+		guard.retire(cur);
+		return true;
+	}
+
+	///Returns true, when stack is empty (value can be obsolete)
+	bool empty() const {
+		return readAcquirePtr(&top) == 0;
+	}
+
+protected:
+
+	struct Node {
+		T value;
+		Node *next;
+
+		Node(const T &value):value(value),next(0) {}
+	};
+
+	Node * volatile top;
+	EpochDomain &domain;
+
+private:
+	LockFreeStack(const LockFreeStack &);
+	LockFreeStack &operator=(const LockFreeStack &);
+};
+
+}
+
+#endif /* LIGHTSPEED_MT_LOCKFREESTACK_H_ */
@@ -93,7 +93,7 @@ void SchedulerThread::worker()
 
 natural SchedulerThread::getSystemTime() const
 {
-	return SysTime::now().msec();
+	return SysTime::wallClock().msec();
 }
 natural SchedulerThread::getCurTime() const {return getSystemTime();}
 
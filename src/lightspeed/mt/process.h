@@ -11,6 +11,7 @@
 #include "../base/streams/fileio.h"
 #include "timeout.h"
 #include "../base/containers/map.h"
+#include "../base/containers/autoArray.h"
 #include "gate.h"
 #include "../base/memory/stdFactory.h"
 
@@ -352,6 +353,101 @@ namespace LightSpeed {
 		Gate finishGate;
 		PProcessContext context;
 
+		friend class ProcessGroup;
+
+	};
+
+
+	///Starts and reaps many processes at once
+	/**
+	 * ProcessGroup doesn't own the processes. It only keeps references to
+	 * the registered Process objects, so they must remain valid until they
+	 * are removed from the group or the group is destroyed.
+	 *
+	 * Function start() launches all registered processes which are not running
+	 * and registers them for the event driven reaping. Processes are spawned
+	 * one after another, there is no system call which spawns more processes
+	 * at once. Pipes are not pooled, they are created by the caller when the
+	 * process is configured (stdOut(), arg(), ...)
+	 *
+	 * Waiting is event driven. On Linux, every started process is tracked by
+	 * a pidfd registered in the epoll, so waitAny() sleeps until any child
+	 * exits, without blocking in waitpid() and without polling. If the kernel
+	 * doesn't support pidfd, the group falls back to periodic checking.
+	 */
+	class ProcessGroup {
+	public:
+
+		ProcessGroup();
+		~ProcessGroup();
+
+		///Registers process to the group
+		/**
+		 * @param p process to register. Process can be already running. In this
+		 * case, it is immediately tracked for the termination
+		 * @return reference to this object to allow chaining
+		 */
+		ProcessGroup &add(Process &p);
+
+		///Removes process from the group
+		/** Process is not stopped nor joined */
+		ProcessGroup &remove(Process &p);
+
+		///Starts all registered processes which are not running yet
+		/**
+		 * @return count of started processes
+		 *
+		 * @exception UnableToStartProcessException first process which failed to start.
+		 *  Processes started before failure are left running and tracked
+		 */
+		natural start();
+
+		///Waits until any process exits
+		/**
+		 * @param tm timeout
+		 * @return pointer to the process which exited. The process is already
+		 *   joined, so getExitCode() returns its exit code. Function returns
+		 *   nil when timeout elapsed or when there is no running process in the group
+		 */
+		Process *waitAny(const Timeout &tm = Timeout());
+
+		///Waits until all processes exit
+		/**
+		 * @param tm timeout
+		 * @retval true all processes exited and were joined
+		 * @retval false timeout
+		 */
+		bool joinAll(const Timeout &tm = Timeout());
+
+		///Stops all running processes
+		/** @param force see Process::stop() */
+		void stopAll(bool force = false);
+
+		///Returns count of registered processes
+		natural length() const {return members.length();}
+
+		///Returns count of running processes
+		natural getRunningCount() const;
+
+	protected:
+
+		struct Member {
+			Process *proc;
+			int pidfd;
+
+			Member(Process *proc):proc(proc),pidfd(-1) {}
+		};
+
+		AutoArray<Member> members;
+		int epollfd;
+
+		void track(Member &m);
+		void untrack(Member &m);
+		Process *reap(natural index);
+
+	private:
+		ProcessGroup(const ProcessGroup &);
+		ProcessGroup &operator=(const ProcessGroup &);
 	};
 
 
@@ -22,6 +22,9 @@ namespace LightSpeed {
 	 *   detection to 16 changes at the same time. If you see problem in modification detection, allocate
 	 *   items using higher align.
 	 *   
+	 * @note pop() reads the item, which can be removed and released by other thread at
+	 *   the same time. Such access is guarded by safeGetPointerValue() and the cookie only.
+	 *   Use LockFreeStack, when removed items are deleted frequently.
      */
 
 	 
@@ -45,8 +45,11 @@ namespace LightSpeed
         ///Constructs timeout specified by count of miliseconds from now
         /**
          * @param ms count of miliseconds in the future. If ms is equal to  naturalNull, timeout
+         *
+         * @note time is taken from SysTime::cached(). In the thread, which runs
+         * CachedClock (event loop), timeout is counted from the last refresh of the clock
          */
-        Timeout(natural ms): expireTime(ms == naturalNull?SysTime(nil):SysTime::now() + SysTime(0,0,0,0,ms)) {}
+        Timeout(natural ms): expireTime(ms == naturalNull?SysTime(nil):SysTime::cached() + SysTime(0,0,0,0,ms)) {}
 
         ///Constructs timeout specified by count of miliseconds from specified time
         /**
@@ -63,7 +66,7 @@ namespace LightSpeed
          * @param ms miliseconds
          */
         Timeout(natural h, natural m, natural s, natural ms)
-        : expireTime(SysTime::now() + SysTime(0,h,m,s,ms)) {}
+        : expireTime(SysTime::cached() + SysTime(0,h,m,s,ms)) {}
 
         ///Retrieves absolute time, when this timeout expires
         /**
@@ -0,0 +1,45 @@
+/*
+ * tscClock.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_MT_TSCCLOCK_H_
+#define LIGHTSPEED_MT_TSCCLOCK_H_
+
+#include "../base/types.h"
+
+namespace LightSpeed {
+
+	///High resolution counter for measuring short spans (profiling)
+	/**
+	 * On x86 with invariant TSC, counter reads the time stamp counter of the CPU,
+	 * which costs few nanoseconds. Ticks are converted to nanoseconds by the
+	 * ratio measured against the monotonic clock. Calibration takes about 10 ms
+	 * and it is performed at the first use.
+	 *
+	 * If TSC is not available or it is not reliable, counter falls back to
+	 * the monotonic clock of the system (ticks are nanoseconds).
+	 *
+	 * Use the counter only for differences measured on the same machine. Don't use
+	 * it for timeouts, use SysTime for them.
+	 */
+	class TscClock {
+	public:
+
+		typedef Bin::natural64 Ticks;
+
+		///Reads the counter
+		static Ticks read();
+		///Converts difference of two readings to nanoseconds
+		static Bin::natural64 toNanosecs(Ticks ticks);
+		///Returns true, if TSC is used
+		static bool isTsc();
+		///Returns count of ticks per second
+		static double getFrequency();
+	};
+
+}
+
+#endif /* LIGHTSPEED_MT_TSCCLOCK_H_ */
@@ -0,0 +1,23 @@
+/*
+ * distRWLock.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "winpch.h"
+#include "../distRWLock.h"
+
+namespace LightSpeed {
+
+natural DistRWLockBase::getCurCPU() {
+	return GetCurrentProcessorNumber();
+}
+
+natural DistRWLockBase::getCPUCount() {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors;
+}
+
+}
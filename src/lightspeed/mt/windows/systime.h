@@ -65,6 +65,29 @@ namespace LightSpeed
             static SysTime now() {
                 return SysTime(GetTickCount());
             }
+
+            ///Returns current wall-clock time
+            /** Time is counted from the midnight UTC, so hour(), min(), sec()
+             * and msec() return the time of the day. Result cannot be mixed with
+             * the result of now()
+             */
+            static SysTime wallClock() {
+                SYSTEMTIME st;
+                GetSystemTime(&st);
+                return SysTime(0, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+            }
+
+            ///Returns current system time with reduced resolution
+            /** GetTickCount() is already coarse, so it is equal to now() */
+            static SysTime coarse() {
+                return now();
+            }
+
+            ///Returns time cached by the current thread
+            /** Reading of the tick counter is cheap, so there is no cache. Function returns now() */
+            static SysTime cached() {
+                return now();
+            }
             
                         
             SysTime operator+(const SysTime &other) const {
@@ -193,7 +216,14 @@ namespace LightSpeed
             }
 
         };
-    
+
+
+        ///Enables cache of the current time in the current thread
+        /** Windows version doesn't cache, refresh() only reads the clock */
+        class CachedClock {
+        public:
+            SysTime refresh() {return SysTime::now();}
+        };
 
 
 
@@ -8,6 +8,7 @@
 #include "winpch.h"
 #include "threadSleeper.h"
 #include "../../base/exceptions/systemException.h"
+#include "../../base/exceptions/invalidParamException.h"
 
 namespace LightSpeed {
 
@@ -51,4 +52,20 @@ bool ThreadSleeper::sleep(Timeout timeout) {
 	}
 }
 
+natural ThreadSleeper::sleepAny(ThreadSleeper *const *sleepers, natural count, Timeout tm) {
+	HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+	if (count > MAXIMUM_WAIT_OBJECTS)
+		throw InvalidParamException(THISLOCATION,2,"Too many sleepers (max 64)");
+	for (natural i = 0; i < count; i++) handles[i] = sleepers[i]->semaphore;
+	DWORD res;
+	do {
+		DWORD msecs = tm.isInfinite()?INFINITE:tm.getRemain().msecs();
+		res = WaitForMultipleObjectsEx((DWORD)count,handles,FALSE,msecs,TRUE);
+		if (res == WAIT_FAILED)
+			throw ErrNoException(THISLOCATION,GetLastError());
+	} while (res == WAIT_IO_COMPLETION);
+	if (res == WAIT_TIMEOUT) return naturalNull;
+	return res - WAIT_OBJECT_0;
+}
+
 }
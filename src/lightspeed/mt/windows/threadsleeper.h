@@ -25,6 +25,16 @@ namespace LightSpeed {
 		void wakeUp(natural reason = 0) throw();
 		bool sleep(Timeout tm);
 
+		///Sleeps until any of the sleepers is woken up
+		/**
+		 * @param sleepers array of sleepers
+		 * @param count count of sleepers (max MAXIMUM_WAIT_OBJECTS)
+		 * @param tm timeout
+		 * @exception InvalidParamException too many sleepers
+		 * @return index of sleeper which has been woken up (its wake up is consumed),
+		 *  or naturalNull, when timeout ellapsed
+		 */
+		static natural sleepAny(ThreadSleeper *const *sleepers, natural count, Timeout tm);
 
 	protected:
 		HANDLE semaphore;
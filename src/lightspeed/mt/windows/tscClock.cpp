@@ -0,0 +1,39 @@
+/*
+ * tscClock.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "winpch.h"
+#include "../tscClock.h"
+
+namespace LightSpeed {
+
+static double getQpcFrequency() {
+	LARGE_INTEGER f;
+	QueryPerformanceFrequency(&f);
+	return (double)f.QuadPart;
+}
+
+static double qpcFrequency = getQpcFrequency();
+
+TscClock::Ticks TscClock::read() {
+	LARGE_INTEGER c;
+	QueryPerformanceCounter(&c);
+	return (Ticks)c.QuadPart;
+}
+
+Bin::natural64 TscClock::toNanosecs(Ticks ticks) {
+	return (Bin::natural64)((double)ticks * 1e9 / qpcFrequency);
+}
+
+bool TscClock::isTsc() {
+	return false;
+}
+
+double TscClock::getFrequency() {
+	return qpcFrequency;
+}
+
+}
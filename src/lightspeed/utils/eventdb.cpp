@@ -10,6 +10,9 @@
 #include "../base/sync/synchronize.h"
 #include "../base/containers/autoArray.tcc"
 #include "../base/streams/fileiobuff.tcc"
+#include "../base/streams/readAheadBuffer.h"
+#include "../base/framework/metrics.h"
+#include "../base/containers/map.tcc"
 
 #include "../base/exceptions/errorMessageException.h"
 #include "../base/debug/dbglog.h"
@@ -154,6 +157,10 @@ bool EventLog::isSlave() const {
 	return slaveMode;
 }
 
+static MetricCounter eventLogRecords("lightspeed_eventdb_records_total","Count of records written to event logs");
+static MetricCounter eventLogBytes("lightspeed_eventdb_written_bytes_total","Count of bytes written to event logs");
+static MetricHistogram eventLogRescan("lightspeed_eventdb_rescan_microseconds","Duration of the rescans of event logs");
+
 EventLog::FileOffset EventLog::sendUpdate_trn(natural recordType, ConstBin recordData, time_t time) {
 
 	SeqFileOutput outp(dbfile,writePos);
@@ -161,6 +168,7 @@ EventLog::FileOffset EventLog::sendUpdate_trn(natural recordType, ConstBin recor
 
 	natural offset = 0;
 	natural wrcount = 0;
+	time_t timeBase = writeState.lastTimestamp;
 
 
 
@@ -188,7 +196,10 @@ EventLog::FileOffset EventLog::sendUpdate_trn(natural recordType, ConstBin recor
 		throw;
 	}
 
+	timeIndex.add(recordType, writeState.lastTimestamp, writePos/blockSize, timeBase);
 	writePos += wrcount;
+	eventLogRecords.add();
+	eventLogBytes.add(wrcount);
 
 	natural limitCheck = watcher.checkLimit(writePos,time);
 	if (limitCheck > 0) {
@@ -213,18 +224,22 @@ void EventLog::open(ConstStrW name, natural flags , ILogDiscovery *discovery) {
 					OpenFlags::create);
 
 	open(f,f2,(flags & flagRescan) != 0,discovery);
+	logName = name;
 
 }
 
 void EventLog::close() {
 	dbfile = nil;
 	fixedfile = nil;
+	logName.clear();
+	timeIndex.clear();
 }
 
 
 void EventLog::open(PRndFileHandle file, PRndFileHandle fixed, bool rescan, ILogDiscovery *discovery) {
 	dbfile = file;
 	fixedfile = fixed;
+	logName.clear();
 	if (fixedfile != nil) {
 		scanStEvents();
 	}
@@ -252,7 +267,8 @@ void EventLog::rescan() {
 	writeState.currentCheckSum = initialChecksum;
 	writeState.lastTimestamp = 0;
 	FileOffset size = dbfile->size();
-	writePos = rescan(0,0,size,writeState.currentCheckSum,writeState.lastTimestamp);
+	timeIndex.clear();
+	writePos = rescan(0,0,size,writeState.currentCheckSum,writeState.lastTimestamp,false,&timeIndex);
 
 	rescanStEvents(0);
 
@@ -316,13 +332,21 @@ natural EventLog::parseBlock(SeqFileInput input, Header &hdr, Bin::natural16 &ch
 
 const char *str_rescanErrorMsg = "Rescan error at position: %1 [byte] - opcode: %2";
 
+///ranges larger than this are read by the read ahead buffer, so reading overlaps parsing
+static const EventLog::FileOffset readAheadThreshold = 1024*1024;
+
 EventLog::FileOffset EventLog::rescan(IUpdateListener* listener, FileOffset from,
 		FileOffset to, Bin::natural16 &checksum, time_t &curtime,
-		bool noinitialchecksumcheck) const {
+		bool noinitialchecksumcheck, TimeIndex *index) const {
 
+	MetricTimer _t(eventLogRescan);
 	SeqFileInput reader(dbfile,from);
-	SeqFileInBuff<> rdbuff(reader);
+	SeqFileInput rdbuff = to - from > readAheadThreshold
+			?SeqFileInput(SeqFileInAhead(reader)):SeqFileInput(SeqFileInBuff<>(reader));
 	FileOffset ofs = from;
+	//start of the event including its time sync prefix
+	FileOffset evStart = from;
+	time_t evTimeBase = curtime;
 	AutoArray<byte, SmallAlloc<1024> > buffer;
 	while (ofs < to) {
 		Header hdr;
@@ -330,6 +354,7 @@ EventLog::FileOffset EventLog::rescan(IUpdateListener* listener, FileOffset from
 			natural adv = parseBlock(rdbuff,hdr,checksum,curtime,buffer,noinitialchecksumcheck);
 			noinitialchecksumcheck = false;
 			if (hdr.recordType != 0xFFFF || hdr.recordSize != 0) {
+					if (index) index->add(hdr.recordType, curtime, evStart/blockSize, evTimeBase);
 					if (listener) {
 						listener->onUpdate(ofs/blockSize,curtime,hdr.recordType,ConstBin(buffer));
 					} else {
@@ -337,6 +362,8 @@ EventLog::FileOffset EventLog::rescan(IUpdateListener* listener, FileOffset from
 							listeners[i]->onUpdate(ofs/blockSize,curtime,hdr.recordType,ConstBin(buffer));
 						}
 					}
+					evStart = ofs + adv;
+					evTimeBase = curtime;
 			}
 			ofs+=adv;
 		} catch (Exception &e) {
@@ -414,6 +441,147 @@ void EventLog::setMaxUpdateSpeed(natural maxSpeedInBytes) {
 	watcher.maxSpeed = maxSpeedInBytes ;
 }
 
+void EventLog::TimeIndex::add(natural recordType, time_t timestamp, FileOffset offset, time_t timeBase) {
+	IndexEntry e;
+	e.bucket = timestamp - timestamp % (time_t)bucketSize;
+	e.offset = offset;
+	e.timeBase = timeBase;
+	if (global.empty() || global[global.length()-1].bucket < e.bucket) global.add(e);
+	IndexList &l = byType(recordType);
+	if (l.empty() || l[l.length()-1].bucket < e.bucket) l.add(e);
+}
+
+void EventLog::TimeIndex::clear() {
+	global.clear();
+	byType.clear();
+}
+
+natural EventLog::TimeIndex::countUpTo(const IndexList &list, time_t time) {
+	natural l = 0, h = list.length();
+	while (l < h) {
+		natural m = (l + h) / 2;
+		if (list[m].bucket <= time) l = m + 1; else h = m;
+	}
+	return l;
+}
+
+void EventLog::setIndexBucket(natural seconds) {
+	if (seconds == 0) throw InvalidParamException(THISLOCATION,1,"Bucket cannot be empty");
+	Sync _(lock);
+	timeIndex.clear();
+	timeIndex.bucketSize = seconds;
+}
+
+EventLog::Position EventLog::getEndPosition() const {
+	return Position(writePos/blockSize, writeState.lastTimestamp);
+}
+
+EventLog::Position EventLog::findTime(time_t time) const {
+	Sync _(lock);
+	const IndexList &l = timeIndex.global;
+	natural pos = TimeIndex::countUpTo(l, time);
+	if (pos) pos--;
+	if (pos >= l.length()) return getEndPosition();
+	return Position(l[pos].offset, l[pos].timeBase);
+}
+
+EventLog::Position EventLog::findTime(time_t time, natural recordType) const {
+	Sync _(lock);
+	const IndexList *l = timeIndex.byType.find(recordType);
+	if (l == 0) return getEndPosition();
+	natural pos = TimeIndex::countUpTo(*l, time);
+	if (pos) pos--;
+	if (pos >= l->length()) return getEndPosition();
+	return Position((*l)[pos].offset, (*l)[pos].timeBase);
+}
+
+///Forwards only events in the requested time range and of the requested type
+class RescanFilter: public IUpdateListener {
+public:
+	RescanFilter(IUpdateListener &target, time_t from, time_t to, natural recordType)
+		:target(target),from(from),to(to),recordType(recordType) {}
+
+	virtual void onUpdate(FileOffset offset, time_t timestamp, natural recordType, RecData data) {
+		if (accept(timestamp, recordType)) target.onUpdate(offset, timestamp, recordType, data);
+	}
+	virtual void onUpdateCell(natural cellId, FileOffset offset, time_t timestamp, natural recordType, RecData data) {
+		if (accept(timestamp, recordType)) target.onUpdateCell(cellId, offset, timestamp, recordType, data);
+	}
+	virtual void onStartRescan() {}
+	virtual void onEndRescan() {}
+	virtual void onRelease() {}
+
+protected:
+	IUpdateListener &target;
+	time_t from, to;
+	natural recordType;
+
+	bool accept(time_t timestamp, natural type) const {
+		return timestamp >= from && (to == 0 || timestamp < to)
+				&& (recordType == naturalNull || recordType == type);
+	}
+};
+
+EventLog::FileOffset EventLog::rescanTime(IUpdateListener &listener, time_t from, time_t to) const {
+	Position start;
+	FileOffset end;
+	{
+		Sync _(lock);
+		const IndexList &l = timeIndex.global;
+		natural b = TimeIndex::countUpTo(l, from);
+		if (b) start = Position(l[b-1].offset, l[b-1].timeBase);
+		//first bucket starting at "to" contains only events beyond the range
+		natural e = to == 0?l.length():TimeIndex::countUpTo(l, to - 1);
+		end = e < l.length()?l[e].offset * blockSize:writePos;
+	}
+	RescanFilter filter(listener, from, to, naturalNull);
+	listener.onStartRescan();
+	Bin::natural16 checksum = 0;
+	FileOffset ret = rescan(&filter, start.offset * blockSize, end, checksum, start.timeBase, true);
+	rescanStEvents(&filter);
+	listener.onEndRescan();
+	return ret / blockSize;
+}
+
+EventLog::FileOffset EventLog::rescanTime(IUpdateListener &listener, time_t from, time_t to, natural recordType) const {
+	struct Range {
+		Position start;
+		FileOffset end;
+	};
+	AutoArray<Range, SmallAlloc<32> > ranges;
+	{
+		Sync _(lock);
+		const IndexList *l = timeIndex.byType.find(recordType);
+		if (l) {
+			const IndexList &g = timeIndex.global;
+			natural b = TimeIndex::countUpTo(*l, from);
+			if (b) b--;
+			for (natural i = b; i < l->length(); i++) {
+				const IndexEntry &e = (*l)[i];
+				if (to != 0 && e.bucket >= to) break;
+				if (e.bucket + (time_t)timeIndex.bucketSize <= from) continue;
+				//bucket ends where the next global bucket starts
+				natural n = TimeIndex::countUpTo(g, e.bucket);
+				Range r;
+				r.start = Position(e.offset, e.timeBase);
+				r.end = n < g.length()?g[n].offset * blockSize:writePos;
+				ranges.add(r);
+			}
+		}
+	}
+	RescanFilter filter(listener, from, to, recordType);
+	listener.onStartRescan();
+	FileOffset ret = 0;
+	for (natural i = 0; i < ranges.length(); i++) {
+		Bin::natural16 checksum = 0;
+		time_t tm = ranges[i].start.timeBase;
+		ret = rescan(&filter, ranges[i].start.offset * blockSize, ranges[i].end, checksum, tm, true);
+	}
+	rescanStEvents(&filter);
+	listener.onEndRescan();
+	return ret / blockSize;
+}
+
 
 
 
@@ -447,14 +615,14 @@ void ReplicationListener::onUpdateCell(natural cellId, FileOffset,
 		time_t timestamp, natural recordType, RecData data) {
 
 	try {
-		natural recsize = sizeof(Header) + data.length() - 1;
+		natural recsize = sizeof(Header) + data.length();
 		Record *rec = (Record *)alloca(recsize);
 		rec->timestamp = Bin::natural32 (timestamp - lastEventTime);
 		rec->recordType = recordType;
 		rec->length = data.length();
 		rec->cellId = cellId;
 		memcpy(rec->data, data.data(),data.length());
-		out.write(&rec, recsize);
+		out.write(rec, recsize);
 		lastEventTime = timestamp;
 
 	} catch (std::exception &) {
@@ -468,6 +636,22 @@ natural EventLog::allocCell() {
 	return lockInc(nextCellId) - 1;
 }
 
+void EventLog::appendBlocks_trn(ConstBin blocks) {
+	dbfile->write(blocks.data(), blocks.length(), writePos);
+	Bin::natural16 checksum = writeState.currentCheckSum;
+	time_t curtime = writeState.lastTimestamp;
+	FileOffset end;
+	try {
+		end = rescan(0, writePos, writePos + blocks.length(), checksum, curtime, false, &timeIndex);
+	} catch (...) {
+		dbfile->setSize(writePos);
+		throw;
+	}
+	writeState.currentCheckSum = checksum;
+	writeState.lastTimestamp = curtime;
+	writePos = end;
+}
+
 void EventLog::expandCellMap(natural cellId) {
 	if (cellId >= cellMap.length()) {
 		if (cellId > cellMap.length()+10000) throw ErrorMessageException(THISLOCATION, "Too large gap in the cellmap");
@@ -536,13 +720,77 @@ void EventLog::scanStEvents() {
 void EventLog::rescanStEvents(IUpdateListener* listener) const {
 	for (CellMap::Iterator iter = cellMap.getFwIter(); iter.hasItems();) {
 		const StFrameInfo &ofs = iter.getNext();
-		loadStEvent(ofs.offset, listener);
+		if (ofs.length) loadStEvent(ofs.offset, listener);
+	}
+}
+
+EventLog::CellFileStats EventLog::getCellFileStats() const {
+	Sync _(lock);
+	CellFileStats res;
+	if (fixedfile == nil) return res;
+	res.fileSize = fixedfile->size();
+	for (CellMap::Iterator iter = cellMap.getFwIter(); iter.hasItems();) {
+		const StFrameInfo &nfo = iter.getNext();
+		if (nfo.length) {
+			res.liveSize += nfo.length;
+			res.liveCells++;
+		}
+	}
+	return res;
+}
+
+EventLog::FileOffset EventLog::copyCells(PRndFileHandle newFile, CellMap &newMap) const {
+	AutoArray<byte, SmallAlloc<1024> > buffer;
+	FileOffset pos = 0;
+	newMap = cellMap;
+	for (natural i = 0; i < newMap.length(); i++) {
+		StFrameInfo &nfo = newMap(i);
+		if (nfo.length == 0) continue;
+		buffer.resize(nfo.length);
+		fixedfile->read(buffer.data(), nfo.length, nfo.offset);
+		newFile->write(buffer.data(), nfo.length, pos);
+		nfo.offset = pos;
+		pos += nfo.length;
+	}
+	newFile->setSize(pos);
+	newFile->flush();
+	return pos;
+}
+
+void EventLog::compactCells(PRndFileHandle newFile) {
+	Sync _(lock);
+	if (fixedfile == nil) throwNullPointerException(THISLOCATION);
+	CellMap newMap;
+	copyCells(newFile, newMap);
+	fixedfile = newFile;
+	cellMap.swap(newMap);
+}
+
+void EventLog::compactCells() {
+	Sync _(lock);
+	if (logName.empty()) throw ErrorMessageException(THISLOCATION, "Log was not opened by name");
+	if (fixedfile == nil) throwNullPointerException(THISLOCATION);
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	String cellName = logName + ConstStrW(L".cells");
+	String tmpName = cellName + ConstStrW(L".tmp");
+	PRndFileHandle newFile = svc.openRndFile(tmpName, IFileIOServices::fileOpenReadWrite,
+			OpenFlags::create | OpenFlags::truncate);
+	CellMap newMap;
+	try {
+		copyCells(newFile, newMap);
+		svc.move(tmpName, cellName, true);
+	} catch (...) {
+		newFile = nil;
+		try {svc.remove(tmpName);} catch (...) {}
+		throw;
 	}
+	fixedfile = newFile;
+	cellMap.swap(newMap);
 }
 
 void EventLog::rescanOtherLog(PInputStream input) {
 	AutoArray<byte> buffer;
-	SeqFileInBuff<> infile(input);
+	SeqFileInAhead infile(input);
 	Bin::natural16 checksum = initialChecksum;
 	Header hdr;
 	time_t tm = 0;
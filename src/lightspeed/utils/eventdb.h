@@ -317,6 +317,29 @@ public:
 
 	EventLog():slaveMode(false),nextCellId(1) {}
 
+	///Position in the log file suitable to start rescanning
+	struct Position {
+		///offset in blocks
+		FileOffset offset;
+		///time of the event which precedes the position
+		time_t timeBase;
+
+		Position():offset(0),timeBase(0) {}
+		Position(FileOffset offset, time_t timeBase):offset(offset),timeBase(timeBase) {}
+	};
+
+	///Statistics of the cell file
+	struct CellFileStats {
+		///total size of the cell file in bytes
+		FileOffset fileSize;
+		///bytes occupied by live frames
+		FileOffset liveSize;
+		///count of live cells
+		natural liveCells;
+
+		CellFileStats():fileSize(0),liveSize(0),liveCells(0) {}
+	};
+
 	void addListener(IUpdateListener *listener);
 	///Adds listener a perform synchronization
 	/**
@@ -559,6 +582,61 @@ protected:
 	 */
 	FileOffset rescan(IUpdateListener &listener, FileOffset from, FileOffset to, time_t curTime) const;
 
+	///Sets granularity of the time index
+	/**
+	 * EventLog keeps in memory sparse index, which contains position of the first event
+	 * for every time bucket and position of the first event of every record type
+	 * within the bucket. Index is built during rescan() and it is updated by every
+	 * sendUpdate. It is not stored anywhere.
+	 *
+	 * @param seconds length of one bucket in seconds. Default value is 60. Function should
+	 * be called before the log is opened, otherwise index is rebuilt with next rescan()
+	 */
+	void setIndexBucket(natural seconds);
+
+	///Finds position where to start scanning to reach events at given time
+	/**
+	 * @param time requested time
+	 * @return position of first event of the bucket containing the time. If the time
+	 * is beyond the last event, returns end of the log.
+	 */
+	Position findTime(time_t time) const;
+
+	///Finds position where to start scanning to reach events of given type at given time
+	/**
+	 * @param time requested time
+	 * @param recordType type of record
+	 * @return position of first event of given type in the bucket containing the time
+	 * or in the nearest following bucket. If there is no such event, returns end of the log
+	 */
+	Position findTime(time_t time, natural recordType) const;
+
+	///Rescans events recorded in given time range
+	/**
+	 * Function uses time index to seek the start of the range, so it doesn't need
+	 * to scan whole file
+	 *
+	 * @param listener listener that receives data
+	 * @param from time of first event (inclusive)
+	 * @param to time of last event (exclusive). Set 0 to process remaining of the file
+	 * @return virtual offset in blocks, where scanning stopped
+	 *
+	 * @note cells are also sent (as in rescan()) but only when their last update is in the range
+	 */
+	FileOffset rescanTime(IUpdateListener &listener, time_t from, time_t to) const;
+
+	///Rescans events of given type recorded in given time range
+	/**
+	 * Function scans only buckets which contain at least one event of given type
+	 *
+	 * @param listener listener that receives data
+	 * @param from time of first event (inclusive)
+	 * @param to time of last event (exclusive). Set 0 to process remaining of the file
+	 * @param recordType type of record
+	 * @return virtual offset in blocks, where scanning stopped
+	 */
+	FileOffset rescanTime(IUpdateListener &listener, time_t from, time_t to, natural recordType) const;
+
 	///Initializes replication state and returns last known offset of local database copy
 	/**
 	 * Function initializes internal structures. You have to call this function everytime you reconnect to master server.
@@ -622,6 +700,32 @@ protected:
 	 */
 	natural allocCell();
 
+	///Retrieves statistics of the cell file
+	/** You can use result to decide, whether it is time to compact the cell file */
+	CellFileStats getCellFileStats() const;
+
+	///Rewrites live cells into the new file and continues using that file
+	/**
+	 * Frames abandoned by cells which needed to grow are not copied. Each cell
+	 * keeps its frame length, so later updates can be still performed in place.
+	 *
+	 * @param newFile new cell file. It should be empty. Function doesn't remove
+	 * the old file
+	 *
+	 * @note offsets of the cells reported to the listeners are changed.
+	 */
+	void compactCells(PRndFileHandle newFile);
+
+	///Compacts cell file of the log opened by name
+	/**
+	 * Live cells are written into temporary file, which atomically replaces
+	 * the current cell file.
+	 *
+	 * @exception ErrorMessageException log was not opened by name
+	 * @note offsets of the cells reported to the listeners are changed.
+	 */
+	void compactCells();
+
 protected:
 	PRndFileHandle dbfile;
 	PRndFileHandle fixedfile;
@@ -663,6 +767,37 @@ protected:
 	typedef AutoArray<StFrameInfo> CellMap;
 	CellMap cellMap;
 
+	struct IndexEntry {
+		///start of the time bucket
+		time_t bucket;
+		///offset in blocks of the first event in the bucket (including its time sync prefix)
+		FileOffset offset;
+		///time of the event preceding the offset
+		time_t timeBase;
+	};
+
+	typedef AutoArray<IndexEntry> IndexList;
+
+	///Sparse time and record-type index
+	struct TimeIndex {
+		///length of bucket in seconds
+		natural bucketSize;
+		///first event of every bucket
+		IndexList global;
+		///first event of every bucket for given record type
+		Map<natural, IndexList> byType;
+
+		TimeIndex():bucketSize(60) {}
+		void add(natural recordType, time_t timestamp, FileOffset offset, time_t timeBase);
+		void clear();
+		///returns count of entries with bucket before or at given time
+		static natural countUpTo(const IndexList &list, time_t time);
+	};
+
+	TimeIndex timeIndex;
+	///name of the log file if opened by name (used to compact the cells)
+	String logName;
+
 	///Peform rescan for given listener
 	/**
 	 * @param listener listener that receives rescanned data. If NULL, all registered listeners receive data
@@ -671,9 +806,10 @@ protected:
 	 * @param checksum - initial checksum (and final checksum)
 	 * @param curtime - absolute time of start scanning - set zero when you start from begining
 	 * @param noinitialchecksumcheck - set true, if you don't want to check the checksum of the first block (i.e. you don't know the checksum)
+	 * @param index - if not NULL, scanned events are added to the index
 	 * @return offset where stopped
 	 */
-	FileOffset rescan(IUpdateListener *listener, FileOffset from, FileOffset to, Bin::natural16 &checksum, time_t &curtime, bool noinitialchecksumcheck = false) const;
+	FileOffset rescan(IUpdateListener *listener, FileOffset from, FileOffset to, Bin::natural16 &checksum, time_t &curtime, bool noinitialchecksumcheck = false, TimeIndex *index = 0) const;
 	FileOffset fileSize() const;
 
 	void rescanOtherLog(PInputStream input);
@@ -681,6 +817,8 @@ protected:
 	void scanStEvents();
 	void rescanStEvents(IUpdateListener *listener = 0) const;
 	void loadStEvent(FileOffset offset, IUpdateListener *listener = 0) const;
+	FileOffset copyCells(PRndFileHandle newFile, CellMap &newMap) const;
+	Position getEndPosition() const;
 
 
 public:
@@ -757,7 +895,15 @@ protected:
 	natural parseBlock(SeqFileInput input, Header &hdr, Bin::natural16 &checksum, time_t &curtime,T &buffer, bool noinitialchecksumcheck = false ) const;
 
 	void expandCellMap(natural cellId);
+	///Appends raw blocks received from the master and broadcasts them to the listeners
+	/**
+	 * Blocks are validated against the current checksum. If validation fails,
+	 * file is truncated back and exception is thrown
+	 */
+	void appendBlocks_trn(ConstBin blocks);
 	friend class ReplicationListener;
+	friend class ReplicationSender;
+	friend class ReplicationReceiver;
 
 };
 
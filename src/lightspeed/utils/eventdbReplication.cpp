@@ -0,0 +1,458 @@
+/*
+ * eventdbReplication.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "eventdbReplication.h"
+#include "../base/containers/autoArray.tcc"
+#include "../base/containers/convertString.h"
+#include "../base/exceptions/errorMessageException.h"
+#include "../base/exceptions/stdexception.h"
+#include "../base/sync/synchronize.h"
+#include "../base/debug/dbglog.h"
+#include "crc32.h"
+#include "lzw.h"
+
+
+namespace LightSpeed {
+
+namespace EventDB {
+
+static Bin::natural32 payloadCrc(ConstBin data) {
+	Crc32 crc;
+	crc.blockWrite(data.data(), data.length());
+	return crc.getCrc32();
+}
+
+ReplicationSender::ReplicationSender(EventLog &db, IReplicationOutput &out, const ReplicationConfig &cfg)
+	:db(db),out(out),cfg(cfg),sentPos(0),ackedSeq(0),sentSeq(0),idle(0),running(false) {}
+
+ReplicationSender::~ReplicationSender() {
+	stop();
+}
+
+void ReplicationSender::start(FileOffset from) {
+	stop();
+	{
+		EventLog::Sync _(db.lock);
+		FileOffset pos = from * EventLog::blockSize;
+		if (pos > db.writePos)
+			throw ErrorMessageException(THISLOCATION, "Slave is ahead of the master");
+		writeRelease(&sentPos,(atomicValue)pos);
+		writeRelease(&sentSeq,0);
+		writeRelease(&ackedSeq,0);
+		pendingCells.clear();
+		db.addListener(this);
+		running = true;
+		//current state of cells is sent after the log
+		if (db.fixedfile != nil) {
+			AutoArray<byte, SmallAlloc<256> > buffer;
+			for (natural i = 0; i < db.cellMap.length(); i++) {
+				const EventLog::StFrameInfo &nfo = db.cellMap[i];
+				if (nfo.length == 0) continue;
+				EventLog::StFrame hdr;
+				db.fixedfile->read(&hdr, sizeof(hdr), nfo.offset);
+				buffer.resize(hdr.hdr.length * EventLog::blockSize);
+				db.fixedfile->read(buffer.data(), buffer.length(), nfo.offset + sizeof(hdr));
+				addCell(db.writePos, hdr.hdr.cellId, hdr.hdr.timestamp, hdr.hdr.recordType, ConstBin(buffer));
+			}
+		}
+	}
+	worker.start(ThreadFunction::create(this, &ReplicationSender::worker_run));
+}
+
+void ReplicationSender::stop() {
+	if (!running) return;
+	{
+		EventLog::Sync _(db.lock);
+		db.removeListener(this);
+		running = false;
+	}
+	worker.stop();
+}
+
+void ReplicationSender::acknowledge(natural seq) {
+	if ((atomicValue)seq > readAcquire(&sentSeq))
+		throw ErrorMessageException(THISLOCATION, "Acknowledged batch has not been sent");
+	//acknowledge is cumulative, never move back
+	atomicValue cur = readAcquire(&ackedSeq);
+	while ((atomicValue)seq > cur) {
+		atomicValue prev = lockCompareExchange(ackedSeq, cur, (atomicValue)seq);
+		if (prev == cur) {
+			worker.wakeUp();
+			break;
+		}
+		cur = prev;
+	}
+}
+
+bool ReplicationSender::readAck(IReplicationInput &input) {
+	BatchAck ack;
+	if (!input.read(&ack, sizeof(ack))) return false;
+	if (ack.magic != ackMagic)
+		throw ErrorMessageException(THISLOCATION, "Replication stream is corrupted (acknowledge)");
+	acknowledge(ack.seq);
+	return true;
+}
+
+natural ReplicationSender::getInFlight() const {
+	atomicValue acked = readAcquire(&ackedSeq);
+	return (natural)(readAcquire(&sentSeq) - acked);
+}
+
+void ReplicationSender::onUpdate(FileOffset offset, time_t , natural , RecData data) {
+	atomicValue st = readAcquire(&idle);
+	if (st == 0) return;
+	if (st == 2) {
+		//waiting to fill the batch, wake only if batch is full
+		FileOffset end = (offset + 1) * EventLog::blockSize + data.length();
+		if (end - getSentPos() < cfg.maxBatchSize) return;
+	}
+	if (lockExchange(idle, 0) != 0) worker.wakeUp();
+}
+
+void ReplicationSender::onUpdateCell(natural cellId, FileOffset , time_t timestamp, natural recordType, RecData data) {
+	addCell(db.writePos, cellId, timestamp, recordType, data);
+	if (lockExchange(idle, 0) != 0) worker.wakeUp();
+}
+
+void ReplicationSender::onRelease() {
+	running = false;
+	worker.stop();
+}
+
+void ReplicationSender::addCell(FileOffset logPos, natural cellId, time_t timestamp, natural recordType, ConstBin data) {
+	PendingCell cell;
+	cell.logPos = logPos;
+	ItemHeader ihdr;
+	ihdr.kind = itemCell;
+	ihdr.length = (Bin::natural32)(sizeof(CellHeader) + data.length());
+	CellHeader chdr;
+	chdr.cellId = (Bin::natural32)cellId;
+	chdr.recordType = (Bin::natural32)recordType;
+	chdr.timestamp = (Bin::natural64)timestamp;
+	cell.item.append(ConstBin(reinterpret_cast<const byte *>(&ihdr), sizeof(ihdr)));
+	cell.item.append(ConstBin(reinterpret_cast<const byte *>(&chdr), sizeof(chdr)));
+	cell.item.append(data);
+	Synchronized<FastLock> _(mtx);
+	pendingCells.add(cell);
+}
+
+void ReplicationSender::worker_run() {
+	AutoArray<byte> payload;
+	while (!Thread::canFinish()) {
+		if (getInFlight() >= cfg.maxInFlight) {
+			//window is full, acknowledge wakes the thread
+			Thread::sleep(nil);
+			continue;
+		}
+		FileOffset end;
+		{
+			EventLog::Sync _(db.lock);
+			end = db.writePos;
+		}
+		bool cells;
+		{
+			Synchronized<FastLock> _(mtx);
+			cells = !pendingCells.empty();
+		}
+		if (end == getSentPos() && !cells) {
+			//publish idle state first, then recheck everything notifiers could add meanwhile
+			lockExchange(idle, 1);
+			{
+				EventLog::Sync _(db.lock);
+				end = db.writePos;
+			}
+			{
+				Synchronized<FastLock> _(mtx);
+				cells = !pendingCells.empty();
+			}
+			if (end == getSentPos() && !cells) Thread::sleep(nil);
+			lockExchange(idle, 0);
+			continue;
+		}
+		if (end - getSentPos() < cfg.maxBatchSize && cfg.maxBatchDelay) {
+			//wait for more data to fill the batch
+			Timeout tm(SysTime::now(), cfg.maxBatchDelay);
+			lockExchange(idle, 2);
+			while (!tm.expired() && !Thread::canFinish()) {
+				Thread::sleep(tm);
+				EventLog::Sync _(db.lock);
+				if (db.writePos - getSentPos() >= cfg.maxBatchSize) break;
+			}
+			lockExchange(idle, 0);
+		}
+		if (buildBatch(payload)) sendBatch(payload);
+	}
+}
+
+bool ReplicationSender::buildBatch(AutoArray<byte> &payload) {
+	payload.clear();
+	FileOffset end;
+	PRndFileHandle file;
+	{
+		EventLog::Sync _(db.lock);
+		end = db.writePos;
+		file = db.dbfile;
+	}
+	if (file == nil) return false;
+	AutoArray<PendingCell> cells;
+	{
+		Synchronized<FastLock> _(mtx);
+		cells.swap(pendingCells);
+	}
+	FileOffset pos = getSentPos();
+	natural ci = 0;
+	while (payload.length() < cfg.maxBatchSize) {
+		FileOffset limit = end;
+		if (ci < cells.length() && cells[ci].logPos < limit) limit = cells[ci].logPos;
+		if (pos < limit) {
+			FileOffset np = appendLog(payload, file, pos, limit, cfg.maxBatchSize - payload.length());
+			if (np == pos) break;
+			pos = np;
+		} else if (ci < cells.length() && cells[ci].logPos <= pos) {
+			payload.append(cells[ci].item);
+			ci++;
+		} else {
+			break;
+		}
+	}
+	writeRelease(&sentPos, (atomicValue)pos);
+	{
+		//return unsent cells before cells arrived in meantime
+		Synchronized<FastLock> _(mtx);
+		cells.erase(0, ci);
+		cells.append(pendingCells);
+		pendingCells.swap(cells);
+	}
+	return !payload.empty();
+}
+
+///calculates length of complete records (including time sync prefix) in the buffer
+/**
+ * @param p pointer to the buffer
+ * @param n size of the buffer
+ * @param need receives count of bytes needed to complete next record
+ * @return count of bytes occupied by complete records
+ */
+static natural completeRecords(const byte *p, natural n, natural &need) {
+	static const natural blockSize = EventLog::blockSize;
+	natural done = 0;
+	need = 0;
+	while (done < n) {
+		natural u = done;
+		//header: checksum, recordType, recordSize, timeadv
+		Bin::natural16 hdr[4];
+		if (n - u < blockSize) {need = u + blockSize;break;}
+		memcpy(hdr, p + u, sizeof(hdr));
+		if (hdr[1] == 0xFFFF && hdr[2] == 0) {
+			u += blockSize;
+			if (n - u < blockSize) {need = u + blockSize;break;}
+			memcpy(hdr, p + u, sizeof(hdr));
+		}
+		u += blockSize + hdr[2] * blockSize;
+		if (u > n) {need = u;break;}
+		done = u;
+	}
+	return done;
+}
+
+ReplicationSender::FileOffset ReplicationSender::appendLog(AutoArray<byte> &payload,
+		PRndFileHandle file, FileOffset pos, FileOffset limit, natural budget) {
+	natural hdrPos = payload.length();
+	natural remain = (natural)(limit - pos);
+	natural n = remain < budget?remain:budget;
+	natural done = 0;
+	while (n) {
+		payload.resize(hdrPos + sizeof(ItemHeader) + n);
+		file->read(payload.data() + hdrPos + sizeof(ItemHeader), n, pos);
+		natural need;
+		done = completeRecords(payload.data() + hdrPos + sizeof(ItemHeader), n, need);
+		//record larger than budget is sent alone
+		if (done || hdrPos || need > remain) break;
+		n = need;
+	}
+	if (done == 0) {
+		payload.resize(hdrPos);
+		return pos;
+	}
+	payload.resize(hdrPos + sizeof(ItemHeader) + done);
+	ItemHeader ihdr;
+	ihdr.kind = itemLog;
+	ihdr.length = (Bin::natural32)done;
+	memcpy(payload.data() + hdrPos, &ihdr, sizeof(ihdr));
+	return pos + done;
+}
+
+void ReplicationSender::sendBatch(ConstBin payload) {
+	BatchHeader hdr;
+	hdr.magic = batchMagic;
+	hdr.seq = (Bin::natural32)(readAcquire(&sentSeq) + 1);
+	hdr.rawSize = (Bin::natural32)payload.length();
+	hdr.crc = payloadCrc(payload);
+	hdr.flags = 0;
+	hdr.reserved = 0;
+	StringB compressed;
+	ConstBin data = payload;
+	if (cfg.compress) {
+		compressed = convertString(LZWCompress(12), payload);
+		if (compressed.length() < payload.length()) {
+			data = compressed;
+			hdr.flags |= flagCompressed;
+		}
+	}
+	hdr.dataSize = (Bin::natural32)data.length();
+	//acknowledge can arrive before write returns
+	writeRelease(&sentSeq, hdr.seq);
+	out.write(&hdr, sizeof(hdr));
+	out.write(data.data(), data.length());
+}
+
+
+ReplicationReceiver::ReplicationReceiver(EventLog &db, IReplicationOutput &ackOut, natural maxQueued, natural maxBatchSize)
+	:db(db),ackOut(ackOut),freeSlots(maxQueued),queued(0),appliedSeq(0),receivedSeq(0),maxQueued(maxQueued),maxBatchSize(maxBatchSize) {
+	worker.start(ThreadFunction::create(this, &ReplicationReceiver::worker_run));
+}
+
+ReplicationReceiver::~ReplicationReceiver() {
+	//empty batch stops the worker
+	freeSlots.lock();
+	{
+		Synchronized<FastLock> _(mtx);
+		queue.add(Batch());
+		queue(queue.length() - 1).hdr.magic = 0;
+	}
+	queued.unlock();
+	worker.join();
+}
+
+bool ReplicationReceiver::receive(IReplicationInput &input) {
+	checkFailed();
+	Batch batch;
+	if (!input.read(&batch.hdr, sizeof(batch.hdr))) return false;
+	if (batch.hdr.magic != batchMagic || batch.hdr.seq != receivedSeq + 1)
+		throw ErrorMessageException(THISLOCATION, "Replication stream is corrupted (batch header)");
+	//sizes come from the network, check them before anything is allocated
+	if (batch.hdr.dataSize > maxBatchSize || batch.hdr.rawSize > maxBatchSize)
+		throw ErrorMessageException(THISLOCATION, "Replication batch is too large");
+	batch.data.resize(batch.hdr.dataSize);
+	//end of stream is allowed only between batches
+	if (!input.read(batch.data.data(), batch.data.length()))
+		throw ErrorMessageException(THISLOCATION, "Replication stream is truncated (batch data)");
+	freeSlots.lock();
+	{
+		Synchronized<FastLock> _(mtx);
+		queue.add(batch);
+	}
+	receivedSeq++;
+	queued.unlock();
+	return true;
+}
+
+void ReplicationReceiver::run(IReplicationInput &input) {
+	while (receive(input)) {}
+	sync();
+}
+
+void ReplicationReceiver::sync() {
+	for (natural i = 0; i < maxQueued; i++) freeSlots.lock();
+	for (natural i = 0; i < maxQueued; i++) freeSlots.unlock();
+	checkFailed();
+}
+
+void ReplicationReceiver::checkFailed() {
+	PException f;
+	{
+		Synchronized<FastLock> _(mtx);
+		f = failure;
+	}
+	if (f != nil) f->throwAgain(THISLOCATION);
+}
+
+void ReplicationReceiver::worker_run() {
+	for(;;) {
+		queued.lock();
+		Batch batch;
+		bool failed;
+		{
+			Synchronized<FastLock> _(mtx);
+			batch = queue[0];
+			queue.erase(0);
+			failed = failure != nil;
+		}
+		if (batch.hdr.magic == 0) break;
+		if (!failed) {
+			try {
+				apply(batch);
+				writeRelease(&appliedSeq, batch.hdr.seq);
+				BatchAck ack;
+				ack.magic = ackMagic;
+				ack.seq = batch.hdr.seq;
+				ackOut.write(&ack, sizeof(ack));
+			} catch (...) {
+				PException f = Exception::getCurrentException();
+				LS_LOG.error("Replication failed: %1") << f->getMessageWithReason();
+				Synchronized<FastLock> _(mtx);
+				failure = f;
+			}
+		}
+		freeSlots.unlock();
+	}
+}
+
+void ReplicationReceiver::decompress(ConstBin data, natural rawSize, AutoArray<byte> &out) {
+	//rawSize is already checked against maxBatchSize, output never grows over it
+	LZWDecompress lzw;
+	out.clear();
+	out.reserve(rawSize);
+	for (natural i = 0; i < data.length(); i++) {
+		lzw.write(data[i]);
+		while (lzw.hasItems) {
+			if (out.length() >= rawSize)
+				throw ErrorMessageException(THISLOCATION, "Replication stream is corrupted (batch size)");
+			out.add(lzw.getNext());
+		}
+	}
+}
+
+void ReplicationReceiver::apply(const Batch &batch) {
+	ConstBin payload = batch.data;
+	AutoArray<byte> decompressed;
+	if (batch.hdr.flags & flagCompressed) {
+		decompress(payload, batch.hdr.rawSize, decompressed);
+		payload = decompressed;
+	}
+	if (payload.length() != batch.hdr.rawSize || payloadCrc(payload) != batch.hdr.crc)
+		throw ErrorMessageException(THISLOCATION, "Replication stream is corrupted (batch checksum)");
+	EventLog::Sync _(db.lock);
+	if (!db.isSlave()) throw ErrorMessageException(THISLOCATION,"Slave mode is not initialized");
+	natural pos = 0;
+	while (pos < payload.length()) {
+		ItemHeader ihdr;
+		if (payload.length() - pos < sizeof(ihdr))
+			throw ErrorMessageException(THISLOCATION, "Replication stream is corrupted (item)");
+		memcpy(&ihdr, payload.data() + pos, sizeof(ihdr));
+		pos += sizeof(ihdr);
+		if (payload.length() - pos < ihdr.length)
+			throw ErrorMessageException(THISLOCATION, "Replication stream is corrupted (item)");
+		ConstBin item = payload.mid(pos, ihdr.length);
+		pos += ihdr.length;
+		if (ihdr.kind == itemLog) {
+			db.appendBlocks_trn(item);
+		} else if (ihdr.kind == itemCell) {
+			CellHeader chdr;
+			if (item.length() < sizeof(chdr))
+				throw ErrorMessageException(THISLOCATION, "Replication stream is corrupted (cell)");
+			memcpy(&chdr, item.data(), sizeof(chdr));
+			if (chdr.cellId >= (natural)db.nextCellId) db.nextCellId = chdr.cellId + 1;
+			db.updateStEvent_trn(chdr.cellId, chdr.recordType, item.offset(sizeof(chdr)), (time_t)chdr.timestamp);
+		} else {
+			throw ErrorMessageException(THISLOCATION, "Replication stream is corrupted (unknown item)");
+		}
+	}
+}
+
+}
+}
@@ -0,0 +1,249 @@
+/*
+ * eventdbReplication.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_UTILS_EVENTDBREPLICATION_H_
+#define LIGHTSPEED_UTILS_EVENTDBREPLICATION_H_
+#include "eventdb.h"
+#include "../mt/semaphore.h"
+
+namespace LightSpeed {
+
+namespace EventDB {
+
+
+///Batched replication protocol
+/**
+ * Master sends raw blocks of the log file packed into batches. Slave appends
+ * these blocks to its own log, so both log files are byte-identical and checksum
+ * chain is validated on the slave side. Cell updates are sent as separate
+ * items in the same batch in the order they happened.
+ *
+ * @code
+ * batch: BatchHeader | payload (possibly compressed)
+ * payload: (ItemHeader | item data)*
+ * ack: BatchAck (slave to master)
+ * @endcode
+ *
+ * Batch is closed when it reaches maxBatchSize or when maxBatchDelay elapses
+ * since the first pending event. Sender keeps up to maxInFlight batches not yet
+ * acknowledged by the slave. Slave acknowledges batches cumulatively after they
+ * are applied.
+ *
+ * @note Slave log must be created by this protocol from the beginning, because
+ * records in the log replicated by ReplicationListener have different padding
+ * and therefore different checksums.
+ */
+class ReplicationProtocol {
+public:
+
+	static const Bin::natural32 batchMagic = 0x48544142;
+	static const Bin::natural32 ackMagic = 0x4B434142;
+	///payload is compressed by LZW
+	static const Bin::natural16 flagCompressed = 1;
+
+	struct BatchHeader {
+		Bin::natural32 magic;
+		///sequence number of the batch, first batch has 1
+		Bin::natural32 seq;
+		///size of the payload before compression
+		Bin::natural32 rawSize;
+		///size of the transferred payload
+		Bin::natural32 dataSize;
+		///CRC32 of the uncompressed payload
+		Bin::natural32 crc;
+		Bin::natural16 flags;
+		Bin::natural16 reserved;
+	};
+
+	struct BatchAck {
+		Bin::natural32 magic;
+		///all batches up to this sequence number has been applied
+		Bin::natural32 seq;
+	};
+
+	///item contains raw blocks of the log file
+	static const Bin::natural32 itemLog = 1;
+	///item contains cell update (CellHeader followed by the data)
+	static const Bin::natural32 itemCell = 2;
+
+	struct ItemHeader {
+		Bin::natural32 kind;
+		Bin::natural32 length;
+	};
+
+	struct CellHeader {
+		Bin::natural32 cellId;
+		Bin::natural32 recordType;
+		Bin::natural64 timestamp;
+	};
+};
+
+///Configuration of the replication sender
+struct ReplicationConfig {
+	///maximum size of uncompressed batch in bytes
+	natural maxBatchSize;
+	///maximum time in milliseconds between first pending event and sending the batch
+	natural maxBatchDelay;
+	///maximum count of batches sent but not acknowledged
+	natural maxInFlight;
+	///compress batches
+	bool compress;
+
+	ReplicationConfig():maxBatchSize(65536),maxBatchDelay(20),maxInFlight(8),compress(false) {}
+};
+
+///Master side of the batched replication
+/**
+ * Sender runs own thread which reads new data directly from the log file and sends
+ * them as batches to the output. Acknowledges must be delivered from the slave
+ * through function acknowledge() or readAck().
+ */
+class ReplicationSender: public ReplicationProtocol, private UpdateAdapter {
+public:
+
+	ReplicationSender(EventLog &db, IReplicationOutput &out, const ReplicationConfig &cfg = ReplicationConfig());
+	~ReplicationSender();
+
+	///Starts replication
+	/**
+	 * @param from offset in blocks where slave's log ends (see EventLog::initReplication).
+	 * Sender streams log from this position and then sends current state of all cells
+	 */
+	void start(FileOffset from);
+	///Stops replication
+	void stop();
+
+	///Processes cumulative acknowledge
+	/**
+	 * @param seq sequence number of the last applied batch
+	 */
+	void acknowledge(natural seq);
+	///Reads acknowledge from the slave
+	/**
+	 * @param input input stream
+	 * @retval true acknowledge processed
+	 * @retval false end of stream
+	 */
+	bool readAck(IReplicationInput &input);
+
+	///Retrieves count of batches sent but not acknowledged yet
+	natural getInFlight() const;
+	///Retrieves sequence number of the last acknowledged batch
+	natural getAcknowledged() const {return (natural)readAcquire(&ackedSeq);}
+
+protected:
+
+	struct PendingCell {
+		///position in the log file (bytes) when cell has been updated
+		FileOffset logPos;
+		AutoArray<byte> item;
+	};
+
+	EventLog &db;
+	IReplicationOutput &out;
+	ReplicationConfig cfg;
+	Thread worker;
+	FastLock mtx;
+	AutoArray<PendingCell> pendingCells;
+	///position in the log (bytes) of the data not sent yet, written by the worker
+	atomic sentPos;
+	///updated by the thread which reads acknowledges
+	atomic ackedSeq;
+	///updated by the worker. Read ackedSeq first, sentSeq is never less than it
+	atomic sentSeq;
+	///0 - worker is busy, 1 - worker sleeps, 2 - worker waits to fill the batch
+	atomic idle;
+	bool running;
+
+	FileOffset getSentPos() const {return (FileOffset)readAcquire(&sentPos);}
+
+	virtual void onUpdate(FileOffset offset, time_t timestamp, natural recordType, RecData data);
+	virtual void onUpdateCell(natural cellId, FileOffset offset, time_t timestamp, natural recordType, RecData data);
+	virtual void onRelease();
+
+	void addCell(FileOffset logPos, natural cellId, time_t timestamp, natural recordType, ConstBin data);
+	void worker_run();
+	bool buildBatch(AutoArray<byte> &payload);
+	FileOffset appendLog(AutoArray<byte> &payload, PRndFileHandle file, FileOffset pos, FileOffset limit, natural budget);
+	void sendBatch(ConstBin payload);
+};
+
+///Slave side of the batched replication
+/**
+ * Receiver reads batches in the caller's thread and applies them in own thread,
+ * so next batch can be received and decompressed while the previous
+ * one is being written. Acknowledges are written to the output after the batch is applied.
+ *
+ * Database must be in slave mode (see EventLog::initReplication)
+ */
+class ReplicationReceiver: public ReplicationProtocol {
+public:
+	///Creates receiver
+	/**
+	 * @param db slave database
+	 * @param ackOut output stream for acknowledges
+	 * @param maxQueued maximum count of batches received but not applied yet
+	 * @param maxBatchSize maximum size of the batch (compressed and uncompressed). Larger
+	 *  batch is rejected as corrupted before the memory is allocated. It must be
+	 *  greater than maxBatchSize of the sender and than the largest record in the log
+	 */
+	ReplicationReceiver(EventLog &db, IReplicationOutput &ackOut, natural maxQueued = 4, natural maxBatchSize = 16*1024*1024);
+	~ReplicationReceiver();
+
+	///Reads and queues one batch
+	/**
+	 * @param input input stream
+	 * @retval true batch queued
+	 * @retval false end of stream before the batch header
+	 * @exception ErrorMessageException stream ends inside of the batch or the batch is corrupted
+	 * @exception any exception thrown while an earlier batch was applied
+	 */
+	bool receive(IReplicationInput &input);
+
+	///Receives batches until end of stream and waits until all of them are applied
+	/**
+	 * @param input input stream
+	 * @exception any exception thrown while batch was applied
+	 */
+	void run(IReplicationInput &input);
+
+	///Waits until all received batches are applied
+	void sync();
+
+	///Retrieves sequence number of the last applied batch
+	natural getApplied() const {return (natural)readAcquire(&appliedSeq);}
+
+protected:
+
+	struct Batch {
+		BatchHeader hdr;
+		AutoArray<byte> data;
+	};
+
+	EventLog &db;
+	IReplicationOutput &ackOut;
+	Thread worker;
+	FastLock mtx;
+	AutoArray<Batch> queue;
+	Semaphore freeSlots, queued;
+	atomic appliedSeq;
+	natural receivedSeq;
+	natural maxQueued;
+	natural maxBatchSize;
+	///exception thrown by the worker (protected by mtx)
+	PException failure;
+
+	void worker_run();
+	void apply(const Batch &batch);
+	void decompress(ConstBin data, natural rawSize, AutoArray<byte> &out);
+	void checkFailed();
+};
+
+}
+}
+
+#endif /* LIGHTSPEED_UTILS_EVENTDBREPLICATION_H_ */
@@ -2,6 +2,7 @@
 #include "../../base/containers/map.tcc"
 #include "../../base/exceptions/invalidParamException.h"
 #include "../../base/text/textFormat.tcc"
+#include "../../base/text/floatConv.h"
 #include "../../mt/atomic.h"
 #include "../../base/iter/vtiterator.h"
 #include "json.h"
@@ -386,9 +387,9 @@ bool IntField64::operator==(const INode &other) const {
 }
 
 TextFieldA *FloatField::createTextNode() const {
-	TextFormatBuff<char,StaticAlloc<200> > fmt;
-	fmt("%1") << x;
-	return new TextFieldA(fmt.write());
+	char buff[shortestFloatBufferSize];
+	natural len = formatShortest(x,buff);
+	return new TextFieldA(ConstStrA(buff,len));
 }
 
 Value FloatField::clone(PFactory factory) const {
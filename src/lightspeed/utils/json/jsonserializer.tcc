@@ -12,6 +12,7 @@
 #include "../../base/interface.tcc"
 #include "../../base/text/textParser.tcc"
 #include "../../base/text/textstream.tcc"
+#include "../../base/text/floatConv.h"
 #include "../../base/containers/autoArray.tcc"
 #include "jsonexception.h"
 
@@ -169,8 +170,9 @@ void Serializer<T>::serializeString(const INode *json) {
 template<typename T>
 void Serializer<T>::serializeFloat(const INode *json) {
 
-	TextOut<IWriteIterator<char, T> &, StaticAlloc<140> > fmt(iter);
-	fmt() << json->getFloat();
+	char buff[shortestFloatBufferSize];
+	natural len = formatShortest(json->getFloat(),buff);
+	iter.blockWrite(ConstStrA(buff,len));
 }
 
 
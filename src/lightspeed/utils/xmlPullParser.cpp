@@ -0,0 +1,394 @@
+/*
+ * xmlPullParser.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#include "xmlPullParser.h"
+#include <string.h>
+#include "../base/containers/autoArray.tcc"
+#include "../base/exceptions/exceptionMsg.tcc"
+
+namespace LightSpeed {
+
+XMLNameTable::XMLNameTable() {
+	hashTable.resize(64, naturalNull);
+}
+
+natural XMLNameTable::hash(ConstStrA name) {
+	//FNV-1a
+	natural h = 2166136261U;
+	for (natural i = 0; i < name.length(); i++) {
+		h ^= (byte)name[i];
+		h *= 16777619U;
+	}
+	return h;
+}
+
+natural XMLNameTable::lookup(ConstStrA name, natural h) const {
+	natural mask = hashTable.length() - 1;
+	natural idx = h & mask;
+	while (true) {
+		natural id = hashTable[idx];
+		if (id == naturalNull || names[id] == name) return idx;
+		idx = (idx + 1) & mask;
+	}
+}
+
+void XMLNameTable::rehash(natural size) {
+	hashTable.clear();
+	hashTable.resize(size, naturalNull);
+	for (natural i = 0; i < names.length(); i++)
+		hashTable(lookup(names[i], hash(names[i]))) = i;
+}
+
+natural XMLNameTable::intern(ConstStrA name) {
+	natural idx = lookup(name, hash(name));
+	natural id = hashTable[idx];
+	if (id != naturalNull) return id;
+	id = names.length();
+	names.add(StringA(name));
+	hashTable(idx) = id;
+	//keep load factor below 1/2
+	if (names.length() * 2 > hashTable.length()) rehash(hashTable.length() * 2);
+	return id;
+}
+
+natural XMLNameTable::find(ConstStrA name) const {
+	return hashTable[lookup(name, hash(name))];
+}
+
+
+XMLPullParser::XMLPullParser(ConstStrA document, bool skipWhitespace)
+	:doc(document),pos(0),base(0),complete(true),nameTable(&ownNames),skipWhitespace(skipWhitespace)
+	,event(eof),nameId(XMLNameTable::unknown),emptyElement(false),pendingEnd(false),depth(0),attrCount(0)
+{
+}
+
+XMLPullParser::XMLPullParser(ConstStrA document, XMLNameTable &names, bool skipWhitespace)
+	:doc(document),pos(0),base(0),complete(true),nameTable(&names),skipWhitespace(skipWhitespace)
+	,event(eof),nameId(XMLNameTable::unknown),emptyElement(false),pendingEnd(false),depth(0),attrCount(0)
+{
+}
+
+void XMLPullParser::error(const char *text) const {
+	throw XMLParseError(THISLOCATION, base + pos, text);
+}
+
+namespace {
+	//thrown when the event doesn't fit in the incomplete buffer, caught by next()
+	struct NeedData {};
+}
+
+void XMLPullParser::endOfData(const char *text) const {
+	if (!complete) throw NeedData();
+	error(text);
+}
+
+void XMLPullParser::refill(ConstStrA document, bool complete) {
+	base += pos;
+	doc = document;
+	pos = 0;
+	this->complete = complete;
+}
+
+static inline bool isXmlSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline bool isNameChar(char c) {
+	return !isXmlSpace(c) && c != '>' && c != '/' && c != '=' && c != '<' && c != '?' && c != '"' && c != '\'';
+}
+
+natural XMLPullParser::findStr(ConstStrA what) const {
+	const char *b = doc.data();
+	natural len = doc.length();
+	natural p = pos;
+	while (p + what.length() <= len) {
+		const char *f = reinterpret_cast<const char *>(memchr(b + p, what[0], len - p));
+		if (f == 0) return naturalNull;
+		p = f - b;
+		if (p + what.length() > len) return naturalNull;
+		if (memcmp(f, what.data(), what.length()) == 0) return p;
+		p++;
+	}
+	return naturalNull;
+}
+
+void XMLPullParser::skipSpaces() {
+	while (pos < doc.length() && isXmlSpace(doc[pos])) pos++;
+}
+
+ConstStrA XMLPullParser::readName() {
+	natural b = pos;
+	while (pos < doc.length() && isNameChar(doc[pos])) pos++;
+	if (pos == b) {
+		if (pos >= doc.length()) endOfData("unexpected end of document");
+		error("name expected");
+	}
+	return ConstStrA(doc.data() + b, pos - b);
+}
+
+XMLPullParser::Event XMLPullParser::next() {
+	attrCount = 0;
+	rawText = ConstStrA();
+	if (pendingEnd) {
+		//empty element generates end tag
+		pendingEnd = false;
+		emptyElement = false;
+		depth--;
+		return event = endTag;
+	}
+	emptyElement = false;
+	natural start = pos;
+	try {
+		while (pos < doc.length()) {
+			const char *b = doc.data();
+			if (b[pos] == '<') {
+				pos++;
+				if (pos >= doc.length()) endOfData("unexpected end of document");
+				switch (b[pos]) {
+				case '/': pos++; parseEndTag(); return event;
+				case '!': pos++; parseMarkup(); return event;
+				case '?': pos++; parseProcInstr(); return event;
+				default: parseTag(); return event;
+				}
+			}
+			//text runs until next tag
+			const char *f = reinterpret_cast<const char *>(memchr(b + pos, '<', doc.length() - pos));
+			if (f == 0 && !complete) throw NeedData();
+			natural e = f?(natural)(f - b):doc.length();
+			ConstStrA t(b + pos, e - pos);
+			pos = e;
+			if (skipWhitespace) {
+				natural i = 0;
+				while (i < t.length() && isXmlSpace(t[i])) i++;
+				if (i == t.length()) continue;
+			}
+			rawText = t;
+			return event = text;
+		}
+		if (!complete) throw NeedData();
+	} catch (const NeedData &) {
+		//event is parsed again from the beginning after refill
+		pos = start;
+		emptyElement = false;
+		pendingEnd = false;
+		attrCount = 0;
+		rawText = ConstStrA();
+		return event = needData;
+	}
+	return event = eof;
+}
+
+void XMLPullParser::parseTag() {
+	name = readName();
+	nameId = nameTable->intern(name);
+	parseAttributes();
+	if (pos < doc.length() && doc[pos] == '/') {
+		emptyElement = true;
+		pendingEnd = true;
+		pos++;
+	}
+	if (pos >= doc.length()) endOfData("unexpected end of document");
+	if (doc[pos] != '>') error("'>' expected");
+	pos++;
+	depth++;
+	event = startTag;
+}
+
+void XMLPullParser::parseAttributes() {
+	while (true) {
+		skipSpaces();
+		if (pos >= doc.length()) endOfData("unexpected end of document");
+		char c = doc[pos];
+		if (c == '>' || c == '/' || c == '?') return;
+		if (attrCount == attrs.length()) attrs.add(Attribute());
+		Attribute &a = attrs(attrCount++);
+		a.name = readName();
+		a.nameId = nameTable->intern(a.name);
+		skipSpaces();
+		if (pos >= doc.length() || doc[pos] != '=') {
+			//attribute without value
+			a.rawValue = ConstStrA();
+			continue;
+		}
+		pos++;
+		skipSpaces();
+		if (pos >= doc.length()) endOfData("unexpected end of document");
+		c = doc[pos];
+		if (c == '"' || c == '\'') {
+			pos++;
+			const char *b = doc.data();
+			const char *f = reinterpret_cast<const char *>(memchr(b + pos, c, doc.length() - pos));
+			if (f == 0) endOfData("unterminated attribute value");
+			a.rawValue = ConstStrA(b + pos, f - b - pos);
+			pos = f - b + 1;
+		} else {
+			//unquoted value
+			natural s = pos;
+			while (pos < doc.length() && !isXmlSpace(doc[pos]) && doc[pos] != '>') pos++;
+			if (pos >= doc.length()) endOfData("unexpected end of document");
+			a.rawValue = ConstStrA(doc.data() + s, pos - s);
+		}
+	}
+}
+
+void XMLPullParser::parseEndTag() {
+	name = readName();
+	nameId = nameTable->intern(name);
+	skipSpaces();
+	if (pos >= doc.length()) endOfData("unexpected end of document");
+	if (doc[pos] != '>') error("'>' expected");
+	pos++;
+	if (depth) depth--;
+	event = endTag;
+}
+
+void XMLPullParser::parseMarkup() {
+	const char *b = doc.data();
+	natural rem = doc.length() - pos;
+	if (rem >= 2 && memcmp(b + pos, "--", 2) == 0) {
+		pos += 2;
+		natural e = findStr("-->");
+		if (e == naturalNull) endOfData("unterminated comment");
+		rawText = ConstStrA(b + pos, e - pos);
+		pos = e + 3;
+		event = comment;
+	} else if (rem >= 7 && memcmp(b + pos, "[CDATA[", 7) == 0) {
+		pos += 7;
+		natural e = findStr("]]>");
+		if (e == naturalNull) endOfData("unterminated CDATA section");
+		rawText = ConstStrA(b + pos, e - pos);
+		pos = e + 3;
+		event = cdata;
+	} else {
+		//declaration, can contain internal subset in brackets
+		natural s = pos;
+		natural level = 0;
+		while (pos < doc.length() && (doc[pos] != '>' || level)) {
+			if (doc[pos] == '[') level++;
+			else if (doc[pos] == ']' && level) level--;
+			pos++;
+		}
+		if (pos >= doc.length()) endOfData("unterminated declaration");
+		rawText = ConstStrA(b + s, pos - s);
+		pos++;
+		event = doctype;
+	}
+}
+
+void XMLPullParser::parseProcInstr() {
+	name = readName();
+	nameId = nameTable->intern(name);
+	skipSpaces();
+	natural e = findStr("?>");
+	if (e == naturalNull) endOfData("unterminated processing instruction");
+	rawText = ConstStrA(doc.data() + pos, e - pos);
+	pos = e + 2;
+	event = procInstr;
+}
+
+const XMLPullParser::Attribute *XMLPullParser::findAttr(natural nameId) const {
+	for (natural i = 0; i < attrCount; i++)
+		if (attrs[i].nameId == nameId) return &attrs[i];
+	return 0;
+}
+
+const XMLPullParser::Attribute *XMLPullParser::findAttr(ConstStrA name) const {
+	natural id = nameTable->find(name);
+	if (id == XMLNameTable::unknown) return 0;
+	return findAttr(id);
+}
+
+bool XMLPullParser::getAttrValue(natural nameId, AutoArray<char> &buffer, ConstStrA &value) const {
+	const Attribute *a = findAttr(nameId);
+	if (a == 0) return false;
+	value = decode(a->rawValue, buffer);
+	return true;
+}
+
+ConstStrA XMLPullParser::decodeText(AutoArray<char> &buffer) const {
+	if (event == cdata || event == comment) return rawText;
+	return decode(rawText, buffer);
+}
+
+static void writeUtf8(AutoArray<char> &buffer, natural cp) {
+	if (cp < 0x80) {
+		buffer.add((char)cp);
+	} else if (cp < 0x800) {
+		buffer.add((char)(0xC0 | (cp >> 6)));
+		buffer.add((char)(0x80 | (cp & 0x3F)));
+	} else if (cp < 0x10000) {
+		buffer.add((char)(0xE0 | (cp >> 12)));
+		buffer.add((char)(0x80 | ((cp >> 6) & 0x3F)));
+		buffer.add((char)(0x80 | (cp & 0x3F)));
+	} else {
+		buffer.add((char)(0xF0 | ((cp >> 18) & 0x07)));
+		buffer.add((char)(0x80 | ((cp >> 12) & 0x3F)));
+		buffer.add((char)(0x80 | ((cp >> 6) & 0x3F)));
+		buffer.add((char)(0x80 | (cp & 0x3F)));
+	}
+}
+
+static bool decodeEntity(ConstStrA ent, AutoArray<char> &buffer) {
+	if (ent == ConstStrA("lt")) buffer.add('<');
+	else if (ent == ConstStrA("gt")) buffer.add('>');
+	else if (ent == ConstStrA("amp")) buffer.add('&');
+	else if (ent == ConstStrA("apos")) buffer.add('\'');
+	else if (ent == ConstStrA("quot")) buffer.add('"');
+	else if (ent.length() > 1 && ent[0] == '#') {
+		natural cp = 0;
+		natural i = 1;
+		bool hex = ent[1] == 'x' || ent[1] == 'X';
+		if (hex) i++;
+		if (i >= ent.length()) return false;
+		for (; i < ent.length(); i++) {
+			char c = ent[i];
+			natural d;
+			if (c >= '0' && c <= '9') d = c - '0';
+			else if (hex && c >= 'a' && c <= 'f') d = c - 'a' + 10;
+			else if (hex && c >= 'A' && c <= 'F') d = c - 'A' + 10;
+			else return false;
+			//stop accumulating once out of range, so the value cannot overflow
+			if (cp <= 0x10FFFF) cp = cp * (hex?16:10) + d;
+		}
+		//reference to a code point which cannot be encoded is replaced by U+FFFD
+		if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) cp = 0xFFFD;
+		writeUtf8(buffer, cp);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+ConstStrA XMLPullParser::decode(ConstStrA raw, AutoArray<char> &buffer) {
+	const char *b = raw.data();
+	natural len = raw.length();
+	const char *f = len?reinterpret_cast<const char *>(memchr(b, '&', len)):0;
+	if (f == 0) return raw;
+	buffer.clear();
+	natural p = 0;
+	while (f) {
+		natural a = f - b;
+		buffer.append(ConstStrA(b + p, a - p));
+		const char *sc = reinterpret_cast<const char *>(memchr(f, ';', len - a));
+		//entities are short, unknown entity is copied as is
+		if (sc == 0 || sc - f > 12 || !decodeEntity(ConstStrA(f + 1, sc - f - 1), buffer)) {
+			buffer.add('&');
+			p = a + 1;
+		} else {
+			p = sc - b + 1;
+		}
+		f = p < len?reinterpret_cast<const char *>(memchr(b + p, '&', len - p)):0;
+	}
+	buffer.append(ConstStrA(b + p, len - p));
+	return ConstStrA(buffer.data(), buffer.length());
+}
+
+void XMLParseError::message(ExceptionMsg &msg) const {
+	msg("XML parser error at offset %1: %2") << offset << text;
+}
+
+}
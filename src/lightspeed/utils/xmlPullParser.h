@@ -0,0 +1,262 @@
+/*
+ * xmlPullParser.h
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+
+#ifndef LIGHTSPEED_UTILS_XMLPULLPARSER_H_
+#define LIGHTSPEED_UTILS_XMLPULLPARSER_H_
+
+#include "../base/containers/constStr.h"
+#include "../base/containers/autoArray.h"
+#include "../base/containers/string.h"
+#include "../base/exceptions/exception.h"
+
+namespace LightSpeed {
+
+	///Table of interned names of tags and attributes
+	/**
+	 * Each name is stored only once and it is identified by a number. Comparing
+	 * ids is faster than comparing strings. You can intern names you are looking
+	 * for before parsing, and then compare the ids of the entities.
+	 *
+	 * Table can be shared by multiple parsers. It is not MT safe.
+	 */
+	class XMLNameTable {
+	public:
+
+		///id of unknown name
+		static const natural unknown = naturalNull;
+
+		XMLNameTable();
+
+		///Interns the name
+		/**
+		 * @param name name
+		 * @return id of the name. If name is already in the table, existing id is returned
+		 */
+		natural intern(ConstStrA name);
+		///Finds the name
+		/**
+		 * @param name name
+		 * @return id of the name or XMLNameTable::unknown, if name is not in the table
+		 */
+		natural find(ConstStrA name) const;
+		///Retrieves name for the id
+		ConstStrA getName(natural id) const {return names[id];}
+		///Count of names
+		natural length() const {return names.length();}
+
+	protected:
+		AutoArray<StringA> names;
+		AutoArray<natural> hashTable;
+
+		static natural hash(ConstStrA name);
+		natural lookup(ConstStrA name, natural h) const;
+		void rehash(natural size);
+	};
+
+	///Pull parser of XML documents encoded in UTF-8
+	/**
+	 * Parser works on the buffer which contains whole document (for example, memory
+	 * mapped file). It doesn't copy the document. All names, values and texts
+	 * are returned as slices of the buffer, so the buffer must exist while the
+	 * parser is used.
+	 *
+	 * Text between the tags is returned as one event. Entities (&amp; etc) are
+	 * not decoded until text is requested by decodeText() or getAttrValue(). Raw
+	 * slices without decoding are available too.
+	 *
+	 * Document received in parts can be parsed too. When the buffer is passed
+	 * by refill() with complete=false, parser returns needData if the buffer
+	 * ends inside of the event. Caller then passes the unparsed rest of the
+	 * buffer followed by the next part to refill().
+	 *
+	 * Names of tags and attributes are interned into the XMLNameTable. The parser
+	 * doesn't allocate memory per event. Only new names and the attribute list
+	 * of the tag with the most attributes need allocation.
+	 *
+	 * @code
+	 * XMLPullParser parser(data);
+	 * natural item = parser.getNames().intern("item");
+	 * while (parser.next() != XMLPullParser::eof) {
+	 *    if (parser.getEvent() == XMLPullParser::startTag && parser.getNameId() == item) {...}
+	 * }
+	 * @endcode
+	 *
+	 * Legacy XMLIterator (xmlparser.h) is an adapter over this parser.
+	 */
+	class XMLPullParser {
+	public:
+
+		enum Event {
+			///end of document
+			eof,
+			///start tag. Name and attributes are valid
+			startTag,
+			///end tag. Name is valid. Empty element (<a/>) generates startTag and endTag
+			endTag,
+			///text between tags
+			text,
+			///content of CDATA section. Text is not decoded
+			cdata,
+			///content of comment
+			comment,
+			///processing instruction (<?xml ... ?>). Name is valid, text contains rest of the instruction
+			procInstr,
+			///document type declaration. Text contains content of the declaration
+			doctype,
+			///buffer ends inside of the next event, call refill(). Returned only if the document is not complete
+			needData
+		};
+
+		///Attribute of the tag
+		struct Attribute {
+			///name of the attribute
+			ConstStrA name;
+			///raw value (entities are not decoded)
+			ConstStrA rawValue;
+			///id of the name in the name table
+			natural nameId;
+		};
+
+		///Creates parser
+		/**
+		 * @param document document to parse. Buffer must exist while parser is used
+		 * @param skipWhitespace if true, text which contains whitespaces only is not reported
+		 */
+		XMLPullParser(ConstStrA document, bool skipWhitespace = true);
+		///Creates parser with shared name table
+		XMLPullParser(ConstStrA document, XMLNameTable &names, bool skipWhitespace = true);
+
+		///Reads next event
+		/**
+		 * @return type of the event
+		 * @exception XMLParseError document is malformed
+		 */
+		Event next();
+		///Returns current event
+		Event getEvent() const {return event;}
+
+		///Name of the tag or processing instruction
+		ConstStrA getName() const {return name;}
+		///Id of the name in the name table
+		natural getNameId() const {return nameId;}
+		///Returns true, if the start tag is empty element (<a/>)
+		bool isEmptyElement() const {return emptyElement;}
+		///Depth of the current element. Root element has depth 1
+		natural getDepth() const {return depth;}
+
+		///Count of the attributes of the start tag
+		natural getAttrCount() const {return attrCount;}
+		///Retrieves attribute
+		const Attribute &getAttr(natural index) const {return attrs[index];}
+		///Finds attribute by id of the name
+		/**
+		 * @param nameId id of the name
+		 * @return pointer to the attribute or 0 if not found
+		 */
+		const Attribute *findAttr(natural nameId) const;
+		///Finds attribute by name
+		const Attribute *findAttr(ConstStrA name) const;
+		///Retrieves decoded value of the attribute
+		/**
+		 * @param nameId id of the name
+		 * @param buffer buffer used if the value contains entities
+		 * @param value receives value
+		 * @retval true found
+		 * @retval false not found
+		 */
+		bool getAttrValue(natural nameId, AutoArray<char> &buffer, ConstStrA &value) const;
+
+		///Retrieves raw text of the text, cdata, comment, procInstr or doctype
+		ConstStrA getRawText() const {return rawText;}
+		///Retrieves decoded text
+		/**
+		 * @param buffer buffer used if the text contains entities
+		 * @return decoded text. It is the slice of the document, if there are no entities
+		 */
+		ConstStrA decodeText(AutoArray<char> &buffer) const;
+
+		///Decodes entities
+		/**
+		 * @param raw raw text
+		 * @param buffer buffer used if the text contains entities
+		 * @return decoded text. It is the slice of the raw text, if there are no entities
+		 */
+		static ConstStrA decode(ConstStrA raw, AutoArray<char> &buffer);
+
+		///Replaces the buffer by the next part of the document
+		/**
+		 * Allows to parse the document received in parts. Slices returned for the
+		 * previous buffer become invalid.
+		 *
+		 * @param document new buffer. It must start by the data which has not been
+		 *  parsed yet, i.e. at getBufferOffset() of the previous buffer
+		 * @param complete true if the buffer contains the rest of the document. If false,
+		 *  the parser returns needData instead of the event which doesn't fit in the buffer
+		 */
+		void refill(ConstStrA document, bool complete);
+		///Retrieves name table
+		XMLNameTable &getNames() const {return *nameTable;}
+		///Retrieves offset of the current position in the document
+		natural getOffset() const {return base + pos;}
+		///Retrieves offset of the current position in the current buffer
+		natural getBufferOffset() const {return pos;}
+
+	protected:
+
+		ConstStrA doc;
+		natural pos;
+		///offset of the buffer in the document
+		natural base;
+		///buffer contains the rest of the document
+		bool complete;
+		XMLNameTable ownNames;
+		XMLNameTable *nameTable;
+		bool skipWhitespace;
+
+		Event event;
+		ConstStrA name;
+		natural nameId;
+		bool emptyElement;
+		bool pendingEnd;
+		natural depth;
+		ConstStrA rawText;
+		AutoArray<Attribute> attrs;
+		natural attrCount;
+
+		natural findStr(ConstStrA what) const;
+		void skipSpaces();
+		ConstStrA readName();
+		void parseTag();
+		void parseEndTag();
+		void parseMarkup();
+		void parseProcInstr();
+		void parseAttributes();
+		void error(const char *text) const;
+		void endOfData(const char *text) const;
+	};
+
+	///Thrown by XMLPullParser when document is malformed
+	class XMLParseError: public Exception {
+	public:
+		LIGHTSPEED_EXCEPTIONFINAL;
+
+		XMLParseError(const ProgramLocation &loc, natural offset, const char *text)
+			:Exception(loc),offset(offset),text(text) {}
+
+		///offset in the document where error has been detected
+		natural getOffset() const {return offset;}
+
+	protected:
+		natural offset;
+		const char *text;
+
+		virtual void message(ExceptionMsg &msg) const;
+	};
+
+}
+
+#endif /* LIGHTSPEED_UTILS_XMLPULLPARSER_H_ */
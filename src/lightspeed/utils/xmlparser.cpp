@@ -4,27 +4,76 @@
 #include "../base/streams/utf.tcc"
 #include "../base/text/textstream.tcc"
 #include "../base/iter/iteratorFilter.tcc"
+#include "../base/containers/autoArray.tcc"
 #define LS_MSVC_SKIPEXTERN_XMLIterator
 #include "xmlparser.h"
 
 namespace LightSpeed {
 
 
-	static void setupScanner(ScanTextW &txtin) {
-		txtin.nxChain().getConverter().enableSkipInvalidChars(true); //skip invalid characters - all is treat as UTF-8 but document can be in different encoding
+	static const natural readBlockSize = 4096;
+
+	//document is UTF-8 already, it is passed to the parser as is
+	static bool readBlock(SeqFileInput &sfi, AutoArray<char> &doc, AutoArray<byte> &, const ScanTextW *) {
+		if (!sfi.hasItems()) return false;
+		char buff[readBlockSize];
+		natural rd = sfi.blockRead(buff, sizeof(buff), false);
+		doc.append(ConstStrA(buff, rd));
+		return true;
+	}
+
+	//wide-char document is converted to UTF-8
+	static bool readBlock(SeqFileInput &sfi, AutoArray<char> &doc, AutoArray<byte> &rest, const ScanTextWW *) {
+		if (!sfi.hasItems()) return false;
+		byte buff[readBlockSize];
+		natural rd = sfi.blockRead(buff, sizeof(buff), false);
+		rest.append(ConstBin(buff, rd));
+		natural cnt = rest.length() / sizeof(wchar_t);
+		AutoArray<wchar_t, SmallAlloc<readBlockSize / sizeof(wchar_t)> > text;
+		text.resize(cnt);
+		memcpy(text.data(), rest.data(), cnt * sizeof(wchar_t));
+		//keep first half of surrogate pair for the next block
+		if (cnt && text[cnt - 1] >= 0xD800 && text[cnt - 1] < 0xDC00) cnt--;
+		rest.erase(0, cnt * sizeof(wchar_t));
+		String::StrA utf = String::getUtf8(ConstStrW(text.data(), cnt));
+		doc.append(ConstStrA(utf));
+		return true;
 	}
 
-	static void setupScanner(ScanTextWW &) {
+	//document can be in different encoding, invalid sequences are passed as characters
+	static String toString(ConstStrA text) {
+		Utf8ToWideConvert conv(true);
+		AutoArray<wchar_t, SmallAlloc<256> > out;
+		for (natural i = 0; i < text.length(); i++) {
+			conv.write(text[i]);
+			if (conv.hasItems) out.add(conv.getNext());
+		}
+		return String(ConstStrW(out.data(), out.length()));
+	}
+
+	static inline bool isSpace(char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
 	}
 
 template<typename Scanner>
 XMLIteratorT<Scanner>::XMLIteratorT( SeqFileInput &sfi,bool skipComments )
-	:cur(&p1),next(&p2),txtin(sfi),curState(textBegin),skipComments(skipComments)
+	:cur(&p1),next(&p2),input(sfi),parser(ConstStrA(), false)
+	,curState(readEvent),textPos(0),textType(XMLEntity::textchar),attrIndex(0)
+	,trimText(true),skipComments(skipComments)
 {
-	setupScanner(txtin);
+	refill();
 	loadNext();
 }
 
+template<typename Scanner>
+void XMLIteratorT<Scanner>::refill()
+{
+	//drop parsed data, keep the incomplete event and append next block
+	document.erase(0, parser.getBufferOffset());
+	bool more = readBlock(input, document, wideRest, (const Scanner *)0);
+	parser.refill(ConstStrA(document.data(), document.length()), !more);
+}
+
 template<typename Scanner>
 bool XMLIteratorT<Scanner>::hasItems() const
 {
@@ -49,184 +98,176 @@ const XMLEntity & XMLIteratorT<Scanner>::peek() const
 
 template<typename Scanner>
 void XMLIteratorT<Scanner>::loadNext()
-{	
+{
 	switch (curState) {
-		case textBegin:
-			eatSpace();
-			curState = textNext; //there is no break
-		case textNext:
-			if (!txtin.hasItems()) {
-				next = 0;
+		case inText:
+			if (textPos < curText.length()) {
+				next->type = textType;
+				next->chr = curText[textPos++];
 				return;
 			}
-			if (txtin(L" <%")) {
-				enterTag();
-				if (next->type == XMLEntity::commentText && skipComments) {
-					skipBlock();
-				}
-				return;
-			}
-			if (txtin(L"&%(1,10)1;%")) {
-				next->chr = loadEntity(txtin[1].str());
-				next->type = XMLEntity::textchar;
-				return;
-			} else {
-				next->chr = txtin.getNext();
-				next->type = XMLEntity::textchar;
-				return;
-			}
-
-		case textCData:
-			if (!txtin.hasItems()) {
-				next = 0;
+			break;
+		case intag:
+			if (attrIndex < parser.getAttrCount()) {
+				const XMLPullParser::Attribute &a = parser.getAttr(attrIndex++);
+				next->type = XMLEntity::attribute;
+				next->tag = curTag;
+				next->attr = toString(a.name);
+				next->value = toString(XMLPullParser::decode(a.rawValue, decodeBuffer));
 				return;
 			}
-			if (txtin(L"]]>%")) {
-				curState = textNext;
-				loadNext();
-			}
-			next->chr = txtin.getNext();
-			next->type = XMLEntity::textchar;
-			return;
-		case incomment:
-			if (txtin(L"-->%")) {
-				curState = textNext;
-				loadNext();
-			}
-			next->type = XMLEntity::commentText;
-			next->chr = txtin.getNext();
-			return;
-		case intag:
-			readAttr();
+			next->type = XMLEntity::closetag;
+			next->tag = curTag;
+			next->endTag = false;
+			curState = readEvent;
 			return;
-		case inendtag: 
-			next->type = XMLEntity::opentag;
-			next->endTag = true;
+		case inprocinstr:
+			if (readPIAttr()) return;
+			next->type = XMLEntity::closetag;
 			next->tag = curTag;
-			curState = inclosetag;
+			next->endTag = false;
+			curState = readEvent;
 			return;
 		case inclosetag:
 			next->type = XMLEntity::closetag;
-			next->endTag = true;
 			next->tag = curTag;
-			curState = textBegin;
-			return;
-		case incloseendtag:
+			next->endTag = true;
+			curState = readEvent;
 			return;
-
+		case readEvent:
+			break;
 	}
+	curState = readEvent;
+	loadEvent();
 }
 
 template<typename Scanner>
-void XMLIteratorT<Scanner>::eatSpace()
+void XMLIteratorT<Scanner>::loadEvent()
 {
-	txtin(L" ");
-}
-
-template<typename Scanner>
-wchar_t XMLIteratorT<Scanner>::loadEntity(ConstStrW entityName)
-{
-	if (entityName == ConstStrW(L"lt")) return '<';
-	if (entityName == ConstStrW(L"gt")) return '>';
-	if (entityName == ConstStrW(L"amp")) return '&';
-	if (entityName == ConstStrW(L"apos")) return '\'';
-	if (entityName == ConstStrW(L"quot")) return '"';
-	if (entityName[0] == '#') {
-		natural r;
-		if (entityName.length()>1 && entityName[1] == 'h') {
-			parseUnsignedNumber<ConstStrW::Iterator,natural>(entityName.getFwIter(),r,16);
-		} else {
-			parseUnsignedNumber<ConstStrW::Iterator,natural>(entityName.getFwIter(),r,10);
+	for(;;) {
+		switch (parser.next()) {
+			case XMLPullParser::eof:
+				next = 0;
+				return;
+			case XMLPullParser::needData:
+				refill();
+				break;
+			case XMLPullParser::startTag:
+				setTag(0, parser.getName());
+				next->type = XMLEntity::opentag;
+				next->tag = curTag;
+				next->endTag = false;
+				attrIndex = 0;
+				curState = intag;
+				trimText = true;
+				return;
+			case XMLPullParser::endTag:
+				setTag(0, parser.getName());
+				next->type = XMLEntity::opentag;
+				next->tag = curTag;
+				next->endTag = true;
+				curState = inclosetag;
+				trimText = true;
+				return;
+			case XMLPullParser::text: {
+				ConstStrA t = parser.decodeText(decodeBuffer);
+				//spaces after the tag are not reported
+				if (trimText) {
+					natural i = 0;
+					while (i < t.length() && isSpace(t[i])) i++;
+					t = t.offset(i);
+				}
+				if (startText(t, XMLEntity::textchar)) {
+					trimText = false;
+					return;
+				}
+				break;
+			}
+			case XMLPullParser::cdata:
+				trimText = false;
+				if (startText(parser.getRawText(), XMLEntity::textchar)) return;
+				break;
+			case XMLPullParser::comment:
+				if (skipComments) break;
+				trimText = false;
+				if (startText(parser.getRawText(), XMLEntity::commentText)) return;
+				break;
+			case XMLPullParser::procInstr:
+				setTag('?', parser.getName());
+				next->type = XMLEntity::opentag;
+				next->tag = curTag;
+				next->endTag = false;
+				piText = parser.getRawText();
+				curState = inprocinstr;
+				trimText = true;
+				return;
+			case XMLPullParser::doctype: {
+				//declaration is reported as tag without attributes
+				ConstStrA t = parser.getRawText();
+				natural i = 0;
+				while (i < t.length() && !isSpace(t[i]) && t[i] != '[') i++;
+				setTag('!', t.head(i));
+				next->type = XMLEntity::opentag;
+				next->tag = curTag;
+				next->endTag = false;
+				attrIndex = parser.getAttrCount();
+				curState = intag;
+				trimText = true;
+				return;
+			}
 		}
-		return (wchar_t)r;
-	} 
-	return '&';
+	}
 }
 
 template<typename Scanner>
-void XMLIteratorT<Scanner>::readAttr()
+bool XMLIteratorT<Scanner>::startText(ConstStrA text, XMLEntity::Type type)
 {
-	if (txtin(L" />%")) {
-		next->type = XMLEntity::closetag;
-		next->tag = curTag;
-		next->endTag = cur->endTag;
-		curState = inendtag;
-		return;
-	} else if (txtin(L" >%") || txtin(L" ?>%")) {
-		next->type = XMLEntity::closetag;
-		next->tag = curTag;
-		next->endTag = cur->endTag;
-		curState = textBegin;
-		return;
-	} else if (txtin(L" %[*^>]1='%[*^>]2'%") || txtin(L" %[*^>]1=\"%[*^>]2\"%") || txtin(L" %[*^>]1=%[*^>]2 %")) {
-		next->type = XMLEntity::attribute;
-		next->tag = curTag;		
-		curAttr = fixEntities(txtin[1].str());
-		curValue = fixEntities(txtin[2].str());
-		next->attr = curAttr;
-		next->value = curValue;
-		return;
-	} else {
-		next->type = XMLEntity::closetag;
-		next->tag = curTag;
-		next->endTag = cur->endTag;
-		curState = textBegin;
-		return;
-
-	}
+	curText = toString(text);
+	if (curText.empty()) return false;
+	textType = type;
+	textPos = 1;
+	curState = inText;
+	next->type = type;
+	next->chr = curText[0];
+	return true;
 }
 
 template<typename Scanner>
-void XMLIteratorT<Scanner>::enterTag()
+void XMLIteratorT<Scanner>::setTag(char prefix, ConstStrA name)
 {
-	if (txtin(L"![CDATA[%")) {
-		curState = textCData;
-		loadNext();
-	} else if (txtin(L"!--")) {
-		curState = incomment;
-		loadNext();
-	} else if (txtin(L"/%[0-9a-zA-Z:_]1 >%")) {
-		curTag = txtin[1].str();
-		next->type = XMLEntity::opentag;
-		next->tag = curTag;
-		next->endTag = true;
-		curState = inclosetag;
-		return;
-
-	} else if (txtin(L"%[!?0-9a-zA-Z:_]1%%")) {
-		curTag = txtin[1].str();
-		next->type = XMLEntity::opentag;
-		next->tag = curTag;
-		next->endTag = false;
-		curState = intag;
-		return;
-	} else {
-		next->type = XMLEntity::textchar;
-		next->chr = '<';
-		curState = textNext;
+	if (prefix) {
+		decodeBuffer.clear();
+		decodeBuffer.add(prefix);
+		decodeBuffer.append(name);
+		name = ConstStrA(decodeBuffer.data(), decodeBuffer.length());
 	}
+	curTag = toString(name);
 }
 
 template<typename Scanner>
-String XMLIteratorT<Scanner>::fixEntities(ConstStrW text)
+bool XMLIteratorT<Scanner>::readPIAttr()
 {
-	natural x = text.find('&');
-	if (x == naturalNull) return text;
-	AutoArrayStream<wchar_t> buff;
-	while (x != naturalNull) {
-		buff.blockWrite(text.head(x),true);
-		text = text.offset(x+1);
-		natural y = text.find(';');
-		if (y != naturalNull) {
-			buff.write(loadEntity(text.head(y)));
-			text = text.offset(y+1);
-		} else {
-			buff.write('&');
-		}
-		x = text.find('&');
-	}
-	buff.blockWrite(text.constRef(),true);
-	return buff.getArray();
+	//pseudo-attributes: name="value" or name='value'
+	natural p = 0;
+	while (p < piText.length() && isSpace(piText[p])) p++;
+	natural nb = p;
+	while (p < piText.length() && piText[p] != '=' && !isSpace(piText[p])) p++;
+	ConstStrA name = piText.mid(nb, p - nb);
+	while (p < piText.length() && isSpace(piText[p])) p++;
+	if (name.empty() || p + 1 >= piText.length() || piText[p] != '=') return false;
+	p++;
+	while (p < piText.length() && isSpace(piText[p])) p++;
+	if (p >= piText.length() || (piText[p] != '"' && piText[p] != '\'')) return false;
+	char q = piText[p++];
+	ConstStrA rest = piText.offset(p);
+	natural e = rest.find(q);
+	if (e == naturalNull) return false;
+	piText = rest.offset(e + 1);
+	next->type = XMLEntity::attribute;
+	next->tag = curTag;
+	next->attr = toString(name);
+	next->value = toString(XMLPullParser::decode(rest.head(e), decodeBuffer));
+	return true;
 }
 
 template<typename Scanner>
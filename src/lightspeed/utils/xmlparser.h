@@ -3,6 +3,7 @@
 #include "../base/iter/iterator.h"
 #include "../base/streams/fileio.h"
 #include "../base/text/textstream.h"
+#include "xmlPullParser.h"
 
 namespace LightSpeed {
 
@@ -42,6 +43,19 @@ namespace LightSpeed {
 	};
 
 
+	///Legacy XML iterator
+	/**
+	 * Iterator reports the document as a stream of entities, single character of
+	 * the text per entity. It is a compatibility adapter over the XMLPullParser.
+	 * Stream is read by blocks as the entities are requested, only the event
+	 * currently parsed is kept in the memory.
+	 *
+	 * Document is expected in UTF-8, but it can be in different encoding. Invalid
+	 * sequences are not reported as errors, bytes are passed as characters.
+	 * Malformed markup causes XMLParseError.
+	 *
+	 * @tparam Scanner ScanTextW for UTF-8 streams, ScanTextWW for wide-char streams
+	 */
 	template<typename Scanner>
 	class XMLIteratorT: public IteratorBase<XMLEntity, XMLIteratorT<Scanner> > {
 	public:
@@ -59,36 +73,45 @@ namespace LightSpeed {
 	protected:
 
 		XMLEntity p1,p2;
-		XMLEntity *cur, *next;		
-		Scanner txtin;
+		XMLEntity *cur, *next;
+		SeqFileInput input;
+		///part of the document which is not parsed yet, in UTF-8
+		AutoArray<char> document;
+		///bytes of incomplete wide character (ScanTextWW)
+		AutoArray<byte> wideRest;
+		XMLPullParser parser;
+		AutoArray<char> decodeBuffer;
 
 		void loadNext();
+		void refill();
 
-		void eatSpace();
 		enum State {
-			textBegin,
-			textNext,
-			textCData,			
+			///reads next event of the parser
+			readEvent,
+			///reports characters of curText
+			inText,
+			///reports attributes of the start tag
 			intag,
-			incomment,
+			///reports pseudo-attributes of the processing instruction
+			inprocinstr,
+			///reports close of the end tag
 			inclosetag,
-			inendtag,
-			incloseendtag,
 		};
 
 		State curState;
 		String curTag;
-		String curAttr;
-		String curValue;
+		String curText;
+		natural textPos;
+		XMLEntity::Type textType;
+		natural attrIndex;
+		ConstStrA piText;
+		bool trimText;
 		bool skipComments;
-			 
-		wchar_t loadEntity(ConstStrW ent);
-		void readAttr();
-		void enterTag();
-		String fixEntities(ConstStrW text);
-
-
 
+		void loadEvent();
+		bool startText(ConstStrA text, XMLEntity::Type type);
+		bool readPIAttr();
+		void setTag(char prefix, ConstStrA name);
 
 	};
 
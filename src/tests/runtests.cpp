@@ -1,6 +1,9 @@
 #include "../lightspeed/base/framework/app.h"
 #include "../lightspeed/base/framework/testapp.h"
 #include "../lightspeed/base/streams/standardIO.tcc"
+#include "../lightspeed/base/text/textParser.tcc"
+#include "../lightspeed/base/memory/staticAlloc.h"
+#include "../lightspeed/utils/json/json.h"
 namespace LightSpeedTest {
 
 	using namespace LightSpeed;
@@ -8,11 +11,98 @@ namespace LightSpeedTest {
 
 	class Main : public App {
 	public:
-		
+
 		virtual integer start(const Args &args);
 
+	protected:
+
+		integer runBenchmarks(const Args &args);
+
 	};
 
+	static JSON::Value benchmarksToJSON(JSON::PFactory f, const TestCollector::BenchmarkResults &results) {
+		JSON::Value out = f->newObject();
+		for (natural i = 0; i < results.length(); i++) {
+			const BenchmarkApp::Result &r = results[i].result;
+			JSON::Value rec = f->newObject();
+			rec->add("iterations", f->newValue(r.iterations));
+			rec->add("min", f->newValue(r.minNs));
+			rec->add("median", f->newValue(r.medianNs));
+			rec->add("p99", f->newValue(r.p99Ns));
+			rec->add("allocs", f->newValue(r.allocs));
+			if (r.cycles >= 0) rec->add("cycles", f->newValue(r.cycles));
+			if (r.instructions >= 0) rec->add("instructions", f->newValue(r.instructions));
+			if (r.cacheMisses >= 0) rec->add("cacheMisses", f->newValue(r.cacheMisses));
+			out->add(ConstStrA(results[i].name), rec);
+		}
+		return out;
+	}
+
+	///Compares results with baseline
+	/**
+	 * @return count of benchmarks, which median time is worse than baseline by more than threshold percents
+	 */
+	static natural compareWithBaseline(const TestCollector::BenchmarkResults &results, JSON::Value baseline, double threshold, ConsoleA &console) {
+		natural regressions = 0;
+		for (natural i = 0; i < results.length(); i++) {
+			const JSON::INode *b = baseline->getVariable(ConstStrA(results[i].name));
+			if (b == 0) continue;
+			const JSON::INode *m = b->getVariable("median");
+			if (m == 0) continue;
+			double base = m->getFloat();
+			double cur = results[i].result.medianNs;
+			if (base > 0 && cur > base * (1.0 + threshold / 100.0)) {
+				console.print("REGRESSION %1: median %2 ns, baseline %3 ns\n") << results[i].name << cur << base;
+				regressions++;
+			}
+		}
+		return regressions;
+	}
+
+	///Runs benchmarks
+	/**
+	 * arguments: bench [list] [json=<file>] [baseline=<file>] [threshold=<percent>]
+	 */
+	integer Main::runBenchmarks(const Args &args) {
+		ConsoleA console;
+		ConstStrW list, jsonOut, baselineFile;
+		double threshold = 10;
+		for (natural i = 2; i < args.length(); i++) {
+			ConstStrW itm = args[i];
+			if (itm.head(5) == ConstStrW(L"json=")) jsonOut = itm.offset(5);
+			else if (itm.head(9) == ConstStrW(L"baseline=")) baselineFile = itm.offset(9);
+			else if (itm.head(10) == ConstStrW(L"threshold=")) {
+				TextParser<wchar_t, StaticAlloc<256> > parser;
+				if (parser(L" %f1 ", itm.offset(10))) threshold = parser[1];
+			}
+			else list = itm;
+		}
+
+		TestCollector &collector = Singleton<TestCollector>::getInstance();
+		if (list == ConstStrW(L"list")) {
+			console.print("%1") << collector.listBenchmarks();
+			return 0;
+		}
+
+		TestCollector::BenchmarkResults results;
+		{
+			SeqFileOutBuff<> out(StdOutput().getStream());
+			results = collector.runBenchmarks(String::getUtf8(list), out);
+		}
+
+		JSON::PFactory f = JSON::create();
+		if (!jsonOut.empty()) {
+			SeqFileOutput fout(jsonOut, OpenFlags::create | OpenFlags::truncate);
+			f->toStream(*benchmarksToJSON(f, results), fout);
+		}
+		if (!baselineFile.empty()) {
+			SeqFileInput fin(baselineFile, 0);
+			JSON::Value baseline = f->fromStream(fin);
+			if (compareWithBaseline(results, baseline, threshold, console)) return 1;
+		}
+		return 0;
+	}
+
 	LightSpeed::integer Main::start(const Args &args)
 	{
 		ConsoleA console;
@@ -22,6 +112,9 @@ namespace LightSpeedTest {
 			SeqFileOutBuff<> out(StdOutput().getStream());
 			collector.runTests(ConstStrW(),out);
 		}
+		else if (args[1] == ConstStrW(L"bench")) {
+			retval = runBenchmarks(args);
+		}
 		else for (natural i = 1; i < args.length(); i++) {
 			ConstStrW itm = args[i];
 			if (itm == L"list") {
@@ -0,0 +1,125 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/serialize/binFormat.h"
+#include "../lightspeed/base/containers/autoArray.tcc"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+typedef AutoArray<byte> BinBuffer;
+typedef BinaryWriter<BinBuffer::WriteIter> TestBinWriter;
+typedef BinaryReader<BinaryMemInput> TestBinReader;
+
+static void binFormatBlockTest(PrintTextA &print) {
+	BinBuffer buff;
+	AutoArray<double> src;
+	for (natural i = 0; i < 1000; i++) src.add(i * 0.5);
+	AutoArray<natural> items;
+	for (natural i = 0; i < 10; i++) items.add(i * 1000);
+	{
+		TestBinWriter wr(buff.getWriteIterator());
+		//misalign the stream
+		wr.exchange('x');
+		wr.exchangeArray(src);
+		//legacy format, item by item
+		wr.openArray(items.length());
+		for (natural i = 0; i < items.length(); i++) wr.exchange(items[i]);
+		wr.closeArray();
+	}
+	TestBinReader rd(BinaryMemInput(ConstBin(buff.data(), buff.length())));
+	char c;
+	rd.exchange(c);
+	AutoArray<double> dst;
+	rd.exchangeArray(dst);
+	AutoArray<natural> itemsRd;
+	rd.exchangeArray(itemsRd);
+	print("%1 %2 %3") << (c == 'x') << (dst == src) << (itemsRd == items);
+
+	//zero copy
+	TestBinReader rd2(BinaryMemInput(ConstBin(buff.data(), buff.length())));
+	rd2.exchange(c);
+	AutoArray<double> storage;
+	ArrayRef<const double> mapped = rd2.mapArray(storage);
+	bool inBuffer = (const byte *)mapped.data() > buff.data()
+			&& (const byte *)mapped.data() < buff.data() + buff.length();
+	print(" %1 %2 %3") << inBuffer << storage.empty() << (mapped.length() == src.length()
+			&& memcmp(mapped.data(), src.data(), src.length() * sizeof(double)) == 0);
+}
+
+static void binFormatSwapTest(PrintTextA &print) {
+	BinBuffer buff;
+	AutoArray<Bin::natural32> src;
+	src.add(0x01020304);
+	src.add(0xA0B0C0D0);
+	{
+		TestBinWriter wr(buff.getWriteIterator());
+		wr.exchangeArray(src);
+	}
+	//pretend, that stream has been written by other byte order
+	buff(1) = buff[1] == BinarySerializer::littleEndianBlock
+			?BinarySerializer::bigEndianBlock:BinarySerializer::littleEndianBlock;
+	TestBinReader rd(BinaryMemInput(ConstBin(buff.data(), buff.length())));
+	AutoArray<Bin::natural32> storage;
+	ArrayRef<const Bin::natural32> res = rd.mapArray(storage);
+	print("%1 %2 %3") << (res[0] == 0x04030201) << (res[1] == 0xD0C0B0A0)
+			<< (res.data() == storage.data());
+}
+
+static void binFormatOffsetTest(PrintTextA &print) {
+	BinBuffer buff;
+	//header written before the writer is created
+	buff.add(0x42);
+	AutoArray<double> src;
+	for (natural i = 0; i < 100; i++) src.add(i * 0.25);
+	{
+		TestBinWriter wr(buff.getWriteIterator(), buff.length());
+		wr.openDynSection("values");
+		wr.exchangeArray(src);
+		wr.closeDynSection("values");
+	}
+	TestBinReader rd(BinaryMemInput(ConstBin(buff.data() + 1, buff.length() - 1)));
+	const char *peek = rd.openDynSection(0);
+	bool found = peek != 0 && ConstStrA(peek) == ConstStrA("values");
+	bool opened = rd.openDynSection("values") != 0;
+	AutoArray<double> storage;
+	ArrayRef<const double> mapped = rd.mapArray(storage);
+	rd.closeDynSection("values");
+	print("%1 %2 %3 %4") << found << opened << storage.empty() << (mapped.length() == src.length()
+			&& memcmp(mapped.data(), src.data(), src.length() * sizeof(double)) == 0);
+}
+
+static void benchBinFormatItems(natural count, IRuntimeAlloc &) {
+	AutoArray<double> src;
+	src.resize(count, 1.5);
+	BinBuffer buff;
+	buff.reserve(count * sizeof(double) + 32);
+	TestBinWriter wr(buff.getWriteIterator());
+	wr.openArray(count);
+	for (natural i = 0; i < count; i++) wr.exchange(src[i]);
+	wr.closeArray();
+	TestBinReader rd(BinaryMemInput(ConstBin(buff.data(), buff.length())));
+	natural cnt = rd.openArray(0);
+	for (natural i = 0; i < cnt; i++) rd.exchange(src(i));
+	rd.closeArray();
+}
+
+static void benchBinFormatBlock(natural count, IRuntimeAlloc &) {
+	AutoArray<double> src;
+	src.resize(count, 1.5);
+	BinBuffer buff;
+	buff.reserve(count * sizeof(double) + 32);
+	TestBinWriter wr(buff.getWriteIterator());
+	wr.exchangeArray(src);
+	TestBinReader rd(BinaryMemInput(ConstBin(buff.data(), buff.length())));
+	rd.exchangeArray(src);
+}
+
+defineTest binFormat_block("binFormat.block","1 1 1 1 1 1",&binFormatBlockTest);
+defineTest binFormat_swap("binFormat.swap","1 1 1",&binFormatSwapTest);
+defineTest binFormat_offset("binFormat.offset","1 1 1 1",&binFormatOffsetTest);
+defineBenchmark bench_binFormatItems("serialize.items",&benchBinFormatItems);
+defineBenchmark bench_binFormatBlock("serialize.block",&benchBinFormatBlock);
+
+}
@@ -0,0 +1,127 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/text/blockLineReader.h"
+#include "../lightspeed/base/text/textLineReader.h"
+#include "../lightspeed/base/streams/memfile.h"
+#include "../lightspeed/base/streams/fileiobuff.tcc"
+#include "../lightspeed/base/actions/queueExecutor.h"
+#include "../lightspeed/base/exceptions/errorMessageException.h"
+#include "../lightspeed/base/containers/autoArray.tcc"
+#include "../lightspeed/base/containers/string.tcc"
+#include "../lightspeed/mt/thread.h"
+#include <string.h>
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static const char *blockLineExample = "first line\r\n\r\nthird\r"
+		"\nThis line is longer than the buffer used by the stream reader, so it must be copied\r\n"
+		"x\r\n"
+		"last line without separator";
+
+static StringA joinLines(BlockLineReader &rd) {
+	AutoArray<char> res;
+	while (rd.hasItems()) {
+		res.append(rd.getNext());
+		res.add('|');
+	}
+	return StringA(ConstStrA(res));
+}
+
+static void blockLineReaderTest(PrintTextA &print) {
+	ConstStrA text(blockLineExample);
+	BlockLineReader mem(text, ConstStrA("\r\n"));
+	StringA expect = joinLines(mem);
+	//small buffer forces lines spanning multiple fetches
+	RefCntPtr<IOBuffer<32> > in = new IOBuffer<32>(new MemFileStr(text));
+	BlockLineReader stream(*in, ConstStrA("\r\n"));
+	StringA fromStream = joinLines(stream);
+	BlockLineReader single(ConstStrA("a\n\nb\n"), ConstStrA("\n"));
+	print("%1 %2 %3") << (expect == fromStream) << joinLines(single)
+			<< (expect == ConstStrA("first line||third|This line is longer than the buffer used by the stream reader, so it must be copied|x|last line without separator|"));
+}
+
+static void scanForCharTest(PrintTextA &print) {
+	char buff[300];
+	memset(buff, 'a', sizeof(buff));
+	bool ok = true;
+	for (natural start = 0; start < 40; start++) {
+		for (natural pos = start; pos < sizeof(buff); pos++) {
+			buff[pos] = '\n';
+			if (scanForChar(buff + start, buff + sizeof(buff), '\n') != buff + pos) ok = false;
+			if (scanForChar(buff + start, buff + pos, '\n') != buff + pos) ok = false;
+			buff[pos] = 'a';
+		}
+	}
+	const char *sepText = "ab\r\rcd\r\n";
+	print("%1 %2") << ok << (scanForSeparator(sepText, sepText + 8, ConstStrA("\r\n")) - sepText);
+}
+
+static void forEachLineParallelTest(PrintTextA &print) {
+	AutoArray<char> text;
+	natural expectSum = 0;
+	for (natural i = 0; i < 10000; i++) {
+		char buff[32];
+		sprintf(buff, "%u\r\n", (unsigned int)i);
+		text.append(ConstStrA(buff));
+		expectSum += i;
+	}
+	QueueExecutor executor(16);
+	Thread thr[3];
+	for (natural i = 0; i < 3; i++)
+		thr[i].start(ThreadFunction::create([&executor]{executor.serve();}));
+	atomic count = 0, sum = 0;
+	forEachLineParallel(executor, ConstStrA(text), ConstStrA("\r\n"), 1000, [&](const ConstStrA &line) {
+		lockInc(count);
+		lockExchangeAdd(sum, (atomicValue)atoi(StringA(line).c_str()));
+	});
+	bool thrown = false;
+	try {
+		forEachLineParallel(executor, ConstStrA(text), ConstStrA("\r\n"), 1000, [&](const ConstStrA &line) {
+			if (line == ConstStrA("5000")) throw ErrorMessageException(THISLOCATION, "failed");
+		});
+	} catch (const ErrorMessageException &) {
+		thrown = true;
+	}
+	executor.stopAll(naturalNull);
+	print("%1 %2 %3") << (natural)count << ((natural)sum == expectSum) << thrown;
+}
+
+static const AutoArray<char> &lineBenchText() {
+	static AutoArray<char> text;
+	if (text.empty()) {
+		for (natural i = 0; i < 20000; i++) {
+			text.append(ConstStrA("2026-10-19 12:00:00 [info] request processed in "));
+			natural n = i * 7919 % 100;
+			for (natural j = 0; j < n; j++) text.add('0' + j % 10);
+			text.add('\n');
+		}
+	}
+	return text;
+}
+
+static void benchBlockLineReader(natural count, IRuntimeAlloc &) {
+	ConstStrA text(lineBenchText());
+	for (natural i = 0; i < count; i++) {
+		BlockLineReader rd(text, ConstStrA("\n"));
+		while (rd.hasItems()) rd.getNext();
+	}
+}
+
+static void benchTextLineReader(natural count, IRuntimeAlloc &) {
+	ConstStrA text(lineBenchText());
+	for (natural i = 0; i < count; i++) {
+		TextLineReader<ConstStrA::Iterator> rd(text.getFwIter(), ConstStrA("\n"));
+		while (rd.hasItems()) rd.getNext();
+	}
+}
+
+defineTest blockLineReader_lines("blockLineReader.lines","1 a||b| 1",&blockLineReaderTest);
+defineTest blockLineReader_scan("blockLineReader.scan","1 6",&scanForCharTest);
+defineTest blockLineReader_parallel("blockLineReader.parallel","10000 1 1",&forEachLineParallelTest);
+defineBenchmark bench_blockLineReader("linereader.block",&benchBlockLineReader);
+defineBenchmark bench_textLineReader("linereader.text",&benchTextLineReader);
+
+}
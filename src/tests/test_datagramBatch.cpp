@@ -0,0 +1,51 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/streams/datagramBatch.h"
+#include <string.h>
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static void sendReceive(PrintTextA &print, natural port, natural slotSize) {
+	INetworkServices &svc = INetworkServices::getNetServices();
+	PNetworkDatagramSource server = svc.createDatagramSource(port, 2000);
+	PNetworkDatagramSource client = svc.createDatagramSource(0, 2000);
+	PNetworkAddress target = svc.createAddr(ConstStrA("127.0.0.1"), port);
+
+	//100 equal sized packets followed by shorter one
+	DatagramBatch out(128, 256);
+	byte buff[200];
+	for (natural i = 0; i <= 100; i++) {
+		memset(buff, (int)(i & 0xFF), sizeof(buff));
+		out.add(ConstBin(buff, i == 100?50:200), *target);
+	}
+	natural sent = client->sendBatch(out);
+
+	DatagramBatch in(32, slotSize);
+	natural received = 0;
+	natural bytes = 0;
+	bool ordered = true;
+	bool sameSender = true;
+	while (received < sent && server->receiveBatch(in)) {
+		for (natural i = 0; i < in.length(); i++) {
+			ConstBin d = in.getData(i);
+			if (d[0] != (byte)received) ordered = false;
+			if (!in.sameAddress(0, i)) sameSender = false;
+			bytes += d.length();
+			received++;
+		}
+	}
+	print("%1 %2 %3 %4 %5 ") << sent << received << bytes << ordered << sameSender;
+}
+
+static void datagramBatchTest(PrintTextA &print) {
+	sendReceive(print, 39517, 256);
+	//large slots enable receiving of coalesced packets
+	sendReceive(print, 39518, 65536);
+}
+
+defineTest datagramBatch_loopback("datagramBatch.loopback","101 101 20050 1 1 101 101 20050 1 1 ",&datagramBatchTest);
+
+}
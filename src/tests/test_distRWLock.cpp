@@ -0,0 +1,77 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/sync/synchronize.h"
+#include "../lightspeed/mt/thread.h"
+#include "../lightspeed/mt/distRWLock.h"
+#include "../lightspeed/mt/rwlock.h"
+#include "../lightspeed/mt/atomic.h"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static void distRWLockTest(PrintTextA &print) {
+	DistRWLock lock;
+	natural a = 0, b = 0;
+	atomic broken = 0;
+	static const natural readers = 6;
+	static const natural writes = 2000;
+	Thread thr[readers];
+	atomic stop = 0;
+	for (natural i = 0; i < readers; i++) {
+		thr[i].start(ThreadFunction::create([&]{
+			while (readAcquire(&stop) == 0) {
+				Synchronized<DistRWLock::ReadLock> _(lock);
+				//writer keeps both values equal
+				if (a != b) lockInc(broken);
+			}
+		}));
+	}
+	for (natural i = 0; i < writes; i++) {
+		Synchronized<DistRWLock::WriteLock> _(lock);
+		a++;
+		b++;
+	}
+	writeRelease(&stop, 1);
+	for (natural i = 0; i < readers; i++) thr[i].join();
+
+	bool tryRead = lock.tryLockRead();
+	bool tryWriteFail = !lock.tryLockWrite();
+	lock.unlockRead();
+	bool tryWrite = lock.tryLockWrite();
+	bool tryReadFail = !lock.tryLockRead();
+	lock.unlockWrite();
+	print("%1 %2 %3 %4 %5 %6") << a << broken << tryRead << tryWriteFail << tryWrite << tryReadFail;
+}
+
+template<typename Lock>
+static void readContention(natural count, natural threads) {
+	Lock lock;
+	volatile natural value = 0;
+	Thread thr[64];
+	natural perThread = (count + threads - 1) / threads;
+	for (natural i = 0; i < threads; i++) {
+		thr[i].start(ThreadFunction::create([&]{
+			for (natural j = 0; j < perThread; j++) {
+				Synchronized<typename Lock::ReadLock> _(lock);
+				natural v = value;
+				(void)v;
+			}
+		}));
+	}
+	for (natural i = 0; i < threads; i++) thr[i].join();
+}
+
+static void benchDistRead8(natural count, IRuntimeAlloc &) {readContention<DistRWLock>(count, 8);}
+static void benchDistRead64(natural count, IRuntimeAlloc &) {readContention<DistRWLock>(count, 64);}
+static void benchRWLockRead8(natural count, IRuntimeAlloc &) {readContention<RWLock>(count, 8);}
+static void benchRWLockRead64(natural count, IRuntimeAlloc &) {readContention<RWLock>(count, 64);}
+
+defineTest distRWLock_exclusive("distRWLock.exclusive","2000 0 1 1 1 1",&distRWLockTest);
+defineBenchmark bench_distRWLockRead8("rwlock.read.dist.8",&benchDistRead8);
+defineBenchmark bench_distRWLockRead64("rwlock.read.dist.64",&benchDistRead64);
+defineBenchmark bench_rwLockRead8("rwlock.read.level.8",&benchRWLockRead8);
+defineBenchmark bench_rwLockRead64("rwlock.read.level.64",&benchRWLockRead64);
+
+}
@@ -0,0 +1,297 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/utils/eventdb.h"
+#include "../lightspeed/utils/eventdbReplication.h"
+#include "../lightspeed/mt/thread.h"
+#include "../lightspeed/base/streams/memfile.h"
+#include "../lightspeed/base/containers/autoArray.tcc"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+using namespace LightSpeed::EventDB;
+
+static const time_t eventDbTime0 = 1000000;
+
+class EventCollector: public UpdateAdapter {
+public:
+	AutoArray<natural> values;
+	bool timeOk;
+
+	EventCollector():timeOk(true) {}
+	virtual void onUpdate(FileOffset , time_t timestamp, natural , RecData data) {
+		const natural &v = data.dynamic();
+		values.add(v);
+		if (v < 1000 && timestamp != eventDbTime0 + (time_t)v * 20) timeOk = false;
+	}
+	virtual void onStartRescan() {values.clear();timeOk = true;}
+};
+
+static void fillEventLog(EventLog &db) {
+	for (natural i = 0; i < 100; i++) {
+		EventLog::Transaction trn(db, eventDbTime0 + i * 20);
+		trn.sendUpdateT(i % 3 + 1, i);
+	}
+	//time gap, which needs the time sync record
+	EventLog::Transaction trn(db, eventDbTime0 + 200000);
+	trn.sendUpdateT(1, (natural)5000);
+}
+
+static void eventDbIndexTest(PrintTextA &print) {
+	PRndFileHandle file = new MemFile<>;
+	PRndFileHandle cells = new MemFile<>;
+	EventLog db;
+	db.open(file, cells, true);
+	fillEventLog(db);
+	EventCollector col;
+	db.rescanTime(col, eventDbTime0 + 400, eventDbTime0 + 800);
+	print("%1 %2 %3 %4") << col.values.length() << col.values[0] << col.values[col.values.length()-1] << col.timeOk;
+	db.rescanTime(col, eventDbTime0 + 400, eventDbTime0 + 800, 2);
+	print(" %1 %2 %3") << col.values.length() << col.values[0] << col.timeOk;
+	db.rescanTime(col, eventDbTime0 + 100000, 0);
+	print(" %1 %2") << col.values.length() << col.values[0];
+
+	//index is rebuilt by the rescan during open
+	EventLog db2;
+	db2.open(file, cells, true);
+	EventLog::Position p1 = db.findTime(eventDbTime0 + 700, 3);
+	EventLog::Position p2 = db2.findTime(eventDbTime0 + 700, 3);
+	print(" %1") << (p1.offset == p2.offset && p1.timeBase == p2.timeBase && p1.offset > 0);
+	db2.rescanTime(col, eventDbTime0 + 1980, 0, 1);
+	print(" %1 %2") << col.values.length() << col.timeOk;
+}
+
+static void eventDbCompactTest(PrintTextA &print) {
+	PRndFileHandle file = new MemFile<>;
+	PRndFileHandle cells = new MemFile<>;
+	EventLog db;
+	db.open(file, cells, true);
+	natural c1, c2;
+	{
+		EventLog::Transaction trn(db, eventDbTime0);
+		c1 = trn.allocCell();
+		c2 = trn.allocCell();
+		trn.sendUpdateT(1, (natural)1001, c1);
+		trn.sendUpdateT(1, (natural)1002, c2);
+		//cell grows and abandons its frame
+		natural big[4] = {1003, 0, 0, 0};
+		trn.sendUpdateT(1, big, c1);
+	}
+	EventLog::CellFileStats before = db.getCellFileStats();
+	PRndFileHandle compacted = new MemFile<>;
+	db.compactCells(compacted);
+	EventLog::CellFileStats after = db.getCellFileStats();
+	print("%1 %2 %3 ") << (before.fileSize > before.liveSize) << (after.fileSize == after.liveSize)
+			<< (after.liveSize == before.liveSize);
+
+	//update after compaction and reopen with the new file
+	{
+		EventLog::Transaction trn(db, eventDbTime0);
+		trn.sendUpdateT(1, (natural)1004, c2);
+	}
+	EventLog db2;
+	db2.open(file, compacted, true);
+	EventCollector col;
+	db2.rescan(col, 0, 0, 0);
+	print("%1 %2 %3") << col.values.length() << col.values[0] << col.values[1];
+}
+
+static void eventDbCompactFileTest(PrintTextA &print) {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	PTemporaryFile tmp = svc.createTempFile(L"eventdb");
+	String fname = tmp->getFilename();
+	tmp->close();
+	String cellName = fname + ConstStrW(L".cells");
+	{
+		EventLog db;
+		db.open(fname);
+		EventLog::Transaction trn(db, eventDbTime0);
+		natural c1 = trn.allocCell();
+		trn.sendUpdateT(1, (natural)1001, c1);
+		natural big[4] = {1002, 0, 0, 0};
+		trn.sendUpdateT(1, big, c1);
+		db.compactCells();
+		trn.sendUpdateT(1, big, c1);
+	}
+	EventLog db;
+	db.open(fname);
+	EventCollector col;
+	db.rescan(col, 0, 0, 0);
+	EventLog::CellFileStats st = db.getCellFileStats();
+	print("%1 %2 %3 %4") << col.values.length() << col.values[0] << (st.fileSize == st.liveSize)
+			<< svc.canOpenFile(String(cellName + ConstStrW(L".tmp")), IFileIOServices::fileAccessible);
+	db.close();
+	svc.remove(cellName);
+}
+
+class PipeReplOutput: public IReplicationOutput {
+public:
+	POutputStream stream;
+	virtual void write(const void *data, natural size) throw() {
+		try {
+			const byte *b = reinterpret_cast<const byte *>(data);
+			while (size) {
+				natural wr = stream->write(b, size);
+				b += wr;
+				size -= wr;
+			}
+		} catch (...) {}
+	}
+};
+
+class PipeReplInput: public IReplicationInput {
+public:
+	PInputStream stream;
+	virtual bool read(void *data, natural size) throw() {
+		try {
+			byte *b = reinterpret_cast<byte *>(data);
+			while (size) {
+				natural rd = stream->read(b, size);
+				if (rd == 0) return false;
+				b += rd;
+				size -= rd;
+			}
+			return true;
+		} catch (...) {
+			return false;
+		}
+	}
+};
+
+static bool eventDbReplicate(bool compress) {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	PRndFileHandle mfile = new MemFile<>, mcells = new MemFile<>;
+	PRndFileHandle sfile = new MemFile<>, scells = new MemFile<>;
+	EventLog master, slave;
+	master.open(mfile, mcells, true);
+	slave.open(sfile, scells, true);
+	natural cell;
+	{
+		EventLog::Transaction trn(master, eventDbTime0);
+		cell = trn.allocCell();
+		trn.sendUpdateT(1, (natural)1001, cell);
+	}
+	fillEventLog(master);
+	PipeReplOutput dataOut, ackOut;
+	PipeReplInput dataIn, ackIn;
+	svc.createPipe(dataIn.stream, dataOut.stream);
+	svc.createPipe(ackIn.stream, ackOut.stream);
+	EventLog::WriteState2 st = slave.initReplication();
+	ReplicationConfig cfg;
+	cfg.maxBatchSize = 512;
+	cfg.maxInFlight = 2;
+	cfg.compress = compress;
+	ReplicationSender sender(master, dataOut, cfg);
+	sender.start(st.ofs);
+	Thread ackThr, recvThr;
+	ackThr.start(ThreadFunction::create([&]{while (sender.readAck(ackIn)) {}}));
+	recvThr.start(ThreadFunction::create([&]{
+		ReplicationReceiver receiver(slave, ackOut);
+		receiver.run(dataIn);
+		ackOut.stream = nil;
+	}));
+	for (natural i = 0; i < 300; i++) {
+		EventLog::Transaction trn(master, eventDbTime0 + 300000 + i);
+		trn.sendUpdateT(i % 5, i, i % 10 == 0?cell:0);
+	}
+	for (natural i = 0; i < 500; i++) {
+		if (slave.getWriteState().currentCheckSum == master.getWriteState().currentCheckSum
+			&& sender.getInFlight() == 0) break;
+		Thread::sleep(10);
+	}
+	Thread::sleep(50);
+	sender.stop();
+	dataOut.stream = nil;
+	recvThr.join();
+	ackThr.join();
+	EventCollector mcol, scol;
+	master.rescan(mcol, 0, 0, 0);
+	slave.rescan(scol, 0, 0, 0);
+	bool same = mfile->size() == sfile->size() && mcol.values == scol.values;
+	AutoArray<byte> mb, sb;
+	mb.resize((natural)mfile->size());
+	sb.resize((natural)sfile->size());
+	mfile->read(mb.data(), mb.length(), 0);
+	sfile->read(sb.data(), sb.length(), 0);
+	return same && mb == sb && sender.getAcknowledged() > 1;
+}
+
+static void eventDbReplicationTest(PrintTextA &print) {
+	print("%1 %2") << eventDbReplicate(false) << eventDbReplicate(true);
+}
+
+class HeaderReplInput: public IReplicationInput {
+public:
+	ReplicationProtocol::BatchHeader hdr;
+	bool dataRead;
+	HeaderReplInput():dataRead(false) {}
+	virtual bool read(void *data, natural size) throw() {
+		if (size != sizeof(hdr)) {dataRead = true; return false;}
+		memcpy(data, &hdr, sizeof(hdr));
+		return true;
+	}
+};
+
+static void eventDbReplicationLimitTest(PrintTextA &print) {
+	EventLog slave;
+	slave.open(new MemFile<>, new MemFile<>, true);
+	PipeReplOutput ackOut;
+	HeaderReplInput input;
+	memset(&input.hdr, 0, sizeof(input.hdr));
+	input.hdr.magic = ReplicationProtocol::batchMagic;
+	input.hdr.seq = 1;
+	input.hdr.rawSize = 100;
+	input.hdr.dataSize = 0xFFFFFFF0;
+	bool rejected = false;
+	{
+		ReplicationReceiver receiver(slave, ackOut, 4, 65536);
+		try {
+			receiver.receive(input);
+		} catch (ErrorMessageException &) {
+			rejected = true;
+		}
+	}
+	bool dataRead = input.dataRead;
+	//connection cut inside of the batch is not a clean end of stream
+	input.hdr.dataSize = 10;
+	bool truncated = false;
+	{
+		ReplicationReceiver receiver(slave, ackOut, 4, 65536);
+		try {
+			receiver.receive(input);
+		} catch (ErrorMessageException &) {
+			truncated = true;
+		}
+	}
+	print("%1 %2 %3") << rejected << dataRead << truncated;
+}
+
+static void benchEventDbReplay(natural count, IRuntimeAlloc &) {
+	static PRndFileHandle file;
+	static PRndFileHandle cells;
+	static EventLog db;
+	if (file == nil) {
+		file = new MemFile<>;
+		cells = new MemFile<>;
+		db.open(file, cells, true);
+		for (natural i = 0; i < 200000; i++) {
+			EventLog::Transaction trn(db, eventDbTime0 + i);
+			trn.sendUpdateT(i % 10, i);
+		}
+	}
+	EventCollector col;
+	for (natural i = 0; i < count; i++) {
+		time_t from = eventDbTime0 + (i * 7919) % 190000;
+		db.rescanTime(col, from, from + 600, 3);
+	}
+}
+
+defineTest eventDb_index("eventdb.index","20 20 39 1 6 22 1 1 5000 1 2 1",&eventDbIndexTest);
+defineTest eventDb_compact("eventdb.compact","1 1 1 2 1003 1004",&eventDbCompactTest);
+defineTest eventDb_compactFile("eventdb.compactFile","1 1002 1 0",&eventDbCompactFileTest);
+defineTest eventDb_replication("eventdb.replication","1 1",&eventDbReplicationTest);
+defineTest eventDb_replicationLimit("eventdb.replicationLimit","1 0 1",&eventDbReplicationLimitTest);
+defineBenchmark bench_eventDbReplay("eventdb.replay.typed",&benchEventDbReplay);
+
+}
@@ -0,0 +1,149 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/streams/parallelCopy.h"
+#include "../lightspeed/base/actions/queueExecutor.h"
+#include "../lightspeed/base/text/textFormat.tcc"
+#include "../lightspeed/base/containers/string.tcc"
+#include "../lightspeed/base/containers/autoArray.tcc"
+#include "../lightspeed/base/exceptions/fileExceptions.h"
+#include "../lightspeed/mt/thread.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+///creates name of test folder, which doesn't exist yet
+static String createCopyTestFolder() {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	String root;
+	{
+		//temporary file is removed by destructor, only unique name is used
+		PTemporaryFile tmp = svc.createTempFile(L"filecopy");
+		root = tmp->getFilename();
+	}
+	svc.createFolder(root, true);
+	return root;
+}
+
+static void writeCopyTestFile(const String &name, natural size, natural seed) {
+	int fd = ::open(name.getUtf8().c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0600);
+	AutoArray<char> data;
+	data.resize(size);
+	for (natural i = 0; i < size; i++) data(i) = (char)(i * 13 + seed + i / 251);
+	if (::write(fd, data.data(), size) != (ssize_t)size) data.clear();
+	::close(fd);
+}
+
+static bool sameContent(const String &a, const String &b) {
+	int fa = ::open(a.getUtf8().c_str(), O_RDONLY);
+	int fb = ::open(b.getUtf8().c_str(), O_RDONLY);
+	bool same = fa != -1 && fb != -1;
+	char ba[65536], bb[65536];
+	while (same) {
+		ssize_t ra = ::read(fa, ba, sizeof(ba));
+		ssize_t rb = ::read(fb, bb, sizeof(bb));
+		if (ra != rb) same = false;
+		else if (ra <= 0) break;
+		else same = memcmp(ba, bb, ra) == 0;
+	}
+	if (fa != -1) ::close(fa);
+	if (fb != -1) ::close(fb);
+	return same;
+}
+
+static void fileCopyTest(PrintTextA &print) {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	String root = createCopyTestFolder();
+	String src = root + ConstStrW(L"/src.bin");
+	String trg = root + ConstStrW(L"/trg.bin");
+	writeCopyTestFile(src, 3*1024*1024 + 17, 1);
+	svc.copy(src, trg, false);
+	bool same = sameContent(src, trg);
+	bool exists = false;
+	try {
+		svc.copy(src, trg, false);
+	} catch (const FileIOException &) {
+		exists = true;
+	}
+
+	//sparse file - two data blocks separated by hole, hole at the end
+	String sparse = root + ConstStrW(L"/sparse.bin");
+	String sparseCopy = root + ConstStrW(L"/sparse2.bin");
+	int fd = ::open(sparse.getUtf8().c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0600);
+	static const natural sparseSize = 64*1024*1024;
+	char block[4096];
+	memset(block, 'x', sizeof(block));
+	bool written = ::pwrite(fd, block, sizeof(block), 0) == sizeof(block)
+			&& ::pwrite(fd, block, sizeof(block), sparseSize / 2) == sizeof(block)
+			&& ::ftruncate(fd, sparseSize) == 0;
+	::close(fd);
+	svc.copy(sparse, sparseCopy, true);
+	struct stat st;
+	::stat(sparseCopy.getUtf8().c_str(), &st);
+	bool sparseOk = written && st.st_size == (off_t)sparseSize && (natural)st.st_blocks * 512 < sparseSize / 4
+			&& sameContent(sparse, sparseCopy);
+	svc.removeFolder(root, true);
+	print("%1 %2 %3") << same << exists << sparseOk;
+}
+
+static void parallelFileCopyTest(PrintTextA &print) {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	String root = createCopyTestFolder();
+	static const natural files = 20;
+	TextFormatBuff<wchar_t> fmt;
+	for (natural i = 0; i < files; i++) {
+		fmt(L"%1/f%2") << root << i;
+		writeCopyTestFile(fmt.write(), 10000 + i * 3001, i);
+	}
+	QueueExecutor executor(16);
+	Thread thr[3];
+	for (natural i = 0; i < 3; i++)
+		thr[i].start(ThreadFunction::create([&executor]{executor.serve();}));
+	natural same = 0;
+	bool failed = false;
+	{
+		ParallelFileCopy cp(svc, executor);
+		for (natural i = 0; i < files; i++) {
+			fmt(L"%1/f%2") << root << i;
+			String from = fmt.write();
+			fmt(L"%1/c%2") << root << i;
+			cp.add(from, fmt.write(), false);
+		}
+		cp.wait();
+		for (natural i = 0; i < files; i++) {
+			fmt(L"%1/f%2") << root << i;
+			String from = fmt.write();
+			fmt(L"%1/c%2") << root << i;
+			if (sameContent(from, fmt.write())) same++;
+		}
+		cp.add(String(root + ConstStrW(L"/missing")), String(root + ConstStrW(L"/missing2")), false);
+		try {
+			cp.wait();
+		} catch (const FileIOException &) {
+			failed = true;
+		}
+	}
+	executor.stopAll(naturalNull);
+	svc.removeFolder(root, true);
+	print("%1 %2") << same << failed;
+}
+
+static void benchFileCopy(natural count, IRuntimeAlloc &) {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	String root = createCopyTestFolder();
+	String src = root + ConstStrW(L"/src.bin");
+	String trg = root + ConstStrW(L"/trg.bin");
+	writeCopyTestFile(src, 8*1024*1024, 0);
+	for (natural i = 0; i < count; i++) svc.copy(src, trg, true);
+	svc.removeFolder(root, true);
+}
+
+defineTest fileCopy_copy("fileCopy.copy","1 1 1",&fileCopyTest);
+defineTest fileCopy_parallel("fileCopy.parallel","20 1",&parallelFileCopyTest);
+defineBenchmark bench_fileCopy("filecopy.8MB",&benchFileCopy);
+
+}
@@ -0,0 +1,152 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/text/floatConv.h"
+#include "../lightspeed/base/text/toString.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static Bin::natural64 nextRandom(Bin::natural64 &state) {
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+static double randomDouble(Bin::natural64 &state) {
+	double d;
+	do {
+		Bin::natural64 bits = nextRandom(state);
+		memcpy(&d, &bits, sizeof(d));
+	} while (d != d || d - d != 0);
+	return d;
+}
+
+static bool sameBits(double a, double b) {
+	return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static void floatConvSamples(PrintTextA &print) {
+	static const double samples[] = {
+		0.1, 1.0/3.0, 100, 1e21, 1e-7, 123456.789, -0.0, 5e-324,
+		1.7976931348623157e308, 2.2250738585072014e-308, 9007199254740993.0
+	};
+	for (natural i = 0; i < sizeof(samples)/sizeof(samples[0]); i++) {
+		print("%1 ") << ConstStrA(ToString<double>(samples[i]));
+	}
+	print("%1 ") << ConstStrA(ToString<float>(0.1f));
+	TextFormatBuff<char> fmt;
+	fmt.setShortest();
+	fmt("%1") << 2.5e-8;
+	print("%1") << fmt.write();
+}
+
+static void floatConvRoundTrip(PrintTextA &print) {
+	static const char *corpus[] = {
+		"0", "-0", "1", "0.1", "3.14159265358979323846", "1e23", "8.98846567431158e307",
+		"1.7976931348623157e308", "1.7976931348623159e308", "2.2250738585072011e-308",
+		"4.9406564584124654e-324", "2.4703282292062328e-324", "2.4703282292062327e-324",
+		"9007199254740993", "9007199254740992.9999999999999999999999", "0.000001",
+		"7.0e-10", "1.00000000000000011102230246251565404236316680908203125",
+		"1.00000000000000011102230246251565404236316680908203124",
+		"1.00000000000000011102230246251565404236316680908203126",
+		"123456789012345678901234567890", "1e400", "1e-400", "  42.5"
+	};
+	natural parseErrors = 0;
+	for (natural i = 0; i < sizeof(corpus)/sizeof(corpus[0]); i++) {
+		natural rd;
+		double a = LightSpeed::strtod(ConstStrA(corpus[i]), &rd);
+		double b = ::strtod(corpus[i], 0);
+		if (!sameBits(a, b) || rd != strlen(corpus[i])) parseErrors++;
+	}
+
+	//random bit patterns and random decimal texts
+	Bin::natural64 state = 88172645463325252ULL;
+	natural roundTripErrors = 0;
+	natural longer = 0;
+	const natural count = 200000;
+	char buff[shortestFloatBufferSize + 1];
+	char ref[64];
+	for (natural i = 0; i < count; i++) {
+		double d = randomDouble(state);
+		natural len = formatShortest(d, buff);
+		natural rd;
+		double back = LightSpeed::strtod(ConstStrA(buff, len), &rd);
+		if (!sameBits(d, back) || rd != len) roundTripErrors++;
+		//compare count of significant digits with the shortest %g representation
+		//(Grisu2 emits one extra digit for about 0.1% of numbers)
+		natural first = naturalNull, last = 0;
+		for (natural j = 0; j < len && buff[j] != 'e'; j++)
+			if (buff[j] >= '1' && buff[j] <= '9') {
+				if (first == naturalNull) first = j;
+				last = j;
+			}
+		natural digits = last - first + 1;
+		for (natural j = first; j < last; j++) if (buff[j] == '.') digits--;
+		int prec = 1;
+		for (; prec < 17; prec++) {
+			snprintf(ref, sizeof(ref), "%.*g", prec, d);
+			if (sameBits(::strtod(ref, 0), d)) break;
+		}
+		if (digits > (natural)prec) longer++;
+
+		snprintf(ref, sizeof(ref), "%llue%d", (unsigned long long)nextRandom(state) >> (nextRandom(state) & 63),
+				(int)(nextRandom(state) % 660) - 340);
+		if (!sameBits(LightSpeed::strtod(ConstStrA(ref), &rd), ::strtod(ref, 0))) parseErrors++;
+	}
+	print("%1 %2 %3") << parseErrors << roundTripErrors << (longer * 100 < count);
+}
+
+static double benchData[1000];
+static char benchText[1000][shortestFloatBufferSize + 1];
+
+//data are prepared once before main(), so the benchmarks measure only the conversion
+static struct PrepareBench {
+	PrepareBench() {
+		Bin::natural64 state = 88172645463325252ULL;
+		for (natural i = 0; i < 1000; i++) {
+			benchData[i] = (double)(nextRandom(state) % 100000000) / 1000.0;
+			natural len = formatShortest(benchData[i], benchText[i]);
+			benchText[i][len] = 0;
+		}
+	}
+} prepareBench;
+
+static void benchFormatShortest(natural count, IRuntimeAlloc &) {
+	char buff[shortestFloatBufferSize];
+	volatile natural sink = 0;
+	for (natural i = 0; i < count; i++) sink = sink + formatShortest(benchData[i % 1000], buff);
+}
+
+static void benchFormatSnprintf(natural count, IRuntimeAlloc &) {
+	char buff[64];
+	volatile natural sink = 0;
+	for (natural i = 0; i < count; i++) sink = sink + snprintf(buff, sizeof(buff), "%.17g", benchData[i % 1000]);
+}
+
+static void benchParse(natural count, IRuntimeAlloc &) {
+	volatile double sink = 0;
+	natural rd;
+	for (natural i = 0; i < count; i++) sink = sink + LightSpeed::strtod(ConstStrA(benchText[i % 1000]), &rd);
+}
+
+static void benchParseLibc(natural count, IRuntimeAlloc &) {
+	volatile double sink = 0;
+	for (natural i = 0; i < count; i++) sink = sink + ::strtod(benchText[i % 1000], 0);
+}
+
+defineTest floatConv_samples("floatConv.samples",
+		"0.1 0.3333333333333333 100 1e+21 1e-7 123456.789 -0 5e-324 "
+		"1.7976931348623157e+308 2.2250738585072014e-308 9007199254740992 0.1 2.5e-8",&floatConvSamples);
+defineTest floatConv_roundTrip("floatConv.roundTrip","0 0 1",&floatConvRoundTrip);
+defineBenchmark bench_floatFormatShortest("float.format.shortest",&benchFormatShortest);
+defineBenchmark bench_floatFormatSnprintf("float.format.snprintf",&benchFormatSnprintf);
+defineBenchmark bench_floatParse("float.parse",&benchParse);
+defineBenchmark bench_floatParseLibc("float.parse.libc",&benchParseLibc);
+
+}
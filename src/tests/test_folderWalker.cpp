@@ -0,0 +1,152 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/streams/folderWalker.h"
+#include "../lightspeed/base/actions/queueExecutor.h"
+#include "../lightspeed/base/text/textFormat.tcc"
+#include "../lightspeed/base/containers/string.tcc"
+#include "../lightspeed/mt/thread.h"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static const natural folderWalkBigCount = 3000;
+
+static void createTestFile(IFileIOServices &svc, const String &path, natural size) {
+	PInOutStream s = svc.openSeqFile(path, IFileIOServices::fileOpenWrite,
+			OpenFlags::create | OpenFlags::createFolder | OpenFlags::truncate);
+	char buff[64] = {0};
+	if (size) s->write(buff, size);
+}
+
+///creates folder tree for tests, returns its root
+static String createTestTree() {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	String root;
+	{
+		//temporary file is removed by destructor, only unique name is used
+		PTemporaryFile tmp = svc.createTempFile(L"walker");
+		root = tmp->getFilename();
+	}
+	createTestFile(svc, root + ConstStrW(L"/a/f1"), 10);
+	createTestFile(svc, root + ConstStrW(L"/a/x1"), 5);
+	createTestFile(svc, root + ConstStrW(L"/a/b/f2"), 20);
+	createTestFile(svc, root + ConstStrW(L"/c/f3"), 30);
+	createTestFile(svc, root + ConstStrW(L"/skip/f4"), 40);
+	createTestFile(svc, root + ConstStrW(L"/skip/d/f5"), 50);
+	TextFormatBuff<wchar_t> fmt;
+	for (natural i = 0; i < folderWalkBigCount; i++) {
+		fmt(L"%1/big/file%2") << root << i;
+		createTestFile(svc, fmt.write(), 0);
+	}
+	return root;
+}
+
+class TestWalkFilter: public IFolderWalkFilter {
+public:
+	virtual bool acceptEntry(const FolderWalkEntry &entry) {
+		return entry.getName().head(1) != ConstStrW(L"x");
+	}
+	virtual bool enterFolder(const FolderWalkEntry &entry) {
+		return entry.getName() != ConstStrW(L"skip");
+	}
+};
+
+static void folderIteratorTest(PrintTextA &print) {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	String root = createTestTree();
+	PFolderIterator iter = svc.openFolder(String(root + ConstStrW(L"/big")));
+	natural count = 0, files = 0;
+	while (iter->getNext()) {
+		count++;
+		if (iter->isFile() && iter->getSize() == 0) files++;
+	}
+	iter->rewind();
+	natural count2 = 0;
+	while (iter->getNext()) count2++;
+	iter = svc.openFolder(String(root + ConstStrW(L"/a")));
+	lnatural size = 0;
+	while (iter->getNext()) {
+		if (iter->entryName == ConstStrW(L"f1")) size = iter->getSize();
+	}
+	iter = nil;
+	svc.removeFolder(root, true);
+	print("%1 %2 %3 %4") << count << files << count2 << size;
+}
+
+static void folderWalkerTest(PrintTextA &print) {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	String root = createTestTree();
+	QueueExecutor executor(64);
+	Thread thr[3];
+	for (natural i = 0; i < 3; i++)
+		thr[i].start(ThreadFunction::create([&executor]{executor.serve();}));
+	TestWalkFilter filter;
+	//small queue forces walkers to wait for the reader
+	FolderWalker walker(svc, executor, 16);
+	walker.start(root, FolderWalker::fieldSize | FolderWalker::fieldModified, &filter);
+	FolderWalkEntry e;
+	natural count = 0, big = 0, maxDepth = 0;
+	lnatural size = 0;
+	bool skipped = true;
+	while (walker.getNext(e)) {
+		count++;
+		if (e.isDirectory()) continue;
+		size += e.size;
+		if (e.depth > maxDepth) maxDepth = e.depth;
+		if (e.getName().head(4) == ConstStrW(L"file")) big++;
+		if (e.getName() == ConstStrW(L"f4")) skipped = false;
+	}
+	//stop in the middle of walking
+	walker.start(root);
+	natural partial = 0;
+	while (partial < 100 && walker.getNext(e)) partial++;
+	walker.stop();
+	bool failed = false;
+	walker.start(String(root + ConstStrW(L"/missing")));
+	try {
+		while (walker.getNext(e)) {}
+	} catch (const Exception &) {
+		failed = true;
+	}
+	executor.stopAll(naturalNull);
+	svc.removeFolder(root, true);
+	print("%1 %2 %3 %4 %5 %6 %7") << count << big << size << maxDepth << skipped << partial << failed;
+}
+
+///test tree shared by benchmark runs, removed at exit
+class FolderWalkBenchTree {
+public:
+	String root;
+	FolderWalkBenchTree():root(createTestTree()) {}
+	~FolderWalkBenchTree() {
+		try {
+			IFileIOServices::getIOServices().removeFolder(root, true);
+		} catch (...) {
+
+		}
+	}
+};
+
+static void benchFolderWalker(natural count, IRuntimeAlloc &) {
+	static FolderWalkBenchTree tree;
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	QueueExecutor executor(64);
+	Thread thr[3];
+	for (natural i = 0; i < 3; i++)
+		thr[i].start(ThreadFunction::create([&executor]{executor.serve();}));
+	for (natural i = 0; i < count; i++) {
+		FolderWalker walker(svc, executor);
+		walker.start(tree.root, FolderWalker::fieldSize);
+		FolderWalkEntry e;
+		while (walker.getNext(e)) {}
+	}
+	executor.stopAll(naturalNull);
+}
+
+defineTest folderIterator_getdents("folderIterator.getdents","3000 3000 3000 10",&folderIteratorTest);
+defineTest folderWalker_walk("folderWalker.walk","3008 3000 60 2 1 100 1",&folderWalkerTest);
+defineBenchmark bench_folderWalker("folderwalker.walk",&benchFolderWalker);
+
+}
@@ -82,10 +82,30 @@ namespace LightSpeedTest {
 		testEqual(print,f("Ahoj"),f("Ahoj"));
 	}
 
+	static void benchParse(natural count, IRuntimeAlloc &alloc) {
+		JSON::PFactory f = JSON::create(alloc);
+		for (natural i = 0; i < count; i++) {
+			JSON::Value v = f->fromString(jsonSrc);
+		}
+	}
+
+	static void benchSerialize(natural count, IRuntimeAlloc &alloc) {
+		JSON::PFactory f = JSON::create(alloc);
+		JSON::Value v = f->fromString(jsonSrc);
+		volatile natural sink = 0;
+		for (natural i = 0; i < count; i++) {
+			ConstStrA s = f->toString(*v);
+			sink = sink + s.length();
+		}
+	}
+
+	defineBenchmark bench_parse("json.parse", &benchParse);
+	defineBenchmark bench_serialize("json.serialize", &benchSerialize);
+
 	defineTest test_parser("json.parser", "10,1,0,3200000000000000000000.000000,0.001200,-23.823200,1", &parser);
-	defineTest test_serialize("json.serialize", "{\"aaa\":10,\"array\":[11,232,1.213000,3200000000000000000000.000000,0.001200,-12,-23.823200],\"bbb\":true,\"ccc\":false,\"emptyArr\":[],\"emptyObj\":{},\"null\":null,\"text\":\"Příšerně žluťoučký kůň úpěl ďábelské kódy\"}", &serialize);
-	defineTest test_serialize_escaped("json.serialize_escaped", "{\"aaa\":10,\"array\":[11,232,1.213000,3200000000000000000000.000000,0.001200,-12,-23.823200],\"bbb\":true,\"ccc\":false,\"emptyArr\":[],\"emptyObj\":{},\"null\":null,\"text\":\"P\\u0159\\u00ED\\u0161ern\\u011B \\u017Elu\\u0165ou\\u010Dk\\u00FD k\\u016F\\u0148 \\u00FAp\\u011Bl \\u010F\\u00E1belsk\\u00E9 k\\u00F3dy\"}", &serializeEscaped);
-	defineTest test_serialize_cycle("json.serialize_cycle_error", "{\"aaa\":10,\"array\":[11,232,1.213000,3200000000000000000000.000000,0.001200,-12,-23.823200,{\"error\":\"<infinite_recursion>\"}],\"bbb\":true,\"ccc\":false,\"emptyArr\":[],\"emptyObj\":{},\"null\":null}", &serializeCycleError);
+	defineTest test_serialize("json.serialize", "{\"aaa\":10,\"array\":[11,232,1.213,3.2e+21,0.0012,-12,-23.8232],\"bbb\":true,\"ccc\":false,\"emptyArr\":[],\"emptyObj\":{},\"null\":null,\"text\":\"Příšerně žluťoučký kůň úpěl ďábelské kódy\"}", &serialize);
+	defineTest test_serialize_escaped("json.serialize_escaped", "{\"aaa\":10,\"array\":[11,232,1.213,3.2e+21,0.0012,-12,-23.8232],\"bbb\":true,\"ccc\":false,\"emptyArr\":[],\"emptyObj\":{},\"null\":null,\"text\":\"P\\u0159\\u00ED\\u0161ern\\u011B \\u017Elu\\u0165ou\\u010Dk\\u00FD k\\u016F\\u0148 \\u00FAp\\u011Bl \\u010F\\u00E1belsk\\u00E9 k\\u00F3dy\"}", &serializeEscaped);
+	defineTest test_serialize_cycle("json.serialize_cycle_error", "{\"aaa\":10,\"array\":[11,232,1.213,3.2e+21,0.0012,-12,-23.8232,{\"error\":\"<infinite_recursion>\"}],\"bbb\":true,\"ccc\":false,\"emptyArr\":[],\"emptyObj\":{},\"null\":null}", &serializeCycleError);
 	defineTest test_number_to_wide("json.number_to_wide", "123,123", &numberToWide);
 	defineTest test_sharePrimitives("json.sharePrimitives", "SSSSSSSSEEENNNNNEEE", &sharePrimitives);
 }
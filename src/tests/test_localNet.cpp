@@ -0,0 +1,182 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/streams/netio_ifc.h"
+#include "../lightspeed/base/interface.tcc"
+#include "../lightspeed/base/text/textFormat.tcc"
+#include "../lightspeed/mt/thread.h"
+#include <string.h>
+#include <unistd.h>
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+///creates unique abstract address
+static PNetworkAddress createTestLocalAddr(ConstStrA name) {
+	TextFormatBuff<char> fmt;
+	fmt("@lightspeed-%1-%2") << name << (natural)getpid();
+	return INetworkServices::getNetServices().getIfc<INetworkServicesLocal>()
+			.createLocalAddr(fmt.write());
+}
+
+static void readAll(PNetworkStream s, void *buffer, natural size) {
+	byte *b = reinterpret_cast<byte *>(buffer);
+	while (size) {
+		natural rd = s->read(b, size);
+		if (rd == 0) break;
+		b += rd;
+		size -= rd;
+	}
+}
+
+static void writeAll(PNetworkStream s, const void *buffer, natural size) {
+	const byte *b = reinterpret_cast<const byte *>(buffer);
+	while (size) {
+		natural wr = s->write(b, size);
+		b += wr;
+		size -= wr;
+	}
+}
+
+static void localNetStreamTest(PrintTextA &print) {
+	INetworkServices &svc = INetworkServices::getNetServices();
+	PNetworkAddress addr = createTestLocalAddr("stream");
+	PNetworkStreamSource server = svc.createStreamSource(addr, StreamOpenMode::passive, 1, 2000, 2000);
+	PNetworkStreamSource client = svc.createStreamSource(addr, StreamOpenMode::active, 1, 2000, 2000);
+	PNetworkStream c = client->getNext();
+	PNetworkStream s = server->getNext();
+	writeAll(c, "hello", 5);
+	char buff[6] = {0};
+	readAll(s, buff, 5);
+
+	//pass write end of the pipe to other side
+	int fds[2];
+	if (pipe(fds) != 0) return;
+	integer h = fds[1];
+	c->getIfc<INetworkHandlePassing>().sendHandles("x", 1, &h, 1);
+	::close(fds[1]);
+	integer recvh[4];
+	natural count = 4;
+	char x = 0;
+	s->getIfc<INetworkHandlePassing>().receiveHandles(&x, 1, recvh, count);
+	char piped = 0;
+	if (count == 1) {
+		if (::write((int)recvh[0], "p", 1) != 1) piped = '?';
+		::close((int)recvh[0]);
+		if (::read(fds[0], &piped, 1) != 1) piped = '?';
+	}
+	::close(fds[0]);
+	print("%1 %2 %3 %4 %5") << buff << x << count << piped
+			<< (server->getLocalAddr()->asString() == addr->asString());
+}
+
+static void localNetDgramTest(PrintTextA &print) {
+	INetworkServicesLocal &local = INetworkServices::getNetServices().getIfc<INetworkServicesLocal>();
+	PNetworkAddress addr = createTestLocalAddr("dgram");
+	PNetworkDatagramSource server = local.createLocalDatagramSource(addr, 2000);
+	PNetworkDatagramSource client = local.createLocalDatagramSource(nil, 2000);
+	PNetworkDatagram d = client->create(addr);
+	d->write("ping", 4);
+	d->send();
+	PNetworkDatagram rd = server->receive();
+	char buff[5] = {0};
+	rd->read(buff, 4);
+	//reply to the autobound address
+	PNetworkDatagram reply = server->create(rd->getTarget());
+	reply->write("pong", 4);
+	reply->send();
+	PNetworkDatagram rd2 = client->receive();
+	char buff2[5] = {0};
+	rd2->read(buff2, 4);
+	print("%1 %2") << buff << buff2;
+}
+
+static void localNetShmTest(PrintTextA &print) {
+	INetworkServices &svc = INetworkServices::getNetServices();
+	INetworkServicesLocal &local = svc.getIfc<INetworkServicesLocal>();
+	PNetworkAddress addr = createTestLocalAddr("shm");
+	PNetworkStreamSource server = local.createSharedMemStreamSource(addr, StreamOpenMode::passive, 1, 2000, 5000, 4096);
+	PNetworkStreamSource client = local.createSharedMemStreamSource(addr, StreamOpenMode::active, 1, 2000, 5000);
+	static const natural total = 1000000;
+	Thread thr;
+	thr.start(ThreadFunction::create([&]{
+		//reads everything until end of stream, then sends back count and checksum
+		PNetworkStream c = client->getNext();
+		natural cnt = 0, sum = 0;
+		byte buff[1000];
+		natural rd;
+		while ((rd = c->read(buff, sizeof(buff))) != 0) {
+			for (natural i = 0; i < rd; i++) sum += buff[i] * ((cnt + i) % 7 + 1);
+			cnt += rd;
+		}
+		natural res[2] = {cnt, sum};
+		writeAll(c, res, sizeof(res));
+		c->closeOutput();
+	}));
+	PNetworkStream s = server->getNext();
+	natural expect = 0;
+	byte buff[1500];
+	natural pos = 0;
+	while (pos < total) {
+		natural sz = total - pos < sizeof(buff)?total - pos:sizeof(buff);
+		for (natural i = 0; i < sz; i++) {
+			buff[i] = (byte)((pos + i) * 31);
+			expect += buff[i] * ((pos + i) % 7 + 1);
+		}
+		writeAll(s, buff, sz);
+		pos += sz;
+	}
+	s->closeOutput();
+	//wait for result through the waiting object
+	PNetworkWaitingObject wo = svc.createWaitingObject();
+	wo->add(s, INetworkResource::waitForInput, 5000);
+	const INetworkWaitingObject::EventInfo &ev = wo->getNext();
+	bool signaled = ev.rsrc == static_cast<INetworkResource *>(s.get());
+	wo->remove(s);
+	natural res[2] = {0, 0};
+	readAll(s, res, sizeof(res));
+	byte eof;
+	natural last = s->read(&eof, 1);
+	thr.join();
+	print("%1 %2 %3 %4") << (res[0] == total) << (res[1] == expect) << signaled << last;
+}
+
+static void pingPong(PNetworkStreamSource server, PNetworkStreamSource client, natural count) {
+	Thread thr;
+	thr.start(ThreadFunction::create([&]{
+		PNetworkStream c = client->getNext();
+		byte b;
+		while (c->read(&b, 1)) c->write(&b, 1);
+	}));
+	PNetworkStream s = server->getNext();
+	byte b = 0;
+	for (natural i = 0; i < count; i++) {
+		s->write(&b, 1);
+		s->read(&b, 1);
+	}
+	s->closeOutput();
+	thr.join();
+}
+
+static void benchShmPingPong(natural count, IRuntimeAlloc &) {
+	INetworkServicesLocal &local = INetworkServices::getNetServices().getIfc<INetworkServicesLocal>();
+	PNetworkAddress addr = createTestLocalAddr("shmbench");
+	pingPong(local.createSharedMemStreamSource(addr, StreamOpenMode::passive, 1, 2000, 5000),
+			local.createSharedMemStreamSource(addr, StreamOpenMode::active, 1, 2000, 5000), count);
+}
+
+static void benchUnixPingPong(natural count, IRuntimeAlloc &) {
+	INetworkServices &svc = INetworkServices::getNetServices();
+	PNetworkAddress addr = createTestLocalAddr("unixbench");
+	pingPong(svc.createStreamSource(addr, StreamOpenMode::passive, 1, 2000, 5000),
+			svc.createStreamSource(addr, StreamOpenMode::active, 1, 2000, 5000), count);
+}
+
+defineTest localNet_stream("localNet.stream","hello x 1 p 1",&localNetStreamTest);
+defineTest localNet_dgram("localNet.dgram","ping pong",&localNetDgramTest);
+defineTest localNet_shm("localNet.shm","1 1 1 0",&localNetShmTest);
+defineBenchmark bench_localNetShm("localnet.shm.pingpong",&benchShmPingPong);
+defineBenchmark bench_localNetUnix("localnet.unix.pingpong",&benchUnixPingPong);
+
+}
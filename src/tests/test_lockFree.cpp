@@ -0,0 +1,120 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/mt/thread.h"
+#include "../lightspeed/mt/lockFreeStack.h"
+#include "../lightspeed/mt/lockFreeQueue.h"
+#include "../lightspeed/mt/lockFreeMap.h"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static const natural lfThreads = 4;
+static const natural lfItems = 20000;
+
+static void lockFreeStackQueueTest(PrintTextA &print) {
+	LockFreeStack<natural> stack;
+	LockFreeQueue<natural> queue;
+	Thread thr[lfThreads];
+	atomic stackSum = 0, queueSum = 0, order = 0;
+	//every thread pushes and pops at the same time
+	for (natural i = 0; i < lfThreads; i++) {
+		thr[i].start(ThreadFunction::create([&,i]{
+			natural last[lfThreads] = {0};
+			natural v;
+			for (natural j = 1; j <= lfItems; j++) {
+				stack.push(j);
+				queue.push(i * lfItems * 2 + j);
+				if (stack.pop(v)) lockExchangeAdd(stackSum, v);
+				if (queue.pop(v)) {
+					lockExchangeAdd(queueSum, v % (lfItems * 2));
+					//items of one producer must come in order
+					natural p = v / (lfItems * 2), n = v % (lfItems * 2);
+					if (n <= last[p]) lockInc(order);
+					last[p] = n;
+				}
+			}
+		}));
+	}
+	for (natural i = 0; i < lfThreads; i++) thr[i].join();
+	natural v;
+	while (stack.pop(v)) stackSum += v;
+	while (queue.pop(v)) queueSum += v % (lfItems * 2);
+	natural expect = lfThreads * lfItems * (lfItems + 1) / 2;
+	print("%1 %2 %3 %4 %5") << (stackSum == (atomicValue)expect) << (queueSum == (atomicValue)expect)
+			<< order << stack.empty() << queue.empty();
+}
+
+static void lockFreeMapTest(PrintTextA &print) {
+	LockFreeMap<natural, natural> map;
+	Thread thr[lfThreads];
+	atomic inserted = 0, erased = 0, wrong = 0;
+	for (natural i = 0; i < lfThreads; i++) {
+		thr[i].start(ThreadFunction::create([&,i]{
+			//threads work with overlapping keys
+			for (natural j = 0; j < lfItems; j++) {
+				natural k = (j * 7 + i * 13) % 1000;
+				if (map.insert(k, k * 3)) lockInc(inserted);
+				natural v;
+				if (map.find(k ^ 1, v) && v != (k ^ 1) * 3) lockInc(wrong);
+				if (j % 3 == i % 3 && map.erase(k)) lockInc(erased);
+			}
+		}));
+	}
+	for (natural i = 0; i < lfThreads; i++) thr[i].join();
+	natural count = 0, prev = 0;
+	bool sorted = true;
+	map.forEach([&](const natural &k, const natural &v) {
+		if (count && k <= prev) sorted = false;
+		if (v != k * 3) sorted = false;
+		prev = k;
+		count++;
+	});
+	bool found = true;
+	for (natural k = 0; k < 1000; k++) {
+		if (map.contains(k)) {
+			if (!map.erase(k)) found = false;
+			else erased++;
+		}
+	}
+	print("%1 %2 %3 %4 %5") << (inserted - erased) << wrong << sorted << found << map.contains(1);
+}
+
+static void benchQueue(natural count, IRuntimeAlloc &) {
+	LockFreeQueue<natural> queue;
+	Thread thr[lfThreads];
+	natural perThread = (count + lfThreads - 1) / lfThreads;
+	for (natural i = 0; i < lfThreads; i++) {
+		thr[i].start(ThreadFunction::create([&]{
+			natural v;
+			for (natural j = 0; j < perThread; j++) {
+				queue.push(j);
+				queue.pop(v);
+			}
+		}));
+	}
+	for (natural i = 0; i < lfThreads; i++) thr[i].join();
+}
+
+static LockFreeMap<natural, natural> &getBenchMap() {
+	static LockFreeMap<natural, natural> map;
+	if (!map.contains(0)) {
+		for (natural i = 0; i < 100000; i++) map.insert(i * 2654435761U % 1000003, i);
+	}
+	return map;
+}
+
+static void benchMapFind(natural count, IRuntimeAlloc &) {
+	LockFreeMap<natural, natural> &map = getBenchMap();
+	natural v;
+	volatile natural found = 0;
+	for (natural i = 0; i < count; i++) if (map.find(i * 40503 % 1000003, v)) found++;
+}
+
+defineTest lockFree_stackQueue("lockFree.stackQueue","1 1 0 1 1",&lockFreeStackQueueTest);
+defineTest lockFree_map("lockFree.map","0 0 1 1 0",&lockFreeMapTest);
+defineBenchmark bench_lockFreeQueue("lockfree.queue.mpmc",&benchQueue);
+defineBenchmark bench_lockFreeMapFind("lockfree.map.find",&benchMapFind);
+
+}
@@ -0,0 +1,113 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/streams/mappedPrefetcher.h"
+#include "../lightspeed/base/streams/fileio.h"
+#include "../lightspeed/base/containers/autoArray.tcc"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+///creates file of given size filled by known pattern, returns its name
+static String createMappedTestFile(natural size) {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	String name;
+	{
+		PTemporaryFile tmp = svc.createTempFile(L"mapped");
+		name = tmp->getFilename();
+	}
+	SeqFileOutput out(name, OpenFlags::create|OpenFlags::truncate);
+	AutoArray<natural> block;
+	block.resize(16384);
+	natural words = size / sizeof(natural);
+	for (natural i = 0; i < words; i += block.length()) {
+		natural cnt = words - i < block.length()?words - i:block.length();
+		for (natural j = 0; j < cnt; j++) block(j) = (i + j) * 7;
+		out.blockWrite(block.data(), cnt * sizeof(natural), true);
+	}
+	return name;
+}
+
+static void mappedFileHintsTest(PrintTextA &print) {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	static const natural size = 16*1024*1024;
+	String name = createMappedTestFile(size);
+	bool resident, hints, sum;
+	{
+		PMappedFile file = svc.mapFile(name, IFileIOServices::fileOpenRead);
+		IMappedFile::MappedRegion reg = file->map(IFileIOServices::fileOpenRead, false, IMappedFile::mapPopulate);
+		IMappedFile::RegionStats st = reg.getStats();
+		resident = st.residentBytes == size;
+		hints = reg.advise(IMappedFile::hintRandom)
+				&& reg.advise(IMappedFile::hintWillNeed, 1000, 5000)
+				&& reg.advise(IMappedFile::hintNormal, size - 10, 1000);
+		const natural *data = reinterpret_cast<const natural *>(reg.address);
+		sum = data[12345] == 12345 * 7 && data[size / sizeof(natural) - 1] == (size / sizeof(natural) - 1) * 7;
+	}
+	svc.remove(name);
+	print("%1 %2 %3") << resident << hints << sum;
+}
+
+static void mappedFilePrefetchTest(PrintTextA &print) {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	static const natural size = 16*1024*1024 + 4096;
+	String name = createMappedTestFile(size);
+	natural errors = 0;
+	natural prefetched, released;
+	{
+		PMappedFile file = svc.mapFile(name, IFileIOServices::fileOpenRead);
+		IMappedFile::MappedRegion reg = file->map(IFileIOServices::fileOpenRead, false);
+		reg.advise(IMappedFile::hintSequential);
+		MappedPrefetcher pf(reg, 1024*1024, 2, true);
+		const natural *data = reinterpret_cast<const natural *>(reg.address);
+		natural words = size / sizeof(natural);
+		for (natural i = 0; i < words; i++) {
+			pf.access(i * sizeof(natural));
+			if (data[i] != i * 7) errors++;
+		}
+		prefetched = pf.getPrefetched();
+		released = pf.getReleased();
+	}
+	svc.remove(name);
+	print("%1 %2 %3") << errors << (prefetched == size) << released;
+}
+
+///file for benchmarks, created once and removed at exit
+class MappedBenchFile {
+public:
+	static const natural size = 64*1024*1024;
+	String name;
+
+	MappedBenchFile():name(createMappedTestFile(size)) {}
+	~MappedBenchFile() {IFileIOServices::getIOServices().remove(name);}
+};
+
+static natural mappedRandomRead(natural count, natural flags) {
+	static MappedBenchFile bf;
+	static const natural size = MappedBenchFile::size;
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	PMappedFile file = svc.mapFile(bf.name, IFileIOServices::fileOpenRead);
+	IMappedFile::MappedRegion reg = file->map(IFileIOServices::fileOpenRead, false, flags);
+	reg.advise(IMappedFile::hintRandom);
+	const natural *data = reinterpret_cast<const natural *>(reg.address);
+	natural words = size / sizeof(natural);
+	natural sum = 0;
+	for (natural i = 0; i < count; i++) sum += data[(i * 2654435761UL) % words];
+	return sum;
+}
+
+static void benchMappedRandom(natural count, IRuntimeAlloc &) {
+	mappedRandomRead(count, 0);
+}
+
+static void benchMappedRandomPopulate(natural count, IRuntimeAlloc &) {
+	mappedRandomRead(count, IMappedFile::mapPopulate);
+}
+
+defineTest mappedFile_hints("mappedFile.hints","1 1 1",&mappedFileHintsTest);
+defineTest mappedFile_prefetch("mappedFile.prefetch","0 1 15728640",&mappedFilePrefetchTest);
+defineBenchmark bench_mappedRandom("mappedfile.random",&benchMappedRandom);
+defineBenchmark bench_mappedRandomPopulate("mappedfile.random.populate",&benchMappedRandomPopulate);
+
+}
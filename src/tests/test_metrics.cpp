@@ -0,0 +1,127 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/framework/metrics.h"
+#include "../lightspeed/base/framework/metricsExporter.h"
+#include "../lightspeed/base/streams/netio.h"
+#include "../lightspeed/base/streams/memfile.h"
+#include "../lightspeed/base/containers/autoArray.tcc"
+#include "../lightspeed/mt/thread.h"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static StringA exportMetrics() {
+	PRndFileHandle file = new MemFile<>;
+	{
+		SeqFileOutput strm(file, 0);
+		SeqTextOutA txt(strm);
+		PrintTextA print(txt);
+		MetricsRegistry::getInstance().exportText(print);
+	}
+	AutoArray<char> out;
+	out.resize((natural)file->size());
+	file->read(out.data(), out.length(), 0);
+	return StringA(ConstStrA(out));
+}
+
+static void metricsCounterTest(PrintTextA &print) {
+	MetricCounter cnt("test_metrics_counter_total", "test counter", "case=\"counter\"");
+	MetricGauge gauge("test_metrics_gauge", "test gauge", "case=\"counter\"");
+	Thread thr[4];
+	for (natural i = 0; i < 4; i++) {
+		thr[i].start(ThreadFunction::create([&]{
+			for (natural j = 0; j < 10000; j++) {
+				cnt.add();
+				gauge.inc();
+			}
+			gauge.dec();
+		}));
+	}
+	for (natural i = 0; i < 4; i++) thr[i].join();
+	const Metric *m = MetricsRegistry::getInstance().find("test_metrics_counter_total", "case=\"counter\"");
+	StringA text = exportMetrics();
+	print("%1 %2 %3 %4") << cnt.getValue() << gauge.getValue() << (m == &cnt)
+		<< (text.find(ConstStrA("test_metrics_counter_total{case=\"counter\"} 40000\n")) != naturalNull);
+	//shards updated before the counter exists are not lost
+	static MetricCounter::Cells extCells;
+	extCells.add(5);
+	MetricCounter ext("test_metrics_external_total", "test external counter", ConstStrA(), extCells);
+	extCells.add();
+	print(" %1") << ext.getValue();
+}
+
+static void metricsLabelsTest(PrintTextA &print) {
+	StringA label = Metric::label("name", "a\"b");
+	MetricCounter a("test_metrics_shared_total", "shared counter", label);
+	MetricCounter b("test_metrics_shared_total", "shared counter", label);
+	MetricCounter c("test_metrics_shared_total", "shared counter", label);
+	a.add(1);
+	b.add(2);
+	c.add(4);
+	c.setLabels(Metric::label("name", "other"));
+	StringA text = exportMetrics();
+	//instances with the same labels are exported as one series
+	print("%1 %2 %3") << label
+		<< (text.find(ConstStrA("test_metrics_shared_total{name=\"a\\\"b\"} 3\n")) != naturalNull)
+		<< (text.find(ConstStrA("test_metrics_shared_total{name=\"other\"} 4\n")) != naturalNull);
+}
+
+static void metricsHistogramTest(PrintTextA &print) {
+	MetricHistogram hist("test_metrics_histogram", "test histogram");
+	bool boundsOk = true;
+	for (natural v = 0; v < 100000; v = v * 3 / 2 + 1) {
+		natural b = MetricHistogram::getBucket(v);
+		if (MetricHistogram::getUpperBound(b) < v) boundsOk = false;
+		if (b > 0 && MetricHistogram::getUpperBound(b - 1) >= v) boundsOk = false;
+	}
+	for (natural i = 1; i <= 1000; i++) hist.record(i);
+	MetricHistogram::Snapshot snap = hist.getSnapshot();
+	natural median = snap.getQuantile(0.5);
+	natural p99 = snap.getQuantile(0.99);
+	StringA text = exportMetrics();
+	print("%1 %2 %3 %4 %5 %6 %7") << boundsOk << snap.count << snap.sum
+		<< (median >= 500 && median <= 500 * 9 / 8) << (p99 >= 990 && p99 <= 990 * 9 / 8)
+		<< (text.find(ConstStrA("# TYPE test_metrics_histogram histogram\n")) != naturalNull)
+		<< (text.find(ConstStrA("test_metrics_histogram_bucket{le=\"+Inf\"} 1000\n")) != naturalNull);
+}
+
+static void metricsExporterTest(PrintTextA &print) {
+	MetricCounter cnt("test_metrics_exported_total", "exported counter");
+	cnt.add(42);
+	MetricsExporter exporter;
+	natural port = exporter.start();
+	NetworkStreamSource src(NetworkAddress("localhost", port), 1, 2000, 2000, StreamOpenMode::active);
+	PNetworkStream conn = src.getNext();
+	ConstStrA req("GET /metrics HTTP/1.0\r\n\r\n");
+	conn->write(req.data(), req.length());
+	AutoArray<char> resp;
+	char buff[4096];
+	natural rd;
+	while ((rd = conn->read(buff, sizeof(buff))) != 0) resp.append(ConstStrA(buff, rd));
+	exporter.stop();
+	ConstStrA r(resp);
+	print("%1 %2") << (r.head(15) == ConstStrA("HTTP/1.0 200 OK"))
+		<< (r.find(ConstStrA("\ntest_metrics_exported_total 42\n")) != naturalNull);
+}
+
+static MetricCounter benchMetricsCounter("bench_metrics_counter_total", "benchmark counter");
+static MetricHistogram benchMetricsHistogram("bench_metrics_histogram", "benchmark histogram");
+
+static void benchCounterAdd(natural count, IRuntimeAlloc &) {
+	for (natural i = 0; i < count; i++) benchMetricsCounter.add();
+}
+
+static void benchHistogramRecord(natural count, IRuntimeAlloc &) {
+	for (natural i = 0; i < count; i++) benchMetricsHistogram.record(i & 0xFFFF);
+}
+
+defineTest metrics_counter("metrics.counter","40000 39996 1 1 6",&metricsCounterTest);
+defineTest metrics_labels("metrics.labels","name=\"a\\\"b\" 1 1",&metricsLabelsTest);
+defineTest metrics_histogram("metrics.histogram","1 1000 500500 1 1 1 1",&metricsHistogramTest);
+defineTest metrics_exporter("metrics.exporter","1 1",&metricsExporterTest);
+defineBenchmark bench_metricsCounter("metrics.counter.add",&benchCounterAdd);
+defineBenchmark bench_metricsHistogram("metrics.histogram.record",&benchHistogramRecord);
+
+}
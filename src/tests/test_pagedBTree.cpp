@@ -0,0 +1,67 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/containers/pagedBTree.tcc"
+#include "../lightspeed/base/streams/fileio.h"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+typedef PagedBTree<Bin::natural32, Bin::natural32> Tree;
+
+static void fillTree(Tree &tree, natural from, natural to) {
+	//keys are inserted in scrambled order
+	for (natural i = from; i < to; i++) {
+		Bin::natural32 k = (Bin::natural32)((i * 7919) % 10007);
+		tree.insert(k, k * 2);
+	}
+}
+
+static void pagedBTreeMemTest(PrintTextA &print) {
+	MemNodeSpace space(1024);
+	Tree tree(space);
+	fillTree(tree, 0, 10007);
+	for (Bin::natural32 k = 0; k < 10007; k += 2) tree.erase(k);
+	bool ordered = true;
+	Bin::natural32 last = 0;
+	natural cnt = 0;
+	Tree::Iterator iter = tree.getFwIter();
+	while (iter.hasItems()) {
+		const Tree::KeyValue &kv = iter.getNext();
+		if (kv.key <= last || kv.value != kv.key * 2) ordered = false;
+		last = kv.key;
+		cnt++;
+	}
+	Tree::Iterator iter2 = tree.seek(5000);
+	print("%1 %2 %3 %4") << tree.length() << cnt << ordered << iter2.getNext().key;
+}
+
+static void pagedBTreeFileTest(PrintTextA &print) {
+	PTemporaryFile tmp = IFileIOServices::getIOServices().createTempFile(L"pbtree");
+	String fname = tmp->getFilename();
+	tmp->close();
+	{
+		//small cache forces eviction
+		FileNodeSpace space(fname, 1024, 32);
+		Tree tree(space);
+		fillTree(tree, 0, 5000);
+		tree.commit();
+		fillTree(tree, 5000, 10007);
+		tree.rollback();
+		for (Bin::natural32 k = 0; k < 100; k++) tree.erase(k);
+		tree.commit();
+	}
+	FileNodeSpace space(fname, 1024, 32);
+	Tree tree(space);
+	Bin::natural32 v = 0;
+	bool f1 = tree.find((Bin::natural32)((4999 * 7919) % 10007), v);
+	bool f2 = tree.contains((Bin::natural32)((5000 * 7919) % 10007));
+	bool f3 = tree.contains(50);
+	print("%1 %2 %3 %4") << tree.length() << f1 << f2 << f3;
+}
+
+defineTest pagedBTree_mem("pagedBTree.mem","5003 5003 1 5001",&pagedBTreeMemTest);
+defineTest pagedBTree_file("pagedBTree.file","4951 1 0 0",&pagedBTreeFileTest);
+
+}
@@ -0,0 +1,46 @@
+/*
+ * test_process.cpp
+ *
+ *  Created on: 19. 10. 2026
+ *      Author: ondra
+ */
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/mt/process.h"
+#include "../lightspeed/base/streams/fileiobuff.tcc"
+
+namespace LightSpeed {
+
+defineTest test_processSpawn("process.spawn","hello world",[](PrintTextA &out) {
+
+	SeqFileInput pipe(nil);
+	Process proc("/bin/echo");
+	proc.arg("hello").arg("world").stdOut(pipe).start();
+
+	SeqFileInBuff<> in(pipe);
+	while (in.hasItems()) {
+		char c = in.getNext();
+		if (c != '\n') out("%1") << c;
+	}
+	proc.join();
+});
+
+defineTest test_processGroup("process.group","3 60",[](PrintTextA &out) {
+
+	Process p1("/bin/sh"), p2("/bin/sh"), p3("/bin/sh");
+	p1.arg("-c").arg("exit 10");
+	p2.arg("-c").arg("sleep 0.1; exit 20");
+	p3.arg("-c").arg("exit 30");
+
+	ProcessGroup group;
+	group.add(p1).add(p2).add(p3);
+	natural cnt = group.start();
+
+	integer sum = 0;
+	Process *p;
+	while ((p = group.waitAny(Timeout(10000))) != 0) {
+		sum += p->getExitCode();
+	}
+	out("%1 %2") << cnt << sum;
+});
+
+}
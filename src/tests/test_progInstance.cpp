@@ -0,0 +1,110 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/framework/proginstance.h"
+#include "../lightspeed/base/streams/fileio.h"
+#include "../lightspeed/base/containers/autoArray.tcc"
+#include "../lightspeed/mt/thread.h"
+#include "../lightspeed/mt/atomic.h"
+#include <string.h>
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+///creates name of instance file which doesn't exist yet
+static String createTestInstanceName() {
+	IFileIOServices &svc = IFileIOServices::getIOServices();
+	PTemporaryFile tmp = svc.createTempFile(L"proginst");
+	String fname = tmp->getFilename();
+	//temporary file is removed on close
+	tmp->close();
+	return fname;
+}
+
+///server echoes requests. First natural of the message contains its size
+class ProgInstanceEchoServer {
+public:
+	ProgInstance instance;
+	Thread thr;
+	volatile bool stopFlag;
+
+	ProgInstanceEchoServer(const String &name, natural slots)
+		:instance(name),stopFlag(false) {
+		instance.create(65536, slots);
+		thr.start(ThreadFunction::create(this, &ProgInstanceEchoServer::run));
+	}
+	~ProgInstanceEchoServer() {
+		stopFlag = true;
+		instance.cancelWaitForRequest();
+		thr.join();
+	}
+	void run() {
+		while (!stopFlag) {
+			void *req = instance.waitForRequest(1000);
+			if (req == 0) continue;
+			natural sz;
+			memcpy(&sz, req, sizeof(sz));
+			instance.sendReply(req, sz);
+		}
+	}
+};
+
+static bool progInstanceEcho(ProgInstance &client, natural size, natural seed) {
+	AutoArray<byte> req, reply;
+	req.resize(size);
+	reply.resize(size);
+	for (natural i = 0; i < size; i++) req(i) = (byte)(i * 7 + seed);
+	memcpy(req.data(), &size, sizeof(size));
+	natural rd = client.request(req.data(), size, reply.data(), size, 10000);
+	return rd == size && req == reply;
+}
+
+static void progInstanceTest(PrintTextA &print) {
+	String name = createTestInstanceName();
+	ProgInstanceEchoServer server(name, 4);
+	atomic failed = 0;
+	static const natural threads = 8;
+	Thread thr[threads];
+	for (natural t = 0; t < threads; t++) {
+		thr[t].start(ThreadFunction::create([&, t]{
+			ProgInstance client(name);
+			client.open();
+			for (natural i = 0; i < 50; i++)
+				if (!progInstanceEcho(client, 16 + (i * 37 + t) % 200, t + i)) lockInc(failed);
+		}));
+	}
+	for (natural t = 0; t < threads; t++) thr[t].join();
+
+	//message larger than the slot is transferred in chunks
+	ProgInstance client(name);
+	client.open();
+	bool large = progInstanceEcho(client, 20000, 3) && progInstanceEcho(client, 65536, 5);
+	bool tooLarge = false;
+	try {
+		progInstanceEcho(client, 65537, 1);
+	} catch (const ProgInstance::RequestTooLarge &) {
+		tooLarge = true;
+	}
+	print("%1 %2 %3") << (failed == 0) << large << tooLarge;
+}
+
+static void benchProgInstance(natural count, IRuntimeAlloc &) {
+	static String name = createTestInstanceName();
+	static ProgInstanceEchoServer server(name, 16);
+	static const natural threads = 4;
+	Thread thr[threads];
+	for (natural t = 0; t < threads; t++) {
+		thr[t].start(ThreadFunction::create([&]{
+			ProgInstance client(name);
+			client.open();
+			for (natural i = 0; i < count; i++) progInstanceEcho(client, 64, i);
+		}));
+	}
+	for (natural t = 0; t < threads; t++) thr[t].join();
+}
+
+defineTest progInstance_channel("progInstance.channel","1 1 1",&progInstanceTest);
+defineBenchmark bench_progInstance("proginstance.request.4threads",&benchProgInstance);
+
+}
@@ -0,0 +1,77 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/actions/queueExecutor.h"
+#include "../lightspeed/base/actions/message.h"
+#include "../lightspeed/mt/thread.h"
+#include "../lightspeed/mt/atomic.h"
+#include "../lightspeed/base/containers/autoArray.tcc"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+struct LargePayload {
+	natural values[32];
+};
+
+static void queueExecutorTest(PrintTextA &print) {
+
+	//small ring forces actions to the overflow queue
+	QueueExecutor executor(8);
+	atomic sum = 0;
+	atomic count = 0;
+	Thread thr[3];
+	for (natural i = 0; i < 3; i++)
+		thr[i].start(ThreadFunction::create([&executor]{executor.serve();}));
+
+	const natural total = 2000;
+	for (natural i = 0; i < total; i++) {
+		if (i & 1) {
+			executor.execute(Message<void>::create([&sum,&count,i]{
+				lockExchangeAdd(sum,(atomicValue)i);
+				lockInc(count);
+			}));
+		} else {
+			LargePayload p;
+			p.values[31] = i;
+			executor.execute(Message<void>::create([&sum,&count,p]{
+				lockExchangeAdd(sum,(atomicValue)p.values[31]);
+				lockInc(count);
+			}));
+		}
+	}
+	while (readAcquire(&count) != (atomicValue)total) Thread::sleep(1);
+	executor.stopAll(naturalNull);
+	print("%1 %2") << readAcquire(&count) << readAcquire(&sum);
+}
+
+static void queueExecutorReturnTest(PrintTextA &print) {
+
+	QueueExecutor executor;
+	//order is written by the serving thread, it is read after the thread is joined
+	AutoArray<natural> order;
+	atomic done = 0;
+	//first action asks the serving thread to finish, the rest of the batch must not be lost
+	executor.execute(Message<void>::create([&order,&done]{
+		order.add(0);
+		lockInc(done);
+		Thread::current().finish();
+	}));
+	for (natural i = 1; i < 6; i++)
+		executor.execute(Message<void>::create([&order,&done,i]{order.add(i);lockInc(done);}));
+	Thread thr;
+	thr.start(ThreadFunction::create([&executor]{executor.serve();}));
+	thr.join();
+	executor.execute(Message<void>::create([&order,&done]{order.add(6);lockInc(done);}));
+	thr.start(ThreadFunction::create([&executor]{executor.serve();}));
+	while (readAcquire(&done) < 7) Thread::sleep(1);
+	executor.stopAll(naturalNull);
+	thr.join();
+	for (natural i = 0; i < order.length(); i++) print("%1 ") << order[i];
+}
+
+defineTest queueExecutor_test("queueExecutor.mpmc","2000 1999000",&queueExecutorTest);
+defineTest queueExecutor_return("queueExecutor.returnBatch","0 1 2 3 4 5 6 ",&queueExecutorReturnTest);
+
+}
@@ -0,0 +1,66 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/actions/rcuDistributor.tcc"
+#include "../lightspeed/base/actions/queueExecutor.h"
+#include "../lightspeed/mt/thread.h"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+class CountingListener {
+public:
+	CountingListener():sum(0),last(0),ordered(1) {}
+	//called from several publisher threads at once
+	void onEvent(natural v) {
+		lockExchangeAdd(sum,(atomicValue)v);
+		atomicValue prev = lockExchange(last,(atomicValue)v);
+		if ((atomicValue)v <= prev) writeRelease(&ordered,0);
+	}
+	atomic sum;
+	atomic last;
+	atomic ordered;
+};
+
+typedef RcuDistributor<CountingListener *> Dist;
+
+static void rcuDistributorTest(PrintTextA &print) {
+	Dist dist;
+	CountingListener a,b,c;
+	dist.add(&a);
+	dist.add(&b);
+
+	//publishers run while listener c is repeatedly added and removed
+	Thread thr[3];
+	for (natural i = 0; i < 3; i++)
+		thr[i].start(ThreadFunction::create([&dist]{
+			for (natural j = 1; j <= 1000; j++)
+				dist.send(Dist::Msg::create([j](CountingListener *l){l->onEvent(j);}));
+		}));
+	for (natural i = 0; i < 100; i++) {
+		dist.add(&c);
+		dist.remove(&c);
+	}
+	for (natural i = 0; i < 3; i++) thr[i].join();
+
+	//ordered delivery through the executor
+	QueueExecutor executor;
+	Thread srv[2];
+	for (natural i = 0; i < 2; i++)
+		srv[i].start(ThreadFunction::create([&executor]{executor.serve();}));
+	CountingListener d,e;
+	Dist dist2;
+	dist2.add(&d);
+	dist2.add(&e);
+	for (natural j = 1; j <= 1000; j++)
+		dist2.post(Dist::Msg::create([j](CountingListener *l){l->onEvent(j);}), executor);
+	while (readAcquire(&d.sum) != 500500 || readAcquire(&e.sum) != 500500) Thread::sleep(1);
+	executor.stopAll(naturalNull);
+
+	print("%1 %2 %3 %4 %5") << a.sum << b.sum << dist.size() << (readAcquire(&d.ordered) && readAcquire(&e.ordered)) << readAcquire(&e.last);
+}
+
+defineTest rcuDistributor_test("rcuDistributor.send","1501500 1501500 2 1 1000",&rcuDistributorTest);
+
+}
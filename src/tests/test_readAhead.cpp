@@ -0,0 +1,141 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/streams/readAheadBuffer.h"
+#include "../lightspeed/base/streams/fileiobuff.tcc"
+#include "../lightspeed/base/text/blockLineReader.h"
+#include "../lightspeed/base/containers/autoArray.tcc"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static String readAheadTempName() {
+	PTemporaryFile tmp = IFileIOServices::getIOServices().createTempFile(L"readahead");
+	return tmp->getFilename();
+}
+
+static byte readAheadPattern(natural pos) {
+	return (byte)(pos * 7 + pos / 997);
+}
+
+///writes pattern through the write behind buffer using odd sized writes
+static void writeAheadPattern(const String &name, natural size) {
+	SeqFileOutput f(name, OpenFlags::create|OpenFlags::truncate);
+	RefCntPtr<WriteBehindBuffer> out = new WriteBehindBuffer(f.getStream(), 1000, 256*1024);
+	byte chunk[3001];
+	natural pos = 0;
+	while (pos < size) {
+		natural sz = size - pos < sizeof(chunk)?size - pos:sizeof(chunk);
+		for (natural i = 0; i < sz; i++) chunk[i] = readAheadPattern(pos + i);
+		natural wr = out->writeAll(chunk, sz);
+		pos += wr;
+	}
+	out->flush();
+}
+
+static void readAheadStreamTest(PrintTextA &print) {
+	String name = readAheadTempName();
+	static const natural size = 5*1024*1024 + 123;
+	writeAheadPattern(name, size);
+	SeqFileInput f(name, 0);
+	RefCntPtr<ReadAheadBuffer> in = new ReadAheadBuffer(f.getStream(), 4096, 1024*1024);
+	natural pos = 0, errors = 0;
+	byte chunk[777];
+	natural rd;
+	while ((rd = in->read(chunk, sizeof(chunk))) != 0) {
+		for (natural i = 0; i < rd; i++) if (chunk[i] != readAheadPattern(pos + i)) errors++;
+		pos += rd;
+	}
+	natural block = in->getBlockSize();
+	in = nil;
+	IFileIOServices::getIOServices().remove(name);
+	print("%1 %2 %3") << (pos == size) << errors << block;
+}
+
+static void readAheadLinesTest(PrintTextA &print) {
+	String name = readAheadTempName();
+	natural total = 0;
+	{
+		SeqFileOutBehind out(name, OpenFlags::create|OpenFlags::truncate);
+		for (natural i = 0; i < 2000; i++) {
+			//every 100th line is longer than initial block
+			natural len = i % 100 == 0?10000:i % 50;
+			for (natural j = 0; j < len; j++) out.write('a' + (char)(j % 26));
+			out.write('\n');
+			total += len;
+		}
+	}
+	SeqFileInput f(name, 0);
+	RefCntPtr<ReadAheadBuffer> in = new ReadAheadBuffer(f.getStream(), 1024, 65536);
+	natural lines = 0, chars = 0;
+	{
+		BlockLineReader rd(*in);
+		while (rd.hasItems()) {
+			const ConstStrA &ln = rd.getNext();
+			lines++;
+			chars += ln.length();
+		}
+	}
+	//test lookup and putBack after the end
+	ConstBin hello(reinterpret_cast<const byte *>("hello"), 5);
+	bool putBackFailed = false;
+	try {
+		in->putBack(hello);
+	} catch (const Exception &) {
+		putBackFailed = true;
+	}
+	in = nil;
+	IFileIOServices::getIOServices().remove(name);
+	print("%1 %2 %3") << lines << (chars == total) << !putBackFailed;
+}
+
+///file for benchmarks, created once and removed at exit
+class ReadAheadBenchFile {
+public:
+	static const natural size = 32*1024*1024;
+	String name;
+
+	ReadAheadBenchFile():name(readAheadTempName()) {writeAheadPattern(name, size);}
+	~ReadAheadBenchFile() {IFileIOServices::getIOServices().remove(name);}
+};
+
+static ReadAheadBenchFile &getReadAheadBenchFile() {
+	static ReadAheadBenchFile f;
+	return f;
+}
+
+///simulates parser, which processes the stream by small records
+static natural parseStream(SeqFileInput &in) {
+	natural sum = 0;
+	byte rec[64];
+	natural rd;
+	PInputStream stream = in.getStream();
+	while ((rd = stream->read(rec, sizeof(rec))) != 0) {
+		for (natural i = 0; i < rd; i++) sum = sum * 31 + rec[i];
+	}
+	return sum;
+}
+
+static void benchReadBuffered(natural count, IRuntimeAlloc &) {
+	ReadAheadBenchFile &bf = getReadAheadBenchFile();
+	for (natural i = 0; i < count; i++) {
+		SeqFileInBuff<> in(bf.name, 0);
+		parseStream(in);
+	}
+}
+
+static void benchReadAhead(natural count, IRuntimeAlloc &) {
+	ReadAheadBenchFile &bf = getReadAheadBenchFile();
+	for (natural i = 0; i < count; i++) {
+		SeqFileInAhead in(bf.name, 0);
+		parseStream(in);
+	}
+}
+
+defineTest readAhead_stream("readAhead.stream","1 0 1048576",&readAheadStreamTest);
+defineTest readAhead_lines("readAhead.lines","2000 1 1",&readAheadLinesTest);
+defineBenchmark bench_readBuffered("readahead.parse.iobuffer",&benchReadBuffered);
+defineBenchmark bench_readAhead("readahead.parse.readahead",&benchReadAhead);
+
+}
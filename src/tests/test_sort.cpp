@@ -0,0 +1,139 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/containers/parallelSort.tcc"
+#include "../lightspeed/base/containers/sort.tcc"
+#include "../lightspeed/base/actions/parallelExecutor.h"
+#include <string.h>
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+struct SortRecord {
+	Bin::integer64 key;
+	natural payload;
+
+	bool operator<(const SortRecord &other) const {return key < other.key;}
+};
+
+struct SortRecordKey {
+	Bin::integer64 operator()(const SortRecord &r) const {return r.key;}
+};
+
+struct StringKey {
+	ConstStrA operator()(const ConstStrA &s) const {return s;}
+};
+
+///compares strings as unsigned bytes
+struct StringLess {
+	bool operator()(const ConstStrA &a, const ConstStrA &b) const {
+		natural l = a.length() < b.length()?a.length():b.length();
+		int r = memcmp(a.data(), b.data(), l);
+		return r < 0 || (r == 0 && a.length() < b.length());
+	}
+};
+
+static void fillRecords(AutoArray<SortRecord> &arr, natural count, natural mod, natural seed) {
+	arr.clear();
+	arr.reserve(count);
+	Bin::natural64 x = seed;
+	for (natural i = 0; i < count; i++) {
+		x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+		SortRecord r = {(Bin::integer64)(x >> 16) % (Bin::integer64)mod - (Bin::integer64)(mod / 2), i};
+		arr.add(r);
+	}
+}
+
+///checks order and stability, payload is original position
+static bool checkRecords(const AutoArray<SortRecord> &arr, bool stable) {
+	natural sum = 0;
+	for (natural i = 0; i < arr.length(); i++) {
+		sum += arr[i].payload;
+		if (i == 0) continue;
+		if (arr[i].key < arr[i - 1].key) return false;
+		if (stable && arr[i].key == arr[i - 1].key && arr[i].payload < arr[i - 1].payload) return false;
+	}
+	natural n = arr.length();
+	return sum == n * (n - 1) / 2;
+}
+
+static void sortAlgorithmsTest(PrintTextA &print) {
+	AutoArray<SortRecord> arr;
+	//random, many duplicates, sorted, reversed
+	bool intro = true;
+	fillRecords(arr, 10000, 1000000, 1);
+	introSort(arr);
+	intro = intro && checkRecords(arr, false);
+	fillRecords(arr, 10000, 3, 2);
+	introSort(arr);
+	intro = intro && checkRecords(arr, false);
+	introSort(arr);
+	intro = intro && checkRecords(arr, false);
+	for (natural i = 0; i < arr.length() / 2; i++) std::swap(arr(i), arr(arr.length() - 1 - i));
+	introSort(ArrayRef<SortRecord>(arr));
+	intro = intro && checkRecords(arr, false);
+
+	fillRecords(arr, 10000, 1000, 3);
+	radixSort(arr, SortRecordKey());
+	bool radix = checkRecords(arr, true);
+
+	static const char *words[] = {"delta","alpha","","alphabet","charlie","bravo","alp","delta","\xC5\x99","zulu"};
+	AutoArray<ConstStrA> strs, strs2;
+	for (natural i = 0; i < 1000; i++) strs.add(ConstStrA(words[(i * 7) % 10]));
+	strs2 = strs;
+	radixSortStrings(strs, StringKey());
+	introSort(strs2, StringLess());
+	bool strings = true;
+	for (natural i = 0; i < strs.length(); i++) if (strs[i] != strs2[i]) strings = false;
+
+	ParallelExecutor executor(4);
+	fillRecords(arr, 100000, 1000000000, 4);
+	parallelSort(arr, std::less<SortRecord>(), executor, 5, 1000);
+	bool parallel = checkRecords(arr, false);
+	print("%1 %2 %3 %4") << intro << radix << strings << parallel;
+}
+
+static const natural benchSize = 100000;
+
+static void benchHeapSort(natural count, IRuntimeAlloc &) {
+	AutoArray<SortRecord> arr;
+	for (natural i = 0; i < count; i++) {
+		fillRecords(arr, benchSize, 1000000000, i);
+		HeapSort<AutoArray<SortRecord> > sorter(arr);
+		sorter.sort();
+	}
+}
+
+static void benchIntroSort(natural count, IRuntimeAlloc &) {
+	AutoArray<SortRecord> arr;
+	for (natural i = 0; i < count; i++) {
+		fillRecords(arr, benchSize, 1000000000, i);
+		introSort(arr);
+	}
+}
+
+static void benchRadixSort(natural count, IRuntimeAlloc &) {
+	AutoArray<SortRecord> arr;
+	for (natural i = 0; i < count; i++) {
+		fillRecords(arr, benchSize, 1000000000, i);
+		radixSort(arr, SortRecordKey());
+	}
+}
+
+static void benchParallelSort(natural count, IRuntimeAlloc &) {
+	ParallelExecutor executor;
+	AutoArray<SortRecord> arr;
+	for (natural i = 0; i < count; i++) {
+		fillRecords(arr, benchSize, 1000000000, i);
+		parallelSort(arr, std::less<SortRecord>(), executor, 0, 4096);
+	}
+}
+
+defineTest sort_algorithms("sort.algorithms","1 1 1 1",&sortAlgorithmsTest);
+defineBenchmark bench_heapSort("sort.heap",&benchHeapSort);
+defineBenchmark bench_introSort("sort.intro",&benchIntroSort);
+defineBenchmark bench_radixSort("sort.radix",&benchRadixSort);
+defineBenchmark bench_parallelSort("sort.parallel",&benchParallelSort);
+
+}
@@ -0,0 +1,88 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/mt/timeout.h"
+#include "../lightspeed/mt/tscClock.h"
+#include "../lightspeed/mt/thread.h"
+#include "../lightspeed/base/timestamp.h"
+#include <sys/time.h>
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static void sysTimeCachedTest(PrintTextA &print) {
+	bool frozen, timeoutFromCache, released, tscSpan;
+	{
+		CachedClock clock;
+		SysTime t = clock.refresh();
+		Thread::sleep(20);
+		//cached time doesn't move until refresh
+		frozen = SysTime::cached() == t;
+		timeoutFromCache = Timeout(100).getExpireTime() == t + SysTime(0,0,0,0,100);
+	}
+	SysTime t1 = SysTime::cached();
+	Thread::sleep(20);
+	released = SysTime::cached() > t1;
+
+	TscClock::Ticks c1 = TscClock::read();
+	Thread::sleep(20);
+	Bin::natural64 ns = TscClock::toNanosecs(TscClock::read() - c1);
+	tscSpan = ns >= 15000000 && ns < 1000000000;
+	print("%1 %2 %3 %4") << frozen << timeoutFromCache << released << tscSpan;
+}
+
+static void sysTimeWallClockTest(PrintTextA &print) {
+	time_t t = time(0);
+	SysTime w = SysTime::wallClock();
+	natural diff = w.secs() > (natural)t?w.secs() - (natural)t:(natural)t - w.secs();
+	//time of the day must match calendar time
+	natural hour = ((natural)t / 3600) % 24;
+	print("%1 %2") << (diff <= 1) << (w.hour() == hour || diff != 0);
+}
+
+static void benchGettimeofday(natural count, IRuntimeAlloc &) {
+	volatile natural sink = 0;
+	for (natural i = 0; i < count; i++) {
+		struct timeval tv;
+		gettimeofday(&tv,0);
+		sink = sink + tv.tv_usec;
+	}
+}
+
+static void benchMonotonic(natural count, IRuntimeAlloc &) {
+	volatile natural sink = 0;
+	for (natural i = 0; i < count; i++) sink = sink + SysTime::now().msec();
+}
+
+static void benchCoarse(natural count, IRuntimeAlloc &) {
+	volatile natural sink = 0;
+	for (natural i = 0; i < count; i++) sink = sink + SysTime::coarse().msec();
+}
+
+static void benchCached(natural count, IRuntimeAlloc &) {
+	CachedClock clock;
+	volatile natural sink = 0;
+	for (natural i = 0; i < count; i++) sink = sink + SysTime::cached().msec();
+}
+
+static void benchTsc(natural count, IRuntimeAlloc &) {
+	volatile natural sink = 0;
+	for (natural i = 0; i < count; i++) sink = sink + (natural)TscClock::read();
+}
+
+static void benchTimeout(natural count, IRuntimeAlloc &) {
+	volatile natural sink = 0;
+	for (natural i = 0; i < count; i++) sink = sink + Timeout(1000).getExpireTime().msec();
+}
+
+defineTest sysTime_cached("sysTime.cached","1 1 1 1",&sysTimeCachedTest);
+defineTest sysTime_wallClock("sysTime.wallClock","1 1",&sysTimeWallClockTest);
+defineBenchmark bench_gettimeofday("clock.gettimeofday",&benchGettimeofday);
+defineBenchmark bench_monotonic("clock.monotonic",&benchMonotonic);
+defineBenchmark bench_coarse("clock.coarse",&benchCoarse);
+defineBenchmark bench_cached("clock.cached",&benchCached);
+defineBenchmark bench_tsc("clock.tsc",&benchTsc);
+defineBenchmark bench_timeout("clock.timeout",&benchTimeout);
+
+}
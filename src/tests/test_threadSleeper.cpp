@@ -0,0 +1,74 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/sync/synchronize.h"
+#include "../lightspeed/mt/thread.h"
+#include "../lightspeed/mt/threadSleeper.h"
+#include "../lightspeed/mt/fastlock.h"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static void threadSleeperTest(PrintTextA &print) {
+	ThreadSleeper a, b;
+	//pending wake up is consumed without waiting
+	a.wakeUp(5);
+	bool pending = !a.sleep(Timeout(1000)) && a.getReason() == 5;
+	bool timeout = a.sleep(Timeout(10));
+
+	ThreadSleeper *both[] = {&a, &b};
+	Thread thr;
+	thr.start(ThreadFunction::create([&b]{
+		Thread::sleep(20);
+		b.wakeUp(7);
+	}));
+	natural idx = ThreadSleeper::sleepAny(both, 2, Timeout(5000));
+	thr.join();
+	natural idx2 = ThreadSleeper::sleepAny(both, 2, Timeout(20));
+	print("%1 %2 %3 %4 %5") << pending << timeout << idx << b.getReason() << (idx2 == naturalNull);
+}
+
+static void benchPingPong(natural count, IRuntimeAlloc &) {
+	ThreadSleeper ping, pong;
+	Thread thr;
+	thr.start(ThreadFunction::create([&]{
+		for (natural i = 0; i < count; i++) {
+			ping.sleep(Timeout());
+			pong.wakeUp();
+		}
+	}));
+	for (natural i = 0; i < count; i++) {
+		ping.wakeUp();
+		pong.sleep(Timeout());
+	}
+	thr.join();
+}
+
+static void lockContention(natural count, natural threads) {
+	FastLock lock;
+	natural counter = 0;
+	Thread thr[64];
+	natural perThread = (count + threads - 1) / threads;
+	for (natural i = 0; i < threads; i++) {
+		thr[i].start(ThreadFunction::create([&]{
+			for (natural j = 0; j < perThread; j++) {
+				Synchronized<FastLock> _(lock);
+				counter++;
+			}
+		}));
+	}
+	for (natural i = 0; i < threads; i++) thr[i].join();
+}
+
+static void benchLock2(natural count, IRuntimeAlloc &) {lockContention(count, 2);}
+static void benchLock8(natural count, IRuntimeAlloc &) {lockContention(count, 8);}
+static void benchLock64(natural count, IRuntimeAlloc &) {lockContention(count, 64);}
+
+defineTest threadSleeper_wake("threadSleeper.wake","1 1 1 7 1",&threadSleeperTest);
+defineBenchmark bench_sleeperPingPong("sleeper.pingpong",&benchPingPong);
+defineBenchmark bench_lockContention2("fastlock.contention.2",&benchLock2);
+defineBenchmark bench_lockContention8("fastlock.contention.8",&benchLock8);
+defineBenchmark bench_lockContention64("fastlock.contention.64",&benchLock64);
+
+}
@@ -0,0 +1,144 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/base/debug/tracing.h"
+#include "../lightspeed/base/actions/parallelExecutor.h"
+#include "../lightspeed/base/actions/queueExecutor.h"
+#include "../lightspeed/base/actions/message.h"
+#include "../lightspeed/base/actions/promise.tcc"
+#include "../lightspeed/base/streams/memfile.h"
+#include "../lightspeed/base/containers/autoArray.tcc"
+#include "../lightspeed/mt/msgthread.h"
+#include "../lightspeed/mt/thread.h"
+#include <string.h>
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static const TraceEvent *findSpan(const AutoArray<TraceEvent> &events, const char *name) {
+	for (natural i = 0; i < events.length(); i++) {
+		if (strcmp(events[i].name, name) == 0) return &events[i];
+	}
+	return 0;
+}
+
+static bool isChildOf(const TraceEvent *child, const TraceEvent *parent) {
+	return child && parent && child->parentId == parent->spanId && child->traceId == parent->traceId;
+}
+
+static void tracingSpanTest(PrintTextA &print) {
+	Tracer::enable(true);
+	Tracer::clear();
+	{
+		LS_TRACE_SPAN("trace.outer");
+		{
+			LS_TRACE_SPAN("trace.inner");
+		}
+	}
+	Tracer::enable(false);
+	{
+		LS_TRACE_SPAN("trace.disabled");
+	}
+	AutoArray<TraceEvent> events;
+	Tracer::collect(events);
+	const TraceEvent *outer = findSpan(events, "trace.outer");
+	const TraceEvent *inner = findSpan(events, "trace.inner");
+	print("%1 %2 %3 %4 %5") << events.length() << isChildOf(inner, outer)
+		<< (outer && outer->parentId == 0 && outer->traceId == outer->spanId)
+		<< (outer && inner && outer->begin <= inner->begin && inner->end <= outer->end)
+		<< TraceContext::current().isValid();
+}
+
+static void tracingResolve(Promise<int> promise) {
+	promise.resolve(1);
+}
+
+static void tracingPropagationTest(PrintTextA &print) {
+	Tracer::enable(true);
+	Tracer::clear();
+	MsgThread msgThread;
+	QueueExecutor queue;
+	ParallelExecutor parallel(2);
+	Thread server, resolver;
+	server.start(ThreadFunction::create([&queue]{queue.serve();}));
+	Future<int> future;
+	Promise<int> promise = future.getPromise();
+	atomic done = 0;
+	{
+		LS_TRACE_SPAN("trace.root");
+		msgThread.postFnCall([]{LS_TRACE_SPAN("trace.msgqueue");});
+		queue.execute(Message<void>::create([&done]{
+			LS_TRACE_SPAN("trace.queue");
+			lockInc(done);
+		}));
+		parallel.execute(Message<void>::create([&done]{
+			LS_TRACE_SPAN("trace.parallel");
+			lockInc(done);
+		}));
+		future.thenCall([](int){LS_TRACE_SPAN("trace.then");});
+	}
+	//promise is resolved by a thread without any trace context
+	resolver.start(ThreadFunction::create(&tracingResolve, promise));
+	resolver.join();
+	msgThread.syncToQueue();
+	while (readAcquire(&done) != 2) Thread::sleep(1);
+	parallel.join();
+	queue.stopAll(naturalNull);
+	server.join();
+	Tracer::enable(false);
+
+	AutoArray<TraceEvent> events;
+	Tracer::collect(events);
+	const TraceEvent *root = findSpan(events, "trace.root");
+	print("%1 %2 %3 %4") << isChildOf(findSpan(events, "trace.msgqueue"), root)
+		<< isChildOf(findSpan(events, "trace.queue"), root)
+		<< isChildOf(findSpan(events, "trace.parallel"), root)
+		<< isChildOf(findSpan(events, "trace.then"), root);
+}
+
+static void tracingExportTest(PrintTextA &print) {
+	Tracer::enable(true);
+	Tracer::clear();
+	{
+		LS_TRACE_SPAN("trace.\"quoted\"");
+	}
+	Tracer::enable(false);
+	PRndFileHandle file = new MemFile<>;
+	{
+		SeqFileOutput strm(file, 0);
+		SeqTextOutA txt(strm);
+		PrintTextA out(txt);
+		Tracer::exportChromeJson(out);
+	}
+	AutoArray<char> buff;
+	buff.resize((natural)file->size());
+	file->read(buff.data(), buff.length(), 0);
+	ConstStrA json(buff);
+	print("%1 %2 %3") << (json.head(16) == ConstStrA("{\"traceEvents\":["))
+		<< (json.find(ConstStrA("\"name\":\"trace.\\\"quoted\\\"\",\"cat\":\"lightspeed\",\"ph\":\"X\"")) != naturalNull)
+		<< (json.find(ConstStrA("\"displayTimeUnit\":\"ns\"}")) != naturalNull);
+}
+
+static void benchSpanDisabled(natural count, IRuntimeAlloc &) {
+	Tracer::enable(false);
+	for (natural i = 0; i < count; i++) {
+		LS_TRACE_SPAN("bench.disabled");
+	}
+}
+
+static void benchSpanEnabled(natural count, IRuntimeAlloc &) {
+	Tracer::enable(true);
+	for (natural i = 0; i < count; i++) {
+		LS_TRACE_SPAN("bench.enabled");
+	}
+	Tracer::enable(false);
+}
+
+defineTest tracing_span("tracing.span","2 1 1 1 0",&tracingSpanTest);
+defineTest tracing_propagation("tracing.propagation","1 1 1 1",&tracingPropagationTest);
+defineTest tracing_export("tracing.export","1 1 1",&tracingExportTest);
+defineBenchmark bench_tracingDisabled("tracing.span.disabled",&benchSpanDisabled);
+defineBenchmark bench_tracingEnabled("tracing.span.enabled",&benchSpanEnabled);
+
+}
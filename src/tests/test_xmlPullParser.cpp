@@ -0,0 +1,150 @@
+#include "../lightspeed/base/text/textstream.tcc"
+#include "../lightspeed/base/framework/testapp.h"
+#include "../lightspeed/utils/xmlPullParser.h"
+#include "../lightspeed/utils/xmlparser.h"
+#include "../lightspeed/base/streams/memfile.h"
+
+
+namespace LightSpeedTest {
+
+using namespace LightSpeed;
+
+static const char *xmlDoc =
+		"<?xml version=\"1.0\"?>\n"
+		"<root a=\"1 &lt; 2\" b='x'>\n"
+		"  <item id=\"i1\">Tom &amp; Jerry &#x41;</item>\n"
+		"  <!-- comment -->\n"
+		"  <empty flag=\"yes\"/>\n"
+		"  <data><![CDATA[<raw&>]]></data>\n"
+		"</root>\n";
+
+static void xmlPullParserTest(PrintTextA &print) {
+	XMLPullParser parser(xmlDoc);
+	natural item = parser.getNames().intern("item");
+	natural idAttr = parser.getNames().intern("id");
+	AutoArray<char> buffer;
+	XMLPullParser::Event ev;
+	while ((ev = parser.next()) != XMLPullParser::eof) {
+		switch (ev) {
+		case XMLPullParser::startTag: {
+				print("<%1:%2") << parser.getName() << parser.getDepth();
+				ConstStrA v;
+				if (parser.getNameId() == item && parser.getAttrValue(idAttr, buffer, v))
+					print("[%1]") << v;
+				const XMLPullParser::Attribute *a = parser.findAttr(ConstStrA("a"));
+				if (a) print("[%1]") << XMLPullParser::decode(a->rawValue, buffer);
+				if (parser.isEmptyElement()) print("/");
+				print(" ");
+			}
+			break;
+		case XMLPullParser::endTag: print(">%1 ") << parser.getName();break;
+		case XMLPullParser::text: print("'%1' ") << parser.decodeText(buffer);break;
+		case XMLPullParser::cdata: print("(%1) ") << parser.getRawText();break;
+		case XMLPullParser::comment: print("#%1# ") << parser.getRawText();break;
+		case XMLPullParser::procInstr: print("?%1 ") << parser.getName();break;
+		default: break;
+		}
+	}
+	bool failed = false;
+	try {
+		XMLPullParser bad("<a><!-- x");
+		while (bad.next() != XMLPullParser::eof) {}
+	} catch (XMLParseError &) {
+		failed = true;
+	}
+	//references out of the Unicode range become U+FFFD
+	ConstStrA refs = XMLPullParser::decode(ConstStrA("&#x110000;&#xD800;&#9999999999;&#1114111;"), buffer);
+	print("%1 %2") << failed << (refs == ConstStrA("\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD\xF4\x8F\xBF\xBF"));
+}
+
+defineTest xmlPullParser_parse("xmlPullParser.parse",
+		"?xml <root:1[1 < 2] <item:2[i1] 'Tom & Jerry A' >item # comment # "
+		"<empty:2/ >empty <data:2 (<raw&>) >data >root 1 1",&xmlPullParserTest);
+
+//parser receives the rest of the document on first needData
+static StringA dumpEvents(XMLPullParser &parser, ConstStrA doc) {
+	AutoArray<char> out;
+	XMLPullParser::Event ev;
+	while ((ev = parser.next()) != XMLPullParser::eof) {
+		if (ev == XMLPullParser::needData) {
+			parser.refill(doc.offset(parser.getOffset()), true);
+			continue;
+		}
+		out.add((char)('0' + ev));
+		out.append(parser.getName());
+		out.append(parser.getRawText());
+		for (natural i = 0; i < parser.getAttrCount(); i++)
+			out.append(parser.getAttr(i).rawValue);
+	}
+	return StringA(ConstStrA(out.data(), out.length()));
+}
+
+static void xmlPullParserRefillTest(PrintTextA &print) {
+	ConstStrA doc(xmlDoc);
+	XMLPullParser whole(doc);
+	StringA expected = dumpEvents(whole, doc);
+	//document split at every position gives the same events
+	natural bad = 0;
+	for (natural k = 0; k <= doc.length(); k++) {
+		XMLPullParser parser((ConstStrA()));
+		parser.refill(doc.head(k), false);
+		if (dumpEvents(parser, doc) != expected) bad++;
+	}
+	print("%1") << bad;
+}
+
+defineTest xmlPullParser_refill("xmlPullParser.refill","0",&xmlPullParserRefillTest);
+
+static void xmlIteratorTest(PrintTextA &print) {
+	SeqFileInput in(new MemFileStr(ConstStrA(xmlDoc)));
+	XMLIterator iter(in, true);
+	while (iter.hasItems()) {
+		if (iter.peek().isText()) {
+			print("'%1' ") << iter.readText();
+			continue;
+		}
+		const XMLEntity &e = iter.getNext();
+		switch (e.type) {
+		case XMLEntity::opentag: print(e.endTag?"</%1":"<%1") << ConstStrW(e.tag);break;
+		case XMLEntity::attribute: print(" %1=%2") << ConstStrW(e.attr) << ConstStrW(e.value);break;
+		case XMLEntity::closetag: print("> ");break;
+		default: break;
+		}
+	}
+	//only &#x is the hexadecimal reference
+	AutoArray<char> buffer;
+	print("%1") << XMLPullParser::decode(ConstStrA("&#h41;&#x41;"), buffer);
+}
+
+defineTest xmlIterator_adapter("xmlIterator.adapter",
+		"<?xml version=1.0> <root a=1 < 2 b=x> <item id=i1> 'Tom & Jerry A' </item> "
+		"<empty flag=yes> </empty> <data> '<raw&>' </data> </root> &#h41;A",&xmlIteratorTest);
+
+static void xmlIteratorStreamTest(PrintTextA &print) {
+	PInputStream rd;
+	POutputStream wr;
+	IFileIOServices::getIOServices().createPipe(rd, wr);
+	//document in other encoding than UTF-8
+	ConstStrA part1("<root><a v='x\xA9y'>");
+	ConstStrA part2("\xA9</a></root>");
+	wr->write(part1.data(), part1.length());
+	SeqFileInput in(rd);
+	//entities of the first part are available before the rest is written
+	XMLIterator iter(in);
+	for (natural i = 0; i < 4; i++) {
+		const XMLEntity &e = iter.getNext();
+		if (e.type == XMLEntity::attribute) print("%1 ") << e.value.length();
+	}
+	wr->write(part2.data(), part2.length());
+	wr = nil;
+	natural cnt = 0;
+	while (iter.hasItems()) {
+		if (iter.peek().isText()) print("%1 ") << iter.readText().length();
+		else {iter.skip(); cnt++;}
+	}
+	print("%1") << cnt;
+}
+
+defineTest xmlIterator_stream("xmlIterator.stream","3 1 5",&xmlIteratorStreamTest);
+
+}